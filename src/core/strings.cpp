@@ -41,8 +41,12 @@ class StringsImpl
 {
 public:     
     char const* getString(char const* data) override;
+    char const* adopt(std::vector<char const*> const& data) override;
 
 private:
+    //  Interning mutates the set; concurrent compilations (and a checker's
+    //  string fixup) go through here, so it takes a lock like the factory.
+    std::mutex                      m_mutex;
     std::set<const char*, cstrless> m_set;
 };
 
@@ -53,10 +57,7 @@ char const* Strings::getString(std::string const& data)
 
 char const* StringsImpl::getString(char const* data)
 {
-    //  Interning mutates the set; concurrent compilations (and a checker's
-    //  string fixup) go through here, so it takes a lock like the factory.
-    static std::mutex           m;
-    std::lock_guard<std::mutex> lock(m);
+    std::lock_guard<std::mutex> lock(m_mutex);
 
     auto iter = m_set.find(data);
 
@@ -72,6 +73,20 @@ char const* StringsImpl::getString(char const* data)
     return *iter;
 }
 
+char const* StringsImpl::adopt(std::vector<char const*> const& data)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto str : data)
+    {
+        auto    it = m_set.find(str);
+        if (it != m_set.end() && *it != str)
+            return str;
+    }
+    m_set.insert(data.begin(), data.end());
+    return nullptr;
+}
+
 Strings*    Strings::instance()
 {
     static Strings* instance    = new StringsImpl();
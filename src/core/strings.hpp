@@ -27,6 +27,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
 
 class Strings
 {
@@ -34,4 +35,9 @@ public:
     static Strings*     instance();
     virtual char const* getString(  char const*         data) = 0;
     char const*         getString(  std::string const&  data);
+
+    //  Intern the strings in `data` themselves rather than copies -- they must
+    //  outlive the table. All or none: if equal content is interned already,
+    //  as another pointer, nothing is adopted and that string is returned.
+    virtual char const* adopt(      std::vector<char const*> const& data) = 0;
 };
\ No newline at end of file
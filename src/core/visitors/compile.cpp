@@ -29,6 +29,7 @@
 #include "strings.hpp"
 #include "../factory.hpp"
 #include "../builtins.hpp"
+#include "runtime/scan.hpp"
 
 #include <algorithm>
 #include <cstdio>
@@ -438,11 +439,24 @@ struct CompileExprImpl
     Type*           valueType(Expr* expr);
     llvm::Value*    setBool(llvm::Value* var, llvm::Value* val);
     void            compileTemporalLoops(Expr* rootExpr);
-    llvm::Value*    compileTemporalLoopInline(Expr*        expr,
-                                              llvm::Value* rhsV,
-                                              llvm::Value* lhsV,
-                                              llvm::Value* endV,
-                                              bool         isUR);
+    void            compileTemporalLoops(std::vector<Expr*> const& roots);
+
+    //  One operator of a fused pass: the (rhsV, lhsV, endV) of a U/R/S/T, or
+    //  the weighting and total type of an integer Sum/Itg.
+    struct Fused
+    {
+        Expr*           expr        = nullptr;
+        llvm::Value*    rhsV        = nullptr;
+        llvm::Value*    lhsV        = nullptr;
+        llvm::Value*    endV        = nullptr;
+        bool            weighted    = false;
+        llvm::Type*     type        = nullptr;
+    };
+    void            compileFusedLoops(std::vector<Fused> const& ops, std::int64_t kind);
+    std::vector<llvm::Value*>
+                    fusedBlock(std::vector<Fused> const& ops, std::int64_t kind,
+                               llvm::Value* lo, llvm::Value* hi,
+                               std::vector<llvm::Value*> const& columns);
     llvm::Value*    compileTemporalLoopBounded(Temporal<ExprBinary>* expr,
                                                llvm::Value* rhsV,
                                                llvm::Value* lhsV,
@@ -451,6 +465,21 @@ struct CompileExprImpl
     llvm::Value*    sliceCount(ExprSlice* expr);
     llvm::Value*    shortCircuit(Expr* lhs, Expr* rhs, bool isAnd);
     llvm::Value*    compileAccumulatorLoop(Temporal<ExprBinary>* expr, bool weighted, llvm::Type* type);
+    llvm::Value*    allocColumn(llvm::Type* elemType, llvm::Value* count, std::string const& name);
+
+    //  A block kernel's body: emitted into the kernel's own instance, given
+    //  the block's bounds and the columns being filled, returning a summary
+    //  per column (see runtime/scan.hpp).
+    using KernelBody    = std::function<std::vector<llvm::Value*>(
+                                CompileExprImpl& kernel, llvm::Value* lo, llvm::Value* hi,
+                                std::vector<llvm::Value*> const& columns)>;
+    void            emitScan(std::vector<Expr*> const&          exprs,
+                             std::vector<llvm::Value*> const&   buffers,
+                             llvm::Value*                       numStates,
+                             std::int64_t                       kind,
+                             std::string const&                 name,
+                             KernelBody const&                  body);
+    llvm::Value*    accumulatorStep(Temporal<ExprBinary>* expr, bool weighted, llvm::Value* zero);
     llvm::Value*    guardIndex(llvm::Value* ptr,  llvm::Value* indx,
                                llvm::Value* count, llvm::Type* elemType, Expr* expr);
 
@@ -480,6 +509,14 @@ struct CompileExprImpl
     //  function (see __prepare__) must drop them between nests.
     void            resetTemporalBuffers()  {m_temporalBuffers.clear(); m_accumBuffers.clear();}
 
+    //  What a monitor's companions hand the compiler in place of a trace: a
+    //  freeze's name bound to a state captured elsewhere, and an accumulator's
+    //  total read from a slot rather than folded. Both outlive one `make`.
+    void            bind(std::string const& name, llvm::Value* state)
+                                            {m_name2value.push_back(std::make_pair(name, state));}
+    void            accumulated(Expr* expr, llvm::Value* slot, llvm::Type* type)
+                                            {m_accumBuffers[expr] = {slot, type};}
+
     //  Nesting depth in a scope that walks segments of the trace -- `before`,
     //  `after`, `while`, `between .. and ..`, `after .. until ..`. Nonzero
     //  means the body being compiled is evaluated over a segment whose bounds
@@ -666,7 +703,11 @@ CompileExprImpl::CompileExprImpl(
     //  A single-state *atom* is `(curr, conf)`: a non-temporal predicate with no
     //  trace at all, for a monitor to evaluate one state at a time. `curr`
     //  stands in for frst/last so the pointer type resolves, and an atom carries
-    //  nothing temporal that would read them.
+    //  nothing temporal that would read them. A block *kernel* is
+    //  `(frst, last, conf, lo, hi, bufs, sums)` -- a requirement's first three
+    //  with the states it walks, the columns it fills and reads, and where its
+    //  block summaries go appended (see emitScan);
+    //  it pushes its own `curr` per state, so there is none to start from.
     auto    iter    = function->arg_begin();
     auto    arity   = function->arg_size();
 
@@ -686,13 +727,20 @@ CompileExprImpl::CompileExprImpl(
     }
 
     m_conf  = iter;
+
+    //  Compiled for one conf (Compile::make's `conf`): read the constant, not
+    //  the argument. The argument is still passed, and still the same bytes.
+    if(auto* baked = m_module->getNamedGlobal("__conf__"); baked && baked->hasInitializer())
+        m_conf  = baked;
+
     m_propType      = propType;
     m_propPtrType   = m_frst.front()->getType();
     m_confType      = confType;
     m_confPtrType   = m_conf->getType();
     m_boolType      = m_builder->getInt1Ty();
 
-    m_curr.push_back(arity == 3 ? getNext(m_frst.front()) : currArg);
+    if(arity != 7)
+        m_curr.push_back(arity == 3 ? getNext(m_frst.front()) : currArg);
 }
 
 void    CompileExprImpl::visit(ExprAdd*          expr)
@@ -1091,10 +1139,17 @@ void    CompileExprImpl::visit(ExprGt*           expr)
     compare(llvm::CmpInst::Predicate::ICMP_SGT, llvm::CmpInst::Predicate::FCMP_OGT, expr);
 }
 
-//  Where an out-of-range read is recorded. Four globals rather than a call,
+//  Where an out-of-range read is recorded. Globals rather than a call,
 //  because the check is on the hot path and a fault is not: the in-range case
 //  costs two compares and a branch that is never taken.
 //
+//  The faulting path takes a spin lock (`__oob_lock__`), because block
+//  kernels under `--threads` and a monitor's evaluator threads reach it
+//  concurrently. Under the lock the fault at the earliest state wins -- the
+//  first recorded, for that state -- so which one is reported does not depend
+//  on how the blocks were scheduled: `--threads 1` walks them in one order
+//  and reports the same one.
+//
 //  The reported verdict cannot be invented here. A requirement returns one
 //  boolean and the host decides what it means -- returning `false` from inside
 //  a negated requirement would read as a pass. So the fault is raised, the
@@ -1143,20 +1198,52 @@ llvm::Value*    CompileExprImpl::guardIndex(llvm::Value* ptr,   llvm::Value* ind
                         m_module->getDataLayout().getTypeAllocSize(elemType).getFixedValue());
     auto    zeroBuf  = faultSlot(m_module, m_context, zeroName.c_str(), elemType);
 
+    auto    i8Ty    = m_builder->getInt8Ty();
+    auto    lock    = faultSlot(m_module, m_context, "__oob_lock__", i8Ty);
+    auto    flag    = faultSlot(m_module, m_context, "__oob_flag__", i8Ty);
+    auto    at      = faultSlot(m_module, m_context, "__oob_at__",   i64Ty);
+    auto    bbSpin  = llvm::BasicBlock::Create(*m_context, "oob.spin",   func);
+    auto    bbHeld  = llvm::BasicBlock::Create(*m_context, "oob.held",   func);
+    auto    bbKeep  = llvm::BasicBlock::Create(*m_context, "oob.record", func);
+    auto    bbFree  = llvm::BasicBlock::Create(*m_context, "oob.unlock", func);
+
+    //  States are laid out in order, so the state's address orders them.
     m_builder->SetInsertPoint(bbOob);
-    m_builder->CreateStore(m_builder->getInt8(1),
-                           faultSlot(m_module, m_context, "__oob_flag__", m_builder->getInt8Ty()));
+    auto    state   = m_curr.empty() ? static_cast<llvm::Value*>(zero)
+                                     : m_builder->CreatePtrToInt(m_curr.back(), i64Ty, "oob.state");
+    m_builder->CreateBr(bbSpin);
+
+    m_builder->SetInsertPoint(bbSpin);
+    auto    taken   = m_builder->CreateAtomicRMW(llvm::AtomicRMWInst::Xchg, lock, m_builder->getInt8(1),
+                                                 llvm::MaybeAlign(1), llvm::AtomicOrdering::Acquire);
+    m_builder->CreateCondBr(m_builder->CreateICmpNE(taken, m_builder->getInt8(0)), bbSpin, bbHeld);
+
+    m_builder->SetInsertPoint(bbHeld);
+    auto    none    = m_builder->CreateICmpEQ(m_builder->CreateLoad(i8Ty, flag, "oob.flag"),
+                                              m_builder->getInt8(0));
+    auto    earlier = m_builder->CreateICmpULT(state, m_builder->CreateLoad(i64Ty, at, "oob.at"));
+    m_builder->CreateCondBr(m_builder->CreateOr(none, earlier), bbKeep, bbFree);
+
+    m_builder->SetInsertPoint(bbKeep);
+    m_builder->CreateStore(m_builder->getInt8(1), flag);
+    m_builder->CreateStore(state, at);
     m_builder->CreateStore(indx,
                            faultSlot(m_module, m_context, "__oob_indx__", i64Ty));
     m_builder->CreateStore(count,
                            faultSlot(m_module, m_context, "__oob_cnt__",  i64Ty));
+    m_builder->CreateBr(bbFree);
+
+    m_builder->SetInsertPoint(bbFree);
+    auto    release = m_builder->CreateStore(m_builder->getInt8(0), lock);
+    release->setAtomic(llvm::AtomicOrdering::Release);
+    release->setAlignment(llvm::Align(1));
     m_builder->CreateBr(bbCont);
 
     m_builder->SetInsertPoint(bbCont);
     auto    phi = m_builder->CreatePHI(m_builder->getPtrTy(), 2, "elem");
 
     phi->addIncoming(ptr,     bbFrom);
-    phi->addIncoming(zeroBuf, bbOob);
+    phi->addIncoming(zeroBuf, bbFree);
 
     return  phi;
 }
@@ -3016,70 +3103,188 @@ llvm::Value*    CompileExprImpl::setBool(llvm::Value* var, llvm::Value* val)
     return m_builder->CreateStore(val, var);
 }
 void CompileExprImpl::compileTemporalLoops(Expr* rootExpr)
+{
+    compileTemporalLoops(std::vector<Expr*>{rootExpr});
+}
+
+//  Build the buffers of every eligible operator under `roots`, as few passes
+//  over the trace as the dependencies allow.
+//
+//  Each buffer used to be a loop of its own, so a requirement with five U/R
+//  operators streamed the state array five times. Operators are now scheduled
+//  by *level* -- one more than the deepest buffered operator nested in them,
+//  so nothing at a level reads anything else at it -- and within a level by
+//  the kind of walk they need: backward booleans (U/R), forward booleans
+//  (S/T), backward integer sums. Each such group is one fused pass that visits
+//  every state once and fills all its columns (compileFusedLoops). Bounded
+//  operators and `number` accumulators keep a pass of their own, emitted at
+//  their level ahead of the fused groups.
+void CompileExprImpl::compileTemporalLoops(std::vector<Expr*> const& roots)
 {
     std::vector<Expr*> temporals;
-    collectTemporals(rootExpr, temporals);
+    for (auto* root : roots)
+        collectTemporals(root, temporals);
 
     if (temporals.empty()) return;
 
+    struct Plan
+    {
+        Fused           op;
+        std::int64_t    kind    = -1;       //  REF_SCAN_*, or -1: a pass of its own
+        bool            isUR    = false;
+        bool            bounded = false;
+        int             level   = 1;
+    };
+
+    std::vector<Plan>       plans;
+    std::map<Expr*, int>    levels;
+    int                     deepest = 0;
+
     for (auto* expr : temporals)
     {
         if (m_temporalBuffers.count(expr)) continue;
         if (m_accumBuffers.count(expr)) continue;
         if (hasFreeContext(expr, {})) continue;
 
+        Plan    plan;
+        plan.op.expr = expr;
+
         if (isLoopAccumulator(expr))
         {
             //  Sum and Itg are both Temporal<ExprBinary>: lhs selects, rhs is
             //  the value. Itg additionally weights each step by its duration.
             auto* acc      = dynamic_cast<Temporal<ExprBinary>*>(expr);
-            bool  weighted = dynamic_cast<ExprInt*>(expr) != nullptr;
-            auto* type = valueType(acc->rhs) == Factory<TypeInteger>::create()
-                       ? static_cast<llvm::Type*>(m_builder->getInt64Ty())
-                       : static_cast<llvm::Type*>(m_builder->getDoubleTy());
+            plan.op.weighted = dynamic_cast<ExprInt*>(expr) != nullptr;
+            plan.op.type     = valueType(acc->rhs) == Factory<TypeInteger>::create()
+                             ? static_cast<llvm::Type*>(m_builder->getInt64Ty())
+                             : static_cast<llvm::Type*>(m_builder->getDoubleTy());
+            plan.kind        = plan.op.type->isIntegerTy() ? REF_SCAN_SUM : -1;
+        }
+        else
+        {
+            //  A bounded operator slides its window with a monotone pointer,
+            //  which needs the bounds to be constants of the trace.  A bound
+            //  reading a `data` signal or a frozen state makes the window
+            //  non-monotone, and such operators stay on the nested scan.
+            auto* temporal  = dynamic_cast<Temporal<ExprBinary>*>(expr);
+            plan.bounded    = temporal && temporal->time != nullptr;
+
+            if (plan.bounded && !hasLoopInvariantTime(temporal->time)) continue;
+
+            //  (rhsV, lhsV, endV) must mirror the corresponding visit() call
+            //  site exactly -- those are the authority on each operator's
+            //  semantics.  U/S short-circuit on rhs==true / lhs==false
+            //  (disjunctive), while their duals R/T short-circuit on
+            //  rhs==false / lhs==true (conjunctive).  Getting this table wrong
+            //  silently collapses e.g. G(a) -- which canonicalises to
+            //  Rw(false, a) -- into pointwise `a`.
+            auto& o = plan.op;
+            if      (dynamic_cast<ExprUs*>(expr)) {plan.isUR = true;  o.rhsV = m_T; o.lhsV = m_F; o.endV = m_F;}
+            else if (dynamic_cast<ExprUw*>(expr)) {plan.isUR = true;  o.rhsV = m_T; o.lhsV = m_F; o.endV = m_T;}
+            else if (dynamic_cast<ExprRs*>(expr)) {plan.isUR = true;  o.rhsV = m_F; o.lhsV = m_T; o.endV = m_F;}
+            else if (dynamic_cast<ExprRw*>(expr)) {plan.isUR = true;  o.rhsV = m_F; o.lhsV = m_T; o.endV = m_T;}
+            else if (dynamic_cast<ExprSs*>(expr)) {plan.isUR = false; o.rhsV = m_T; o.lhsV = m_F; o.endV = m_F;}
+            else if (dynamic_cast<ExprSw*>(expr)) {plan.isUR = false; o.rhsV = m_T; o.lhsV = m_F; o.endV = m_T;}
+            else if (dynamic_cast<ExprTs*>(expr)) {plan.isUR = false; o.rhsV = m_F; o.lhsV = m_T; o.endV = m_F;}
+            else if (dynamic_cast<ExprTw*>(expr)) {plan.isUR = false; o.rhsV = m_F; o.lhsV = m_T; o.endV = m_T;}
+            else                                  continue;
+
+            if (!plan.bounded)
+                plan.kind = plan.isUR ? REF_SCAN_BACKWARD : REF_SCAN_FORWARD;
+        }
 
-            m_accumBuffers[expr] = {compileAccumulatorLoop(acc, weighted, type), type};
-            continue;
+        //  `temporals` is post-order, so every operator nested in this one
+        //  that is being buffered already has its level.
+        std::vector<Expr*>  inner;
+        collectTemporals(expr, inner);
+        for (auto* e : inner)
+            if (auto it = levels.find(e); e != expr && it != levels.end())
+                plan.level = std::max(plan.level, it->second + 1);
+
+        levels[expr]    = plan.level;
+        deepest         = std::max(deepest, plan.level);
+        plans.push_back(plan);
+    }
+
+    for (int level = 1; level <= deepest; level++)
+    {
+        for (auto const& plan : plans)
+        {
+            if (plan.level != level || plan.kind != -1)
+                continue;
+
+            auto* expr = plan.op.expr;
+            if (plan.bounded)
+                m_temporalBuffers[expr] = compileTemporalLoopBounded(
+                    dynamic_cast<Temporal<ExprBinary>*>(expr),
+                    plan.op.rhsV, plan.op.lhsV, plan.op.endV, plan.isUR);
+            else
+                m_accumBuffers[expr] = {compileAccumulatorLoop(
+                    dynamic_cast<Temporal<ExprBinary>*>(expr), plan.op.weighted, plan.op.type),
+                    plan.op.type};
+        }
+
+        for (auto kind : {REF_SCAN_BACKWARD, REF_SCAN_FORWARD, REF_SCAN_SUM})
+        {
+            std::vector<Fused>  group;
+            for (auto const& plan : plans)
+            {
+                if (plan.level != level || plan.kind != kind)
+                    continue;
+
+                group.push_back(plan.op);
+                if (static_cast<std::int64_t>(group.size()) == referee::rt::kMaxWidth)
+                {
+                    compileFusedLoops(group, kind);
+                    group.clear();
+                }
+            }
+            if (!group.empty())
+                compileFusedLoops(group, kind);
         }
+    }
+}
 
-        //  A bounded operator slides its window with a monotone pointer, which
-        //  needs the bounds to be constants of the trace.  A bound reading a
-        //  `data` signal or a frozen state makes the window non-monotone, and
-        //  such operators stay on the nested scan.
-        auto* temporal  = dynamic_cast<Temporal<ExprBinary>*>(expr);
-        bool  isBounded = temporal && temporal->time != nullptr;
-
-        if (isBounded && !hasLoopInvariantTime(temporal->time)) continue;
-
-        //  (rhsV, lhsV, endV) must mirror the corresponding visit() call site
-        //  exactly -- those are the authority on each operator's semantics.
-        //  U/S short-circuit on rhs==true / lhs==false (disjunctive), while
-        //  their duals R/T short-circuit on rhs==false / lhs==true
-        //  (conjunctive).  Getting this table wrong silently collapses e.g.
-        //  G(a) -- which canonicalises to Rw(false, a) -- into pointwise `a`.
-        bool            isUR = false;
-        llvm::Value*    rhsV = nullptr;
-        llvm::Value*    lhsV = nullptr;
-        llvm::Value*    endV = nullptr;
-
-        if      (dynamic_cast<ExprUs*>(expr)) {isUR = true;  rhsV = m_T; lhsV = m_F; endV = m_F;}
-        else if (dynamic_cast<ExprUw*>(expr)) {isUR = true;  rhsV = m_T; lhsV = m_F; endV = m_T;}
-        else if (dynamic_cast<ExprRs*>(expr)) {isUR = true;  rhsV = m_F; lhsV = m_T; endV = m_F;}
-        else if (dynamic_cast<ExprRw*>(expr)) {isUR = true;  rhsV = m_F; lhsV = m_T; endV = m_T;}
-        else if (dynamic_cast<ExprSs*>(expr)) {isUR = false; rhsV = m_T; lhsV = m_F; endV = m_F;}
-        else if (dynamic_cast<ExprSw*>(expr)) {isUR = false; rhsV = m_T; lhsV = m_F; endV = m_T;}
-        else if (dynamic_cast<ExprTs*>(expr)) {isUR = false; rhsV = m_F; lhsV = m_T; endV = m_F;}
-        else if (dynamic_cast<ExprTw*>(expr)) {isUR = false; rhsV = m_F; lhsV = m_T; endV = m_T;}
-        else                                  continue;
-
-        m_temporalBuffers[expr] = isBounded
-            ? compileTemporalLoopBounded(temporal, rhsV, lhsV, endV, isUR)
-            : compileTemporalLoopInline(expr, rhsV, lhsV, endV, isUR);
+//  A trace-length buffer of `count` elements, taken from the host rather than
+//  the stack (see runtime/columns.hpp). An alloca of numStates capped a trace
+//  at the stack size and pinned every column in RAM; a host column can be
+//  spilled to a file the kernel pages through as the loop streams.
+//
+//  The lifetime is the alloca's: the first column a function takes also plants
+//  a mark at the top of its entry block, and `releaseColumns` releases back to
+//  it before every return once the module is complete.
+llvm::Value* CompileExprImpl::allocColumn(llvm::Type* elemType, llvm::Value* count,
+                                          std::string const& name)
+{
+    auto    i64     = m_builder->getInt64Ty();
+    auto    markFn  = m_module->getOrInsertFunction("__ref_column_mark",
+                        llvm::FunctionType::get(i64, {}, false));
+    auto    takeFn  = m_module->getOrInsertFunction("__ref_column",
+                        llvm::FunctionType::get(m_builder->getPtrTy(), {i64}, false));
+
+    auto&   entry   = m_function->getEntryBlock();
+    bool    marked  = false;
+    for (auto& inst : entry)
+        if (auto* call = llvm::dyn_cast<llvm::CallInst>(&inst))
+            if (auto* f = call->getCalledFunction(); f && f->getName() == "__ref_column_mark")
+                marked = true;
+
+    if (!marked)
+    {
+        llvm::IRBuilder<>   top(&entry, entry.begin());
+        top.CreateCall(markFn, {}, "columns");
     }
+
+    //  i1 is stored a byte per element, as the alloca laid it out.
+    auto    width   = (elemType->getPrimitiveSizeInBits() + 7) / 8;
+    auto    bytes   = m_builder->CreateMul(count, llvm::ConstantInt::get(i64, width), name + "_bytes");
+    return m_builder->CreateCall(takeFn, {bytes}, name);
 }
 
-//  Emit the O(N) recurrence for one unbounded U/R/S/T node into a
-//  bool[numStates] stack buffer, and return the buffer.
+//  Emit the O(N) recurrence for a group of unbounded U/R/S/T nodes into a
+//  bool[numStates] column each -- or, for integer Sum/Itg, the suffix-sum
+//  fold described at compileAccumulatorLoop into a value column each -- as
+//  one pass over the trace, and record the buffers.
 //
 //  The slow path is a linear scan that, walking away from the evaluation
 //  point, returns rhsV on the first state where rhs==rhsV, lhsV on the first
@@ -3094,144 +3299,295 @@ void CompileExprImpl::compileTemporalLoops(Expr* rootExpr)
 //  for their duals R/T once the constants are substituted.  Emitting the
 //  select chain rather than a hand-specialised form keeps the two families
 //  from drifting apart.
-llvm::Value* CompileExprImpl::compileTemporalLoopInline(Expr*        expr,
-                                                        llvm::Value* rhsV,
-                                                        llvm::Value* lhsV,
-                                                        llvm::Value* endV,
-                                                        bool         isUR)
+//
+//  The walk itself is a block kernel (fusedBlock) handed to `__ref_scan`,
+//  which runs it over the whole trace on one thread or over a block per
+//  worker with a fix-up pass -- the recurrence's steps compose, so the two
+//  agree state for state.  Every operator in `ops` walks the same way and
+//  reads none of the others (compileTemporalLoops grouped them so), which is
+//  what lets one walk serve them all.
+void CompileExprImpl::compileFusedLoops(std::vector<Fused> const& ops, std::int64_t kind)
 {
     auto frst = m_frst.back();
     auto last = m_last.back();
+    auto i64  = m_builder->getInt64Ty();
 
     auto diff = m_builder->CreatePtrDiff(m_propType, last, frst, "diff");
-    auto numStates = m_builder->CreateAdd(diff, llvm::ConstantInt::get(m_builder->getInt64Ty(), 1), "numStates");
+    auto numStates = m_builder->CreateAdd(diff, llvm::ConstantInt::get(i64, 1), "numStates");
+    auto lastIdx = m_builder->CreateSub(numStates, llvm::ConstantInt::get(i64, 1));
+
+    std::vector<Expr*>          exprs;
+    std::vector<llvm::Value*>   buffers;
+    for (auto const& op : ops)
+    {
+        bool    sum     = kind == REF_SCAN_SUM;
+        auto    elem    = sum ? op.type : m_builder->getInt1Ty();
+        auto    buffer  = allocColumn(elem, numStates, sum ? "accum_buf" : "temp_buf");
+
+        //  Both sentinel slots get the base value.  The one the recurrence
+        //  starts from -- numStates-1 backward, 0 forward -- is its base case,
+        //  and the scan reads it as the carry into the first block.  The other
+        //  is never a legitimate evaluation point (the sentinels carry no prop
+        //  storage, so evaluating rhs/lhs there would dereference garbage --
+        //  the slow path avoids it for the same reason), but a nested Ys at the
+        //  first real state or Xs at the last still reads the slot, so it must
+        //  hold something defined.  A sum's base value is the identity.
+        auto    base    = sum ? llvm::ConstantInt::getSigned(op.type, 0) : op.endV;
+        m_builder->CreateStore(base, m_builder->CreateGEP(elem, buffer, lastIdx));
+        m_builder->CreateStore(base, m_builder->CreateGEP(elem, buffer, llvm::ConstantInt::get(i64, 0)));
+
+        exprs.push_back(op.expr);
+        buffers.push_back(buffer);
+    }
+
+    auto name = std::string(kind == REF_SCAN_SUM ? "Sum" : kind == REF_SCAN_BACKWARD ? "UR" : "ST");
+    emitScan(exprs, buffers, numStates, kind, name,
+             [&](CompileExprImpl& kernel, llvm::Value* lo, llvm::Value* hi,
+                 std::vector<llvm::Value*> const& columns)
+             {
+                 return kernel.fusedBlock(ops, kind, lo, hi, columns);
+             });
+
+    for (std::size_t c = 0; c < ops.size(); c++)
+        if (kind == REF_SCAN_SUM)
+            m_accumBuffers[ops[c].expr] = {buffers[c], ops[c].type};
+        else
+            m_temporalBuffers[ops[c].expr] = buffers[c];
+}
 
-    auto buffer = m_builder->CreateAlloca(m_builder->getInt1Ty(), numStates, "temp_buf");
+//  One block of a fused pass, states [lo, hi], walked in the pass's own
+//  direction, returning each column's summary.
+//
+//  A boolean column's carry into the block is provisionally endV -- the true
+//  one only for the block the walk starts in, where it is the base case -- so
+//  its states up to the first decisive one may be wrong, and that state's
+//  index is what the block reports: everything nearer the entry edge than it
+//  equals the carry, whatever the carry turns out to be.  `lo-1` (backward) or
+//  `hi+1` (forward) says no state in the block was decisive.  A sum's running
+//  total starts at the identity and the block reports it: the scan adds every
+//  other block's shortfall back.
+//
+//  Every operand is evaluated before any column is stored, so the state's
+//  props are read in one run with nothing in between that could alias them
+//  -- the optimiser folds the repeated loads, and each state is read once
+//  however many operators the pass serves.
+std::vector<llvm::Value*> CompileExprImpl::fusedBlock(std::vector<Fused> const& ops,
+                                                      std::int64_t kind,
+                                                      llvm::Value* lo, llvm::Value* hi,
+                                                      std::vector<llvm::Value*> const& columns)
+{
+    auto i64      = m_builder->getInt64Ty();
+    auto frst     = m_frst.back();
+    bool sum      = kind == REF_SCAN_SUM;
+    bool backward = kind != REF_SCAN_FORWARD;
+    auto start    = backward ? hi : lo;
+    auto none     = sum      ? nullptr
+                  : backward ? m_builder->CreateSub(lo, m_p1, "none")
+                             : m_builder->CreateAdd(hi, m_p1, "none");
+    auto tag      = std::string(sum ? "Sum" : backward ? "UR" : "ST");
 
     auto bbEntry = m_builder->GetInsertBlock();
+    auto bbWhile = llvm::BasicBlock::Create(*m_context, "while_" + tag, m_function);
+    auto bbBody  = llvm::BasicBlock::Create(*m_context, "body_"  + tag, m_function);
+    auto bbNext  = llvm::BasicBlock::Create(*m_context, "next_"  + tag, m_function);
+    auto bbExit  = llvm::BasicBlock::Create(*m_context, "exit_"  + tag, m_function);
 
-    if (isUR)
+    m_builder->CreateBr(bbWhile);
+
+    m_builder->SetInsertPoint(bbWhile);
+    auto idx = m_builder->CreatePHI(i64, 2, "idx");
+    std::vector<llvm::PHINode*> carries, decs;
+    for (auto const& op : ops)
     {
-        //  Both sentinel slots get the base value.  index numStates-1 is the
-        //  recurrence's base case; index 0 is never a legitimate evaluation
-        //  point (the sentinels carry no prop storage, so evaluating rhs/lhs
-        //  there would dereference garbage -- the slow path avoids it for the
-        //  same reason), but a nested Ys at the first real state still reads
-        //  the slot, so it must hold something defined rather than whatever
-        //  the alloca happened to contain.
-        auto lastIdx = m_builder->CreateSub(numStates, llvm::ConstantInt::get(m_builder->getInt64Ty(), 1));
-        auto lastPtr = m_builder->CreateGEP(m_builder->getInt1Ty(), buffer, lastIdx);
-        m_builder->CreateStore(endV, lastPtr);
-        m_builder->CreateStore(endV, m_builder->CreateGEP(m_builder->getInt1Ty(), buffer,
-                                        llvm::ConstantInt::get(m_builder->getInt64Ty(), 0)));
-
-        auto bbWhile = llvm::BasicBlock::Create(*m_context, "while_UR", m_function);
-        auto bbBody  = llvm::BasicBlock::Create(*m_context, "body_UR", m_function);
-        auto bbNext  = llvm::BasicBlock::Create(*m_context, "next_UR", m_function);
-        auto bbExit  = llvm::BasicBlock::Create(*m_context, "exit_UR", m_function);
-
-        auto curr0 = getPrev(last);
-        m_builder->CreateBr(bbWhile);
-
-        m_builder->SetInsertPoint(bbWhile);
-        auto curr = m_builder->CreatePHI(m_propPtrType, 2, "curr");
-        auto cond = m_builder->CreateICmpSGT(curr, frst, "curr > frst");
-        m_builder->CreateCondBr(cond, bbBody, bbExit);
-
-        m_builder->SetInsertPoint(bbBody);
-        m_curr.push_back(curr);
-
-        auto idx = m_builder->CreatePtrDiff(m_propType, curr, frst, "idx");
-        auto idxNext = m_builder->CreateAdd(idx, llvm::ConstantInt::get(m_builder->getInt64Ty(), 1), "idxNext");
-        auto nextPtr = m_builder->CreateGEP(m_builder->getInt1Ty(), buffer, idxNext);
-        auto nextVal = m_builder->CreateLoad(m_builder->getInt1Ty(), nextPtr, false, "nextVal");
-
-        auto binary = dynamic_cast<ExprBinary*>(expr);
+        carries.push_back(m_builder->CreatePHI(sum ? op.type : m_boolType, 2, "carry"));
+        if (!sum)
+            decs.push_back(m_builder->CreatePHI(i64, 2, "dec"));
+    }
+    auto cond = backward ? m_builder->CreateICmpSGE(idx, lo, "idx >= lo")
+                         : m_builder->CreateICmpSLE(idx, hi, "idx <= hi");
+    m_builder->CreateCondBr(cond, bbBody, bbExit);
+
+    m_builder->SetInsertPoint(bbBody);
+    m_curr.push_back(m_builder->CreateGEP(m_propType, frst, idx, "curr"));
+
+    std::vector<llvm::Value*>   vals, decNexts;
+    for (std::size_t c = 0; c < ops.size(); c++)
+    {
+        auto const& op = ops[c];
+        if (sum)
+        {
+            auto zero = llvm::ConstantInt::getSigned(op.type, 0);
+            vals.push_back(add(carries[c],
+                accumulatorStep(dynamic_cast<Temporal<ExprBinary>*>(op.expr), op.weighted, zero),
+                "total"));
+            continue;
+        }
+
+        auto binary = dynamic_cast<ExprBinary*>(op.expr);
         auto rhs = make(binary->rhs);
         auto lhs = make(binary->lhs);
-        auto rhsHit = m_builder->CreateICmpEQ(rhs, rhsV, "rhsHit");
-        auto lhsHit = m_builder->CreateICmpEQ(lhs, lhsV, "lhsHit");
-        auto val = m_builder->CreateSelect(
-                        rhsHit, rhsV,
-                        m_builder->CreateSelect(lhsHit, lhsV, nextVal, "lhsSel"),
-                        "val");
+        auto rhsHit = m_builder->CreateICmpEQ(rhs, op.rhsV, "rhsHit");
+        auto lhsHit = m_builder->CreateICmpEQ(lhs, op.lhsV, "lhsHit");
+        vals.push_back(m_builder->CreateSelect(
+                        rhsHit, op.rhsV,
+                        m_builder->CreateSelect(lhsHit, op.lhsV, carries[c], "lhsSel"),
+                        "val"));
+
+        auto first = m_builder->CreateAnd(m_builder->CreateICmpEQ(decs[c], none, "undecided"),
+                                          m_builder->CreateOr(rhsHit, lhsHit, "decisive"), "first");
+        decNexts.push_back(m_builder->CreateSelect(first, idx, decs[c], "decNext"));
+    }
 
-        auto currPtr = m_builder->CreateGEP(m_builder->getInt1Ty(), buffer, idx);
-        m_builder->CreateStore(val, currPtr);
+    for (std::size_t c = 0; c < ops.size(); c++)
+        m_builder->CreateStore(vals[c], m_builder->CreateGEP(sum ? ops[c].type : m_boolType,
+                                                             columns[c], idx));
 
-        m_curr.pop_back();
-        m_builder->CreateBr(bbNext);
+    m_curr.pop_back();
+    m_builder->CreateBr(bbNext);
 
-        m_builder->SetInsertPoint(bbNext);
-        auto currPrev = getPrev(curr);
-        m_builder->CreateBr(bbWhile);
+    m_builder->SetInsertPoint(bbNext);
+    auto idxNext = backward ? m_builder->CreateSub(idx, m_p1, "idxNext")
+                            : m_builder->CreateAdd(idx, m_p1, "idxNext");
+    m_builder->CreateBr(bbWhile);
 
-        curr->addIncoming(curr0, bbEntry);
-        curr->addIncoming(currPrev, bbNext);
+    idx->addIncoming(start, bbEntry);
+    idx->addIncoming(idxNext, bbNext);
 
-        m_builder->SetInsertPoint(bbExit);
+    std::vector<llvm::Value*>   summaries;
+    for (std::size_t c = 0; c < ops.size(); c++)
+    {
+        carries[c]->addIncoming(sum ? llvm::ConstantInt::getSigned(ops[c].type, 0) : ops[c].endV, bbEntry);
+        carries[c]->addIncoming(vals[c], bbNext);
+        if (sum)
+        {
+            summaries.push_back(carries[c]);
+            continue;
+        }
+        decs[c]->addIncoming(none, bbEntry);
+        decs[c]->addIncoming(decNexts[c], bbNext);
+        summaries.push_back(decs[c]);
     }
-    else
+
+    m_builder->SetInsertPoint(bbExit);
+    return summaries;
+}
+
+//  Hand a per-state walk to the host scheduler (runtime/scan.hpp).
+//
+//  The walk is emitted as a function of its own -- a *kernel* over states
+//  [lo, hi] -- because it is the only shape that can be run on several threads
+//  at once: the caller's loop would have every block share its PHIs. It is
+//  compiled by a fresh instance over the kernel, which knows nothing of the
+//  caller's columns, so each one the walk reads (an operator nested in one of
+//  `exprs` and built before it) is passed in the table after the columns
+//  being filled and installed under the same expression.  Everything else a
+//  body reads -- frst, last, conf, the props of a state -- is the caller's own
+//  arguments passed through, and nothing it does depends on which thread runs
+//  it.
+void CompileExprImpl::emitScan(std::vector<Expr*> const&          exprs,
+                               std::vector<llvm::Value*> const&   buffers,
+                               llvm::Value*                       numStates,
+                               std::int64_t                       kind,
+                               std::string const&                 name,
+                               KernelBody const&                  body)
+{
+    auto    i64     = m_builder->getInt64Ty();
+    auto    ptrTy   = m_builder->getPtrTy();
+    auto    width   = buffers.size();
+
+    std::vector<Expr*>  nested, passed;
+    for (auto* expr : exprs)
+        collectTemporals(expr, nested);
+    for (auto* e : nested)
+        if (std::find(exprs.begin(), exprs.end(), e) == exprs.end()
+         && (m_temporalBuffers.count(e) || m_accumBuffers.count(e)))
+            passed.push_back(e);
+
+    //  `__scan__` keeps it out of the driver's list of requirements, like the
+    //  other companions; nothing reaches it by name, so it stays internal.
+    auto    kernelTy = llvm::FunctionType::get(m_builder->getVoidTy(),
+                        {m_propPtrType, m_propPtrType, m_confPtrType, i64, i64, ptrTy, ptrTy}, false);
+    auto    kernelFn = llvm::Function::Create(kernelTy, llvm::Function::InternalLinkage,
+                        "__scan__" + m_function->getName().str() + "." + name, m_module);
+
+    auto    saved   = m_builder->saveIP();
+    m_builder->SetInsertPoint(llvm::BasicBlock::Create(*m_context, "entry", kernelFn));
     {
-        //  Mirror of the UR case: index 0 is the base case, index numStates-1
-        //  is the far sentinel that a nested Xs at the last real state reads.
-        auto zeroPtr = m_builder->CreateGEP(m_builder->getInt1Ty(), buffer, llvm::ConstantInt::get(m_builder->getInt64Ty(), 0));
-        m_builder->CreateStore(endV, zeroPtr);
-        auto lastIdx = m_builder->CreateSub(numStates, llvm::ConstantInt::get(m_builder->getInt64Ty(), 1));
-        m_builder->CreateStore(endV, m_builder->CreateGEP(m_builder->getInt1Ty(), buffer, lastIdx));
-
-        auto bbWhile = llvm::BasicBlock::Create(*m_context, "while_ST", m_function);
-        auto bbBody  = llvm::BasicBlock::Create(*m_context, "body_ST", m_function);
-        auto bbNext  = llvm::BasicBlock::Create(*m_context, "next_ST", m_function);
-        auto bbExit  = llvm::BasicBlock::Create(*m_context, "exit_ST", m_function);
-
-        auto curr0 = getNext(frst);
-        m_builder->CreateBr(bbWhile);
-
-        m_builder->SetInsertPoint(bbWhile);
-        auto curr = m_builder->CreatePHI(m_propPtrType, 2, "curr");
-        auto cond = m_builder->CreateICmpSLT(curr, last, "curr < last");
-        m_builder->CreateCondBr(cond, bbBody, bbExit);
-
-        m_builder->SetInsertPoint(bbBody);
-        m_curr.push_back(curr);
-
-        auto idx = m_builder->CreatePtrDiff(m_propType, curr, frst, "idx");
-        auto idxPrev = m_builder->CreateSub(idx, llvm::ConstantInt::get(m_builder->getInt64Ty(), 1), "idxPrev");
-        auto prevPtr = m_builder->CreateGEP(m_builder->getInt1Ty(), buffer, idxPrev);
-        auto prevVal = m_builder->CreateLoad(m_builder->getInt1Ty(), prevPtr, false, "prevVal");
-
-        auto binary = dynamic_cast<ExprBinary*>(expr);
-        auto rhs = make(binary->rhs);
-        auto lhs = make(binary->lhs);
-        auto rhsHit = m_builder->CreateICmpEQ(rhs, rhsV, "rhsHit");
-        auto lhsHit = m_builder->CreateICmpEQ(lhs, lhsV, "lhsHit");
-        auto val = m_builder->CreateSelect(
-                        rhsHit, rhsV,
-                        m_builder->CreateSelect(lhsHit, lhsV, prevVal, "lhsSel"),
-                        "val");
+        CompileExprImpl kernel(m_context, m_module, m_builder, kernelFn, m_refmod, m_propType, m_confType);
 
-        auto currPtr = m_builder->CreateGEP(m_builder->getInt1Ty(), buffer, idx);
-        m_builder->CreateStore(val, currPtr);
+        auto    bufs    = kernelFn->getArg(5);
+        auto    sums    = kernelFn->getArg(6);
+        auto    column  = [&](std::size_t slot)
+        {
+            auto    at  = m_builder->CreateGEP(ptrTy, bufs, llvm::ConstantInt::get(i64, slot));
+            return  static_cast<llvm::Value*>(m_builder->CreateLoad(ptrTy, at, "col"));
+        };
 
-        m_curr.pop_back();
-        m_builder->CreateBr(bbNext);
+        for (std::size_t j = 0; j < passed.size(); j++)
+        {
+            auto*   e = passed[j];
+            if (auto it = m_accumBuffers.find(e); it != m_accumBuffers.end())
+                kernel.m_accumBuffers[e] = {column(width + j), it->second.second};
+            else
+                kernel.m_temporalBuffers[e] = column(width + j);
+        }
 
-        m_builder->SetInsertPoint(bbNext);
-        auto currNext = getNext(curr);
-        m_builder->CreateBr(bbWhile);
+        std::vector<llvm::Value*>   own;
+        for (std::size_t c = 0; c < width; c++)
+            own.push_back(column(c));
 
-        curr->addIncoming(curr0, bbEntry);
-        curr->addIncoming(currNext, bbNext);
+        auto    summaries = body(kernel, kernelFn->getArg(3), kernelFn->getArg(4), own);
+        for (std::size_t c = 0; c < summaries.size(); c++)
+            m_builder->CreateStore(summaries[c],
+                m_builder->CreateGEP(i64, sums, llvm::ConstantInt::get(i64, c)));
+        m_builder->CreateRetVoid();
+    }
+    m_builder->restoreIP(saved);
 
-        m_builder->SetInsertPoint(bbExit);
+    if(llvm::verifyFunction(*kernelFn, &llvm::outs()))
+    {
+//  LCOV_EXCL_START
+//  GCOV_EXCL_START
+        throw std::runtime_error("scan kernel failed LLVM verification");
+//  GCOV_EXCL_STOP
+//  LCOV_EXCL_STOP
     }
 
-    return buffer;
+    //  The column table lives in the caller's frame; at the top of the entry
+    //  block, like any alloca, so a scan emitted inside a loop does not grow
+    //  the stack per iteration. Never empty, so a map's table is a valid
+    //  pointer too.
+    auto&   entry   = m_function->getEntryBlock();
+    llvm::IRBuilder<>   top(&entry, entry.begin());
+    auto    table   = top.CreateAlloca(llvm::ArrayType::get(ptrTy, width + passed.size() + 1),
+                                       nullptr, name + "_cols");
+
+    auto    slot    = [&](std::size_t j, llvm::Value* value)
+    {
+        m_builder->CreateStore(value, m_builder->CreateGEP(ptrTy, table, llvm::ConstantInt::get(i64, j)));
+    };
+
+    for (std::size_t c = 0; c < width; c++)
+        slot(c, buffers[c]);
+    for (std::size_t j = 0; j < passed.size(); j++)
+    {
+        auto*   e = passed[j];
+        if (auto it = m_accumBuffers.find(e); it != m_accumBuffers.end())
+            slot(width + j, it->second.first);
+        else
+            slot(width + j, m_temporalBuffers[e]);
+    }
+
+    auto    scanFn  = m_module->getOrInsertFunction("__ref_scan",
+                        llvm::FunctionType::get(m_builder->getVoidTy(),
+                            {ptrTy, m_propPtrType, m_propPtrType, m_confPtrType, ptrTy, i64, i64, i64}, false));
+    m_builder->CreateCall(scanFn, {kernelFn, m_frst.back(), m_last.back(), m_conf,
+                                   table, numStates, llvm::ConstantInt::get(i64, kind),
+                                   llvm::ConstantInt::get(i64, width)});
 }
 
-//  Emit the O(N) fold for one unbounded Sum/Cnt into a value[numStates] stack
-//  buffer, and return it.
+//  Emit the O(N) fold for one unbounded Sum/Cnt into a value[numStates]
+//  column, and return it.
 //
 //  Same shape as the boolean recurrence above, with an add in place of the
 //  select chain and a carrier wider than a bit:
@@ -3247,6 +3603,13 @@ llvm::Value* CompileExprImpl::compileTemporalLoopInline(Expr*        expr,
 //  as it can be; there was simply one per state. This was never a decision --
 //  the accumulators were added after the linear lowering existed and were not
 //  considered for it.
+//
+//  This is the `number` fold only. An integer one is a suffix sum, so it is
+//  fused and scanned in blocks like the boolean recurrence (compileFusedLoops).
+//  A `number` one stays a single walk on the calling thread: summing in blocks
+//  reassociates the additions, and a total that differs in its last bit from
+//  the sequential one can move a comparison against a threshold -- a verdict
+//  must not depend on how many threads computed it.
 llvm::Value* CompileExprImpl::compileAccumulatorLoop(Temporal<ExprBinary>* expr,
                                                      bool weighted, llvm::Type* type)
 {
@@ -3255,7 +3618,7 @@ llvm::Value* CompileExprImpl::compileAccumulatorLoop(Temporal<ExprBinary>* expr,
 
     auto diff = m_builder->CreatePtrDiff(m_propType, last, frst, "diff");
     auto numStates = m_builder->CreateAdd(diff, llvm::ConstantInt::get(m_builder->getInt64Ty(), 1), "numStates");
-    auto buffer = m_builder->CreateAlloca(type, numStates, "accum_buf");
+    auto buffer = allocColumn(type, numStates, "accum_buf");
     auto zero = type->isDoubleTy()
               ? static_cast<llvm::Value*>(llvm::ConstantFP::get(type, 0.0))
               : static_cast<llvm::Value*>(llvm::ConstantInt::getSigned(type, 0));
@@ -3287,22 +3650,7 @@ llvm::Value* CompileExprImpl::compileAccumulatorLoop(Temporal<ExprBinary>* expr,
     auto idxNext = m_builder->CreateAdd(idx, llvm::ConstantInt::get(m_builder->getInt64Ty(), 1), "idxNext");
     auto nextVal = m_builder->CreateLoad(type, m_builder->CreateGEP(type, buffer, idxNext), false, "nextVal");
 
-    //  A state where the condition fails contributes nothing and does not stop
-    //  the fold -- the condition selects states, it does not delimit them.
-    auto cond    = make(expr->lhs);
-    auto value   = make(expr->rhs);
-
-    //  Itg weights the value by how long this state lasted: the gap to the
-    //  next state's timestamp. `__time__` is in nanoseconds, so this is an
-    //  i64 the `mul` helper widens to double for a `number` integrand.
-    if (weighted)
-    {
-        auto dt = m_builder->CreateSub(getTime(getNext(curr)), getTime(curr), "dt");
-        value   = mul(value, dt, "weighted");
-    }
-
-    auto contrib = m_builder->CreateSelect(cond, value, zero, "contrib");
-    auto val     = add(nextVal, contrib, "total");
+    auto val     = add(nextVal, accumulatorStep(expr, weighted, zero), "total");
 
     m_builder->CreateStore(val, m_builder->CreateGEP(type, buffer, idx));
 
@@ -3326,6 +3674,31 @@ llvm::Value* CompileExprImpl::compileAccumulatorLoop(Temporal<ExprBinary>* expr,
     return buffer;
 }
 
+//  What the state at m_curr adds to an accumulator: its value where the
+//  condition holds, weighted by its duration for Itg, and the identity where
+//  it does not.
+llvm::Value* CompileExprImpl::accumulatorStep(Temporal<ExprBinary>* expr, bool weighted,
+                                              llvm::Value* zero)
+{
+    auto curr = m_curr.back();
+
+    //  A state where the condition fails contributes nothing and does not stop
+    //  the fold -- the condition selects states, it does not delimit them.
+    auto cond    = make(expr->lhs);
+    auto value   = make(expr->rhs);
+
+    //  Itg weights the value by how long this state lasted: the gap to the
+    //  next state's timestamp. `__time__` is in nanoseconds, so this is an
+    //  i64 the `mul` helper widens to double for a `number` integrand.
+    if (weighted)
+    {
+        auto dt = m_builder->CreateSub(getTime(getNext(curr)), getTime(curr), "dt");
+        value   = mul(value, dt, "weighted");
+    }
+
+    return m_builder->CreateSelect(cond, value, zero, "contrib");
+}
+
 //  Emit the O(N) lowering for one *bounded* U/R/S/T node.
 //
 //  The recurrence used for the unbounded operators does not apply here: the
@@ -3373,9 +3746,9 @@ llvm::Value* CompileExprImpl::compileTemporalLoopBounded(Temporal<ExprBinary>* e
     auto    nm1     = m_builder->CreateSub(n, K(1), "n-1");
     auto    nm2     = m_builder->CreateSub(n, K(2), "n-2");
 
-    auto    decV    = m_builder->CreateAlloca(i1,  n, "decV");
-    auto    decI    = m_builder->CreateAlloca(i64, n, "decI");
-    auto    buffer  = m_builder->CreateAlloca(i1,  n, "temp_buf");
+    auto    decV    = allocColumn(i1,  n, "decV");
+    auto    decI    = allocColumn(i64, n, "decI");
+    auto    buffer  = allocColumn(i1,  n, "temp_buf");
 
     //  Time bounds are loop-invariant (checked before we get here), so emit
     //  them once, outside every loop.
@@ -3727,6 +4100,45 @@ static void     emitCheckerTable(llvm::LLVMContext* context, llvm::Module* modul
     b.CreateRet(modGV);
 }
 
+//  Close every column lifetime `allocColumn` opened: before each return of a
+//  function that took a mark, release back to it. Done once over the finished
+//  module rather than at each `CreateRet`, so no function-building site has to
+//  remember -- a requirement, a companion and `__prepare__` alike.
+static void     releaseColumns(llvm::Module* module)
+{
+    auto    markFn  = module->getFunction("__ref_column_mark");
+    if (markFn == nullptr)
+        return;
+
+    auto&   context = module->getContext();
+    auto    release = module->getOrInsertFunction("__ref_column_release",
+                        llvm::FunctionType::get(llvm::Type::getVoidTy(context),
+                                                {llvm::Type::getInt64Ty(context)}, false));
+
+    for (auto& fn : *module)
+    {
+        if (fn.isDeclaration())
+            continue;
+
+        //  The mark sits at the top of the entry block, so it dominates every
+        //  return. Several instances compiling into one function each plant
+        //  one; the first is the outermost and releasing to it frees them all.
+        llvm::CallInst* mark = nullptr;
+        for (auto& inst : fn.getEntryBlock())
+            if (auto* call = llvm::dyn_cast<llvm::CallInst>(&inst); call && call->getCalledFunction() == markFn)
+            {
+                mark = call;
+                break;
+            }
+        if (mark == nullptr)
+            continue;
+
+        for (auto& bb : fn)
+            if (auto* ret = llvm::dyn_cast_or_null<llvm::ReturnInst>(bb.getTerminator()))
+                llvm::CallInst::Create(release, {mark}, "", ret);
+    }
+}
+
 //  Whether an expression reads only the current state -- no operator that
 //  reaches another one, so it can be evaluated on one `state_t` alone. This is
 //  the eligibility test for a single-state atom, and `is_temporal()` is not
@@ -3748,21 +4160,125 @@ static bool readsOnlyCurrent(Expr* e)
     return true;
 }
 
-//  Does the expression carry a freeze (`@`) anywhere? A freeze binds a state
-//  other than the current one, so its subexpressions are not the plain
-//  single-state atomic propositions progression works over -- a requirement
-//  with one stays on the prefix path, and its atoms are not extracted.
-static bool containsFreeze(Expr* e)
+//  The freezes (`@`) the expression carries, outermost first. A freeze binds a
+//  state other than the current one, so the subexpressions that read it are
+//  not plain single-state atoms: a monitor evaluates them against a state it
+//  captured. It captures one -- a requirement with more than one freeze stays
+//  on the prefix path, and its atoms are not extracted.
+static void collectFreezes(Expr* e, std::vector<ExprAt*>& out)
+{
+    if(e == nullptr)                                return;
+    if(auto* at = dynamic_cast<ExprAt*>(e))         { out.push_back(at); collectFreezes(at->arg, out); return; }
+    if(auto* c = dynamic_cast<ExprCount*>(e))       { collectFreezes(c->arg, out); collectFreezes(c->body, out); return; }
+    if(auto* u = dynamic_cast<ExprUnary*>(e))       { collectFreezes(u->arg, out); return; }
+    if(auto* b = dynamic_cast<ExprBinary*>(e))      { collectFreezes(b->lhs, out); collectFreezes(b->rhs, out); return; }
+    if(auto* t = dynamic_cast<ExprTernary*>(e))     { collectFreezes(t->lhs, out); collectFreezes(t->mhs, out); collectFreezes(t->rhs, out); return; }
+}
+
+//  Does the expression read any of the named props, at any state? The test
+//  for whether two computed props may share a `__prepare__` pass. Time-window
+//  bounds count: a bound may read a signal too.
+static bool readsProp(Expr* e, std::set<std::string> const& names)
 {
     if(e == nullptr)                            return false;
-    if(dynamic_cast<ExprAt*>(e))                return true;      //  before ExprUnary: ExprAt derives from it
-    if(auto* c = dynamic_cast<ExprCount*>(e))   return containsFreeze(c->arg) || containsFreeze(c->body);
-    if(auto* u = dynamic_cast<ExprUnary*>(e))   return containsFreeze(u->arg);
-    if(auto* b = dynamic_cast<ExprBinary*>(e))  return containsFreeze(b->lhs) || containsFreeze(b->rhs);
-    if(auto* t = dynamic_cast<ExprTernary*>(e)) return containsFreeze(t->lhs) || containsFreeze(t->mhs) || containsFreeze(t->rhs);
+    if(auto* d = dynamic_cast<ExprData*>(e))    return names.contains(d->name) || readsProp(d->ctxt, names);
+    if(auto* c = dynamic_cast<ExprCount*>(e))   return readsProp(c->arg, names) || readsProp(c->body, names);
+    if(auto* s = dynamic_cast<ExprSlice*>(e))   return readsProp(s->arg, names) || readsProp(s->lo, names) || readsProp(s->hi, names);
+    if(auto* f = dynamic_cast<ExprCall*>(e))
+    {
+        for(auto* arg : f->args)
+            if(readsProp(arg, names))           return true;
+        return false;
+    }
+    if(auto* t = dynamic_cast<Temporal<ExprBinary>*>(e); t && t->time
+       && (readsProp(t->time->lo, names) || readsProp(t->time->hi, names)))
+                                                return true;
+    if(auto* t = dynamic_cast<Temporal<ExprUnary>*>(e); t && t->time
+       && (readsProp(t->time->lo, names) || readsProp(t->time->hi, names)))
+                                                return true;
+    if(auto* u = dynamic_cast<ExprUnary*>(e))   return readsProp(u->arg, names);
+    if(auto* b = dynamic_cast<ExprBinary*>(e))  return readsProp(b->lhs, names) || readsProp(b->rhs, names);
+    if(auto* t = dynamic_cast<ExprTernary*>(e)) return readsProp(t->lhs, names) || readsProp(t->mhs, names) || readsProp(t->rhs, names);
     return false;
 }
 
+//  Every name the expression reads as a signal, at any state: `readsProp`,
+//  collecting rather than testing.
+static void collectProps(Expr* e, std::set<std::string>& out)
+{
+    if(e == nullptr)                            return;
+    if(auto* d = dynamic_cast<ExprData*>(e))    { out.insert(d->name); collectProps(d->ctxt, out); return; }
+    if(auto* c = dynamic_cast<ExprCount*>(e))   { collectProps(c->arg, out); collectProps(c->body, out); return; }
+    if(auto* s = dynamic_cast<ExprSlice*>(e))   { collectProps(s->arg, out); collectProps(s->lo, out); collectProps(s->hi, out); return; }
+    if(auto* f = dynamic_cast<ExprCall*>(e))
+    {
+        for(auto* arg : f->args)
+            collectProps(arg, out);
+        return;
+    }
+    if(auto* t = dynamic_cast<Temporal<ExprBinary>*>(e); t && t->time)
+                                                { collectProps(t->time->lo, out); collectProps(t->time->hi, out); }
+    if(auto* t = dynamic_cast<Temporal<ExprUnary>*>(e); t && t->time)
+                                                { collectProps(t->time->lo, out); collectProps(t->time->hi, out); }
+    if(auto* u = dynamic_cast<ExprUnary*>(e))   { collectProps(u->arg, out); return; }
+    if(auto* b = dynamic_cast<ExprBinary*>(e))  { collectProps(b->lhs, out); collectProps(b->rhs, out); return; }
+    if(auto* t = dynamic_cast<ExprTernary*>(e)) { collectProps(t->lhs, out); collectProps(t->mhs, out); collectProps(t->rhs, out); return; }
+}
+
+std::set<std::string>   Compile::reads(Module* refmod, std::set<std::string> const& only)
+{
+    std::set<std::string>   recorded;
+    for(auto const& name : refmod->getPropNames())
+        if(!refmod->isExprData(name))
+            recorded.insert(name);
+
+    for(auto const& name : refmod->getFuncNames())
+        for(auto const& decl : refmod->funcsNamed(name))
+            if(decl.state)
+                return recorded;
+
+    //  Labelled as `make` labels the requirement functions.
+    auto    wanted  = [&](std::string const& named, Base* node)
+    {
+        return only.empty() || only.contains(named.empty() ? node->where().text() : named);
+    };
+
+    std::set<std::string>   names;
+    auto const& exprs   = refmod->getExprs();
+    for(std::size_t ei = 0; ei < exprs.size(); ei++)
+        if(wanted(refmod->getExprName(ei), exprs[ei]))
+            collectProps(exprs[ei], names);
+
+    //  A scope's boundaries are compiled from the AST as they stand; only the
+    //  pattern inside is rewritten to a formula first.
+    auto const& specs   = refmod->getSpecs();
+    for(std::size_t si = 0; si < specs.size(); si++)
+    {
+        if(!wanted(refmod->getSpecName(si), specs[si]))
+            continue;
+        Spec*   spec = specs[si];
+        while(auto* scoped = dynamic_cast<SpecScoped*>(spec))
+        {
+            if(auto* sc = dynamic_cast<SpecBefore*>(scoped))        collectProps(sc->arg, names);
+            if(auto* sc = dynamic_cast<SpecAfter*>(scoped))         collectProps(sc->arg, names);
+            if(auto* sc = dynamic_cast<SpecBetweenAnd*>(scoped))    { collectProps(sc->lhs, names); collectProps(sc->rhs, names); }
+            if(auto* sc = dynamic_cast<SpecAfterUntil*>(scoped))    { collectProps(sc->lhs, names); collectProps(sc->rhs, names); }
+            spec = scoped->spec;
+        }
+        collectProps(Rewrite::make(spec), names);
+    }
+
+    for(auto const& name : refmod->getPropNames())
+        if(refmod->isExprData(name))
+            collectProps(refmod->getPropExpr(name), names);
+
+    std::set<std::string>   out;
+    for(auto const& name : names)
+        if(recorded.contains(name))
+            out.insert(name);
+    return out;
+}
+
 //  The atomic propositions of a formula: its maximal subexpressions that read
 //  only the current state. Walking down, the first `readsOnlyCurrent` node is
 //  an atom and its interior is left alone; a temporal or boolean node above one
@@ -3778,8 +4294,45 @@ static void collectAPs(Expr* e, std::vector<Expr*>& out)
     if(auto* t = dynamic_cast<ExprTernary*>(e))     { collectAPs(t->lhs, out); collectAPs(t->mhs, out); collectAPs(t->rhs, out); return; }
 }
 
+//  Does the expression read no state but through its accumulators? Each `Sum`
+//  (and `Cnt`) or `Itg` found must fold single-state operands over a literal
+//  window, and is added to `accs` once, in pre-order; around them only
+//  constants, conf and operators over those. `Sum[lo:hi](p, v) <= 20` is such
+//  an expression, `Sum(p, v) <= x` is not. A monitor carries these as running
+//  totals -- what the expression reads of the trace is then a few numbers.
+static bool readsOnlyTotals(Expr* e, std::vector<Temporal<ExprBinary>*>& accs)
+{
+    if(e == nullptr)                                                      return true;
+    if(dynamic_cast<ExprSum*>(e) || dynamic_cast<ExprInt*>(e))
+    {
+        auto*   acc     = dynamic_cast<Temporal<ExprBinary>*>(e);
+        auto    literal = [](Expr* b) { return b == nullptr || dynamic_cast<ExprConstInteger*>(b) != nullptr; };
+        if(!readsOnlyCurrent(acc->lhs) || !readsOnlyCurrent(acc->rhs) || hasFreeContext(acc, {}))
+            return false;
+        if(acc->time && !(literal(acc->time->lo) && literal(acc->time->hi)))
+            return false;
+        if(std::find(accs.begin(), accs.end(), acc) == accs.end())
+            accs.push_back(acc);
+        return true;
+    }
+    if(dynamic_cast<ExprConstBoolean*>(e) || dynamic_cast<ExprConstInteger*>(e) ||
+       dynamic_cast<ExprConstNumber*>(e)  || dynamic_cast<ExprConf*>(e))   return true;
+    //  Anything else that reaches a state -- a signal, another temporal, a
+    //  freeze, a call or a count -- puts the trace back in the expression.
+    if(dynamic_cast<Temporal<ExprUnary>*>(e) || dynamic_cast<Temporal<ExprBinary>*>(e) ||
+       dynamic_cast<ExprXs*>(e) || dynamic_cast<ExprXw*>(e) ||
+       dynamic_cast<ExprYs*>(e) || dynamic_cast<ExprYw*>(e) ||
+       dynamic_cast<ExprAt*>(e) || dynamic_cast<ExprCount*>(e))          return false;
+    if(auto* u = dynamic_cast<ExprUnary*>(e))   return readsOnlyTotals(u->arg, accs);
+    if(auto* b = dynamic_cast<ExprBinary*>(e))  return readsOnlyTotals(b->lhs, accs) && readsOnlyTotals(b->rhs, accs);
+    if(auto* t = dynamic_cast<ExprTernary*>(e)) return readsOnlyTotals(t->lhs, accs) && readsOnlyTotals(t->mhs, accs)
+                                                    && readsOnlyTotals(t->rhs, accs);
+    return false;
+}
+
 void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* refmod,
-                   std::vector<std::uint8_t> const* schema)
+                   std::vector<std::uint8_t> const* schema,
+                   std::vector<std::uint8_t> const* conf)
 {
     auto    builder = std::make_unique<llvm::IRBuilder<>>(*context);
 
@@ -3798,7 +4351,26 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
     }
     auto    confType    = llvm::StructType::create(*context, confTypes, "__conf_t");
     auto    confPtrType = llvm::PointerType::get(*context, 0);
-    module->getOrInsertGlobal("__conf__", confType);
+    if(conf == nullptr)
+        module->getOrInsertGlobal("__conf__", confType);
+    else
+    {
+        //  The blob as bytes rather than a `__conf_t` initializer: a load at a
+        //  member's offset folds out of a byte array as readily as out of a
+        //  struct, and the bytes need no decoding against the schema. A string
+        //  member is an interned pointer, which folds to the same constant the
+        //  trace would have loaded.
+        auto    size    = module->getDataLayout().getTypeAllocSize(confType).getFixedValue();
+        if(conf->size() < size)
+            throw std::runtime_error("conf blob of " + std::to_string(conf->size())
+                                   + " bytes is smaller than __conf_t (" + std::to_string(size) + ")");
+
+        auto    bytes   = llvm::ConstantDataArray::get(*context,
+                            llvm::ArrayRef<std::uint8_t>(conf->data(), size));
+        auto    baked   = newGlobal(*module, bytes->getType(), /*isConstant*/ true,
+                            llvm::GlobalValue::PrivateLinkage, bytes, "__conf__");
+        baked->setAlignment(module->getDataLayout().getABITypeAlign(confType));
+    }
 
     //  create __prop__
     auto    propNames   = refmod->getPropNames();
@@ -3832,6 +4404,13 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
         return nullptr;
     };
 
+    //  The module's atomic propositions, each once. AST nodes are interned, so
+    //  a predicate written in many requirements is one node here and one entry
+    //  in `__ap__eval__` (emitted at the end); each requirement's
+    //  `__ap__map__<name>` says where its own atoms sit in that table.
+    std::map<Expr*, std::uint32_t>  apIndex;
+    std::vector<Expr*>              apList;
+
     //  Emit the single-state companions a monitor evaluates per state: `__atom__`
     //  for a reducible requirement, else one `__ap__<k>__` per atomic proposition
     //  (numbered by the same pre-order walk the monitor uses). Shared by the
@@ -3858,8 +4437,21 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
             builder->CreateRet(compAtom.make(atomTemp));
         }
 
-        if(atomOf(reqExpr) == nullptr && !containsFreeze(reqExpr))
+        //  A freeze's atoms read two states: the current one, and the one its
+        //  `t@` captured -- which, to a monitor, is a row it kept. They reach
+        //  the latter through `__frz__<name>`, a pointer the monitor sets before
+        //  it calls one. Being a function of two states, they are not entries
+        //  in the shared `__ap__eval__` table either.
+        std::vector<ExprAt*>    freezes;
+        collectFreezes(reqExpr, freezes);
+        if(atomOf(reqExpr) == nullptr && freezes.size() <= 1)
         {
+            llvm::GlobalVariable*   frozen  = nullptr;
+            if(!freezes.empty())
+                frozen  = newGlobal(*module, builder->getPtrTy(), /*isConstant*/ false,
+                                    llvm::GlobalValue::ExternalLinkage,
+                                    llvm::ConstantPointerNull::get(builder->getPtrTy()), "__frz__" + funcName);
+
             std::vector<Expr*>  aps;
             collectAPs(reqExpr, aps);
             for(std::size_t k = 0; k < aps.size(); k++)
@@ -3878,9 +4470,151 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
                 builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", apBody));
 
                 CompileExprImpl compAp(context, module, builder.get(), apBody, refmod, propType, confType);
+                if(frozen && hasFreeContext(apTemp, {}))
+                    compAp.bind(freezes.front()->name,
+                                builder->CreateLoad(builder->getPtrTy(), frozen, "frozen"));
                 builder->CreateRet(compAp.make(apTemp));
             }
+
+            if(!aps.empty() && freezes.empty())
+            {
+                std::vector<std::uint32_t>  at;
+                for(auto* ap : aps)
+                {
+                    auto [it, fresh] = apIndex.try_emplace(ap, static_cast<std::uint32_t>(apList.size()));
+                    if(fresh)
+                        apList.push_back(ap);
+                    at.push_back(it->second);
+                }
+                auto    table = llvm::ConstantDataArray::get(*context, llvm::ArrayRef<std::uint32_t>(at));
+                newGlobal(*module, table->getType(), /*isConstant*/ true,
+                          llvm::GlobalValue::ExternalLinkage, table, "__ap__map__" + funcName);
+                //  Its length, so a reader never has to trust its own count.
+                auto    length = builder->getInt32(static_cast<std::uint32_t>(at.size()));
+                newGlobal(*module, length->getType(), /*isConstant*/ true,
+                          llvm::GlobalValue::ExternalLinkage, length, "__ap__map__" + funcName + "__n__");
+            }
+        }
+    };
+
+    //  A requirement that reads the trace only through its accumulators gets
+    //  the companions a monitor keeps running totals with:
+    //    - `__acc__<j>__<name>(curr, conf)`: what accumulator `j` adds at a
+    //      state -- its value where its condition holds, else zero (per unit
+    //      time, for an `Itg`);
+    //    - `__acc__fin__<name>(totals, conf)`: the requirement, each of its
+    //      accumulators read from the 8-byte slot `j` of `totals`;
+    //    - `__acc__tab__<name>`: where the windows open -- 0 at the first state
+    //      (`phi`), 1 at every state (`G(phi)`), 2 where `__acc__ante__<name>`
+    //      holds (`G(a => phi)`) -- the accumulator count, then per accumulator
+    //      its flags (1 a number, 2 an `Itg`, 4 a lower bound, 8 an upper one)
+    //      and its bounds.
+    //  A window opened at every state has to close for its total to be known,
+    //  so under `G` each accumulator needs an upper bound.
+    auto    emitTotals = [&](std::string const& funcName, Expr* reqExpr)
+    {
+        Expr*           ante    = nullptr;
+        Expr*           body    = reqExpr;
+        std::int64_t    opens   = 0;
+        if(auto* g = dynamic_cast<ExprG*>(reqExpr); g && g->time == nullptr)
+        {
+            opens   = 1;
+            body    = g->arg;
+            if(auto* imp = dynamic_cast<ExprImp*>(body);
+               imp && readsOnlyCurrent(imp->lhs) && !hasFreeContext(imp->lhs, {}))
+            {
+                opens   = 2;
+                ante    = imp->lhs;
+                body    = imp->rhs;
+            }
+        }
+
+        //  On the written form first, so a requirement that is nothing of the
+        //  kind costs one walk rather than a rewrite.
+        std::vector<Temporal<ExprBinary>*>  accs;
+        if(!readsOnlyTotals(body, accs) || accs.empty())
+            return;
+
+        auto    bodyTemp = Rewrite::make(body);
+        TypeCalc::make(refmod, bodyTemp);
+
+        accs.clear();
+        if(!readsOnlyTotals(bodyTemp, accs) || accs.empty())
+            return;
+
+        std::vector<std::uint64_t>  tab{static_cast<std::uint64_t>(opens), accs.size()};
+        std::vector<llvm::Type*>    types;
+        for(auto* acc : accs)
+        {
+            auto    type    = acc->rhs->type();
+            auto    number  = type == Factory<TypeNumber>::create();
+            if(!number && type != Factory<TypeInteger>::create() && type != Factory<TypeByte>::create())
+                return;
+
+            auto*   lo      = acc->time ? dynamic_cast<ExprConstInteger*>(acc->time->lo) : nullptr;
+            auto*   hi      = acc->time ? dynamic_cast<ExprConstInteger*>(acc->time->hi) : nullptr;
+            if(opens != 0 && hi == nullptr)
+                return;
+
+            tab.push_back((number ? 1 : 0) | (dynamic_cast<ExprInt*>(acc) ? 2 : 0) | (lo ? 4 : 0) | (hi ? 8 : 0));
+            tab.push_back(static_cast<std::uint64_t>(lo ? lo->value : 0));
+            tab.push_back(static_cast<std::uint64_t>(hi ? hi->value : 0));
+            types.push_back(number ? builder->getDoubleTy() : builder->getInt64Ty());
+        }
+
+        for(std::size_t j = 0; j < accs.size(); j++)
+        {
+            auto    accType = llvm::FunctionType::get(types[j], {propPtrType, confPtrType}, false);
+            auto    accBody = llvm::Function::Create(accType, llvm::Function::ExternalLinkage,
+                                "__acc__" + std::to_string(j) + "__" + funcName, module);
+            auto    accArg  = accBody->args().begin();
+            accArg->setName("curr"); accArg++;
+            accArg->setName("conf");
+
+            builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", accBody));
+
+            CompileExprImpl compAcc(context, module, builder.get(), accBody, refmod, propType, confType);
+            auto    cond    = compAcc.make(accs[j]->lhs);
+            auto    value   = compAcc.make(accs[j]->rhs);
+            builder->CreateRet(builder->CreateSelect(cond, value, llvm::Constant::getNullValue(types[j]), "weight"));
+        }
+
+        auto    finType = llvm::FunctionType::get(builder->getInt1Ty(), {propPtrType, confPtrType}, false);
+        auto    finBody = llvm::Function::Create(finType, llvm::Function::ExternalLinkage,
+                            "__acc__fin__" + funcName, module);
+        auto    finArg  = finBody->args().begin();
+        auto    totals  = &*finArg;
+        finArg->setName("totals"); finArg++;
+        finArg->setName("conf");
+
+        builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", finBody));
+
+        CompileExprImpl compFin(context, module, builder.get(), finBody, refmod, propType, confType);
+        for(std::size_t j = 0; j < accs.size(); j++)
+            compFin.accumulated(accs[j], builder->CreateConstGEP1_64(builder->getInt8Ty(), totals, 8 * j, "slot"), types[j]);
+        builder->CreateRet(compFin.make(bodyTemp));
+
+        if(ante)
+        {
+            auto    anteTemp = Rewrite::make(ante);
+            TypeCalc::make(refmod, anteTemp);
+
+            auto    anteType = llvm::FunctionType::get(builder->getInt1Ty(), {propPtrType, confPtrType}, false);
+            auto    anteBody = llvm::Function::Create(anteType, llvm::Function::ExternalLinkage,
+                                "__acc__ante__" + funcName, module);
+            auto    anteArg  = anteBody->args().begin();
+            anteArg->setName("curr"); anteArg++;
+            anteArg->setName("conf");
+
+            builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", anteBody));
+
+            CompileExprImpl compAnte(context, module, builder.get(), anteBody, refmod, propType, confType);
+            builder->CreateRet(compAnte.make(anteTemp));
         }
+
+        auto    table   = llvm::ConstantDataArray::get(*context, llvm::ArrayRef<std::uint64_t>(tab));
+        newGlobal(*module, table->getType(), /*isConstant*/ true,
+                  llvm::GlobalValue::ExternalLinkage, table, "__acc__tab__" + funcName);
     };
 
     auto    exprs   = refmod->getExprs();
@@ -3913,8 +4647,9 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
         compExpr.compileTemporalLoops(temp);
         builder->CreateRet(compExpr.make(temp));
 
-        //  Emit `__atom__` / `__ap__` companions the monitor evaluates per state.
+        //  Emit `__atom__` / `__ap__` / `__acc__` companions the monitor evaluates per state.
         emitCompanions(funcName, expr);
+        emitTotals(funcName, expr);
 
         //  A run trace names a requirement vacuous when its antecedent never
         //  fires: `G(a => b)` proves nothing about `b` on a trace where `a` is
@@ -4228,10 +4963,22 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
 
         auto    frst        = compExpr.m_frst.back();
         auto    last        = compExpr.m_last.back();
-        auto    curr0       = compExpr.getNext(frst);
 
         auto    propNames   = refmod->getPropNames();
 
+        //  Consecutive computed props that read none of each other share a
+        //  pass: their operators are scheduled together and one walk fills
+        //  them all. A prop that reads one already in the group starts the
+        //  next, which keeps prop-major order wherever it matters.
+        struct Computed
+        {
+            std::size_t     index;
+            std::string     name;
+            Expr*           expr;
+        };
+        std::vector<std::vector<Computed>>  groups;
+        std::set<std::string>               inGroup;
+
         for (std::size_t pi = 0; pi < propNames.size(); pi++)
         {
             auto const& name    = propNames[pi];
@@ -4241,49 +4988,90 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
             auto    rewritten   = Rewrite::make(refmod->getPropExpr(name));
             TypeCalc::make(refmod, rewritten);
 
-            //  Setup: build this prop's temporal buffers once, outside its
+            if (groups.empty() || readsProp(rewritten, inGroup))
+            {
+                groups.emplace_back();
+                inGroup.clear();
+            }
+            groups.back().push_back({pi, name, rewritten});
+            inGroup.insert(name);
+        }
+
+        for (auto const& group : groups)
+        {
+            std::vector<Expr*>  exprs;
+            std::string         label   = "prepare";
+            for (auto const& c : group)
+            {
+                exprs.push_back(c.expr);
+                label += "_" + c.name;
+            }
+
+            //  Setup: build the group's temporal buffers once, outside its
             //  state loop.  Buffers only dominate blocks emitted after them,
-            //  so anything a previous prop built is unusable here -- drop it
+            //  so anything a previous group built is unusable here -- drop it
             //  rather than let the fast path load from a buffer that does not
             //  dominate this use.
             compExpr.resetTemporalBuffers();
-            compExpr.compileTemporalLoops(rewritten);
-
-            auto    bbWhile     = llvm::BasicBlock::Create(*context, "while_" + name, funcBody);
-            auto    bbBody      = llvm::BasicBlock::Create(*context, "body_"  + name, funcBody);
-            auto    bbNext      = llvm::BasicBlock::Create(*context, "next_"  + name, funcBody);
-            auto    bbDone      = llvm::BasicBlock::Create(*context, "done_"  + name, funcBody);
-
-            //  compileTemporalLoops leaves the insert point in whichever block
-            //  its last loop nest ended in, so capture it rather than assume.
-            auto    bbSetup     = builder->GetInsertBlock();
-            builder->CreateBr(bbWhile);
-
-            builder->SetInsertPoint(bbWhile);
-            auto    curr        = builder->CreatePHI(propPtrType, 2, "curr");
-            auto    currLTlast  = builder->CreateICmpSLT(curr, last, "curr < last");
-            builder->CreateCondBr(currLTlast, bbBody, bbDone);
-
-            builder->SetInsertPoint(bbBody);
-            compExpr.m_curr.push_back(curr);
-
-            llvm::Value* val    = compExpr.make(rewritten);
-
-            auto    propPtrPtr  = builder->CreateStructGEP(propType, curr, pi + 1);
-            auto    propPtr     = builder->CreateLoad(builder->getPtrTy(), propPtrPtr, false, "ptr_" + name);
-            builder->CreateStore(val, propPtr);
-
-            compExpr.m_curr.pop_back();
-            builder->CreateBr(bbNext);
-
-            builder->SetInsertPoint(bbNext);
-            auto    currNext    = compExpr.getNext(curr);
-            builder->CreateBr(bbWhile);
-
-            curr->addIncoming(curr0, bbSetup);
-            curr->addIncoming(currNext, bbNext);
-
-            builder->SetInsertPoint(bbDone);
+            compExpr.compileTemporalLoops(exprs);
+
+            //  The state loop is a block kernel too, of the carry-free kind:
+            //  every state of these props is independent of the others, since
+            //  whatever it reads at another state belongs to a prop already
+            //  complete. So `__ref_scan` may hand each worker a block, and the
+            //  scan returns only once all of them are done -- the next group
+            //  never sees this one half-written.
+            auto    numStates   = builder->CreateAdd(
+                                    builder->CreatePtrDiff(propType, last, frst, "diff"),
+                                    builder->getInt64(1), "numStates");
+
+            compExpr.emitScan(exprs, {}, numStates, REF_SCAN_MAP, label,
+                [&](CompileExprImpl& k, llvm::Value* lo, llvm::Value* hi,
+                    std::vector<llvm::Value*> const&)
+                {
+                    auto&   b       = *builder;
+                    auto    kfn     = b.GetInsertBlock()->getParent();
+                    auto    bbEntry = b.GetInsertBlock();
+                    auto    bbWhile = llvm::BasicBlock::Create(*context, "while_" + label, kfn);
+                    auto    bbBody  = llvm::BasicBlock::Create(*context, "body_"  + label, kfn);
+                    auto    bbNext  = llvm::BasicBlock::Create(*context, "next_"  + label, kfn);
+                    auto    bbDone  = llvm::BasicBlock::Create(*context, "done_"  + label, kfn);
+                    b.CreateBr(bbWhile);
+
+                    b.SetInsertPoint(bbWhile);
+                    auto    idx     = b.CreatePHI(b.getInt64Ty(), 2, "idx");
+                    b.CreateCondBr(b.CreateICmpSLE(idx, hi, "idx <= hi"), bbBody, bbDone);
+
+                    b.SetInsertPoint(bbBody);
+                    auto    curr    = b.CreateGEP(propType, k.m_frst.back(), idx, "curr");
+                    k.m_curr.push_back(curr);
+
+                    //  Every value first, then every store, as in fusedBlock:
+                    //  the state is read in one run.
+                    std::vector<llvm::Value*>   vals;
+                    for (auto const& c : group)
+                        vals.push_back(k.make(c.expr));
+
+                    for (std::size_t j = 0; j < group.size(); j++)
+                    {
+                        auto    propPtrPtr  = b.CreateStructGEP(propType, curr, group[j].index + 1);
+                        auto    propPtr     = b.CreateLoad(b.getPtrTy(), propPtrPtr, false, "ptr_" + group[j].name);
+                        b.CreateStore(vals[j], propPtr);
+                    }
+
+                    k.m_curr.pop_back();
+                    b.CreateBr(bbNext);
+
+                    b.SetInsertPoint(bbNext);
+                    auto    idxNext = b.CreateAdd(idx, b.getInt64(1), "idxNext");
+                    b.CreateBr(bbWhile);
+
+                    idx->addIncoming(lo, bbEntry);
+                    idx->addIncoming(idxNext, bbNext);
+
+                    b.SetInsertPoint(bbDone);
+                    return std::vector<llvm::Value*>{};
+                });
         }
 
         builder->CreateRetVoid();
@@ -4330,6 +5118,61 @@ void Compile::make(llvm::LLVMContext* context, llvm::Module* module, Module* ref
             return parse(a.first) < parse(b.first);
         });
 
+    //  `__ap__eval__(curr, conf, out)`: every distinct atomic proposition of
+    //  the module evaluated at one state, `out[n]` set to 0 or 1 -- so a monitor
+    //  carrying hundreds of requirements over a few dozen predicates evaluates
+    //  each predicate once a state, not once per requirement reading it. Each
+    //  proposition is its own always-inline function, so an optimised build
+    //  folds them into one body and shares the loads they have in common.
+    //  `__ap__count__` is the table's length.
+    if(!apList.empty())
+    {
+        auto    apType   = llvm::FunctionType::get(builder->getInt1Ty(), {propPtrType, confPtrType}, false);
+        std::vector<llvm::Function*>    shared;
+        for(std::size_t n = 0; n < apList.size(); n++)
+        {
+            auto    apTemp = Rewrite::make(apList[n]);
+            TypeCalc::make(refmod, apTemp);
+
+            auto    apBody = llvm::Function::Create(apType, llvm::Function::InternalLinkage,
+                                "__ap__shared__" + std::to_string(n), module);
+            apBody->addFnAttr(llvm::Attribute::AlwaysInline);
+            auto    apArg  = apBody->args().begin();
+            apArg->setName("curr"); apArg++;
+            apArg->setName("conf");
+
+            builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", apBody));
+            CompileExprImpl compAp(context, module, builder.get(), apBody, refmod, propType, confType);
+            builder->CreateRet(compAp.make(apTemp));
+            shared.push_back(apBody);
+        }
+
+        auto    evalType = llvm::FunctionType::get(builder->getVoidTy(),
+                            {propPtrType, confPtrType, llvm::PointerType::get(*context, 0)}, false);
+        auto    evalBody = llvm::Function::Create(evalType, llvm::Function::ExternalLinkage,
+                            "__ap__eval__", module);
+        auto    evalArg  = evalBody->args().begin();
+        llvm::Value*    curr = evalArg;     evalArg->setName("curr"); evalArg++;
+        llvm::Value*    cnf  = evalArg;     evalArg->setName("conf"); evalArg++;
+        llvm::Value*    out  = evalArg;     evalArg->setName("out");
+
+        builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", evalBody));
+        for(std::size_t n = 0; n < shared.size(); n++)
+        {
+            auto    v = builder->CreateCall(shared[n], {curr, cnf});
+            builder->CreateStore(builder->CreateZExt(v, builder->getInt8Ty()),
+                                 builder->CreateConstGEP1_32(builder->getInt8Ty(), out, n));
+        }
+        builder->CreateRetVoid();
+        llvm::verifyFunction(*evalBody, &llvm::outs());
+
+        auto    count = builder->getInt32(static_cast<std::uint32_t>(apList.size()));
+        newGlobal(*module, count->getType(), /*isConstant*/ true,
+                  llvm::GlobalValue::ExternalLinkage, count, "__ap__count__");
+    }
+
+    releaseColumns(module);
+
     //  The ahead-of-time checker table: label + function pointer per
     //  requirement, plus __prepare__, behind one exported `referee_module`.
     emitCheckerTable(context, module, requirements, prepareFn, schema);
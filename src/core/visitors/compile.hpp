@@ -41,6 +41,8 @@
 
 #include <cstdint>
 #include <iostream>
+#include <set>
+#include <string>
 #include <vector>
 
 class Compile
@@ -51,6 +53,21 @@ public:
     //  `schema` is opaque bytes embedded into the ahead-of-time checker table
     //  so the object can reject a trace it was not built for. Null (the JIT
     //  path) leaves the table's schema fields empty.
+    //
+    //  `conf`, when given, is the loaded conf blob of the trace the module
+    //  will run over. It becomes the initializer of a constant `__conf__`,
+    //  which every function reads in place of its `conf` argument, so the
+    //  optimiser sees each conf value as the constant it is for that trace.
+    //  The module is then good for that conf and no other.
     static void         make(llvm::LLVMContext* context, llvm::Module* module, Module* mod,
-                             std::vector<std::uint8_t> const* schema = nullptr);
+                             std::vector<std::uint8_t> const* schema = nullptr,
+                             std::vector<std::uint8_t> const* conf   = nullptr);
+
+    //  The recorded props -- `data` the trace carries -- that the requirements
+    //  labelled in `only` read, at any state, directly or through a computed
+    //  prop; every requirement when `only` is empty. A host loads just these.
+    //  Every computed prop counts, since `__prepare__` fills them all, and a
+    //  `(__state__)` function may read anything. Rewrites patterns, so call it
+    //  inside the module's arena.
+    static std::set<std::string>    reads(Module* mod, std::set<std::string> const& only = {});
 };
@@ -0,0 +1,73 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022-2026 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+//  The JIT setup `referee execute` and `referee monitor` share. Internal to the
+//  driver: referee.cpp defines it, monitor.cpp builds on it.
+
+#include "referee.hpp"
+#include "antlr2ast.hpp"
+#include "rdb/database.hpp"
+#include "runtime/referee_checker.h"
+
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// JIT setup shared by execute() / executeRdb() / monitor(): create LLJIT,
+// compile the .ref pinned to the JIT's data layout, expose process symbols,
+// register the host `debug(int64)` callback, add the IR module, and collect
+// the requirement function names sorted by source position.
+struct JitWithSpecs
+{
+    std::unique_ptr<llvm::orc::LLJIT>       jit;
+    std::vector<std::string>                funcNames;
+    std::unique_ptr<Antlr2AST>              astOwner;
+    ::Module*                               astModule = nullptr;
+};
+
+JitWithSpecs    buildJitFromRef(std::istream& refStream, std::string const& refName,
+                                std::vector<std::string> const& includePaths,
+                                Referee::Sizes const& sizes,
+                                std::vector<std::string> const& libraryPaths = {},
+                                std::size_t states = std::numeric_limits<std::size_t>::max(),
+                                std::vector<std::uint8_t> const* conf = nullptr);
+
+//  Re-intern the module's string literals through this process's `Strings`.
+void            internModuleStrings(referee_module_v1 const* m);
+
+//  Check one trace against every requirement `js.funcNames` lists, printing a
+//  verdict line each to `os`. True if all of them held.
+bool            runOneTrace(JitWithSpecs&            js,
+                            referee::db::Reader&     rdb,
+                            std::ostream&            os,
+                            std::ostream*            explain    = nullptr,
+                            std::string const&       refName    = {},
+                            std::string const&       tracePath  = {});
@@ -22,6 +22,7 @@
  *  SOFTWARE.
  */
 #include "referee.hpp"
+#include "rdb/merge.hpp"
 
 #include <spdlog/spdlog.h>
 #include "spdlog/fmt/fmt.h"
@@ -29,8 +30,10 @@
 
 #include <vector>
 #include <algorithm>
+#include <limits>
 #include <sstream>
 #include <utility>
+#include <unistd.h>
 
 #include <CLI/App.hpp>
 #include "CLI/Formatter.hpp"
@@ -247,6 +250,17 @@ int main(int argc, char * argv[])
         ->add_option("--suite", runSuite,
             "Manifest of traces and what each is expected to do")
         ->check(CLI::ExistingFile);
+    //  Thousands of small traces: one file, one schema, one string pool.
+    std::vector<std::string>    runCorpus;
+    execute
+        ->add_option("--corpus", runCorpus,
+            "A .rdbx of traces from `rdb pack`, each with what it is expected to do (repeatable)")
+        ->check(CLI::ExistingFile);
+    //  One trace checked by many processes at once: mapped, not loaded.
+    std::vector<std::string>    runAttach;
+    execute
+        ->add_option("--attach", runAttach,
+            "A trace `rdb serve` put in shared memory, by segment name (one per run)");
     execute
         ->add_option("--explain", runExplain,
             "Write a run trace here: what was evaluated where, for a viewer (see tools/)");
@@ -258,6 +272,48 @@ int main(int argc, char * argv[])
         ->add_option("--conf", runConf,
             "Conf file (.csv / .yml / .yaml); not used when datafile is .rdb")
         ->check(CLI::ExistingFile);
+    //  Multi-day captures: the per-state buffers go to files here, so peak
+    //  memory no longer grows with the trace.
+    std::string                 runSpill;
+    execute
+        ->add_option("--spill", runSpill,
+            "Directory for trace-length buffers, for traces larger than memory")
+        ->check(CLI::ExistingDirectory);
+    //  A window of a long capture: the `.rdb` is binary-searched for it and
+    //  nothing outside it is read.
+    std::int64_t                runFrom = std::numeric_limits<std::int64_t>::min();
+    std::int64_t                runTo   = std::numeric_limits<std::int64_t>::max();
+    auto    fromOpt = execute->add_option("--from", runFrom,
+        "Check only states at or after this __time__ (.rdb traces)");
+    auto    toOpt   = execute->add_option("--to", runTo,
+        "Check only states at or before this __time__ (.rdb traces)");
+    //  A few requirements of a large specification over a wide trace: only
+    //  the signals they read are loaded.
+    std::vector<std::string>    runOnly;
+    execute->add_option("--only", runOnly,
+        "Check only the requirement with this label (repeatable)");
+    //  One long trace is otherwise one core: this cuts each pass over it into
+    //  a block per worker.
+    unsigned                    runThreads = 1;
+    execute
+        ->add_option("-j,--threads", runThreads,
+            "Workers to split each trace across (1 = sequential)")
+        ->check(CLI::Range(1, 256));
+    //  A fifty-row unit-test trace spends nearly all its time in the O2
+    //  pipeline; `auto` skips it unless the trace is long enough to repay it.
+    std::string                 optLevel = "auto";
+    auto    addOptOption = [&](CLI::App* cmd) {
+        cmd->add_option("--opt", optLevel,
+            "Optimisation tier: auto (by trace length), 0, 1, 2 or 3")
+            ->check(CLI::IsMember({"auto", "0", "1", "2", "3"}));
+    };
+    addOptOption(execute);
+    //  A corpus sharing one conf pays a compilation per distinct conf and gets
+    //  code with every threshold folded in.
+    bool                        runSpecialize = false;
+    execute
+        ->add_flag("--specialize-conf", runSpecialize,
+            "Compile a module per distinct conf, with its values as constants");
     addIncludeOption(execute);
 
     // monitor subcommand: stream states from stdin, check online
@@ -276,6 +332,122 @@ int main(int argc, char * argv[])
     monitor
         ->add_flag("--stop-at-first", monStopAtFirst,
             "Exit non-zero on the first violation instead of running to end of stream");
+    //  `--key`: one stream interleaving many independent sessions, each
+    //  monitored on its own, bounded by `--max-keys` and `--idle`.
+    std::string     monKey;
+    std::size_t     monMaxKeys  = 0;
+    std::int64_t    monIdle     = 0;
+    monitor
+        ->add_option("--key", monKey,
+            "Column whose value splits the stream into independent sessions");
+    monitor
+        ->add_option("--max-keys", monMaxKeys,
+            "With --key: sessions open at once; the least recently seen is closed first (0: no limit)")
+        ->check(CLI::NonNegativeNumber);
+    monitor
+        ->add_option("--idle", monIdle,
+            "With --key: close a session after this much __time__ without a row (0: never)")
+        ->check(CLI::NonNegativeNumber);
+    //  `--binary`: framed `.rdb` rows (`rdb frames`) instead of CSV text;
+    //  `--input`: read from a path -- a FIFO or a Unix socket, typically --
+    //  instead of stdin.
+    bool            monBinary   = false;
+    std::string     monInput;
+    monitor
+        ->add_flag("--binary", monBinary,
+            "States arrive as a binary frame stream (see `rdb frames`) rather than CSV");
+    monitor
+        ->add_option("--input", monInput,
+            "Read states from this path (a file, FIFO or Unix socket) instead of stdin")
+        ->check(CLI::ExistingPath);
+    //  `--source`: several live sources -- FIFOs, Unix sockets, files -- each
+    //  carrying some of the signals, merged online by `__time__` as `rdb merge`
+    //  would merge them recorded (rdb/merge.hpp).
+    std::vector<std::string>    monSources;
+    std::size_t                 monReorder  = 1000;
+    std::int64_t                monJitter   = 0;
+    std::string                 monLeading  = "trim";
+    std::string                 monOverlap  = "error";
+    bool                        monFollow   = false;
+    monitor
+        ->add_option("--source", monSources,
+            "Merge states from this path (a FIFO, Unix socket or file) with the other sources (repeatable)")
+        ->check(CLI::ExistingPath);
+    monitor
+        ->add_option("--reorder", monReorder,
+            "With --source: rows held waiting for a lagging source before it is passed over")
+        ->check(CLI::PositiveNumber);
+    monitor
+        ->add_option("--jitter", monJitter,
+            "With --source: __time__ a source's own rows may arrive out of order")
+        ->check(CLI::NonNegativeNumber);
+    monitor
+        ->add_option("--leading", monLeading,
+            "With --source: states before every signal has reported: trim | zero")
+        ->check(CLI::IsMember({"trim", "zero"}));
+    monitor
+        ->add_option("--overlap", monOverlap,
+            "With --source: a column two sources share: error | merge")
+        ->check(CLI::IsMember({"error", "merge"}));
+    monitor
+        ->add_flag("--follow", monFollow,
+            "With --source: read a file source as it grows rather than ending at its end");
+    //  `--format`: every state's verdicts, only their changes, or NDJSON
+    //  events; `--flush-ms` trades output latency for fewer writes.
+    std::string     monFormat   = "states";
+    unsigned        monFlushMs  = 0;
+    monitor
+        ->add_option("--format", monFormat,
+            "Output: states (a verdict line per state), changes (only verdicts that moved), ndjson")
+        ->check(CLI::IsMember({"states", "changes", "ndjson"}));
+    monitor
+        ->add_option("--flush-ms", monFlushMs,
+            "Flush output at most this often, in milliseconds (0: after every state)")
+        ->check(CLI::NonNegativeNumber);
+    //  `--checkpoint`: save the sessions every `--checkpoint-every` rows, so a
+    //  restarted monitor can `--resume` where it was rather than from the start.
+    std::string     monCheckpoint;
+    std::size_t     monCheckpointEvery  = 1000;
+    std::string     monResume;
+    monitor
+        ->add_option("--checkpoint", monCheckpoint,
+            "Save the monitor's state to this file periodically (written atomically)");
+    monitor
+        ->add_option("--checkpoint-every", monCheckpointEvery,
+            "With --checkpoint: rows between saves")
+        ->check(CLI::PositiveNumber);
+    monitor
+        ->add_option("--resume", monResume,
+            "Start from a checkpoint; the stream then carries the header and the rows after it")
+        ->check(CLI::ExistingFile);
+    //  `--clock wall`: deadlines fire on the host clock, not only when a row
+    //  past them arrives, so a quiet stream still reports a missed one.
+    std::string     monClock        = "stream";
+    std::string     monClockUnit    = "1ms";
+    std::string     monClockEpoch   = "first";
+    monitor
+        ->add_option("--clock", monClock,
+            "What moves deadlines: stream (rows' __time__) or wall (the host clock)")
+        ->check(CLI::IsMember({"stream", "wall"}));
+    monitor
+        ->add_option("--clock-unit", monClockUnit,
+            "With --clock wall: wall time per __time__ unit (e.g. 1ms, 100us, 1s)");
+    monitor
+        ->add_option("--clock-epoch", monClockEpoch,
+            "With --clock wall: __time__ counts from the first row (first) or the Unix epoch (unix)")
+        ->check(CLI::IsMember({"first", "unix"}));
+    //  `--threads`: parse, evaluate and report on separate cores, for a stream
+    //  faster than one core checks it.
+    unsigned        monThreads      = 0;
+    bool            monLatency      = false;
+    monitor
+        ->add_option("--threads", monThreads,
+            "Evaluator threads: ingest, evaluate and report run pipelined (0: one thread)")
+        ->check(CLI::NonNegativeNumber);
+    monitor
+        ->add_flag("--latency", monLatency,
+            "Report per-row latency (read to verdict) percentiles at the end");
+    addOptOption(monitor);
     addIncludeOption(monitor);
 
     try {
@@ -284,6 +456,8 @@ int main(int argc, char * argv[])
         if(flDebug)
             spdlog::set_level(spdlog::level::debug);
 
+        Referee::optimize(optLevel == "auto" ? -1 : std::stoi(optLevel));
+
         if(app.got_subcommand("compile"))
         {
             std::ifstream   is(compileRef, std::ios_base::in);
@@ -320,9 +494,26 @@ int main(int argc, char * argv[])
         }
         else if(app.got_subcommand("execute"))
         {
+            if (!runSpill.empty())
+                Referee::spill(runSpill);
+            Referee::threads(runThreads);
+            Referee::specializeConf(runSpecialize);
+            if (fromOpt->count() || toOpt->count())
+                Referee::window(runFrom, runTo);
+            if (!runOnly.empty())
+                Referee::only(runOnly);
+
+            //  Attach first: the segment's strings must be the first of their
+            //  content this process interns.
             std::vector<Referee::Trace>     traces;
+            for (auto const& n : runAttach)
+                traces.push_back(Referee::attach(n));
             if (!runSuite.empty())
-                traces = Referee::readSuite(runSuite);
+                for (auto& t : Referee::readSuite(runSuite))
+                    traces.push_back(std::move(t));
+            for (auto const& p : runCorpus)
+                for (auto& t : Referee::corpus(p))
+                    traces.push_back(std::move(t));
             //  In checker mode there is no reffile, so the first positional is
             //  a trace rather than a specification.
             if (!runChecker.empty() && !runRef.empty())
@@ -368,9 +559,51 @@ int main(int argc, char * argv[])
         else if(app.got_subcommand("monitor"))
         {
             std::ifstream   refStream(monRef, std::ios_base::in);
+            //  stdin or `--input`, read through a `LiveInput` rather than
+            //  std::cin or an ifstream, so a wall-clock monitor that stops
+            //  while the input is quiet can interrupt its blocked read.
+            std::unique_ptr<referee::db::LiveBuf>   live;
+            referee::db::SourceMerge*               merged = nullptr;
+            if (monSources.empty())
+            {
+                try
+                {
+                    if (monInput.empty())   live = std::make_unique<referee::db::LiveInput>(STDIN_FILENO);
+                    else                    live = std::make_unique<referee::db::LiveInput>(monInput);
+                }
+                catch (std::exception const& e)
+                {
+                    throw std::runtime_error(std::string("monitor: ") + e.what());
+                }
+            }
+            else
+            {
+                if (monBinary)
+                    throw std::runtime_error("monitor: --source merges CSV sources; it does not combine with --binary");
+                if (!monInput.empty())
+                    throw std::runtime_error("monitor: give --input or --source, not both");
+                auto    merge = std::make_unique<referee::db::SourceMerge>(
+                    monSources,
+                    monLeading == "zero"  ? referee::db::LeadingGap::Zero : referee::db::LeadingGap::Trim,
+                    monOverlap == "merge" ? referee::db::Overlap::Merge   : referee::db::Overlap::Error,
+                    monReorder, monJitter, monFollow);
+                merged = merge.get();
+                live   = std::move(merge);
+            }
+            std::istream    inputStream(live.get());
+            Referee::monitorKeys(monKey, monMaxKeys, monIdle);
+            Referee::monitorBinary(monBinary);
+            Referee::monitorOutput(monFormat, monFlushMs);
+            Referee::monitorCheckpoint(monCheckpoint, monCheckpointEvery, monResume);
+            Referee::monitorClock(monClock, monClockUnit, monClockEpoch);
+            Referee::monitorThreads(monThreads, monLatency);
             bool            allPass = Referee::monitor(
-                                refStream, monRef, std::cin, monConf, std::cout,
-                                monStopAtFirst, includePaths);
+                                refStream, monRef,
+                                inputStream,
+                                monConf, std::cout, monStopAtFirst, includePaths);
+            if (merged && merged->late() > 0)
+                std::cerr << "monitor: " << merged->late()
+                          << " late samples held from the next state on\n";
             if (!allPass) return 1;
         }
     }
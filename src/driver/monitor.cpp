@@ -0,0 +1,4457 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022-2026 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+
+#include "monitor.hpp"
+#include "jit.hpp"
+#include "core/factory.hpp"
+#include "core/json.hpp"
+#include "core/colormod.hpp"
+#include "core/visitors/rewrite.hpp"
+
+#include "rdb/database.hpp"
+#include "rdb/ingest.hpp"
+#include "rdb/merge.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ── referee monitor: online, one state at a time ────────────────────────────
+//
+//  The JIT is built once. Each requirement is then carried by an incremental
+//  evaluator -- a latch, a deadline, a residual formula over past machines,
+//  pending windows and captured freezes, or running totals for its `Sum`/
+//  `Cnt`/`Itg` -- so the work per row is bounded by the requirement's window,
+//  not by the length of the stream (docs/monitor.md, "What actually
+//  accumulates"). A requirement none of them can carry -- a non-literal bound,
+//  a prop computed from other states, an accumulator beside a signal read
+//  directly, more than one freeze -- runs on the prefix path: for each new row
+//  the accumulated CSV is re-ingested and that requirement re-run over the
+//  prefix. That is O(N^2), but it is paid by those requirements alone; the
+//  rest of the specification stays incremental.
+//
+//  A prefix verdict is exact for safety -- an invariant broken on a prefix
+//  stays broken -- and pessimistic for liveness, where an `F`/until obligation
+//  reads unmet until it is satisfied. So a mid-stream violation is reported
+//  only for requirements with no eventually operator; the rest are finalised at
+//  end of stream, where the prefix is the whole trace and every verdict final.
+//
+//  `MonitorSpec` is the compiled specification and each requirement's
+//  evaluator, built once; a `Stream` is one run of it over a stream of states,
+//  stepped serially or pipelined (`--threads`), with its sessions, output,
+//  clock and checkpoints.
+
+namespace {
+
+//  `monitor --key`: the column that splits one stream into independent
+//  sessions, and when a session is closed early -- past `g_monitorMaxKeys`
+//  open at once (least recently seen first), or `g_monitorIdle` units of
+//  `__time__` after its last row. No column: the stream is one session.
+std::string     g_monitorKey;
+std::size_t     g_monitorMaxKeys    = 0;
+std::int64_t    g_monitorIdle       = 0;
+
+//  `monitor --binary`: states arrive as `rdb::FrameWriter` frames rather than
+//  CSV rows.
+bool            g_monitorBinary     = false;
+
+//  `monitor --format`: `states` (a verdict line per state), `changes` (only
+//  the verdicts that moved, and violations) or `ndjson` (the same events as
+//  JSON lines); `--flush-ms`: how long output may wait in the buffer.
+std::string     g_monitorFormat     = "states";
+unsigned        g_monitorFlushMs    = 0;
+
+//  `monitor --checkpoint`: where the sessions are saved, every how many rows;
+//  `--resume`: a checkpoint to start from.
+std::string     g_monitorCheckpoint;
+std::size_t     g_monitorCheckpointEvery = 0;
+std::string     g_monitorResume;
+
+//  `monitor --clock`: what moves a pending deadline -- `stream`, the rows' own
+//  `__time__`, or `wall`, the host clock read as `__time__` at
+//  `g_monitorClockUnit` nanoseconds a unit, counted from the first row
+//  (`first`) or from the Unix epoch (`unix`).
+std::string     g_monitorClock      = "stream";
+std::int64_t    g_monitorClockUnit  = 1000000;
+std::string     g_monitorClockEpoch = "first";
+
+//  `monitor --threads`: parse, evaluate and report pipelined, the incremental
+//  requirements shared among this many evaluator threads (0: all on one);
+//  `--latency`: end with the rows' read-to-verdict latency.
+unsigned        g_monitorThreads    = 0;
+bool            g_monitorLatency    = false;
+
+} // anonymous namespace
+
+void    Referee::monitorKeys(std::string const& column, std::size_t maxKeys, std::int64_t idle)
+{
+    g_monitorKey      = column;
+    g_monitorMaxKeys  = maxKeys;
+    g_monitorIdle     = idle;
+}
+
+void    Referee::monitorBinary(bool on)
+{
+    g_monitorBinary = on;
+}
+
+void    Referee::monitorOutput(std::string const& format, unsigned flushMs)
+{
+    if (format != "states" && format != "changes" && format != "ndjson")
+        throw std::runtime_error("monitor: unknown output format '" + format + "'");
+    g_monitorFormat   = format;
+    g_monitorFlushMs  = flushMs;
+}
+
+void    Referee::monitorCheckpoint(std::string const& path, std::size_t every, std::string const& resume)
+{
+    if (!path.empty() && every == 0)
+        throw std::runtime_error("monitor: --checkpoint needs --checkpoint-every of at least 1");
+    g_monitorCheckpoint      = path;
+    g_monitorCheckpointEvery = every;
+    g_monitorResume          = resume;
+}
+
+void    Referee::monitorClock(std::string const& clock, std::string const& unit, std::string const& epoch)
+{
+    if (clock != "stream" && clock != "wall")
+        throw std::runtime_error("monitor: unknown clock '" + clock + "'");
+    if (epoch != "first" && epoch != "unix")
+        throw std::runtime_error("monitor: unknown clock epoch '" + epoch + "'");
+
+    //  A count and a unit: `1ms`, `100us`, `1s`.
+    std::size_t     used = 0;
+    std::int64_t    n    = 0;
+    try                 { n = std::stoll(unit, &used); }
+    catch (...)         { used = 0; }
+    auto            suffix = unit.substr(used);
+    std::int64_t    scale  = suffix == "ns" ? 1
+                           : suffix == "us" ? 1000
+                           : suffix == "ms" ? 1000000
+                           : suffix == "s"  ? 1000000000
+                           :                  0;
+    if (used == 0 || n <= 0 || scale == 0)
+        throw std::runtime_error("monitor: clock unit must be a count and ns/us/ms/s, not '" + unit + "'");
+
+    g_monitorClock      = clock;
+    g_monitorClockUnit  = n * scale;
+    g_monitorClockEpoch = epoch;
+}
+
+void    Referee::monitorThreads(unsigned threads, bool latency)
+{
+    g_monitorThreads = threads;
+    g_monitorLatency = latency;
+}
+
+//  Does the requirement carry an eventually-flavoured operator (`F`, strong or
+//  weak until, release), whose prefix verdict can climb from false back to
+//  true?  Such requirements are deferred to end of stream rather than reported
+//  mid-stream, so a pessimistic prefix is never mistaken for a violation.  The
+//  walk covers the operator spine and quantifier bodies, where temporal
+//  operators actually appear.
+static bool hasEventually(Expr* e)
+{
+    if (e == nullptr)                                                   return false;
+    if (dynamic_cast<ExprF*>(e)  || dynamic_cast<ExprUs*>(e) ||
+        dynamic_cast<ExprUw*>(e) || dynamic_cast<ExprRs*>(e) ||
+        dynamic_cast<ExprRw*>(e))                                       return true;
+    if (auto* u = dynamic_cast<ExprUnary*>(e))   return hasEventually(u->arg);
+    if (auto* b = dynamic_cast<ExprBinary*>(e))  return hasEventually(b->lhs) || hasEventually(b->rhs);
+    if (auto* t = dynamic_cast<ExprTernary*>(e)) return hasEventually(t->lhs) || hasEventually(t->mhs) || hasEventually(t->rhs);
+    if (auto* c = dynamic_cast<ExprCount*>(e))   return hasEventually(c->arg) || hasEventually(c->body);
+    return false;
+}
+
+//  A state predicate: no operator that reaches another state, so it is one of
+//  the requirement's atomic propositions the code generator emitted an `__ap__`
+//  for. Mirrors the compiler's `readsOnlyCurrent`, including the `Xs`/`Ys` and
+//  freeze exclusions `is_temporal()` misses.
+static bool isStatePredicate(Expr* e)
+{
+    if (e == nullptr)                                                       return true;
+    if (dynamic_cast<Temporal<ExprUnary>*>(e) || dynamic_cast<Temporal<ExprBinary>*>(e) ||
+        dynamic_cast<ExprXs*>(e) || dynamic_cast<ExprXw*>(e) ||
+        dynamic_cast<ExprYs*>(e) || dynamic_cast<ExprYw*>(e) ||
+        dynamic_cast<ExprAt*>(e))                                          return false;
+    if (auto* c = dynamic_cast<ExprCount*>(e))   return isStatePredicate(c->arg) && isStatePredicate(c->body);
+    if (auto* u = dynamic_cast<ExprUnary*>(e))   return isStatePredicate(u->arg);
+    if (auto* b = dynamic_cast<ExprBinary*>(e))  return isStatePredicate(b->lhs) && isStatePredicate(b->rhs);
+    if (auto* t = dynamic_cast<ExprTernary*>(e)) return isStatePredicate(t->lhs) && isStatePredicate(t->mhs) && isStatePredicate(t->rhs);
+    return true;
+}
+
+//  A time bound as a plain integer: an absent bound takes `dflt` (a missing
+//  lower bound is 0), a constant literal its value. A non-literal bound (a conf
+//  reference, an expression) is not one the monitor's single window can carry,
+//  so it returns false and the requirement stays on the prefix path.
+static bool constTime(Expr* e, std::int64_t dflt, std::int64_t& out)
+{
+    if (e == nullptr)                                       { out = dflt; return true; }
+    if (auto* c = dynamic_cast<ExprConstInteger*>(e))       { out = c->value; return true; }
+    return false;
+}
+
+//  ---------------------------------------------------------------------------
+//  General residual evaluator -- LTL3 formula progression.
+//
+//  A nested future formula (`G(a => F b)`, `G(F p)`, `F(G p)`, `Fa && Fb`,
+//  `p U q`, `p R q`, ...) is not a single fold, but its verdict can still be
+//  tracked incrementally by carrying a *residual* formula and rewriting it
+//  against each state -- the formula-derivative technique. This one mechanism
+//  subsumes the response/until/release latches: each is a special case.
+//
+//  The residual is a small boolean-plus-temporal tree over the requirement's
+//  atomic propositions. `progress` evaluates every AP at the current state and
+//  unfolds one step; `finalize` closes an unsettled residual over the empty
+//  suffix at end of stream (G safety holds, F liveness fails, weak/strong until
+//  and release split). Aggressive constant folding and idempotence keep the
+//  residual bounded -- it is always a boolean combination of the formula's
+//  finitely many subformulas.
+//  Beyond the plain atomic proposition (`Ap`), one more leaf kind and the nodes
+//  that carry state of their own:
+//    - `PastRef` references one of the requirement's *past* subformulas
+//      (`O`, `H`, `Ys`/`Yw`, ...). A past formula is history-determined, so it is
+//      not progressed: a little forward-DP machine (see `PNode`) evaluates it to a
+//      boolean each state, and the residual just reads that value like an atom.
+//    - `Next` (`Xs`/`Xw`) owes its body `shift` states ahead; progression counts
+//      it down and, once the target state arrives, progresses the body there. At
+//      end of stream an unresolved `Next` yields its weak/strong end value.
+//    - `Window` is a bounded until/release (`U[lo:hi]`, `R[lo:hi]` and the
+//      `F[lo:hi]`/`G[lo:hi]` they canonicalise to) -- one pending obligation. The
+//      template is unanchored; the state it is first progressed at fixes its
+//      absolute window, and from then it settles on the first decisive state in
+//      that window, or on its end value once a state past the deadline arrives.
+//      Its operands must be decidable at the state itself (atoms and past
+//      references), so an obligation never owes another one.
+//    - `Freeze` is `t@(phi)`. The state it is first progressed at is copied --
+//      the props `phi` reads of `t` -- and from then its body progresses with
+//      the atoms that read `t` evaluated against that copy. An obligation whose
+//      frozen atoms all carry a `t.elapsed <= n` deadline is dropped once it
+//      has passed, so `G(p => t@(F(q && t.elapsed <= n)))` holds O(n) of them.
+struct  RWin
+{
+    std::int64_t    lo = 0, hi = 0;             //  relative bounds, as written
+    bool            hasLo = false, hasHi = false;
+    bool            rhsV = false, lhsV = false, endV = false;  //  the offline lowering's table
+    bool            anchored = false;           //  an instance: bounds made absolute
+    std::int64_t    loT = 0, hiT = 0;
+    bool            seeking = false;            //  within [anchor, anchor+lo]: the scan starts at the last state there
+    bool            candDec = false, candOut = false;
+    std::int64_t    candT   = 0;                //  seeking: that last state so far
+};
+
+//  The state a freeze (`t@`) captured: a row laid out as the generated code
+//  reads one -- `__time__`, then a pointer per prop -- whose frozen props point
+//  into `data`, a copy of their values at the time. The rest are never read.
+struct  Frozen
+{
+    std::int64_t                time = 0;
+    std::vector<std::uint8_t>   row;
+    std::vector<std::uint8_t>   data;
+};
+
+struct  RNode;
+using   RPtr = std::shared_ptr<RNode const>;
+struct  RNode
+{
+    enum Kind { True, False, Ap, PastRef, Not, And, Or, Glob, Finl, Until, Release, Next, Window, Freeze }    kind;
+    int     ap    = -1;     //  Ap / PastRef: index
+    bool    weak  = false;  //  Until / Release / Next
+    int     shift = 0;      //  Next: states still to skip
+    RPtr    a, b;           //  children (Window: a = lhs, b = rhs)
+    RWin    win;            //  Window
+    std::shared_ptr<Frozen const>   frz;    //  Freeze: the state captured, once met
+    bool    clocked = false;    //  holds a `Window` or `Freeze`: its progression reads the state's time or row
+};
+
+//  One requirement's residuals, hash-consed. A node without a `Window` below it
+//  is interned -- built once, shared by every residual that contains it -- so
+//  structural equality is pointer identity and the residuals reachable from the
+//  template are a finite set: the states of an LTL3 automaton, discovered as the
+//  stream visits them. `next` is its transition table, (residual, valuation) ->
+//  residual, filled by `progress` on a miss; once the stream has been through
+//  the states it keeps returning to, a step is one lookup and allocates nothing.
+//
+//  A `Window` carries the absolute time it was anchored at, and a `Freeze` the
+//  state it captured, so each instance is a distinct state and a residual
+//  holding one is neither interned nor cached; it is built as before and freed
+//  with the last residual that refers to it.
+//  Its window-free subtrees are still interned and still hit the table. So the
+//  lookup-and-no-allocation step is unbounded LTL's: a bounded `F`/`G`/`U`/`R`
+//  under a residual rebuilds the nodes above its windows every step, though
+//  neither map grows for them.
+//
+//  The valuation is this state's leaves, loaded by the monitor before it
+//  progresses: `leaf[k]` is `__ap__k`, `leaf[pastBase + p]` past machine `p`.
+//  It keys the table packed into one word, so a requirement with more than 64
+//  leaves is interned but not cached.
+//
+//  Both maps key on raw node pointers. `nodes` keeps every child it keys on
+//  alive through the node it maps to, and a `next` entry holds the residual it
+//  leaves from, so no key can outlive its node and be matched by a new one
+//  allocated at the same address.
+struct  RPool
+{
+    struct  Key
+    {
+        int             kind, ap, shift;
+        bool            weak;
+        RNode const*    a;
+        RNode const*    b;
+        bool operator==(Key const& o) const
+        { return kind == o.kind && ap == o.ap && shift == o.shift && weak == o.weak && a == o.a && b == o.b; }
+    };
+    struct  Step
+    {
+        RNode const*    r;
+        std::uint64_t   bits;
+        bool operator==(Step const& o) const { return r == o.r && bits == o.bits; }
+    };
+    struct  Hash
+    {
+        static std::size_t mix(std::size_t h, std::size_t v) { return h ^ (v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2)); }
+        std::size_t operator()(Key const& k) const
+        {
+            std::size_t h = std::hash<int>()(k.kind);
+            h = mix(h, std::hash<int>()(k.ap));
+            h = mix(h, std::hash<int>()(k.shift));
+            h = mix(h, k.weak);
+            h = mix(h, std::hash<void const*>()(k.a));
+            return mix(h, std::hash<void const*>()(k.b));
+        }
+        std::size_t operator()(Step const& s) const
+        { return mix(std::hash<void const*>()(s.r), std::hash<std::uint64_t>()(s.bits)); }
+    };
+
+    struct  Edge
+    {
+        RPtr    from;                       //  pins `Step::r`
+        RPtr    to;
+    };
+
+    //  A pathological formula can visit exponentially many residuals. Both maps
+    //  are only caches, so past either bound they start over together: a live
+    //  residual built before is still valid, merely no longer shared with the
+    //  nodes built after, and its transitions are learned again.
+    static constexpr std::size_t    kMaxNodes = 1 << 20;
+    static constexpr std::size_t    kMaxSteps = 1 << 20;
+
+    //  A requirement's freeze: how to capture the state it binds, and how to
+    //  read its frozen leaves -- the `__ap__`s that read that state -- against a
+    //  capture. `slot` is the compiled `__frz__<label>` they read it through;
+    //  `curr`/`conf` are this state's, set before each progression. `retire`,
+    //  when not negative, is how long after its capture every frozen leaf is
+    //  false for good -- each has a `t.elapsed <= n` conjunct.
+    struct  Freeze
+    {
+        struct  Prop { std::size_t slot, width, at; };     //  row slot, bytes, offset in `data`
+
+        std::vector<Prop>           props;
+        std::size_t                 bytes   = 0;
+        std::size_t                 stride  = 0;
+        std::vector<char>           frozen;                 //  per leaf
+        std::vector<bool(*)(void*, void*)>  fns;            //  per leaf: its `__ap__`
+        std::int64_t                retire  = -1;
+        void**                      slot    = nullptr;
+        void*                       curr    = nullptr;
+        void*                       conf    = nullptr;
+        std::vector<char>           saved;                  //  the state's own frozen leaves, while a capture's stand in
+
+        std::shared_ptr<Frozen const>   make(std::int64_t time, std::vector<std::uint8_t> data) const
+        {
+            auto    f = std::make_shared<Frozen>();
+            f->time = time;
+            f->data = std::move(data);
+            f->row.assign(stride, 0);
+            std::memcpy(f->row.data(), &time, sizeof(time));
+            for (auto const& p : props)
+            {
+                void const* at = f->data.data() + p.at;
+                std::memcpy(f->row.data() + sizeof(std::int64_t) + p.slot * sizeof(void*), &at, sizeof(at));
+            }
+            return f;
+        }
+        std::shared_ptr<Frozen const>   capture() const
+        {
+            auto const*     row = static_cast<std::uint8_t const*>(curr);
+            std::int64_t    time;
+            std::memcpy(&time, row, sizeof(time));
+            std::vector<std::uint8_t>   data(bytes, 0);
+            for (auto const& p : props)
+            {
+                void const* v;
+                std::memcpy(&v, row + sizeof(std::int64_t) + p.slot * sizeof(void*), sizeof(v));
+                std::memcpy(data.data() + p.at, v, p.width);
+            }
+            return make(time, std::move(data));
+        }
+        //  Read the frozen leaves against `f`, keeping the state's own aside.
+        void    thaw(Frozen const& f, std::vector<char>& leaf)
+        {
+            *slot = const_cast<std::uint8_t*>(f.row.data());
+            saved.assign(leaf.begin(), leaf.end());
+            for (std::size_t k = 0; k < frozen.size(); k++)
+                if (frozen[k])
+                    leaf[k] = fns[k](curr, conf);
+        }
+        void    restore(std::vector<char>& leaf) const
+        {
+            leaf.assign(saved.begin(), saved.end());
+        }
+    };
+
+    std::unordered_map<Key, RPtr, Hash>     nodes;
+    std::unordered_map<Step, Edge, Hash>    next;
+    std::vector<char>   leaf;               //  this state's valuation: aps, then pasts
+    int                 pastBase = 0;
+    std::uint64_t       bits     = 0;       //  `leaf`, packed
+    bool                packed   = false;   //  it fits in `bits`
+    Freeze              freeze;             //  unused without one
+
+    void    size(int aps, int pasts)
+    {
+        pastBase = aps;
+        leaf.assign(aps + pasts, 0);
+        packed   = leaf.size() <= 64;
+    }
+    void    clear()
+    {
+        nodes.clear();
+        next.clear();
+    }
+    void    pack()
+    {
+        bits = 0;
+        if (packed)
+            for (std::size_t k = 0; k < leaf.size(); k++)
+                bits |= std::uint64_t(leaf[k] != 0) << k;
+    }
+
+    RPtr    make(RNode&& n)
+    {
+        n.clocked = n.kind == RNode::Window || n.kind == RNode::Freeze
+                 || (n.a && n.a->clocked) || (n.b && n.b->clocked);
+        if (n.clocked)      return std::make_shared<RNode>(std::move(n));
+
+        Key     key{n.kind, n.ap, n.shift, n.weak, n.a.get(), n.b.get()};
+        auto    it = nodes.find(key);
+        if (it != nodes.end())  return it->second;
+        if (nodes.size() >= kMaxNodes)  clear();
+        return nodes.emplace(key, std::make_shared<RNode>(std::move(n))).first->second;
+    }
+};
+
+static RPtr rTrue()                 { static RPtr t = std::make_shared<RNode>(RNode{RNode::True});  return t; }
+static RPtr rFalse()                { static RPtr f = std::make_shared<RNode>(RNode{RNode::False}); return f; }
+static bool isT(RPtr const& r)      { return r->kind == RNode::True;  }
+static bool isF(RPtr const& r)      { return r->kind == RNode::False; }
+
+//  Structural equality. Interned nodes are equal exactly when they are the same
+//  node; only a residual holding a `Window` needs the walk. It is what collapses
+//  `G phi && G phi` back to `G phi`.
+static bool rEq(RPtr const& x, RPtr const& y)
+{
+    if (x == y)                     return true;
+    if (x->kind != y->kind)         return false;
+    if (!x->clocked && !y->clocked) return x->kind == RNode::True || x->kind == RNode::False;
+    switch (x->kind)
+    {
+        case RNode::Ap: case RNode::PastRef:        return x->ap == y->ap;
+        case RNode::Not: case RNode::Glob: case RNode::Finl:    return rEq(x->a, y->a);
+        case RNode::And: case RNode::Or:            return rEq(x->a, y->a) && rEq(x->b, y->b);
+        case RNode::Until: case RNode::Release:     return x->weak == y->weak && rEq(x->a, y->a) && rEq(x->b, y->b);
+        case RNode::Next:                           return x->weak == y->weak && x->shift == y->shift && rEq(x->a, y->a);
+        case RNode::Window:
+        {
+            auto const& v = x->win;
+            auto const& w = y->win;
+            return v.anchored == w.anchored && v.loT == w.loT && v.hiT == w.hiT && v.seeking == w.seeking
+                && v.candDec == w.candDec && v.candOut == w.candOut && v.candT == w.candT
+                && v.lo == w.lo && v.hi == w.hi && v.hasLo == w.hasLo && v.hasHi == w.hasHi
+                && v.rhsV == w.rhsV && v.lhsV == w.lhsV && v.endV == w.endV
+                && rEq(x->a, y->a) && rEq(x->b, y->b);
+        }
+        case RNode::Freeze:                         return x->frz == y->frz && rEq(x->a, y->a);
+        default:                                    return true;    //  True / False
+    }
+}
+
+static RPtr mkNode(RPool& pool, RNode::Kind k, RPtr a = nullptr, RPtr b = nullptr, int ap = -1, bool weak = false, int shift = 0)
+{
+    RNode   n{k};
+    n.a = std::move(a); n.b = std::move(b); n.ap = ap; n.weak = weak; n.shift = shift;
+    return pool.make(std::move(n));
+}
+static RPtr mkAp(RPool& pool, int k)    { return mkNode(pool, RNode::Ap, nullptr, nullptr, k); }
+static RPtr mkNot(RPool& pool, RPtr a)
+{
+    if (isT(a))                     return rFalse();
+    if (isF(a))                     return rTrue();
+    if (a->kind == RNode::Not)      return a->a;                    //  double negation
+    return mkNode(pool, RNode::Not, a);
+}
+static RPtr mkAnd(RPool& pool, RPtr a, RPtr b)
+{
+    if (isF(a) || isF(b))           return rFalse();
+    if (isT(a))                     return b;
+    if (isT(b))                     return a;
+    if (rEq(a, b))                  return a;
+    return mkNode(pool, RNode::And, a, b);
+}
+static RPtr mkOr(RPool& pool, RPtr a, RPtr b)
+{
+    if (isT(a) || isT(b))           return rTrue();
+    if (isF(a))                     return b;
+    if (isF(b))                     return a;
+    if (rEq(a, b))                  return a;
+    return mkNode(pool, RNode::Or, a, b);
+}
+static RPtr mkGlob(RPool& pool, RPtr a)                 { return mkNode(pool, RNode::Glob, a); }
+static RPtr mkFinl(RPool& pool, RPtr a)                 { return mkNode(pool, RNode::Finl, a); }
+static RPtr mkUntil(RPool& pool, RPtr a, RPtr b, bool w)    { return mkNode(pool, RNode::Until,   a, b, -1, w); }
+static RPtr mkRelease(RPool& pool, RPtr a, RPtr b, bool w)  { return mkNode(pool, RNode::Release, a, b, -1, w); }
+static RPtr mkPastRef(RPool& pool, int k)               { return mkNode(pool, RNode::PastRef, nullptr, nullptr, k); }
+static RPtr mkNext(RPool& pool, int shift, bool w, RPtr a)  { return mkNode(pool, RNode::Next, a, nullptr, -1, w, shift); }
+static RPtr mkWindow(RPool& pool, RPtr a, RPtr b, RWin const& w)
+{
+    RNode   n{RNode::Window};
+    n.a = std::move(a); n.b = std::move(b); n.win = w;
+    return pool.make(std::move(n));
+}
+
+static RPtr mkFreeze(RPool& pool, RPtr a, std::shared_ptr<Frozen const> frz)
+{
+    RNode   n{RNode::Freeze};
+    n.a = std::move(a); n.frz = std::move(frz);
+    return pool.make(std::move(n));
+}
+
+//  A literal `[lo:hi]` bound pair as a window carrying the offline lowering's
+//  (rhsV, lhsV, endV) for its operator. An absent bound stays absent -- the
+//  lowering tells `[:hi]` from `[0:hi]` -- and a non-literal one is refused.
+static bool windowOf(Time* t, bool rhsV, bool lhsV, bool endV, RWin& w)
+{
+    w        = RWin{};
+    w.hasLo  = t->lo != nullptr;
+    w.hasHi  = t->hi != nullptr;
+    w.rhsV   = rhsV;
+    w.lhsV   = lhsV;
+    w.endV   = endV;
+    return constTime(t->lo, 0, w.lo) && constTime(t->hi, 0, w.hi);
+}
+
+//  Decidable at the state itself: no operator that owes a later state. The
+//  operands of a `Window` must be, so that one state tells whether it is the
+//  decisive one.
+static bool nowOnly(RPtr const& r)
+{
+    switch (r->kind)
+    {
+        case RNode::True: case RNode::False: case RNode::Ap: case RNode::PastRef:  return true;
+        case RNode::Not:                        return nowOnly(r->a);
+        case RNode::And: case RNode::Or:        return nowOnly(r->a) && nowOnly(r->b);
+        default:                                return false;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Past machine -- forward DP over a pure-past subformula (`O`, `H`, `Ys`/`Yw`
+//  and boolean combinations of them over state predicates). A past formula's
+//  truth at each state is fixed by the history already seen, so rather than
+//  progress it, the monitor evaluates it bottom-up once per state, threading a
+//  little memory: `O`/`H` keep their running value, `Ys`/`Yw` keep the child's
+//  previous value. The tree is immutable and shared; the mutable memory lives in
+//  a per-run slot array (`pmem`), one signed byte per stateful node (-1 = not yet
+//  started, so the first state gets the right base case).
+//
+//  A bounded since/trigger (`S[lo:hi]`, `T[lo:hi]`, and the `O[lo:hi]`/`H[lo:hi]`
+//  they canonicalise to) needs more than a bit: the states of the last `lo` time
+//  units, which the window's near end has not yet passed, and the latest
+//  decisive state among those it has. That is a `PWin`, one per bounded node --
+//  O(window) states, each pushed and retired once.
+struct  PWin
+{
+    struct  Sample { std::int64_t t; bool dec, out; };
+    std::deque<Sample>  live;               //  states not yet behind the near end
+    bool                popped   = false;   //  the near end has left the trace start behind
+    bool                older    = false;   //  a decisive state among those retired ...
+    std::int64_t        olderT   = 0;       //  ... the latest one
+    bool                olderOut = false;
+};
+
+struct  PastMem
+{
+    std::vector<signed char>    bits;       //  one per stateful node (-1 = not yet started)
+    std::vector<PWin>           wins;       //  one per bounded node
+    void    reset(int slots, int windows)   { bits.assign(slots, -1); wins.assign(windows, PWin{}); }
+};
+
+struct  PNode;
+using   PPtr = std::shared_ptr<PNode const>;
+struct  PNode
+{
+    enum Kind { Ap, Const, Not, And, Or, Once, Hist, Prev, Since, Trig, Window }    kind;
+    int     ap   = -1;      //  Ap: __ap__ index
+    bool    weak = false;   //  Prev / Since / Trig: base value before the first state; Const: the value
+    int     slot = -1;      //  stateful nodes: index into PastMem::bits; Window: into PastMem::wins
+    PPtr    a, b;           //  Since / Trig / Window: a = p (lhs), b = q (rhs)
+    RWin    bounds;         //  Window: bounds and table only -- it is never anchored
+};
+
+//  Evaluate the past subtree at the current state, updating memory. `evalAp`
+//  reads a state predicate now; `mem` carries each stateful node's memory and
+//  `now` is the state's `__time__`, which a bounded window is measured against.
+static bool stepPast(PPtr const& p, std::function<bool(int)> const& evalAp, PastMem& mem, std::int64_t now)
+{
+    auto&   pmem = mem.bits;
+    switch (p->kind)
+    {
+        case PNode::Ap:     return evalAp(p->ap);
+        case PNode::Const:  return p->weak;
+        case PNode::Not:    return !stepPast(p->a, evalAp, mem, now);
+        case PNode::And:    { bool x = stepPast(p->a, evalAp, mem, now); bool y = stepPast(p->b, evalAp, mem, now); return x && y; }
+        case PNode::Or:     { bool x = stepPast(p->a, evalAp, mem, now); bool y = stepPast(p->b, evalAp, mem, now); return x || y; }
+        case PNode::Once:   //  once_i = child_i || once_{i-1}   (once_0 = child_0)
+        {
+            bool    v    = stepPast(p->a, evalAp, mem, now);
+            bool    prev = pmem[p->slot] == 1;
+            bool    cur  = v || prev;
+            pmem[p->slot] = cur;
+            return cur;
+        }
+        case PNode::Hist:   //  hist_i = child_i && hist_{i-1}   (hist_0 = child_0)
+        {
+            bool    v    = stepPast(p->a, evalAp, mem, now);
+            bool    prev = pmem[p->slot] != 0;      //  -1 (start) counts as true
+            bool    cur  = v && prev;
+            pmem[p->slot] = cur;
+            return cur;
+        }
+        case PNode::Prev:   //  Ys/Yw: the child's value one state back (weak/strong base at the start)
+        {
+            bool    result = pmem[p->slot] == -1 ? p->weak : pmem[p->slot] == 1;
+            bool    child  = stepPast(p->a, evalAp, mem, now);
+            pmem[p->slot] = child ? 1 : 0;
+            return result;
+        }
+        case PNode::Since:  //  p Ss/Sw q:  S_i = q_i || (p_i && S_{i-1})
+        {
+            bool    pv   = stepPast(p->a, evalAp, mem, now);
+            bool    qv   = stepPast(p->b, evalAp, mem, now);
+            bool    prev = pmem[p->slot] == -1 ? p->weak : pmem[p->slot] == 1;
+            bool    cur  = qv || (pv && prev);
+            pmem[p->slot] = cur;
+            return cur;
+        }
+        case PNode::Trig:   //  p Ts/Tw q:  T_i = q_i && (p_i || T_{i-1})
+        {
+            bool    pv   = stepPast(p->a, evalAp, mem, now);
+            bool    qv   = stepPast(p->b, evalAp, mem, now);
+            bool    prev = pmem[p->slot] == -1 ? p->weak : pmem[p->slot] == 1;
+            bool    cur  = qv && (pv || prev);
+            pmem[p->slot] = cur;
+            return cur;
+        }
+        case PNode::Window: //  bounded S/T, exactly as the offline window scan reads it
+        {
+            //  At state i the offline scan takes S, the first state at or after
+            //  t_i-lo (i itself with no lower bound), and the latest decisive
+            //  state k <= S; the verdict is k's outcome if k is a real state after
+            //  t_i-hi, else the end value. Every state before S leaves `live`,
+            //  remembered only if it was decisive, so `live.front()` is S.
+            bool    pv     = stepPast(p->a, evalAp, mem, now);
+            bool    qv     = stepPast(p->b, evalAp, mem, now);
+            auto&   w      = p->bounds;
+            auto&   m      = mem.wins[p->slot];
+            bool    rhsHit = qv == w.rhsV;
+            m.live.push_back({now, rhsHit || pv == w.lhsV, rhsHit ? w.rhsV : w.lhsV});
+
+            while (m.live.size() > 1 && (!w.hasLo || m.live.front().t < now - w.lo))
+            {
+                auto const& s = m.live.front();
+                if (s.dec)  { m.older = true; m.olderT = s.t; m.olderOut = s.out; }
+                m.live.pop_front();
+                m.popped = true;
+            }
+            //  Nothing retired and even the first state lies after t_i-lo: the
+            //  scan lands on the leading sentinel, an empty window.
+            if (w.hasLo && !m.popped && m.live.front().t > now - w.lo)  return w.endV;
+
+            auto const&     s  = m.live.front();
+            if (!s.dec && !m.older)                                     return w.endV;
+            std::int64_t    kt = s.dec ? s.t   : m.olderT;
+            bool            kv = s.dec ? s.out : m.olderOut;
+            return (!w.hasHi || kt > now - w.hi) ? kv : w.endV;
+        }
+    }
+    return false;
+}
+
+//  Build a pure-past subtree (`O`, `H`, `Ys`/`Yw`, since/trigger, bounded or not,
+//  and booleans over state predicates) into a past machine. Returns null if it
+//  meets any operator that is not history-determined (a future/next operator, a
+//  non-literal bound), which drops the requirement to the prefix path. Shares the
+//  `apc` leaf counter with `buildResidual` and assigns memory via `pslots` (bits)
+//  and `pwins` (bounded windows).
+static PPtr buildPast(Expr* e, int& apc, int& pslots, int& pwins)
+{
+    if (e == nullptr)                       return nullptr;
+    if (isStatePredicate(e))                { auto n = std::make_shared<PNode>(); n->kind = PNode::Ap; n->ap = apc++; return n; }
+
+    auto    unary = [&](PNode::Kind k, PPtr a) -> PPtr
+    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; return n; };
+    auto    binary = [&](PNode::Kind k, PPtr a, PPtr b) -> PPtr
+    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; n->b = b; return n; };
+
+    auto    stateful = [&](PNode::Kind k, PPtr a, bool w) -> PPtr
+    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; n->weak = w; n->slot = pslots++; return n; };
+    auto    statefulBin = [&](PNode::Kind k, PPtr a, PPtr b, bool w) -> PPtr
+    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; n->b = b; n->weak = w; n->slot = pslots++; return n; };
+    auto    constant = [&](bool v) -> PPtr
+    { auto n = std::make_shared<PNode>(); n->kind = PNode::Const; n->weak = v; return n; };
+    //  A bounded since/trigger: `(rhsV, lhsV, endV)` is the offline table's row.
+    auto    windowed = [&](Time* t, PPtr p, PPtr q, bool rhsV, bool lhsV, bool endV) -> PPtr
+    {
+        RWin    w;
+        if (!p || !q || !windowOf(t, rhsV, lhsV, endV, w))    return nullptr;
+        auto n = std::make_shared<PNode>(); n->kind = PNode::Window; n->a = p; n->b = q; n->bounds = w; n->slot = pwins++; return n;
+    };
+
+    if (auto* n = dynamic_cast<ExprNot*>(e))    { auto a = buildPast(n->arg, apc, pslots, pwins); return a ? unary(PNode::Not, a) : nullptr; }
+    if (auto* a = dynamic_cast<ExprAnd*>(e))    { auto l = buildPast(a->lhs, apc, pslots, pwins); auto r = buildPast(a->rhs, apc, pslots, pwins); return (l && r) ? binary(PNode::And, l, r) : nullptr; }
+    if (auto* o = dynamic_cast<ExprOr*>(e))     { auto l = buildPast(o->lhs, apc, pslots, pwins); auto r = buildPast(o->rhs, apc, pslots, pwins); return (l && r) ? binary(PNode::Or,  l, r) : nullptr; }
+    if (auto* i = dynamic_cast<ExprImp*>(e))    { auto l = buildPast(i->lhs, apc, pslots, pwins); auto r = buildPast(i->rhs, apc, pslots, pwins); return (l && r) ? binary(PNode::Or, unary(PNode::Not, l), r) : nullptr; }
+    if (auto* x = dynamic_cast<ExprXor*>(e))    { auto l = buildPast(x->lhs, apc, pslots, pwins); auto r = buildPast(x->rhs, apc, pslots, pwins); return (l && r) ? binary(PNode::Or, binary(PNode::And, l, unary(PNode::Not, r)), binary(PNode::And, unary(PNode::Not, l), r)) : nullptr; }
+    if (auto* q = dynamic_cast<ExprEqu*>(e))    { auto l = buildPast(q->lhs, apc, pslots, pwins); auto r = buildPast(q->rhs, apc, pslots, pwins); return (l && r) ? binary(PNode::Or, binary(PNode::And, l, r), binary(PNode::And, unary(PNode::Not, l), unary(PNode::Not, r))) : nullptr; }
+    //  A bounded once/historically is the bounded since/trigger it canonicalises
+    //  to: `O[lo:hi] x` = `true Ss[lo:hi] x`, `H[lo:hi] x` = `false Tw[lo:hi] x`.
+    if (auto* o = dynamic_cast<ExprO*>(e))      { auto a = buildPast(o->arg, apc, pslots, pwins); if (o->time) return windowed(o->time, constant(true),  a, true,  false, false); return a ? stateful(PNode::Once, a, false) : nullptr; }
+    if (auto* h = dynamic_cast<ExprH*>(e))      { auto a = buildPast(h->arg, apc, pslots, pwins); if (h->time) return windowed(h->time, constant(false), a, false, true,  true);  return a ? stateful(PNode::Hist, a, false) : nullptr; }
+    //  `Ys(k, phi)` = `phi` k states back = `Ys(1)` nested k deep, each a one-bit
+    //  `Prev`. The shift `lhs` is a literal `collectAPs` counts as an AP, so
+    //  consume one `apc` slot for it (before the body) to stay in step.
+    if (auto* y = dynamic_cast<ExprYs*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(y->lhs); if (!k || k->value < 1) return nullptr; apc++; auto a = buildPast(y->rhs, apc, pslots, pwins); if (!a) return nullptr; for (std::int64_t s = 0; s < k->value; s++) a = stateful(PNode::Prev, a, false); return a; }
+    if (auto* y = dynamic_cast<ExprYw*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(y->lhs); if (!k || k->value < 1) return nullptr; apc++; auto a = buildPast(y->rhs, apc, pslots, pwins); if (!a) return nullptr; for (std::int64_t s = 0; s < k->value; s++) a = stateful(PNode::Prev, a, true);  return a; }
+    //  Since `Ss`/`Sw` and trigger `Ts`/`Tw` -- the past duals of until/release.
+    //  lhs = p, rhs = q; a bounded one is a sliding window (see `PWin`).
+    if (auto* s = dynamic_cast<ExprSs*>(e))     { auto p = buildPast(s->lhs, apc, pslots, pwins); auto q = buildPast(s->rhs, apc, pslots, pwins); if (s->time) return windowed(s->time, p, q, true,  false, false); return (p && q) ? statefulBin(PNode::Since, p, q, false) : nullptr; }
+    if (auto* s = dynamic_cast<ExprSw*>(e))     { auto p = buildPast(s->lhs, apc, pslots, pwins); auto q = buildPast(s->rhs, apc, pslots, pwins); if (s->time) return windowed(s->time, p, q, true,  false, true);  return (p && q) ? statefulBin(PNode::Since, p, q, true)  : nullptr; }
+    if (auto* t = dynamic_cast<ExprTs*>(e))     { auto p = buildPast(t->lhs, apc, pslots, pwins); auto q = buildPast(t->rhs, apc, pslots, pwins); if (t->time) return windowed(t->time, p, q, false, true,  false); return (p && q) ? statefulBin(PNode::Trig,  p, q, false) : nullptr; }
+    if (auto* t = dynamic_cast<ExprTw*>(e))     { auto p = buildPast(t->lhs, apc, pslots, pwins); auto q = buildPast(t->rhs, apc, pslots, pwins); if (t->time) return windowed(t->time, p, q, false, true,  true);  return (p && q) ? statefulBin(PNode::Trig,  p, q, true)  : nullptr; }
+
+    return nullptr;                             //  future/next/etc. inside a past formula
+}
+
+//  Build the residual template from the AST, numbering atomic propositions in
+//  the SAME pre-order the code generator's `collectAPs` uses -- so leaf k here
+//  is the compiled `__ap__k__<label>`. `isStatePredicate` is the AP boundary,
+//  exactly the generator's `readsOnlyCurrent`. A past subformula becomes a
+//  `PastRef` into `pasts` (a machine that evaluates it per state); a next
+//  operator becomes a countdown `Next`, a bounded future one a `Window`, a
+//  freeze a `Freeze` over its body. Returns null on any operator not handled
+//  (an accumulator, a ternary, a non-literal bound, a window over a future
+//  operand, ...), routing the requirement to another lane or the prefix path. Children are sequenced left before right so
+//  AP indices match. `apc` counts leaves, `pslots`/`pwins` past memory.
+static RPtr buildResidual(RPool& pool, Expr* e, int& apc, int& pslots, int& pwins, std::vector<PPtr>& pasts)
+{
+    if (e == nullptr)                       return nullptr;
+    if (isStatePredicate(e))                return mkAp(pool, apc++);
+
+    if (auto* n = dynamic_cast<ExprNot*>(e))
+    {
+        auto    x = buildResidual(pool, n->arg, apc, pslots, pwins, pasts);
+        return x ? mkNot(pool, x) : nullptr;
+    }
+    if (auto* a = dynamic_cast<ExprAnd*>(e))
+    {
+        auto    l = buildResidual(pool, a->lhs, apc, pslots, pwins, pasts);
+        auto    r = buildResidual(pool, a->rhs, apc, pslots, pwins, pasts);
+        return (l && r) ? mkAnd(pool, l, r) : nullptr;
+    }
+    if (auto* o = dynamic_cast<ExprOr*>(e))
+    {
+        auto    l = buildResidual(pool, o->lhs, apc, pslots, pwins, pasts);
+        auto    r = buildResidual(pool, o->rhs, apc, pslots, pwins, pasts);
+        return (l && r) ? mkOr(pool, l, r) : nullptr;
+    }
+    if (auto* i = dynamic_cast<ExprImp*>(e))    //  a => b  ==  !a || b
+    {
+        auto    l = buildResidual(pool, i->lhs, apc, pslots, pwins, pasts);
+        auto    r = buildResidual(pool, i->rhs, apc, pslots, pwins, pasts);
+        return (l && r) ? mkOr(pool, mkNot(pool, l), r) : nullptr;
+    }
+    if (auto* x = dynamic_cast<ExprXor*>(e))    //  a ^^ b  ==  (a & !b) | (!a & b)
+    {
+        auto    l = buildResidual(pool, x->lhs, apc, pslots, pwins, pasts);
+        auto    r = buildResidual(pool, x->rhs, apc, pslots, pwins, pasts);
+        return (l && r) ? mkOr(pool, mkAnd(pool, l, mkNot(pool, r)), mkAnd(pool, mkNot(pool, l), r)) : nullptr;
+    }
+    if (auto* q = dynamic_cast<ExprEqu*>(e))    //  a <=> b  ==  (a & b) | (!a & !b)
+    {
+        auto    l = buildResidual(pool, q->lhs, apc, pslots, pwins, pasts);
+        auto    r = buildResidual(pool, q->rhs, apc, pslots, pwins, pasts);
+        return (l && r) ? mkOr(pool, mkAnd(pool, l, r), mkAnd(pool, mkNot(pool, l), mkNot(pool, r))) : nullptr;
+    }
+    //  A bounded future operator is a `Window` -- a pending obligation per state
+    //  it is anchored at. `(rhsV, lhsV, endV)` is the offline table's row; `G`
+    //  and `F` are the `false Rw` and `true Us` they canonicalise to.
+    auto    window = [&](Time* t, RPtr l, RPtr r, bool rhsV, bool lhsV, bool endV) -> RPtr
+    {
+        RWin    w;
+        if (!l || !r || !nowOnly(l) || !nowOnly(r) || !windowOf(t, rhsV, lhsV, endV, w))   return nullptr;
+        return mkWindow(pool, l, r, w);
+    };
+    if (auto* g = dynamic_cast<ExprG*>(e))
+    {
+        auto    x = buildResidual(pool, g->arg, apc, pslots, pwins, pasts);
+        if (g->time)    return window(g->time, rFalse(), x, false, true, true);
+        return x ? mkGlob(pool, x) : nullptr;
+    }
+    if (auto* f = dynamic_cast<ExprF*>(e))
+    {
+        auto    x = buildResidual(pool, f->arg, apc, pslots, pwins, pasts);
+        if (f->time)    return window(f->time, rTrue(), x, true, false, false);
+        return x ? mkFinl(pool, x) : nullptr;
+    }
+    if (auto* u = dynamic_cast<ExprUs*>(e))     { auto l = buildResidual(pool, u->lhs, apc, pslots, pwins, pasts); auto r = buildResidual(pool, u->rhs, apc, pslots, pwins, pasts); if (u->time) return window(u->time, l, r, true,  false, false); return (l && r) ? mkUntil(pool, l, r, false) : nullptr; }
+    if (auto* u = dynamic_cast<ExprUw*>(e))     { auto l = buildResidual(pool, u->lhs, apc, pslots, pwins, pasts); auto r = buildResidual(pool, u->rhs, apc, pslots, pwins, pasts); if (u->time) return window(u->time, l, r, true,  false, true);  return (l && r) ? mkUntil(pool, l, r, true)  : nullptr; }
+    if (auto* r = dynamic_cast<ExprRs*>(e))     { auto l = buildResidual(pool, r->lhs, apc, pslots, pwins, pasts); auto q = buildResidual(pool, r->rhs, apc, pslots, pwins, pasts); if (r->time) return window(r->time, l, q, false, true,  false); return (l && q) ? mkRelease(pool, l, q, false) : nullptr; }
+    if (auto* r = dynamic_cast<ExprRw*>(e))     { auto l = buildResidual(pool, r->lhs, apc, pslots, pwins, pasts); auto q = buildResidual(pool, r->rhs, apc, pslots, pwins, pasts); if (r->time) return window(r->time, l, q, false, true,  true);  return (l && q) ? mkRelease(pool, l, q, true)  : nullptr; }
+
+    //  Next `Xs`/`Xw`: shift the body forward `k` states; progression counts it
+    //  down. The shift `lhs` is a literal -- and `collectAPs` counts it as a
+    //  (constant) atomic proposition, so consume one `apc` slot to stay in step.
+    if (auto* x = dynamic_cast<ExprXs*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(x->lhs); if (!k || k->value < 1) return nullptr; apc++; auto b = buildResidual(pool, x->rhs, apc, pslots, pwins, pasts); return b ? mkNext(pool, (int)k->value, false, b) : nullptr; }
+    if (auto* x = dynamic_cast<ExprXw*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(x->lhs); if (!k || k->value < 1) return nullptr; apc++; auto b = buildResidual(pool, x->rhs, apc, pslots, pwins, pasts); return b ? mkNext(pool, (int)k->value, true,  b) : nullptr; }
+
+    //  Past operators -- `O`/`H`/`Ys`/`Yw` and since/trigger `Ss`/`Sw`/`Ts`/`Tw`:
+    //  history-determined, built as a past machine and referenced by a `PastRef`
+    //  leaf. `buildPast` shares the `apc` counter.
+    if (dynamic_cast<ExprO*>(e) || dynamic_cast<ExprH*>(e) ||
+        dynamic_cast<ExprYs*>(e) || dynamic_cast<ExprYw*>(e) ||
+        dynamic_cast<ExprSs*>(e) || dynamic_cast<ExprSw*>(e) ||
+        dynamic_cast<ExprTs*>(e) || dynamic_cast<ExprTw*>(e))
+    {
+        auto    p = buildPast(e, apc, pslots, pwins);
+        if (!p) return nullptr;
+        int     idx = (int)pasts.size();
+        pasts.push_back(p);
+        return mkPastRef(pool, idx);
+    }
+
+    //  A freeze `t@(phi)`: the template's is unanchored, and the state it is
+    //  first progressed at is the one it captures (see `unfold`).
+    if (auto* at = dynamic_cast<ExprAt*>(e))
+    {
+        auto    x = buildResidual(pool, at->arg, apc, pslots, pwins, pasts);
+        return x ? mkFreeze(pool, x, nullptr) : nullptr;
+    }
+
+    return nullptr;                             //  unsupported operator
+}
+
+//  A residual with every frozen leaf false for good -- what an obligation
+//  under a freeze is left with once its `t.elapsed` deadline has passed.
+//  Only what that settles is folded: an `F` of nothing left to meet fails, a
+//  `G` of nothing left to break holds. The rest is left to progress as it
+//  was, which reads those leaves false anyway.
+static RPtr starve(RPool& pool, RPtr const& r)
+{
+    switch (r->kind)
+    {
+        case RNode::Ap:     return pool.freeze.frozen[r->ap] ? rFalse() : r;
+        case RNode::Not:    return mkNot(pool, starve(pool, r->a));
+        case RNode::And:    return mkAnd(pool, starve(pool, r->a), starve(pool, r->b));
+        case RNode::Or:     return mkOr (pool, starve(pool, r->a), starve(pool, r->b));
+        case RNode::Finl:   { auto a = starve(pool, r->a); return isF(a) ? a : mkFinl(pool, a); }
+        case RNode::Glob:   { auto a = starve(pool, r->a); return isT(a) ? a : mkGlob(pool, a); }
+        default:            return r;
+    }
+}
+
+//  The leaves of a formula in `buildResidual`'s order -- the generator's
+//  `collectAPs` walk -- so leaf k is the expression `__ap__k__` compiled.
+static void collectLeaves(Expr* e, std::vector<Expr*>& out)
+{
+    if (e == nullptr)                               return;
+    if (isStatePredicate(e))                        { out.push_back(e); return; }
+    if (auto* c = dynamic_cast<ExprCount*>(e))      { collectLeaves(c->arg, out); collectLeaves(c->body, out); return; }
+    if (auto* u = dynamic_cast<ExprUnary*>(e))      { collectLeaves(u->arg, out); return; }
+    if (auto* b = dynamic_cast<ExprBinary*>(e))     { collectLeaves(b->lhs, out); collectLeaves(b->rhs, out); return; }
+    if (auto* t = dynamic_cast<ExprTernary*>(e))    { collectLeaves(t->lhs, out); collectLeaves(t->mhs, out); collectLeaves(t->rhs, out); return; }
+}
+
+//  The freezes in a formula, outermost first.
+static void collectFreezes(Expr* e, std::vector<ExprAt*>& out)
+{
+    if (e == nullptr)                               return;
+    if (auto* at = dynamic_cast<ExprAt*>(e))        { out.push_back(at); collectFreezes(at->arg, out); return; }
+    if (auto* c = dynamic_cast<ExprCount*>(e))      { collectFreezes(c->arg, out); collectFreezes(c->body, out); return; }
+    if (auto* u = dynamic_cast<ExprUnary*>(e))      { collectFreezes(u->arg, out); return; }
+    if (auto* b = dynamic_cast<ExprBinary*>(e))     { collectFreezes(b->lhs, out); collectFreezes(b->rhs, out); return; }
+    if (auto* t = dynamic_cast<ExprTernary*>(e))    { collectFreezes(t->lhs, out); collectFreezes(t->mhs, out); collectFreezes(t->rhs, out); return; }
+}
+
+//  Does a leaf read the state frozen as `name`? The props it reads of it are
+//  added to `props`.
+static bool readsFrozen(Expr* e, std::string const& name, std::set<std::string>& props)
+{
+    if (e == nullptr)                               return false;
+    if (auto* d = dynamic_cast<ExprData*>(e))
+    {
+        if (d->ctxt == nullptr || d->ctxt->name != name)    return false;
+        props.insert(d->name);
+        return true;
+    }
+    if (auto* c = dynamic_cast<ExprContext*>(e))    return c->name == name;
+    bool    any = false;
+    if (auto* c = dynamic_cast<ExprCount*>(e))      { any |= readsFrozen(c->arg, name, props); any |= readsFrozen(c->body, name, props); return any; }
+    if (auto* u = dynamic_cast<ExprUnary*>(e))      return readsFrozen(u->arg, name, props);
+    if (auto* b = dynamic_cast<ExprBinary*>(e))     { any |= readsFrozen(b->lhs, name, props); any |= readsFrozen(b->rhs, name, props); return any; }
+    if (auto* t = dynamic_cast<ExprTernary*>(e))
+    {
+        any |= readsFrozen(t->lhs, name, props);
+        any |= readsFrozen(t->mhs, name, props);
+        any |= readsFrozen(t->rhs, name, props);
+        return any;
+    }
+    return false;
+}
+
+//  How long after the capture a frozen leaf is false for good: one with a
+//  `t.elapsed <= n` (or `< n`) conjunct is from `n` on, since time never runs
+//  backwards. -1 for a leaf with no such deadline.
+static std::int64_t elapsedDeadline(Expr* e, std::string const& name)
+{
+    while (auto* p = dynamic_cast<ExprParen*>(e))   e = p->arg;
+    if (auto* a = dynamic_cast<ExprAnd*>(e))
+    {
+        auto    l = elapsedDeadline(a->lhs, name);
+        auto    r = elapsedDeadline(a->rhs, name);
+        return l < 0 ? r : r < 0 ? l : std::min(l, r);
+    }
+    //  `t.elapsed` is `__time__ - t.__time__`.
+    auto    elapsed = [&](Expr* x)
+    {
+        while (auto* p = dynamic_cast<ExprParen*>(x))   x = p->arg;
+        auto*   sub = dynamic_cast<ExprSub*>(x);
+        auto*   now = sub ? dynamic_cast<ExprData*>(sub->lhs) : nullptr;
+        auto*   was = sub ? dynamic_cast<ExprData*>(sub->rhs) : nullptr;
+        return now && was && now->name == "__time__" && was->name == "__time__"
+            && (now->ctxt == nullptr || now->ctxt->name == "__curr__")
+            && was->ctxt && was->ctxt->name == name;
+    };
+    auto    bound   = [&](Expr* x, std::int64_t& n)
+    {
+        auto*   c = dynamic_cast<ExprConstInteger*>(x);
+        if (c)  n = c->value;
+        return c != nullptr && c->value >= 0;
+    };
+    std::int64_t    n;
+    if (auto* le = dynamic_cast<ExprLe*>(e); le && elapsed(le->lhs) && bound(le->rhs, n))   return n;
+    if (auto* lt = dynamic_cast<ExprLt*>(e); lt && elapsed(lt->lhs) && bound(lt->rhs, n) && n > 0)  return n - 1;
+    return -1;
+}
+
+//  Does a past machine read any of the flagged leaves?
+static bool pastReads(PPtr const& p, std::vector<char> const& leaves)
+{
+    if (p == nullptr)                               return false;
+    if (p->kind == PNode::Ap)                       return leaves[p->ap] != 0;
+    return pastReads(p->a, leaves) || pastReads(p->b, leaves);
+}
+
+//  Rewrite the residual against one state: read every leaf from the pool's
+//  valuation (an `Ap` or a `PastRef`), unfold each temporal one step, and
+//  simplify. Temporal nodes are threaded through unchanged (the `r` on the
+//  right), which the smart constructors' idempotence folds back together. A
+//  `Next` counts its shift down; when it reaches the target state the body
+//  applies there and is progressed. A `Window` is anchored at `now`, this
+//  state's `__time__`, the first time it is met, and from then watches for its
+//  decisive state or its deadline. A `Freeze` captures the state it is first
+//  met at, and from then progresses its body with the frozen leaves read
+//  against that capture.
+static RPtr progress(RPool& pool, RPtr const& r, std::int64_t now);
+
+static RPtr unfold(RPool& pool, RPtr const& r, std::int64_t now)
+{
+    switch (r->kind)
+    {
+        case RNode::True:
+        case RNode::False:      return r;
+        case RNode::Ap:
+        case RNode::PastRef:    return pool.leaf[r->kind == RNode::Ap ? r->ap : pool.pastBase + r->ap] ? rTrue() : rFalse();
+        case RNode::Not:        return mkNot(pool, progress(pool, r->a, now));
+        case RNode::And:        return mkAnd(pool, progress(pool, r->a, now), progress(pool, r->b, now));
+        case RNode::Or:         return mkOr (pool, progress(pool, r->a, now), progress(pool, r->b, now));
+        case RNode::Glob:       return mkAnd(pool, progress(pool, r->a, now), r);                       //  G x = x' & G x
+        case RNode::Finl:       return mkOr (pool, progress(pool, r->a, now), r);                       //  F x = x' | F x
+        case RNode::Until:      return mkOr (pool, progress(pool, r->b, now), mkAnd(pool, progress(pool, r->a, now), r));   //  a U b = b' | (a' & aUb)
+        case RNode::Release:    return mkAnd(pool, progress(pool, r->b, now), mkOr (pool, progress(pool, r->a, now), r));   //  a R b = b' & (a' | aRb)
+        case RNode::Next:       return r->shift >= 1 ? mkNext(pool, r->shift - 1, r->weak, r->a)   //  consume a state, one fewer to skip
+                                                     : progress(pool, r->a, now);                //  target state reached: body applies now
+        case RNode::Window:
+        {
+            //  Mirrors the offline window scan from anchor i: it starts at S,
+            //  the last state at or before t_i+lo (i itself with no lower bound),
+            //  and takes the first decisive state k >= S -- its outcome if
+            //  t_k < t_i+hi, else the end value. S is only known once a later
+            //  state has passed t_i+lo, so while `seeking` the newest state up
+            //  to there is held as the candidate.
+            auto    w   = r->win;
+            if (!w.anchored)
+            {
+                w.anchored = true;
+                w.loT      = now + w.lo;
+                w.hiT      = now + w.hi;
+                w.seeking  = w.hasLo;
+            }
+            bool    lv     = isT(progress(pool, r->a, now));     //  operands are `nowOnly`: they fold to constants
+            bool    rv     = isT(progress(pool, r->b, now));
+            bool    rhsHit = rv == w.rhsV;
+            bool    dec    = rhsHit || lv == w.lhsV;
+            bool    out    = rhsHit ? w.rhsV : w.lhsV;
+
+            if (w.seeking)
+            {
+                if (now <= w.loT)
+                {
+                    w.candDec = dec;
+                    w.candOut = out;
+                    w.candT   = now;
+                    return mkWindow(pool, r->a, r->b, w);
+                }
+                if (w.candDec && (!w.hasHi || w.candT < w.hiT))     return w.candOut ? rTrue() : rFalse();
+                w.seeking = false;                                  //  S was not decisive: scan on from here
+            }
+            if (w.hasHi && now >= w.hiT)    return w.endV ? rTrue() : rFalse();
+            if (dec)                        return out    ? rTrue() : rFalse();
+            return r->win.anchored && !r->win.seeking ? r : mkWindow(pool, r->a, r->b, w);
+        }
+        case RNode::Freeze:
+        {
+            //  The body holds at most one freeze (the requirement carries one),
+            //  so the state's own frozen leaves are set aside once, not nested.
+            auto&   fz  = pool.freeze;
+            auto    frz = r->frz ? r->frz : fz.capture();
+            fz.thaw(*frz, pool.leaf);
+            pool.pack();
+            auto    x   = progress(pool, r->a, now);
+            fz.restore(pool.leaf);
+            pool.pack();
+            if (fz.retire >= 0 && now - frz->time > fz.retire)
+                x = starve(pool, x);
+            if (isT(x) || isF(x))           return x;
+            return mkFreeze(pool, x, frz);
+        }
+    }
+    return r;
+}
+
+//  Progress through the pool's transition table: a window-free residual under a
+//  valuation it has already met is one lookup.
+static RPtr progress(RPool& pool, RPtr const& r, std::int64_t now)
+{
+    if (r->clocked || !pool.packed || r->kind <= RNode::PastRef)    //  a constant or a leaf is cheaper read
+        return unfold(pool, r, now);
+
+    RPool::Step     key{r.get(), pool.bits};
+    auto            it = pool.next.find(key);
+    if (it != pool.next.end())  return it->second.to;
+
+    auto    out = unfold(pool, r, now);
+    if (pool.next.size() >= RPool::kMaxSteps)   pool.clear();
+    pool.next.emplace(key, RPool::Edge{r, out});
+    return out;
+}
+
+//  Close an unsettled residual over the empty suffix at end of stream: G (safety)
+//  vacuously holds, F (liveness) is unmet, a still-live until/release resolves by
+//  its weak/strong flag. No AP survives here -- every one is evaluated the step
+//  it is met -- so the recursion only meets boolean and temporal nodes.
+static bool finalize(RPtr const& r)
+{
+    switch (r->kind)
+    {
+        case RNode::True:       return true;
+        case RNode::False:      return false;
+        case RNode::Not:        return !finalize(r->a);
+        case RNode::And:        return finalize(r->a) && finalize(r->b);
+        case RNode::Or:         return finalize(r->a) || finalize(r->b);
+        case RNode::Glob:       return true;
+        case RNode::Finl:       return false;
+        case RNode::Until:      return r->weak;
+        case RNode::Release:    return r->weak;
+        case RNode::Next:       return r->weak;  //  Xs owes a state that never came -> strong false / weak true
+        case RNode::Window:     //  the trailing sentinel sits one tick after the last state; S is the
+        {                       //  candidate only if that sentinel lies past t_i+lo
+            auto const& w = r->win;
+            if (w.anchored && w.seeking && w.candT >= w.loT && w.candDec && (!w.hasHi || w.candT < w.hiT))
+                return w.candOut;
+            return w.endV;
+        }
+        case RNode::Freeze:     return finalize(r->a);
+        case RNode::Ap:
+        case RNode::PastRef:    return false;   //  unreachable: leaves are evaluated during progress
+    }
+    return false;
+}
+
+//  The bounded response `G(a => F[lo:hi] b)`: whenever `a` holds, `b` must follow
+//  within a `[lo, hi)` window. Unlike the top-level bounded `F`, this is nested
+//  under an unbounded `G`, so every instant `a` is true opens its own window --
+//  the dense-time interval-covering case the monitor evaluates specially. Match
+//  the exact shape (outer `G` unbounded, inner `F` bounded, `a`/`b` state
+//  predicates, literal bounds); anything else stays on the prefix path.
+static bool isBoundedResponse(Expr* e, std::int64_t& lo, std::int64_t& hi)
+{
+    auto* g = dynamic_cast<ExprG*>(e);
+    if (g == nullptr || g->time != nullptr)                             return false;
+    auto* imp = dynamic_cast<ExprImp*>(g->arg);
+    if (imp == nullptr)                                                 return false;
+    auto* f = dynamic_cast<ExprF*>(imp->rhs);
+    if (f == nullptr || f->time == nullptr || f->time->hi == nullptr)   return false;
+    if (!isStatePredicate(imp->lhs) || !isStatePredicate(f->arg))       return false;
+    return constTime(f->time->lo, 0, lo) && constTime(f->time->hi, 0, hi);
+}
+
+//  Parse `name … PASS/FAIL …` verdict lines from a runOneTrace capture into a
+//  label -> passed map.  The name is left-justified in a fixed column, so it is
+//  everything before the first ` PASS`/` FAIL`, trailing padding trimmed.
+static std::map<std::string, bool>  parseVerdicts(std::string const& text)
+{
+    std::map<std::string, bool> out;
+    std::istringstream          in(text);
+    std::string                 line;
+    while (std::getline(in, line))
+    {
+        auto    p = line.find(" PASS");
+        auto    f = line.find(" FAIL");
+        if (p == std::string::npos && f == std::string::npos)   continue;
+
+        bool        pass = p != std::string::npos && (f == std::string::npos || p < f);
+        std::string name = line.substr(0, pass ? p : f);
+        while (!name.empty() && name.back() == ' ')             name.pop_back();
+        if (!name.empty())                                      out[name] = pass;
+    }
+    return out;
+}
+
+//  Does the expression read any of the named props, at any state? Mirrors the
+//  code generator's `readsProp`, time-window bounds included.
+static bool readsAnyOf(Expr* e, std::set<std::string> const& names)
+{
+    if (e == nullptr || names.empty())              return false;
+    if (auto* d = dynamic_cast<ExprData*>(e))       return names.count(d->name) || readsAnyOf(d->ctxt, names);
+    if (auto* c = dynamic_cast<ExprCount*>(e))      return readsAnyOf(c->arg, names) || readsAnyOf(c->body, names);
+    if (auto* s = dynamic_cast<ExprSlice*>(e))      return readsAnyOf(s->arg, names) || readsAnyOf(s->lo, names) || readsAnyOf(s->hi, names);
+    if (auto* f = dynamic_cast<ExprCall*>(e))
+    {
+        for (auto* arg : f->args)
+            if (readsAnyOf(arg, names))             return true;
+        return false;
+    }
+    if (auto* t = dynamic_cast<Temporal<ExprBinary>*>(e); t && t->time
+        && (readsAnyOf(t->time->lo, names) || readsAnyOf(t->time->hi, names)))
+                                                    return true;
+    if (auto* t = dynamic_cast<Temporal<ExprUnary>*>(e); t && t->time
+        && (readsAnyOf(t->time->lo, names) || readsAnyOf(t->time->hi, names)))
+                                                    return true;
+    if (auto* u = dynamic_cast<ExprUnary*>(e))      return readsAnyOf(u->arg, names);
+    if (auto* b = dynamic_cast<ExprBinary*>(e))     return readsAnyOf(b->lhs, names) || readsAnyOf(b->rhs, names);
+    if (auto* t = dynamic_cast<ExprTernary*>(e))    return readsAnyOf(t->lhs, names) || readsAnyOf(t->mhs, names) || readsAnyOf(t->rhs, names);
+    return false;
+}
+
+//  The same over a Dwyer scope's boundary conditions -- the `Q`/`R`/`E` the
+//  `__scope*__` columns evaluate.
+static bool scopeReadsAnyOf(SpecScoped* sc, std::set<std::string> const& names)
+{
+    if (auto* b = dynamic_cast<SpecBefore*>(sc))        return readsAnyOf(b->arg, names);
+    if (auto* a = dynamic_cast<SpecAfter*>(sc))         return readsAnyOf(a->arg, names);
+    if (auto* b = dynamic_cast<SpecBetweenAnd*>(sc))    return readsAnyOf(b->lhs, names) || readsAnyOf(b->rhs, names);
+    if (auto* a = dynamic_cast<SpecAfterUntil*>(sc))    return readsAnyOf(a->lhs, names) || readsAnyOf(a->rhs, names);
+    return false;
+}
+
+//  ---------------------------------------------------------------------------
+//  Monitor checkpoints -- `--checkpoint`/`--resume`. Everything a session
+//  carries is written as plain little records: fixed-size fields as their
+//  bytes, strings and vectors length-prefixed. The file is only ever read back
+//  by the same build on the same machine, guarded by a hash of the spec, so
+//  there is no attempt at a portable encoding.
+struct  CkOut
+{
+    std::string     bytes;
+
+    template<typename T>
+    void    pod(T const& v)     { bytes.append(reinterpret_cast<char const*>(&v), sizeof(T)); }
+    void    str(std::string const& s)
+    {
+        pod<std::uint64_t>(s.size());
+        bytes += s;
+    }
+    template<typename T>
+    void    vec(std::vector<T> const& v)
+    {
+        pod<std::uint64_t>(v.size());
+        bytes.append(reinterpret_cast<char const*>(v.data()), v.size() * sizeof(T));
+    }
+};
+
+struct  CkIn
+{
+    char const*     cur;
+    char const*     end;
+
+    void    need(std::size_t n)
+    {
+        if (static_cast<std::size_t>(end - cur) < n)
+            throw std::runtime_error("monitor: checkpoint is truncated");
+    }
+    template<typename T>
+    T       pod()
+    {
+        need(sizeof(T));
+        T   v;
+        std::memcpy(&v, cur, sizeof(T));
+        cur += sizeof(T);
+        return v;
+    }
+    std::string     str()
+    {
+        auto    n = pod<std::uint64_t>();
+        need(n);
+        std::string     s(cur, n);
+        cur += n;
+        return s;
+    }
+    template<typename T>
+    std::vector<T>  vec()
+    {
+        auto    n = pod<std::uint64_t>();
+        need(n * sizeof(T));
+        std::vector<T>  v(n);
+        std::memcpy(v.data(), cur, n * sizeof(T));
+        cur += n * sizeof(T);
+        return v;
+    }
+};
+
+//  64-bit FNV-1a: the checkpoint's guard against resuming under another spec.
+static std::uint64_t    fnv1a(std::string_view s, std::uint64_t h = 14695981039346656037ull)
+{
+    for (unsigned char c : s)
+        h = (h ^ c) * 1099511628211ull;
+    return h;
+}
+
+//  A residual is a DAG -- interned subterms are shared -- so its nodes are
+//  written children first, each once, and refer to one another by index. A
+//  freeze's capture is written with the first node holding it, and referred to
+//  by index after that.
+static void saveResid(CkOut& out, RPtr const& root)
+{
+    std::unordered_map<RNode const*, std::int32_t>  at;
+    std::unordered_map<Frozen const*, std::int32_t> frozen;
+    std::vector<RNode const*>                       list;
+    std::function<std::int32_t(RNode const*)>       visit = [&](RNode const* n) -> std::int32_t
+    {
+        if (n == nullptr)                       return -1;
+        if (auto it = at.find(n); it != at.end())   return it->second;
+        visit(n->a.get());
+        visit(n->b.get());
+        list.push_back(n);
+        return at[n] = static_cast<std::int32_t>(list.size() - 1);
+    };
+    std::int32_t    top = visit(root.get());
+
+    out.pod<std::uint32_t>(list.size());
+    for (auto const* n : list)
+    {
+        out.pod<std::int32_t>(n->kind);
+        out.pod<std::int32_t>(n->ap);
+        out.pod<std::int32_t>(n->shift);
+        out.pod<bool>(n->weak);
+        out.pod<std::int32_t>(n->a ? at[n->a.get()] : -1);
+        out.pod<std::int32_t>(n->b ? at[n->b.get()] : -1);
+        out.pod<RWin>(n->win);
+        if (n->frz == nullptr)
+            out.pod<std::int32_t>(-1);
+        else if (auto it = frozen.find(n->frz.get()); it != frozen.end())
+            out.pod<std::int32_t>(it->second);
+        else
+        {
+            auto    k = static_cast<std::int32_t>(frozen.size());
+            frozen.emplace(n->frz.get(), k);
+            out.pod<std::int32_t>(k);
+            out.pod(n->frz->time);
+            out.vec(n->frz->data);
+        }
+    }
+    out.pod<std::int32_t>(top);
+}
+
+//  Rebuilt through the pool, so a restored node is interned exactly as a
+//  progressed one would be and the transition table keeps working.
+static RPtr loadResid(CkIn& in, RPool& pool)
+{
+    std::vector<RPtr>   built;
+    std::vector<std::shared_ptr<Frozen const>>  frozen;
+    auto                count = in.pod<std::uint32_t>();
+    auto                ref   = [&](std::int32_t k) -> RPtr
+    {
+        if (k < 0)  return nullptr;
+        if (static_cast<std::size_t>(k) >= built.size())
+            throw std::runtime_error("monitor: checkpoint residual is malformed");
+        return built[k];
+    };
+    for (std::uint32_t k = 0; k < count; k++)
+    {
+        auto    kind  = static_cast<RNode::Kind>(in.pod<std::int32_t>());
+        auto    ap    = in.pod<std::int32_t>();
+        auto    shift = in.pod<std::int32_t>();
+        auto    weak  = in.pod<bool>();
+        auto    a     = ref(in.pod<std::int32_t>());
+        auto    b     = ref(in.pod<std::int32_t>());
+        auto    win   = in.pod<RWin>();
+        auto    fk    = in.pod<std::int32_t>();
+        std::shared_ptr<Frozen const>   frz;
+        if (fk >= 0 && static_cast<std::size_t>(fk) == frozen.size())
+        {
+            auto    time = in.pod<std::int64_t>();
+            auto    data = in.vec<std::uint8_t>();
+            if (data.size() != pool.freeze.bytes)
+                throw std::runtime_error("monitor: checkpoint residual is malformed");
+            frozen.push_back(pool.freeze.make(time, std::move(data)));
+        }
+        if (fk >= 0)
+        {
+            if (static_cast<std::size_t>(fk) >= frozen.size())
+                throw std::runtime_error("monitor: checkpoint residual is malformed");
+            frz = frozen[fk];
+        }
+        if      (kind == RNode::True)       built.push_back(rTrue());
+        else if (kind == RNode::False)      built.push_back(rFalse());
+        else
+        {
+            RNode   n{kind};
+            n.ap = ap; n.shift = shift; n.weak = weak;
+            n.a  = std::move(a); n.b = std::move(b); n.win = win; n.frz = std::move(frz);
+            built.push_back(pool.make(std::move(n)));
+        }
+    }
+    return ref(in.pod<std::int32_t>());
+}
+
+static void savePast(CkOut& out, PastMem const& mem)
+{
+    out.vec(mem.bits);
+    out.pod<std::uint64_t>(mem.wins.size());
+    for (auto const& w : mem.wins)
+    {
+        out.vec(std::vector<PWin::Sample>(w.live.begin(), w.live.end()));
+        out.pod(w.popped);
+        out.pod(w.older);
+        out.pod(w.olderT);
+        out.pod(w.olderOut);
+    }
+}
+
+static void loadPast(CkIn& in, PastMem& mem)
+{
+    mem.bits = in.vec<signed char>();
+    mem.wins.resize(in.pod<std::uint64_t>());
+    for (auto& w : mem.wins)
+    {
+        auto    live = in.vec<PWin::Sample>();
+        w.live.assign(live.begin(), live.end());
+        w.popped   = in.pod<bool>();
+        w.older    = in.pod<bool>();
+        w.olderT   = in.pod<std::int64_t>();
+        w.olderOut = in.pod<bool>();
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  `monitor --clock wall` -- pending deadlines and an input that can be waited
+//  on with a timeout.
+//
+//  A hashed timing wheel: a ring of slots `width` units of `__time__` wide, a
+//  timer filed under the slot its deadline falls in. Adding is O(1); the clock
+//  advancing visits only the slots it passes (at most one revolution), firing
+//  the due timers there and leaving those a revolution or more ahead. Nothing
+//  is ever cancelled -- a timer names its session and requirement, and the
+//  monitor ignores one that no longer matches what is armed.
+class   TimerWheel
+{
+public:
+    struct  Timer
+    {
+        std::int64_t    at;
+        std::string     key;            //  the session
+        std::size_t     req;            //  index into the incremental requirements
+    };
+
+    TimerWheel(std::int64_t width, std::size_t slots = 256)
+    : m_width(std::max<std::int64_t>(width, 1)), m_slots(slots)
+    {}
+
+    bool            empty() const   { return m_count == 0; }
+
+    //  The start of the slot after the current one: when, at the latest, the
+    //  wheel should be advanced again while anything is pending.
+    std::int64_t    nextTick() const
+    {
+        return (floorDiv(m_now, m_width) + 1) * m_width;
+    }
+
+    void    add(Timer t)
+    {
+        auto    at = std::max(t.at, m_now);     //  already due: fires at the next advance
+        m_slots[slotOf(at)].push_back(std::move(t));
+        m_count++;
+    }
+
+    template<typename Fire>
+    void    advance(std::int64_t now, Fire&& fire)
+    {
+        if (now < m_now)    return;
+        auto    from  = floorDiv(m_now, m_width);
+        auto    to    = floorDiv(now, m_width);
+        auto    steps = std::min<std::int64_t>(to - from, m_slots.size() - 1);
+        m_now = now;
+
+        std::vector<Timer>  due;
+        for (std::int64_t k = 0; k <= steps; k++)
+        {
+            auto&   slot = m_slots[slotOf((from + k) * m_width)];
+            auto    keep = std::partition(slot.begin(), slot.end(),
+                                          [now](Timer const& t) { return t.at > now; });
+            std::move(keep, slot.end(), std::back_inserter(due));
+            slot.erase(keep, slot.end());
+        }
+        m_count -= due.size();
+        for (auto& t : due)
+            fire(t);
+    }
+
+private:
+    static std::int64_t floorDiv(std::int64_t a, std::int64_t b)
+    {
+        return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+    }
+    std::size_t     slotOf(std::int64_t t) const
+    {
+        auto    s = floorDiv(t, m_width) % static_cast<std::int64_t>(m_slots.size());
+        return static_cast<std::size_t>(s < 0 ? s + m_slots.size() : s);
+    }
+
+    std::int64_t                        m_width;
+    std::vector<std::vector<Timer>>     m_slots;
+    std::int64_t                        m_now   = std::numeric_limits<std::int64_t>::min() / 4;
+    std::size_t                         m_count = 0;
+};
+
+//  The input read on a thread of its own, one row in flight: the reader reads
+//  a row and parks until the monitor has taken it and asks for the next, so
+//  the monitor can wait for a row *or* a deadline. `read` fills the line (CSV)
+//  or advances a frame reader it shares (binary). The reader is always joined:
+//  if the monitor returns while it is mid-read, `interrupt` ends that read --
+//  the input's `LiveBuf` -- and an input that is not one never blocks for long.
+class   TimedFeed
+{
+public:
+    TimedFeed(std::function<bool(std::string&)> read, std::function<void()> interrupt)
+    : m_state(std::make_shared<State>()), m_interrupt(std::move(interrupt))
+    {
+        m_state->read = std::move(read);
+        m_thread = std::thread([state = m_state]()
+        {
+            std::unique_lock<std::mutex>    lock(state->mutex);
+            while (!state->stop)
+            {
+                state->reading = true;
+                lock.unlock();
+                bool                more = false;
+                std::exception_ptr  err;
+                try                 { more = state->read(state->line); }
+                catch (...)         { err  = std::current_exception(); }
+                lock.lock();
+                state->reading = false;
+                state->more    = more;
+                state->error   = err;
+                state->ready   = true;
+                state->cv.notify_all();
+                if (!more || err)   return;
+                state->cv.wait(lock, [&] { return state->stop || !state->ready; });
+            }
+        });
+    }
+
+    ~TimedFeed()
+    {
+        {
+            std::lock_guard<std::mutex>     lock(m_state->mutex);
+            m_state->stop = true;
+            m_state->cv.notify_all();
+            if (m_state->reading && m_interrupt)
+                m_interrupt();
+        }
+        m_thread.join();
+    }
+
+    TimedFeed(TimedFeed const&)             = delete;
+    TimedFeed& operator=(TimedFeed const&)  = delete;
+
+    //  Release the row taken last, then wait for the next until `until`. True
+    //  if one came -- `more` false at end of input -- false on timeout. A read
+    //  that threw rethrows here.
+    bool    wait(std::chrono::steady_clock::time_point until, bool& more)
+    {
+        std::unique_lock<std::mutex>    lock(m_state->mutex);
+        if (m_taken)
+        {
+            m_taken        = false;
+            m_state->ready = false;
+            m_state->cv.notify_all();
+        }
+        if (!m_state->cv.wait_until(lock, until, [&] { return m_state->ready; }))
+            return false;
+        m_taken = true;
+        if (m_state->error)
+            std::rethrow_exception(m_state->error);
+        more = m_state->more;
+        return true;
+    }
+
+    //  The row taken last (CSV).
+    std::string const&  line() const    { return m_state->line; }
+
+private:
+    struct  State
+    {
+        std::mutex                          mutex;
+        std::condition_variable             cv;
+        std::function<bool(std::string&)>   read;
+        std::string                         line;
+        bool                                ready   = false;
+        bool                                reading = false;
+        bool                                more    = false;
+        bool                                stop    = false;
+        std::exception_ptr                  error;
+    };
+    std::shared_ptr<State>  m_state;
+    std::function<void()>   m_interrupt;
+    std::thread             m_thread;
+    bool                    m_taken = false;
+};
+
+//  Row latencies in log-spaced buckets, eight to an octave, so a quantile
+//  costs no memory per row and comes out within a bucket -- about 9% -- of
+//  the exact one.
+class   LatencyHistogram
+{
+public:
+    void    add(std::chrono::nanoseconds d)
+    {
+        auto    ns = std::max<std::int64_t>(1, d.count());
+        auto    b  = std::min<std::size_t>(m_n.size() - 1, static_cast<std::size_t>(std::log2(double(ns)) * 8));
+        m_n[b]++;
+        m_count++;
+        m_max = std::max(m_max, ns);
+    }
+
+    std::uint64_t   count() const   { return m_count; }
+    std::int64_t    max()   const   { return m_max; }
+
+    //  The `q` quantile in nanoseconds: the upper edge of its bucket.
+    std::int64_t    quantile(double q) const
+    {
+        auto            rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * m_count)));
+        std::uint64_t   seen = 0;
+        for (std::size_t b = 0; b < m_n.size(); b++)
+            if ((seen += m_n[b]) >= rank)
+                return std::min(m_max, static_cast<std::int64_t>(std::exp2((b + 1) / 8.0)));
+        return m_max;
+    }
+
+private:
+    std::array<std::uint64_t, 64 * 8>   m_n{};
+    std::uint64_t                       m_count = 0;
+    std::int64_t                        m_max   = 0;
+};
+
+//  A bounded response `G(a => F[lo:hi] b)` decided online. `buf` is the
+//  session's (time, a, b) samples, the last one's segment taken as still
+//  open; in doubled coordinates (see the end-of-stream fold) a `b` segment
+//  witnesses the anchors `[2(bs-hi)+1, 2(be-lo)-1]` and an `a` segment is the
+//  anchors `[2as, 2ae-1]`. Returns the first anchor no `b` seen so far
+//  witnesses, at or after `from` (doubled), scanning samples from `first` --
+//  the last one at or before `from`, since an earlier `b` ends before it.
+//  That anchor is decided -- failed -- once `__time__` reaches its window's
+//  end: `brDeadline`.
+template<typename Sample>
+static std::optional<std::int64_t>  brFirstGap(std::vector<Sample> const& buf, std::size_t first,
+                                               std::int64_t from, std::int64_t lo, std::int64_t hi)
+{
+    constexpr std::int64_t  kOpen = std::numeric_limits<std::int64_t>::max() / 4;
+    std::int64_t            covLo = 0, covHi = 0;       //  the merged cover being built
+    bool                    cov   = false;
+    std::size_t             nb    = first;              //  next `b` sample to merge
+    auto    coverTo = [&](std::int64_t p)               //  merge every `b` segment starting at or before p
+    {
+        for (; nb < buf.size(); nb++)
+        {
+            if (!buf[nb].b)     continue;
+            std::int64_t    s = 2 * (buf[nb].t - hi) + 1;
+            std::int64_t    e = nb + 1 < buf.size() ? 2 * (buf[nb + 1].t - lo) - 1 : kOpen;
+            if (s > p)          break;
+            if (cov && s <= covHi + 1)  covHi = std::max(covHi, e);
+            else if (!cov || e > covHi) { covLo = s; covHi = e; cov = true; }
+        }
+    };
+    for (std::size_t k = first; k < buf.size(); k++)
+    {
+        if (!buf[k].a)      continue;
+        std::int64_t    p = std::max(2 * buf[k].t, from);
+        std::int64_t    q = k + 1 < buf.size() ? 2 * buf[k + 1].t - 1 : kOpen;
+        while (p <= q)
+        {
+            coverTo(p);
+            if (!cov || p < covLo || p > covHi)     return p;
+            if (covHi >= q)     break;
+            p = covHi + 1;
+        }
+    }
+    return std::nullopt;
+}
+
+//  When the anchor at doubled `x` is decided: the integer `__time__` by which
+//  its window `[x/2+lo, x/2+hi)` has wholly passed.
+static std::int64_t brDeadline(std::int64_t x, std::int64_t hi)
+{
+    std::int64_t    n = x + 1;
+    return n / 2 - (n % 2 != 0 && n < 0) + hi;
+}
+
+// ── the monitor's requirements ──────────────────────────────────────────────
+//
+//  A requirement the monitor can carry incrementally never sees the growing
+//  prefix. Each row is ingested on its own, the requirement's single-state
+//  companions -- `__atom__<name>`, or `__ap__<k>__<name>` per atomic
+//  proposition -- are evaluated on that one state, and the result folded
+//  into per-requirement state: a latch for a single-state atom (`all` for
+//  G/H, `any` for F/O, `first` for a bare predicate), a deadline for a
+//  top-level bounded `F`/`G`, for anything richer a residual formula over
+//  past machines, pending windows and captured freezes, and for a
+//  requirement over `Sum`/`Cnt`/`Itg` a running total per accumulator. What
+//  none of them can carry is listed in `prefixReqs` and takes the prefix
+//  path, alone.
+namespace {
+
+using AtomFn    = bool(*)(void*, void*);
+using ScopeFn   = bool(*)(void*, void*, void*, void*);     //  (frst, last, curr, conf)
+using PrepFn    = void(*)(void*, void*, void*);
+using ApEvalFn  = void(*)(void*, void*, std::uint8_t*);
+using AccIntFn  = std::int64_t(*)(void*, void*);
+using AccNumFn  = double(*)(void*, void*);
+
+//  Evaluators sharing the incremental path. A single-fold atom (an
+//  invariant, an eventually, a bare predicate) is one latch -- fn + a
+//  fold. A top-level bounded `F`/`G` is a latch over a `__time__` window
+//  -- fn + a [lo, hi] deadline. Anything richer that progression handles
+//  carries a residual formula and its atomic-proposition functions. A
+//  requirement that reads the trace only through its accumulators is its
+//  running totals -- what each accumulator adds per state, and the
+//  requirement over the totals.
+enum    Fold  { FoldAll, FoldAny, FoldFirst, BoundedF, BoundedG, BoundedResponse, Residual, Totals };
+//  A residual's Dwyer scope. Single-interval: globally (whole trace),
+//  before R ([frst, R), vacuous if no R), after Q ([Q, end], vacuous if no
+//  Q). Multi-interval: between Q and R and after Q until R (each [Q, R),
+//  plus a final open [Q, end] -- checked strongly by between, leniently by
+//  after-until), while E (each maximal run of E). Multi-interval scopes
+//  reset (`refresh`) the residual at each interval open.
+enum    Scope { ScGlobally, ScBefore, ScAfter, ScBetween, ScAfterUntil, ScWhile };
+//  Where a totals requirement's windows open: at the first state (`phi`), at
+//  every state (`G(phi)`), or where an antecedent holds (`G(a => phi)`).
+enum    Opens { OpFirst, OpEvery, OpWhere };
+//  One accumulator of a totals requirement: its `__acc__<j>__` -- an integer
+//  or a number weight, whichever it is -- and its window, relative to where
+//  it opens. An `Itg` weighs each state by how long it lasts within it.
+struct  AccSpec
+{
+    AccIntFn            wi  = nullptr;
+    AccNumFn            wd  = nullptr;
+    bool                itg = false;
+    bool                hasLo = false, hasHi = false;
+    std::int64_t        lo = 0, hi = 0;
+};
+struct  AtomReq
+{
+    std::string         label;
+    Fold                fold;
+    AtomFn              fn  = nullptr;   //  atom folds, bounded F/G body
+    std::int64_t        lo  = 0;         //  bounded F/G: window [now+lo, now+hi]
+    std::int64_t        hi  = 0;
+    RPtr                templ;          //  Residual: the progression template
+    std::vector<AtomFn> aps;            //  Residual: __ap__0..k
+    std::vector<PPtr>   pasts;          //  Residual: past-subformula machines
+    int                 pslots = 0;     //  Residual: past-memory bits
+    int                 pwins  = 0;     //  Residual: bounded past windows
+    std::shared_ptr<RPool>  pool;       //  Residual: its nodes and transition table
+    Scope               scope   = ScGlobally;
+    ScopeFn             scopeA  = nullptr;   //  boundary column: before/after R/Q, between/while open
+    ScopeFn             scopeB  = nullptr;   //  boundary column: between/after-until close R
+    std::vector<std::uint32_t>  apAt;       //  Residual / response: each atom's slot in the shared table
+    std::vector<AccSpec>    accs;           //  Totals: its accumulators, in `__acc__fin__`'s slot order
+    AtomFn              fin     = nullptr;  //  Totals: the requirement over the totals
+    AtomFn              ante    = nullptr;  //  Totals, `OpWhere`: where a window opens
+    Opens               opens   = OpFirst;  //  Totals; `hi` is then the widest window
+};
+
+} // namespace
+
+//  A specification compiled for monitoring, its requirements sorted into the
+//  evaluators above and the prefix path. Built once; every stream and every
+//  session in it shares the compiled functions, the residual templates and
+//  their pools.
+struct  MonitorSpec
+{
+    MonitorSpec(std::istream& refStream, std::string const& refName,
+                std::string const& confPath, std::vector<std::string> const& includePaths);
+
+    std::string                 refSrc;
+    std::string                 confPath;
+    std::string                 confContents;
+    JitWithSpecs                js;
+    std::set<std::string>       deferred;       //  finalised only at end of stream
+    std::vector<std::string>    order;          //  requirement labels, source order
+    std::vector<AtomReq>        atomReqs;       //  the incremental requirements ...
+    std::set<std::string>       prefixReqs;     //  ... and the prefix path's
+    std::map<std::string, std::size_t>  fastAt; //  label -> index into atomReqs
+    PrepFn                      prepFn  = nullptr;
+    ApEvalFn                    apEval  = nullptr;
+    std::size_t                 apCount = 0;    //  `__ap__eval__`'s atoms, a byte apiece
+};
+
+MonitorSpec::MonitorSpec(std::istream& refStream, std::string const& refName,
+                         std::string const& confPath, std::vector<std::string> const& includePaths)
+: refSrc(std::istreambuf_iterator<char>(refStream), std::istreambuf_iterator<char>())
+, confPath(confPath)
+{
+    std::istringstream  refForJit(refSrc);
+    js = buildJitFromRef(refForJit, refName, includePaths, Referee::Sizes{});
+
+
+    //  `buildJitFromRef`'s arena scope ended when it returned, so make this
+    //  module's arena current again while the requirements are classified: classifying a
+    //  spec rewrites its pattern (`Rewrite::make`), which interns fresh AST nodes.
+    //  Without a current arena those land in the process-global (nullptr) bucket,
+    //  outlive this module, and -- once its arena is swept and the memory reused
+    //  -- collide by raw pointer with a later module, yielding a dangling node
+    //  ("bad type" on a garbage position). Bound to the module's arena, they are
+    //  keyed per module and die with it.
+    Arena::Scope        arenaScope(js.astOwner->arena);
+
+    //  Which requirements are finalised only at end of stream (see above), keyed
+    //  by the same label runOneTrace prints.  A Dwyer spec on the prefix path always
+    //  defers.
+    {
+        auto&   exprs = js.astModule->getExprs();
+        for (std::size_t i = 0; i < exprs.size(); i++)
+        {
+            auto    label = js.astModule->getExprName(i);
+            if (label.empty())              label = exprs[i]->where().text();
+            if (hasEventually(exprs[i]))    deferred.insert(label);
+            order.push_back(label);
+        }
+        auto&   specs = js.astModule->getSpecs();
+        for (std::size_t i = 0; i < specs.size(); i++)
+        {
+            auto    label = js.astModule->getSpecName(i);
+            if (label.empty())  label = specs[i]->where().text();
+            deferred.insert(label);
+            order.push_back(label);
+        }
+    }
+
+    if (!confPath.empty())
+    {
+        std::ifstream   cf(confPath);
+        confContents.assign(std::istreambuf_iterator<char>(cf),
+                            std::istreambuf_iterator<char>());
+    }
+
+    //  A computed prop is materialised per row by `__prepare__`, over that row
+    //  and its two sentinels -- exact for a definition that reads only the
+    //  current state. One that reads other states (a temporal definition, or
+    //  one over such a prop) cannot be, so a requirement reading it, in its
+    //  body or in a scope boundary, takes the prefix path.
+    std::set<std::string>   historic;
+    for (bool grew = true; grew; )
+    {
+        grew = false;
+        for (auto const& name : js.astModule->getPropNames())
+        {
+            if (!js.astModule->isExprData(name) || historic.count(name))   continue;
+            auto*   def = js.astModule->getPropExpr(name);
+            if (isStatePredicate(def) && !readsAnyOf(def, historic))        continue;
+            historic.insert(name);
+            grew = true;
+        }
+    }
+
+    auto    lookupFn = [&]<typename F>(std::string const& name, F& out)
+    {
+        auto    sym = js.jit->lookup(name);
+        if (!sym)   { llvm::consumeError(sym.takeError()); return false; }
+        out = (*sym).toPtr<F>();
+        return true;
+    };
+
+    //  A totals requirement, as `__acc__tab__<label>` lays it out: where its
+    //  windows open, then per accumulator its flags (1 a number, 2 an `Itg`,
+    //  4 a lower bound, 8 an upper one) and bounds. None if a function it
+    //  names is missing.
+    auto    totalsOf = [&](std::string const& label, std::int64_t const* tab) -> std::optional<AtomReq>
+    {
+        AtomReq     req{label, Totals};
+        req.opens   = static_cast<Opens>(tab[0]);
+        if (!lookupFn("__acc__fin__" + label, req.fin))                             return std::nullopt;
+        if (req.opens == OpWhere && !lookupFn("__acc__ante__" + label, req.ante))   return std::nullopt;
+        for (std::int64_t j = 0; j < tab[1]; j++)
+        {
+            auto const* row  = tab + 2 + 3 * j;
+            auto        name = "__acc__" + std::to_string(j) + "__" + label;
+            AccSpec     acc;
+            acc.itg     = (row[0] & 2) != 0;
+            acc.hasLo   = (row[0] & 4) != 0;
+            acc.hasHi   = (row[0] & 8) != 0;
+            acc.lo      = row[1];
+            acc.hi      = row[2];
+            if (!((row[0] & 1) ? lookupFn(name, acc.wd) : lookupFn(name, acc.wi)))  return std::nullopt;
+            req.hi      = j == 0 ? acc.hi : std::max(req.hi, acc.hi);
+            req.accs.push_back(acc);
+        }
+        return req;
+    };
+
+    //  Set a residual's freeze up (see `RPool::Freeze`): which of its leaves
+    //  read the captured state and which props of that state they read --
+    //  each copied at the capture -- and, where every frozen leaf carries a
+    //  `t.elapsed` deadline, when a capture retires. A past machine steps on
+    //  the state's own valuation, so one reading a frozen leaf cannot be
+    //  thawed; that requirement stays on the prefix path.
+    auto    freezeOf = [&](RPool& pool, Expr* e, std::string const& label,
+                           std::vector<AtomFn> const& aps, std::vector<PPtr> const& pasts)
+    {
+        std::vector<ExprAt*>    freezes;
+        std::vector<Expr*>      leaves;
+        collectFreezes(e, freezes);
+        collectLeaves(e, leaves);
+        if (freezes.size() != 1 || leaves.size() != aps.size())    return false;
+
+        auto&                   fz      = pool.freeze;
+        auto const&             name    = freezes.front()->name;
+        std::set<std::string>   props;
+        bool                    retires = true;
+        fz.frozen.assign(aps.size(), 0);
+        fz.fns.assign(aps.begin(), aps.end());
+        for (std::size_t k = 0; k < leaves.size(); k++)
+        {
+            if (!readsFrozen(leaves[k], name, props))  continue;
+            fz.frozen[k] = 1;
+            auto    n = elapsedDeadline(leaves[k], name);
+            retires   = retires && n >= 0;
+            fz.retire = std::max(fz.retire, n);
+        }
+        if (!retires)   fz.retire = -1;
+        for (auto const& p : pasts)
+            if (pastReads(p, fz.frozen))    return false;
+
+        auto const  names = js.astModule->getPropNames();
+        for (auto const& prop : props)
+        {
+            if (prop == "__time__")     continue;
+            auto    it   = std::find(names.begin(), names.end(), prop);
+            auto*   type = it == names.end() ? nullptr : dynamic_cast<TypePrimitive*>(js.astModule->getProp(prop));
+            if (type == nullptr)        return false;
+            auto    at = (fz.bytes + 7) & ~std::size_t(7);      //  each value 8-aligned, as it was read
+            fz.props.push_back({static_cast<std::size_t>(it - names.begin()), type->size(), at});
+            fz.bytes = at + type->size();
+        }
+        fz.stride = sizeof(std::int64_t) + names.size() * sizeof(void*);
+        return lookupFn("__frz__" + label, fz.slot);
+    };
+
+    auto&   exprs = js.astModule->getExprs();
+    for (std::size_t i = 0; i < exprs.size(); i++)
+    {
+        auto    label = js.astModule->getExprName(i);
+        if (label.empty())  label = exprs[i]->where().text();
+        auto*   e = exprs[i];
+
+        if (readsAnyOf(e, historic))    { prefixReqs.insert(label); continue; }
+
+        auto    atomSym = js.jit->lookup("__atom__" + label);
+        if (atomSym)
+        {
+            auto    fn = (*atomSym).toPtr<AtomFn>();
+
+            //  A bounded operator folds its body over a `__time__` window the
+            //  plain all/any latch cannot express. A top-level `F[lo:hi]` or
+            //  `G[lo:hi]` over a state predicate is one window anchored at the
+            //  first state, so the monitor carries it as a deadline latch;
+            //  `__atom__` is that body predicate (`atomOf` peels the operator
+            //  bound and all). Any other bounded operator here -- `O[lo:hi]`,
+            //  `H[lo:hi]`, an `F`/`G` with no upper bound -- is a residual over
+            //  that one predicate, which the generator emitted as `__atom__` in
+            //  place of `__ap__0__`.
+            if (auto* t = dynamic_cast<Temporal<ExprUnary>*>(e); t != nullptr && t->time != nullptr)
+            {
+                std::int64_t    lo, hi;
+                bool            isF = dynamic_cast<ExprF*>(e) != nullptr;
+                bool            isG = dynamic_cast<ExprG*>(e) != nullptr;
+                if ((isF || isG) && t->time->hi != nullptr
+                    && constTime(t->time->lo, 0, lo) && constTime(t->time->hi, 0, hi))
+                {
+                    atomReqs.push_back({label, isF ? BoundedF : BoundedG, fn, lo, hi});
+                    continue;
+                }
+
+                int                 apc    = 0;
+                int                 pslots = 0;
+                int                 pwins  = 0;
+                std::vector<PPtr>   pasts;
+                auto                pool = std::make_shared<RPool>();
+                RPtr                tmpl = buildResidual(*pool, e, apc, pslots, pwins, pasts);
+                pool->size(apc, (int)pasts.size());
+                if (tmpl && apc == 1)
+                    atomReqs.push_back({label, Residual, nullptr, 0, 0, tmpl, {fn}, std::move(pasts), pslots, pwins, pool});
+                else
+                    prefixReqs.insert(label);
+                continue;
+            }
+            auto    fold = (dynamic_cast<ExprG*>(e) || dynamic_cast<ExprH*>(e)) ? FoldAll
+                         : (dynamic_cast<ExprF*>(e) || dynamic_cast<ExprO*>(e)) ? FoldAny
+                         :                                                        FoldFirst;
+            atomReqs.push_back({label, fold, fn});
+            continue;
+        }
+        llvm::consumeError(atomSym.takeError());
+
+        //  The bounded response `G(a => F[lo:hi] b)`: a bounded window opened
+        //  at every instant `a` holds. Its `a`/`b` are `__ap__0`/`__ap__1`
+        //  (piece 1); the monitor evaluates the dense-time covering directly.
+        {
+            std::int64_t    rlo, rhi;
+            if (isBoundedResponse(e, rlo, rhi))
+            {
+                auto    ap0 = js.jit->lookup("__ap__0__" + label);
+                auto    ap1 = js.jit->lookup("__ap__1__" + label);
+                if (ap0 && ap1)
+                {
+                    atomReqs.push_back({label, BoundedResponse, nullptr, rlo, rhi, nullptr,
+                                        {(*ap0).toPtr<AtomFn>(), (*ap1).toPtr<AtomFn>()}});
+                    continue;
+                }
+                if (!ap0)   llvm::consumeError(ap0.takeError());
+                if (!ap1)   llvm::consumeError(ap1.takeError());
+            }
+        }
+
+        //  A requirement that reads the trace only through `Sum`/`Cnt`/`Itg`
+        //  -- the generator emitted `__acc__tab__<label>` for it -- is carried
+        //  as running totals.
+        {
+            std::int64_t const*     tab = nullptr;
+            if (lookupFn("__acc__tab__" + label, tab))
+            {
+                if (auto req = totalsOf(label, tab))
+                {
+                    atomReqs.push_back(std::move(*req));
+                    continue;
+                }
+                prefixReqs.insert(label);
+                continue;
+            }
+        }
+
+        //  Not a single-fold atom. If progression can represent it -- a
+        //  boolean/temporal formula over `G`/`F`/`U`/`R` bounded or not,
+        //  `Xs`/`Xw` next, past operators, a freeze and state predicates --
+        //  carry it as a residual. `buildResidual` numbers the atoms exactly
+        //  as the code generator's `collectAPs` did, so leaf k binds to
+        //  `__ap__k__<label>` (piece 1).
+        int                 apc    = 0;
+        int                 pslots = 0;
+        int                 pwins  = 0;
+        std::vector<PPtr>   pasts;
+        auto                pool = std::make_shared<RPool>();
+        RPtr                tmpl = buildResidual(*pool, e, apc, pslots, pwins, pasts);
+        pool->size(apc, (int)pasts.size());
+        if (tmpl)
+        {
+            std::vector<AtomFn>     aps;
+            bool                    ok = true;
+            for (int k = 0; k < apc; k++)
+            {
+                auto    sym = js.jit->lookup("__ap__" + std::to_string(k) + "__" + label);
+                if (!sym)   { llvm::consumeError(sym.takeError()); ok = false; break; }
+                aps.push_back((*sym).toPtr<AtomFn>());
+            }
+            std::vector<ExprAt*>    freezes;
+            collectFreezes(e, freezes);
+            if (ok && !freezes.empty())
+                ok = freezeOf(*pool, e, label, aps, pasts);
+            if (ok)
+            {
+                atomReqs.push_back({label, Residual, nullptr, 0, 0, tmpl,
+                                    std::move(aps), std::move(pasts), pslots, pwins, pool});
+                continue;
+            }
+        }
+        prefixReqs.insert(label);
+    }
+
+    //  Dwyer-pattern specs. Every scope is incremental -- `globally` over
+    //  the whole trace, `before R` and `after Q` over one interval, and
+    //  `between`/`after-until`/`while` over a run of them. The pattern is
+    //  the scope body rewritten (and canonicalised, as the compiler did
+    //  when emitting its `__ap__` companions), so `buildResidual` sees the
+    //  same `Rw`/`Us`/... form and numbers the atoms alike. A scope's
+    //  boundary is one of the `__scope*__<name>` column functions the
+    //  generator emits; the monitor folds the intervals out of it. What
+    //  still takes the prefix path: a pattern outside the residual
+    //  fragment, and a past-bearing one under any scope that restarts
+    //  (`pastOK` below).
+    auto&   specs = js.astModule->getSpecs();
+    for (std::size_t i = 0; i < specs.size(); i++)
+    {
+        auto    label = js.astModule->getSpecName(i);
+        if (label.empty())  label = specs[i]->where().text();
+
+        auto*   scoped = dynamic_cast<SpecScoped*>(specs[i]);
+        auto*   sc     = js.astModule->scopeFor(label);
+        if (scoped == nullptr || sc == nullptr) { prefixReqs.insert(label); continue; }
+
+        Scope   scope;
+        if      (sc->kind == "globally")    scope = ScGlobally;
+        else if (sc->kind == "before")      scope = ScBefore;
+        else if (sc->kind == "after")       scope = ScAfter;
+        else if (sc->kind == "between")     scope = ScBetween;
+        else if (sc->kind == "after_until") scope = ScAfterUntil;
+        else if (sc->kind == "while")       scope = ScWhile;
+        else    { prefixReqs.insert(label); continue; }
+
+        auto*   pattern = Rewrite::make(scoped->spec);
+        if (readsAnyOf(pattern, historic) || scopeReadsAnyOf(scoped, historic))
+        {
+            prefixReqs.insert(label);
+            continue;
+        }
+
+        int                 apc    = 0;
+        int                 pslots = 0;
+        int                 pwins  = 0;
+        std::vector<PPtr>   pasts;
+        auto                pool = std::make_shared<RPool>();
+        RPtr                tmpl = buildResidual(*pool, pattern, apc, pslots, pwins, pasts);
+        pool->size(apc, (int)pasts.size());
+        //  Every scope but `before`/`globally` starts (or restarts) the pattern
+        //  fresh at an interval open, while the offline anchors it one state
+        //  earlier so a past operator can read across the boundary; a
+        //  past-bearing pattern there would disagree, so it takes the prefix
+        //  path. `before`/`globally` progress from the trace start, so their
+        //  past machines have the right history. A pattern with a freeze
+        //  takes it too: its capture is set up for expression requirements.
+        bool    pastOK = (pslots == 0 && pwins == 0) || scope == ScBefore || scope == ScGlobally;
+        std::vector<ExprAt*>    freezes;
+        collectFreezes(pattern, freezes);
+        if (tmpl != nullptr && pastOK && freezes.empty())
+        {
+            std::vector<AtomFn>     aps;
+            bool                    ok = true;
+            for (int k = 0; k < apc; k++)
+            {
+                auto    sym = js.jit->lookup("__ap__" + std::to_string(k) + "__" + label);
+                if (!sym)   { llvm::consumeError(sym.takeError()); ok = false; break; }
+                aps.push_back((*sym).toPtr<AtomFn>());
+            }
+
+            auto    lookupScope = [&](std::string const& name, ScopeFn& out)
+            {
+                auto    sym = js.jit->lookup(name);
+                if (!sym)   { llvm::consumeError(sym.takeError()); return false; }
+                out = (*sym).toPtr<ScopeFn>();
+                return true;
+            };
+            ScopeFn scopeA = nullptr, scopeB = nullptr;
+            if (ok && scope != ScGlobally)              ok = lookupScope(sc->condA, scopeA);
+            if (ok && (scope == ScBetween || scope == ScAfterUntil))    ok = lookupScope(sc->condB, scopeB);
+
+            if (ok)
+            {
+                atomReqs.push_back({label, Residual, nullptr, 0, 0, tmpl, std::move(aps),
+                                    std::move(pasts), pslots, pwins, pool, scope, scopeA, scopeB});
+                continue;
+            }
+        }
+        prefixReqs.insert(label);
+    }
+
+    for (std::size_t i = 0; i < atomReqs.size(); i++)
+        fastAt[atomReqs[i].label] = i;
+
+    //  The prefix path re-runs only its own requirements: the entry points
+    //  `runOneTrace` walks are narrowed to them, so a row costs the prefix
+    //  re-run for what needs it and nothing for what does not.
+    {
+        std::vector<std::string>    keep;
+        for (auto const& name : js.funcNames)
+            if (prefixReqs.count(name))     keep.push_back(name);
+        js.funcNames = std::move(keep);
+    }
+
+    if (!atomReqs.empty())
+    {
+        if (auto modSym = js.jit->lookup("referee_module"))
+            internModuleStrings((*modSym).toPtr<referee_module_v1 const* (*)()>()());
+        else
+            llvm::consumeError(modSym.takeError());
+
+        auto    prepSym = js.jit->lookup("__prepare__");
+        if (!prepSym)   throw std::runtime_error("JIT: missing __prepare__");
+        prepFn  = (*prepSym).toPtr<PrepFn>();
+    }
+
+    //  The module's atomic propositions, each evaluated once a state by
+    //  `__ap__eval__` into `apRow`, a byte apiece; a residual or a response
+    //  reads its atoms from there through the generator's `__ap__map__<label>`
+    //  rather than calling its own `__ap__k__` -- so a predicate shared by a
+    //  hundred requirements costs one evaluation, not a hundred. A requirement
+    //  with no map (none is emitted where `__atom__` stands in, nor for a
+    //  freeze's atoms, which read a captured state too) keeps its own,
+    //  and so does one whose map is not the length of its own atom list or
+    //  points outside the table: the generator's walk and `buildResidual`'s
+    //  disagree, and the map is not read past its end on that word.
+    if (!atomReqs.empty())
+    {
+        auto    evalSym  = js.jit->lookup("__ap__eval__");
+        auto    countSym = js.jit->lookup("__ap__count__");
+        if (evalSym && countSym)
+        {
+            apEval = (*evalSym).toPtr<ApEvalFn>();
+            apCount = *(*countSym).toPtr<std::uint32_t const*>();
+            for (auto& r : atomReqs)
+            {
+                if ((r.fold != Residual && r.fold != BoundedResponse) || r.aps.empty())     continue;
+                auto    mapSym = js.jit->lookup("__ap__map__" + r.label);
+                auto    lenSym = js.jit->lookup("__ap__map__" + r.label + "__n__");
+                if (!mapSym || !lenSym)
+                {
+                    if (!mapSym)    llvm::consumeError(mapSym.takeError());
+                    if (!lenSym)    llvm::consumeError(lenSym.takeError());
+                    continue;
+                }
+                auto*   at  = (*mapSym).toPtr<std::uint32_t const*>();
+                auto    len = *(*lenSym).toPtr<std::uint32_t const*>();
+                if (len != r.aps.size())    continue;
+                if (std::any_of(at, at + len, [&](std::uint32_t k) { return k >= apCount; }))   continue;
+                r.apAt.assign(at, at + len);
+            }
+        }
+        if (!evalSym)   llvm::consumeError(evalSym.takeError());
+        if (!countSym)  llvm::consumeError(countSym.takeError());
+    }
+}
+
+// ── one stream of states ────────────────────────────────────────────────────
+namespace {
+
+//  Everything one stream of states carries from row to row: the folds'
+//  latches, each residual and its past memory, the bounded operators'
+//  previous segment, and the prefix path's CSV and verdicts. The
+//  requirements themselves -- compiled functions, residual templates and
+//  their pools -- are shared, so a session costs a few bytes per
+//  requirement plus whatever its windows hold.
+//
+//  Bounded operators are dense-time: a state's value holds over the
+//  half-open segment [its time, the next state's time), and the window
+//  is [t0+lo, t0+hi) -- upper-exclusive, values persisting between
+//  states (`F[500:1000]` is met by a `b` that went true before 500 and
+//  is still true at 500). So a segment is only closed once the next
+//  state's time is known: the monitor lags one state, carrying the
+//  previous state's body value, and closes the final state as a point.
+//  A bounded response keeps per-state (time, a, b) for the dense-time
+//  covering fold computed at end of stream.
+struct  Sample { std::int64_t t; char a, b; };
+//  An accumulator's total or weight, in whichever of the two it is kept.
+struct  Tot
+{
+    std::int64_t    i = 0;
+    double          d = 0;
+};
+//  A totals requirement's running totals. Opened at the first state, each
+//  accumulator's total so far -- and, an `Itg`, the newest state's weight,
+//  whose segment has no end yet. Opened at other states, a mark per state
+//  from the oldest window still open -- its time, whether a window opens
+//  there, each accumulator's weight -- so a window is totalled in state order
+//  once a state past its end arrives, or at end of stream, and then dropped.
+struct  TotalsMem
+{
+    std::vector<Tot>            run;
+    std::vector<Tot>            last;
+    std::int64_t                lastT = 0;
+    bool                        any   = false;  //  a state seen
+    std::deque<std::int64_t>    t;
+    std::deque<char>            opens;
+    std::deque<Tot>             wt;             //  `accs.size()` per mark
+    std::vector<Tot>            sums;           //  a window's totals, as they are checked
+    std::vector<std::int64_t>   slots;          //  ... and as `__acc__fin__` reads them
+};
+
+static void addTot(Tot& to, Tot const& w, std::int64_t len)
+{
+    to.i += w.i * len;
+    to.d += w.d * static_cast<double>(len);
+}
+
+static Tot  weigh(AccSpec const& a, void* curr, void* conf)
+{
+    Tot     w;
+    if (a.wd)   w.d = a.wd(curr, conf);
+    else        w.i = a.wi(curr, conf);
+    return w;
+}
+
+//  How much of `[from, to)` an `Itg` opened at `t0` integrates over: its
+//  window, clipped to `[t0+lo, t0+hi)` where it has those bounds.
+static std::int64_t clipped(AccSpec const& a, std::int64_t t0, std::int64_t from, std::int64_t to)
+{
+    auto    lo = a.hasLo ? std::max(from, t0 + a.lo) : from;
+    auto    hi = a.hasHi ? std::min(to,   t0 + a.hi) : to;
+    return lo < hi ? hi - lo : 0;
+}
+
+//  The totals of the window opened at mark `k0`, added in state order as the
+//  offline fold adds them, so a number total agrees to the last bit. `end`:
+//  the stream has ended, and the last mark's segment closes one tick after
+//  it, where the trailing sentinel sits.
+static void windowTotals(AtomReq const& q, TotalsMem& m, std::size_t k0, bool end)
+{
+    auto const  n  = q.accs.size();
+    auto const  ti = m.t[k0];
+    m.sums.assign(n, Tot{});
+    for (std::size_t j = 0; j < n; j++)
+    {
+        auto const& a = q.accs[j];
+        for (std::size_t k = k0; k < m.t.size(); k++)
+        {
+            if (a.hasHi && m.t[k] >= ti + a.hi)         break;
+            if (!a.itg)
+            {
+                if (!a.hasLo || m.t[k] >= ti + a.lo)    addTot(m.sums[j], m.wt[k * n + j], 1);
+                continue;
+            }
+            if (k + 1 == m.t.size() && !end)            break;
+            auto    next = k + 1 < m.t.size() ? m.t[k + 1] : m.t[k] + 1;
+            addTot(m.sums[j], m.wt[k * n + j], clipped(a, ti, m.t[k], next));
+        }
+    }
+}
+
+//  The requirement over `m.sums`.
+static bool holdsOver(AtomReq const& q, TotalsMem& m, void* conf)
+{
+    m.slots.resize(m.sums.size());
+    for (std::size_t j = 0; j < m.sums.size(); j++)
+        if (q.accs[j].wd)   std::memcpy(&m.slots[j], &m.sums[j].d, sizeof(double));
+        else                m.slots[j] = m.sums[j].i;
+    return q.fin(m.slots.data(), conf);
+}
+struct  Session
+{
+    std::vector<char>       value;      //  all/G[]: ok / any: met / first & residual: verdict once done
+    std::vector<char>       done;       //  first, residual, bounded: decided yet
+    std::vector<char>       started;    //  after-scope: its Q boundary has fired
+    std::vector<char>       inside;     //  multi-interval scope: currently within an interval
+    std::vector<RPtr>       resid;      //  residual: the current progression formula
+    std::vector<PastMem>    pmem;       //  residual: past-machine memory
+    std::vector<std::vector<Sample>>    brBuf;
+    std::vector<TotalsMem>  tmem;       //  totals: the running totals
+    std::int64_t            t0     = 0; //  window anchor: __time__ of the first state
+    bool                    haveT0 = false;
+    std::int64_t            prevTs = 0;
+    std::string             prevNow, prevLine;
+    std::vector<char>       prevBody;   //  bounded: body over the previous segment
+    std::vector<char>       curBody;
+    std::string             csv;        //  prefix path: the rows so far ...
+    std::vector<std::int64_t>           times;  //  ... or, binary, their times and blobs
+    std::vector<referee::db::blob_t>    rows;
+    std::map<std::string, bool>     prev, verdicts;     //  ... its verdicts, the last row's and this one's
+    std::string             lastCapture;
+    std::string             tag;        //  `key=<k>  ` on every line it prints, keyed
+    std::string             key;
+    std::vector<char>       shown;      //  changes/ndjson: each requirement's verdict as last printed
+    std::int64_t            lastT  = 0; //  keyed: __time__ of its latest row
+    std::list<std::string>::iterator    lru;
+    std::vector<std::int64_t>   armedAt;    //  wall clock: the deadline each requirement has on the wheel
+    std::vector<std::size_t>    brFrom;     //  bounded response: the first sample still worth scanning ...
+    std::vector<std::int64_t>   brLo;       //  ... and the first anchor (doubled) not yet known covered
+};
+
+//  Where a violation found stepping a requirement goes: printed at once, or --
+//  a pipelined shard -- kept for the reporter to print in order.
+using   Flag = std::function<void(Session const&, std::size_t, std::string const&, std::string const&)>;
+
+//  One row as a requirement steps over it: the window and conf, the shared
+//  atoms' values, `__time__`, and what the session held from the row
+//  before. The serial step points it at the session; a pipelined one
+//  (`--threads`) at a ring slot, which carries its own copy.
+struct  RowCtx
+{
+    void*                                   sfrst;
+    void*                                   slast;
+    void*                                   curr;
+    void*                                   conf;
+    std::uint8_t const*                     ap;
+    std::int64_t                            ts;
+    std::int64_t                            t0;
+    bool                                    first;
+    std::int64_t                            prevTs;
+    std::string const*                      now;
+    std::string const*                      prevNow;
+    std::string const*                      prevLine;
+    std::function<std::string()> const*     text;
+};
+
+//  A binary state taken off the frame reader, so it outlives the reader's
+//  `next()`: a pipelined ring slot holds one while its row is in flight.
+struct  FrameRow
+{
+    std::int64_t                time = 0;
+    std::vector<std::uint8_t>   row;        //  the fixed-up state, detached from the reader
+    std::vector<void const*>    ptrs;       //  each prop's blob in it
+    referee::db::blob_t         wire;       //  the prefix path's copy (`wireRow`)
+};
+
+//  One run of a `MonitorSpec` over a stream of states: how the stream is read,
+//  its open sessions, the output and the clock. `run` opens the stream --
+//  header, framing, a resumed checkpoint -- and hands it to `serial`, one row
+//  at a time on this thread, or to `pipelined` (`--threads`). Both step a
+//  session with the same pieces: `stepReq` for an incremental requirement,
+//  `stepPrefix` for the prefix path, `emitLine` and `closeSession` to report.
+class   Stream
+{
+public:
+    Stream(MonitorSpec& spec, std::istream& states, std::ostream& os, bool stopAtFirst);
+    ~Stream()   { os.flush(); }
+
+    bool    run();
+
+private:
+    //  Sessions.
+    Session     openSession(std::string const& key);
+    void        retire(std::string const& key);
+    bool        closeSession(Session& s, std::string const& title);
+
+    //  Rows.
+    std::unique_ptr<referee::db::Reader>    ingest(std::string const& text);
+    std::unique_ptr<referee::db::Reader>    pack(Session const& s);
+    std::string loadRow(std::uint8_t* states, std::vector<std::vector<std::uint8_t>>& computed,
+                        std::uint8_t* ap, referee::db::Reader const* rdb, std::string const& now,
+                        FrameRow const* frame = nullptr);
+    referee::db::blob_t wireRow() const;
+    bool        fetch(std::string& line);
+    void        interruptInput();
+
+    //  Stepping.
+    bool        stepReq(Session& s, std::size_t i, RowCtx const& r, Flag const& flag);
+    bool        stepPrefix(Session& s, std::function<std::string()> const& text, std::string const& now,
+                           bool& violatedNow, FrameRow* frame = nullptr);
+    bool        step(Session& s, std::function<std::string()> const& text, std::string const& now);
+    bool        brCheck(Session& s, std::size_t i, std::int64_t now,
+                        std::function<std::string()> const& row, Flag const& flag);
+    char        fastVerdict(Session const& s, std::size_t i) const;
+
+    //  Deadlines.
+    void        arm(Session& s, std::size_t i, std::int64_t at);
+    void        armBounded(Session& s);
+    bool        fire(TimerWheel::Timer const& t, std::int64_t now);
+    std::optional<std::int64_t>             clockNow() const;
+    std::chrono::steady_clock::time_point   wallAt(std::int64_t t) const;
+
+    //  Output.
+    void        flush(bool now = false);
+    std::chrono::steady_clock::time_point   flushBy() const;
+    static void jsonTime(json::Writer& w, std::string const& when);
+    template<typename Fields>
+    void        event(Session const* s, char const* kind, Fields&& fields)
+    {
+        json::Writer    w(os);
+        {
+            auto    obj = w.object();
+            w.key("event").value(kind);
+            if (s != nullptr && !g_monitorKey.empty())
+                w.key("key").value(s->key);
+            fields(w);
+        }
+        w.line();
+    }
+    void        violation(Session const& s, std::string const& label,
+                          std::string const& when, std::string const& row);
+    void        error(std::string const& message);
+    void        emitLine(Session& s, std::string const& now, bool onlyMoved, char const* fast = nullptr);
+    void        reportLatency();
+    void        timed();
+
+    //  Checkpoints.
+    std::uint64_t   specHash() const;
+    void        saveCheckpoint();
+    void        loadCheckpoint(std::string const& path);
+    void        checkpoint();
+
+    //  The two ways through the stream.
+    bool        serial();
+    bool        pipelined();
+
+    static constexpr std::int64_t   kUnarmed = std::numeric_limits<std::int64_t>::min();
+
+    //  The specification's, shared by every stream.
+    JitWithSpecs&                           js;
+    std::vector<AtomReq> const&             atomReqs;
+    std::set<std::string> const&            prefixReqs;
+    std::set<std::string> const&            deferred;
+    std::vector<std::string> const&         order;
+    std::map<std::string, std::size_t> const&   fastAt;
+    std::string const&                      confPath;
+    std::string const&                      confContents;
+    std::string const&                      refSrc;
+    PrepFn const                            prepFn;
+    ApEvalFn const                          apEval;
+
+    std::istream&   states;
+    std::ostream&   os;
+    bool const      stopAtFirst;
+
+    Color::Modifier const   green {Color::FG_GREEN};
+    Color::Modifier const   red   {Color::FG_RED};
+    Color::Modifier const   yellow{Color::FG_YELLOW};
+    Color::Modifier const   reset {Color::FG_DEFAULT};
+
+    //  The stream's CSV header; or, `--binary`, its frames and the conf packed
+    //  on its own.
+    std::string                                 header;
+    std::shared_ptr<referee::db::FrameReader>   frames;
+    std::vector<std::uint8_t>                   confBlob;
+    std::unique_ptr<referee::db::Reader>        confRdb;
+
+    //  The row as the generated code reads it -- `{__time__, prop*[N]}` with
+    //  every prop a slot, a computed one pointing at storage of its own --
+    //  between its two sentinels, so `__prepare__` can fill the computed
+    //  props. A `.rdb` row carries only the recorded ones, which is why it is
+    //  not used directly.
+    std::vector<std::string> const&         propNames;
+    std::size_t const                       stride;
+    std::vector<std::uint8_t>               rowStates;
+    std::vector<std::vector<std::uint8_t>>  computedRows;
+    std::vector<std::size_t>                width;          //  computed: the prop's size
+    std::vector<std::size_t>                csvIndex;       //  recorded: its index in the .rdb
+    std::vector<std::size_t>                frameAt;        //  binary: recorded -> index in the stream
+    std::vector<std::vector<std::uint8_t>>  zeroRows;       //  binary: a recorded prop's sentinel value
+    std::vector<std::uint8_t>               apRow;          //  the row's shared atoms, by `__ap__eval__`
+
+    //  A bounded `G` reports its violation one row late, and a deadline fired
+    //  by the wall clock against the last row, so they alone need the previous
+    //  row's text kept.
+    bool const  wall;
+    bool const  lagText;
+
+    bool const  ndjson  = g_monitorFormat == "ndjson";
+    bool const  changes = g_monitorFormat != "states";
+    std::chrono::steady_clock::time_point   flushed = std::chrono::steady_clock::now();
+    bool        held    = false;
+    Flag const  printFlag;
+
+    TimerWheel  wheel{std::max<std::int64_t>(1, 1000000 / g_monitorClockUnit)};     //  a slot per millisecond
+    std::chrono::steady_clock::time_point   clockAt;        //  epoch `first`: when the first row was read ...
+    std::int64_t                            clockTs  = 0;   //  ... and its `__time__`
+    bool                                    clockSet = false;
+
+    bool        failed  = false;    //  a row could not be read: the run ends there
+    bool        halted  = false;    //  a deadline fired a violation under `--stop-at-first`
+
+    //  Unkeyed, the stream is one session, open from the header on. Keyed,
+    //  each distinct value of the key column is a session of its own --
+    //  opened by its first row, closed (and reported) when it has been idle
+    //  too long, when too many are open and it is the least recently seen,
+    //  or at end of stream. A key seen again after its session closed starts
+    //  a new one. Sessions share the compiled module and every requirement's
+    //  automaton, so memory follows the open sessions, not the keys seen.
+    bool const      keyed;
+    std::size_t     keyAt   = 0, timeAt = 0;
+
+    std::unordered_map<std::string, Session>    sessions;
+    std::list<std::string>                      lru;        //  most recently seen first
+    bool            allPass  = true;
+    std::size_t     closed   = 0, closedFailing = 0;
+    std::uint64_t   rowsSeen = 0;
+
+    LatencyHistogram                        latency;
+    std::chrono::steady_clock::time_point   runStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point   readAt;
+    std::unique_ptr<TimedFeed>              feed;
+};
+
+Stream::Stream(MonitorSpec& spec, std::istream& states, std::ostream& os, bool stopAtFirst)
+: js(spec.js), atomReqs(spec.atomReqs), prefixReqs(spec.prefixReqs)
+, deferred(spec.deferred), order(spec.order), fastAt(spec.fastAt)
+, confPath(spec.confPath), confContents(spec.confContents), refSrc(spec.refSrc)
+, prepFn(spec.prepFn), apEval(spec.apEval)
+, states(states), os(os), stopAtFirst(stopAtFirst)
+, propNames(spec.js.astModule->getPropNames())
+, stride(sizeof(std::int64_t) + propNames.size() * sizeof(void*))
+, apRow(spec.apCount, 0)
+, wall(g_monitorClock == "wall")
+, lagText(wall || std::any_of(atomReqs.begin(), atomReqs.end(),
+                              [](AtomReq const& r) { return r.fold == BoundedG; }))
+, printFlag([this](Session const& s, std::size_t i, std::string const& when, std::string const& row)
+  {
+      violation(s, atomReqs[i].label, when, row);
+  })
+, keyed(!g_monitorKey.empty())
+{}
+
+//  Open the stream -- its framing or header, the row layout both paths fill,
+//  the sessions, restored if resuming, and the reader -- then check it.
+bool    Stream::run()
+{
+    //  `--binary`: the stream is a `FrameReader` one -- each state already in
+    //  `.rdb` wire form, fixed up in place and read straight from the frame
+    //  buffer, so a row costs no parse and no ingest. It carries only `data`;
+    //  the conf is loaded once from `--conf` and packed on its own.
+    if (g_monitorBinary)
+    {
+        if (!g_monitorKey.empty())
+            throw std::runtime_error("monitor: --key splits on a CSV column; it does not combine with --binary");
+        if (states.peek() == std::char_traits<char>::eof())    return true;     //  empty stream
+        frames = std::make_shared<referee::db::FrameReader>(states, "stdin");
+    }
+    else if (!std::getline(states, header))     return true;    //  empty stream
+
+    //  A totals requirement still has windows to close at end of stream, when
+    //  the CSV rows -- each ingested with a conf of its own -- are gone; so
+    //  with one of those the conf is packed on its own here too.
+    if (frames || std::any_of(atomReqs.begin(), atomReqs.end(),
+                              [](AtomReq const& r) { return r.fold == Totals; }))
+    {
+        std::unique_ptr<std::istringstream>     confIn;
+        if (!confContents.empty())
+            confIn = std::make_unique<std::istringstream>(confContents);
+        confBlob = referee::db::confBlobWithModule(confIn.get(), confPath, js.astModule);
+
+        std::stringstream   rdbBuf(std::ios::in | std::ios::out | std::ios::binary);
+        referee::db::packWithModule({}, {}, confBlob, js.astModule, rdbBuf);
+        auto                        str = std::move(rdbBuf).str();
+        std::vector<std::uint8_t>   bytes(str.begin(), str.end());
+        confRdb = std::make_unique<referee::db::Reader>(std::move(bytes), confPath);
+    }
+
+    rowStates.assign(3 * stride, 0);
+    computedRows.resize(propNames.size());
+    width.assign(propNames.size(), 0);
+    csvIndex.assign(propNames.size(), 0);
+    zeroRows.resize(propNames.size());
+    {
+        std::size_t     ci = 0;
+        for (std::size_t pi = 0; pi < propNames.size(); pi++)
+            if (js.astModule->isExprData(propNames[pi]))
+            {
+                width[pi] = js.astModule->getProp(propNames[pi])->size();
+                computedRows[pi].assign(3 * width[pi], 0);
+            }
+            else
+                csvIndex[pi] = ci++;
+    }
+    if (frames)
+    {
+        //  Matched by name and checked by type: a producer built against
+        //  another version of the spec is caught here, not by a misread blob.
+        auto const&     have = frames->props();
+        for (auto const& decl : referee::db::recordedProps(js.astModule))
+        {
+            auto    it = std::find_if(have.begin(), have.end(),
+                                      [&](auto const& p) { return p.name == decl.name; });
+            if (it == have.end())
+                throw std::runtime_error("monitor: the stream carries no signal '" + decl.name + "'");
+            if (!referee::db::typesEqual(it->type, decl.type))
+                throw std::runtime_error("monitor: signal '" + decl.name + "' has another type in the stream");
+            frameAt.push_back(it - have.begin());
+        }
+        for (std::size_t pi = 0; pi < propNames.size(); pi++)
+            if (!js.astModule->isExprData(propNames[pi]))
+                zeroRows[pi].assign(js.astModule->getProp(propNames[pi])->size(), 0);
+    }
+
+    if (keyed)
+    {
+        auto    cols = referee::db::splitCells(header);
+        auto    at = [&](std::string const& name)
+        {
+            auto    it = std::find(cols.begin(), cols.end(), name);
+            if (it == cols.end())
+                throw std::runtime_error("monitor: no column '" + name + "' in the stream's header");
+            return (std::size_t)(it - cols.begin());
+        };
+        keyAt  = at(g_monitorKey);
+        timeAt = at("__time__");
+    }
+    if (!keyed)
+        sessions.emplace("", openSession(""));
+
+    if (!g_monitorResume.empty())
+    {
+        loadCheckpoint(g_monitorResume);
+        if (ndjson)
+            event(nullptr, "resumed", [&](json::Writer& w)
+            {
+                w.key("rows").value(static_cast<std::uint64_t>(rowsSeen));
+                w.key("sessions").value(static_cast<std::uint64_t>(sessions.size()));
+            });
+        else
+            os << "-- resumed after " << rowsSeen << " rows, " << sessions.size() << " open sessions --\n";
+    }
+
+    runStart = std::chrono::steady_clock::now();
+    if (wall || (g_monitorFlushMs > 0 && g_monitorThreads == 0))
+    {
+        std::function<bool(std::string&)>  read;
+        if (frames)     read = [this](std::string&) { return frames->next(); };
+        else            read = [this](std::string& l) { return static_cast<bool>(std::getline(states, l)); };
+        feed = std::make_unique<TimedFeed>(std::move(read), [this] { interruptInput(); });
+    }
+    if (wall)
+    {
+        for (auto& [key, s] : sessions)         //  resumed: re-arm what the checkpoint left pending
+        {
+            armBounded(s);
+            for (std::size_t i = 0; i < atomReqs.size(); i++)
+                if (atomReqs[i].fold == BoundedResponse && !s.done[i])
+                    brCheck(s, i, s.prevTs, [&] { return s.prevLine; }, printFlag);
+        }
+    }
+
+    return g_monitorThreads > 0 ? pipelined() : serial();
+}
+
+Session Stream::openSession(std::string const& key)
+{
+    auto        n = atomReqs.size();
+    Session     s;
+    s.value.assign(n, 0);
+    s.done.assign(n, 0);
+    s.started.assign(n, 0);
+    s.inside.assign(n, 0);
+    s.resid.resize(n);
+    s.pmem.resize(n);
+    s.brBuf.resize(n);
+    s.tmem.resize(n);
+    s.prevBody.assign(n, 0);
+    s.curBody.assign(n, 0);
+    s.csv = header;
+    s.tag = g_monitorKey.empty() ? "" : "key=" + key + "  ";
+    s.key = key;
+    s.shown.assign(order.size(), '?');
+    s.armedAt.assign(n, kUnarmed);
+    s.brFrom.assign(n, 0);
+    s.brLo.assign(n, std::numeric_limits<std::int64_t>::min() / 4);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        //  G and G[lo:hi] are safety -- true until broken. A multi-interval
+        //  scope is a running AND of its intervals -- true until one fails,
+        //  vacuously true if none opens. Totals hold until a total says
+        //  otherwise, as a prefix verdict would. Everything else starts unmet.
+        bool    multi = atomReqs[i].scope == ScBetween || atomReqs[i].scope == ScAfterUntil || atomReqs[i].scope == ScWhile;
+        s.value[i] = (atomReqs[i].fold == FoldAll || atomReqs[i].fold == BoundedG
+                   || atomReqs[i].fold == Totals || multi) ? 1 : 0;
+        s.resid[i] = atomReqs[i].templ;         //  null for atom folds
+        s.pmem[i].reset(atomReqs[i].pslots, atomReqs[i].pwins);
+    }
+    return s;
+}
+
+std::unique_ptr<referee::db::Reader>   Stream::ingest(std::string const& text)
+{
+    std::istringstream                      csvIn(text);
+    std::unique_ptr<std::istringstream>     confIn;
+    if (!confContents.empty())
+        confIn = std::make_unique<std::istringstream>(confContents);
+
+    //  ingestWithModule picks the CSV vs YAML loader by the name's
+    //  extension, so the conf name must carry its real one (the path).
+    std::stringstream   rdbBuf(std::ios::in | std::ios::out | std::ios::binary);
+    referee::db::ingestWithModule(csvIn, "stdin.csv", confIn.get(), confPath,
+                                  js.astModule, rdbBuf);
+
+    auto                        str = std::move(rdbBuf).str();
+    std::vector<std::uint8_t>   bytes(str.begin(), str.end());
+    return std::make_unique<referee::db::Reader>(std::move(bytes), "stdin.csv");
+}
+
+//  The prefix path's trace from a binary session's rows, already in
+//  `Loader::load` form -- no text in between.
+std::unique_ptr<referee::db::Reader>   Stream::pack(Session const& s)
+{
+    std::stringstream   rdbBuf(std::ios::in | std::ios::out | std::ios::binary);
+    referee::db::packWithModule(s.times, s.rows, confBlob, js.astModule, rdbBuf);
+
+    auto                        str = std::move(rdbBuf).str();
+    std::vector<std::uint8_t>   bytes(str.begin(), str.end());
+    return std::make_unique<referee::db::Reader>(std::move(bytes), "stdin");
+}
+
+//  Output. `states` is the verdict line per state; `changes` prints only
+//  the verdicts that moved since the session's last line, so a quiet
+//  stream writes nothing; `ndjson` writes each event -- a verdict change,
+//  a violation, a final verdict -- as one JSON object per line. Output is
+//  flushed per state, or with `--flush-ms` once that long has passed since
+//  the last flush: what is held is flushed by then even if no row comes
+//  (`fetch` waits no longer), and a violation or an error is never held.
+//  It is always flushed when the run ends.
+void    Stream::flush(bool now)
+{
+    if (g_monitorFlushMs == 0)  { os.flush(); return; }
+    auto    t = std::chrono::steady_clock::now();
+    if (now || t - flushed >= std::chrono::milliseconds(g_monitorFlushMs))
+    {
+        os.flush();
+        flushed = t;
+        held    = false;
+    }
+    else
+        held = true;
+}
+
+std::chrono::steady_clock::time_point   Stream::flushBy() const
+{
+    return flushed + std::chrono::milliseconds(g_monitorFlushMs);
+}
+
+//  `__time__` as a JSON number when it is one, else as the text it was.
+void    Stream::jsonTime(json::Writer& w, std::string const& when)
+{
+    try
+    {
+        std::size_t     used = 0;
+        auto            t    = std::stoll(when, &used);
+        if (used == when.size())    { w.value(static_cast<std::int64_t>(t)); return; }
+    }
+    catch (...) {}
+    w.value(when);
+}
+
+void    Stream::violation(Session const& s, std::string const& label,
+                          std::string const& when, std::string const& row)
+{
+    if (ndjson)
+        event(&s, "violation", [&](json::Writer& w)
+        {
+            w.key("time");          jsonTime(w, when);
+            w.key("requirement").value(label);
+            w.key("row").value(row);
+        });
+    else
+        os << red << "VIOLATION" << reset << "  " << yellow << label << reset
+           << "  @ " << s.tag << "__time__=" << when << "  " << row << "\n";
+    flush(true);
+}
+
+void    Stream::error(std::string const& message)
+{
+    if (ndjson)
+        event(nullptr, "error", [&](json::Writer& w) { w.key("message").value(message); });
+    else
+        os << red << "error" << reset << ": " << message << "\n";
+    flush(true);
+}
+
+//  One verdict per requirement -- the three-valued LTL3 view. A safety
+//  requirement is `?` while it holds (it could still break) and FAIL once
+//  broken; a liveness one is `?` until it is met and PASS once settled
+//  true. This is an incremental one's, read off its session's latches.
+char    Stream::fastVerdict(Session const& s, std::size_t i) const
+{
+    bool    v = s.value[i];
+    if      (atomReqs[i].fold == FoldAll)    return v ? '?' : 'F';
+    else if (atomReqs[i].fold == FoldAny)    return v ? 'P' : '?';
+    else if (atomReqs[i].fold == Totals)     return s.done[i] ? (v ? 'P' : 'F') : v ? '?' : 'F';
+    else                                     return s.done[i] ? (v ? 'P' : 'F') : '?';    //  first / residual
+}
+
+//  A session's verdict line at `now`: every requirement, or -- `onlyMoved`
+//  -- just those whose verdict moved since it was last printed. `fast`,
+//  if given, holds the incremental requirements' verdicts as of this row
+//  (a pipelined run's shards are on later rows by the time it prints).
+void    Stream::emitLine(Session& s, std::string const& now, bool onlyMoved, char const* fast)
+{
+    auto    verdictOf = [&](std::string const& label)
+    {
+        if (auto f = fastAt.find(label); f != fastAt.end())
+            return fast ? fast[f->second] : fastVerdict(s, f->second);
+        auto    it = s.verdicts.find(label);
+        if (it == s.verdicts.end())             return '?';
+        else if (deferred.count(label))         return it->second ? 'P' : '?';
+        else                                    return it->second ? '?' : 'F';
+    };
+    auto    show = [&](char v) -> std::ostream&
+    {
+        if (v == 'P')   return os << green << "PASS" << reset;
+        if (v == 'F')   return os << red << "FAIL" << reset;
+        return os << '?';
+    };
+
+    //  The whole line, or -- `changes`/`ndjson` -- just what moved. The
+    //  line is flushed so a live producer sees each state as it arrives
+    //  rather than at some buffer boundary.
+    bool    opened = false;
+    auto    open   = [&]()
+    {
+        if (!opened)
+            os << yellow << s.tag << "__time__=" << now << reset;
+        opened = true;
+    };
+    if (!onlyMoved)
+        open();
+    for (std::size_t k = 0; k < order.size(); k++)
+    {
+        auto const& label = order[k];
+        char        v     = verdictOf(label);
+        if (onlyMoved && v == s.shown[k])     continue;
+        s.shown[k] = v;
+
+        if (ndjson)
+        {
+            event(&s, "verdict", [&](json::Writer& w)
+            {
+                w.key("time");          jsonTime(w, now);
+                w.key("requirement").value(label);
+                w.key("verdict").value(v == 'P' ? "PASS" : v == 'F' ? "FAIL" : "?");
+            });
+            continue;
+        }
+        open();
+        os << "  " << label << '=';
+        show(v);
+    }
+    if (opened)
+        os << "\n";
+    flush();
+}
+
+//  Deadlines. A bounded `F`/`G` on the stream clock settles when a row past
+//  its window arrives, which on a stream gone quiet is late or never; on
+//  the wall clock each session arms the time its open segment decides the
+//  window -- a decisive body once the window is reached, else the window's
+//  end -- and the wheel fires it without waiting for a row. A bounded
+//  response is checked after every row on either clock (`brCheck`), its
+//  first uncovered anchor armed on the wall clock. One timer per session
+//  and requirement is live: `armedAt` is its deadline, and a fired timer
+//  that does not match it is stale.
+void    Stream::arm(Session& s, std::size_t i, std::int64_t at)
+{
+    if (s.armedAt[i] == at)     return;
+    s.armedAt[i] = at;
+    wheel.add({at, s.key, i});
+}
+
+void    Stream::armBounded(Session& s)
+{
+    if (!s.haveT0)  return;
+    for (std::size_t i = 0; i < atomReqs.size(); i++)
+    {
+        if ((atomReqs[i].fold != BoundedF && atomReqs[i].fold != BoundedG) || s.done[i])    continue;
+        std::int64_t    winLo    = s.t0 + atomReqs[i].lo;
+        std::int64_t    winHi    = s.t0 + atomReqs[i].hi;
+        bool            decisive = (atomReqs[i].fold == BoundedF) == (s.prevBody[i] != 0);
+        arm(s, i, decisive ? std::min(std::max(s.prevTs, winLo) + 1, winHi) : winHi);
+    }
+}
+
+//  Fail a bounded response whose first uncovered anchor's window has
+//  passed by `now`; otherwise move its scan past what is now known covered
+//  -- dropping the samples before it, so the buffer holds only the open
+//  windows' -- and, on the wall clock, arm that anchor's deadline.
+bool    Stream::brCheck(Session& s, std::size_t i, std::int64_t now,
+                        std::function<std::string()> const& row, Flag const& flag)
+{
+    auto&       buf = s.brBuf[i];
+    auto        hi  = atomReqs[i].hi;
+    auto        gap = brFirstGap(buf, s.brFrom[i], s.brLo[i], atomReqs[i].lo, hi);
+    if (gap && brDeadline(*gap, hi) <= now)
+    {
+        s.value[i] = 0;
+        s.done[i]  = 1;
+        flag(s, i, std::to_string(brDeadline(*gap, hi)), row());
+        return true;
+    }
+    s.brLo[i] = std::max(s.brLo[i], 2 * (now - hi) + 1);
+    while (s.brFrom[i] + 1 < buf.size() && 2 * buf[s.brFrom[i] + 1].t <= s.brLo[i])
+        s.brFrom[i]++;
+    if (2 * s.brFrom[i] >= buf.size())      //  half dead: trimming costs no more than the pushes did
+    {
+        buf.erase(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(s.brFrom[i]));
+        s.brFrom[i] = 0;
+    }
+    if (gap && wall)
+        arm(s, i, brDeadline(*gap, hi));
+    return false;
+}
+
+//  Fill a row window -- `states`, three rows whose computed props point
+//  into `computed` -- from one ingested CSV row (`rdb`) or the current
+//  frame, then run `__prepare__` over it and `__ap__eval__` into `ap`. A
+//  CSV row is ingested on its own, sentinels and all; a frame is already
+//  the middle row, its sentinels the type's zeros just either side of its
+//  time. Returns what is wrong with the row, if anything.
+std::string Stream::loadRow(std::uint8_t* states, std::vector<std::vector<std::uint8_t>>& computed,
+                            std::uint8_t* ap, referee::db::Reader const* rdb, std::string const& now,
+                            FrameRow const* frame)
+{
+    constexpr auto  kMin = std::numeric_limits<std::int64_t>::min();
+    constexpr auto  kMax = std::numeric_limits<std::int64_t>::max();
+    //  Binary: the reader's current state, or one taken off it (`frame`).
+    std::int64_t const  ft = !frames ? 0 : frame ? frame->time : frames->time();
+    auto    blob = [&](std::size_t k) { return frame ? frame->ptrs.at(k) : frames->propBlob(k); };
+    for (std::size_t si = 0; si < 3; si++)
+    {
+        auto*           row = states + si * stride;
+        std::int64_t    t   = 0;
+        if (!frames)            t = rdb->time(si);
+        else if (si == 1)       t = ft;
+        else if (si == 0)       t = ft > kMin ? ft - 1 : kMin;
+        else                    t = ft < kMax ? ft + 1 : kMax;
+        std::memcpy(row, &t, sizeof(t));
+        for (std::size_t pi = 0; pi < propNames.size(); pi++)
+        {
+            void const* val = js.astModule->isExprData(propNames[pi])
+                            ? computed[pi].data() + si * width[pi]
+                            : !frames   ? rdb->propBlob(si, csvIndex[pi])
+                            : si != 1   ? zeroRows[pi].data()
+                            :             blob(frameAt[csvIndex[pi]]);
+            if (val == nullptr)
+                return "no value for '" + propNames[pi] + "' at __time__=" + now;
+            std::memcpy(row + sizeof(std::int64_t) + pi * sizeof(void*), &val, sizeof(val));
+        }
+    }
+    void*   conf = frames ? confRdb->confPtr() : rdb->confPtr();
+    prepFn(states, states + 2 * stride, conf);
+    if (apEval)
+        apEval(states + stride, conf, ap);
+    return {};
+}
+
+//  Advance requirement `i` of a session by one row. It touches only that
+//  requirement's slice of the session and its own pool, so requirements
+//  can be stepped over the same row on different threads. Returns whether
+//  it failed at this row.
+bool    Stream::stepReq(Session& s, std::size_t i, RowCtx const& r, Flag const& flag)
+{
+    auto&   value    = s.value;
+    auto&   done     = s.done;
+    auto&   started  = s.started;
+    auto&   inside   = s.inside;
+    auto&   resid    = s.resid;
+    auto&   pmem     = s.pmem;
+    auto&   brBuf    = s.brBuf;
+    auto&   prevBody = s.prevBody;
+    auto&   curBody  = s.curBody;
+    bool    violated = false;
+
+    if (atomReqs[i].fold == BoundedResponse)
+    {
+        //  Record (time, a, b); the dense-time covering is folded
+        //  at end of stream, when every `a` interval and `b` gap is
+        //  known. Once failed, nothing more is needed.
+        if (done[i])    return violated;
+        auto const&     at = atomReqs[i].apAt;
+        brBuf[i].push_back({r.ts, (char)(at.empty() ? atomReqs[i].aps[0](r.curr, r.conf) : r.ap[at[0]]),
+                                (char)(at.empty() ? atomReqs[i].aps[1](r.curr, r.conf) : r.ap[at[1]])});
+        if (brCheck(s, i, r.ts, *r.text, flag))
+            violated = true;
+        return violated;
+    }
+
+    if (atomReqs[i].fold == BoundedF || atomReqs[i].fold == BoundedG)
+    {
+        //  Top-level `F[lo:hi]`/`G[lo:hi]` over the dense-time
+        //  window [t0+lo, t0+hi). Close the previous state's
+        //  segment [prevTs, ts) -- which held `prevBody[i]` -- now
+        //  that its end `ts` is known: F is met if a `true` segment
+        //  overlaps the window; G is broken if a `false` one does.
+        //  A segment [a, b) overlaps iff a < winHi and b > winLo.
+        curBody[i] = atomReqs[i].fn(r.curr, r.conf);        //  value over the NEXT segment [ts, ...)
+        if (done[i])    return violated;
+        std::int64_t    winLo = r.t0 + atomReqs[i].lo;
+        std::int64_t    winHi = r.t0 + atomReqs[i].hi;
+
+        if (!r.first && r.prevTs < winHi && r.ts > winLo)    //  previous segment overlaps the window
+        {
+            if (atomReqs[i].fold == BoundedF && prevBody[i])     { value[i] = 1; done[i] = 1; }
+            if (atomReqs[i].fold == BoundedG && !prevBody[i])
+            {
+                value[i] = 0;
+                done[i]  = 1;
+                flag(s, i, *r.prevNow, *r.prevLine);
+                violated = true;
+            }
+        }
+        //  Once we observe a state at or past the window's end, F
+        //  can no longer be met -- the window is entirely behind us.
+        if (atomReqs[i].fold == BoundedF && !done[i] && r.ts >= winHi)
+        {
+            value[i] = 0;
+            done[i]  = 1;
+            flag(s, i, *r.now, (*r.text)());
+            violated = true;
+        }
+        return violated;
+    }
+
+    if (atomReqs[i].fold == Residual)
+    {
+        //  Evaluate each past subformula once (advancing its DP
+        //  memory), then progress the residual against this state.
+        //  It settles the instant the residual folds to a constant:
+        //  TRUE is a definitive PASS, FALSE a definitive violation
+        //  (a safety breach -- G broken, until's p failed, release's
+        //  q failed). A liveness obligation never settles here; it
+        //  stays `unknown` and is closed at end of stream.
+        if (done[i])    return violated;
+
+        auto&   aps   = atomReqs[i].aps;
+        auto&   apAt  = atomReqs[i].apAt;
+        auto&   pasts = atomReqs[i].pasts;
+        auto&   pool  = *atomReqs[i].pool;
+        auto    stepAndProgress = [&]()      //  load the valuation, then progress one state
+        {
+            //  Every leaf is read up front -- the valuation keys
+            //  the transition table -- and the past machines read
+            //  their atoms from it too.
+            //  A frozen leaf has no value at a state of its own: it
+            //  is read against a capture, where a `Freeze` is met.
+            auto const& frozen = pool.freeze.frozen;
+            for (std::size_t k = 0; k < aps.size(); k++)
+                pool.leaf[k] = !frozen.empty() && frozen[k] ? 0
+                             : apAt.empty() ? aps[k](r.curr, r.conf) : r.ap[apAt[k]];
+            pool.freeze.curr = r.curr;
+            pool.freeze.conf = r.conf;
+            auto    evalAp = [&pool](int k){ return pool.leaf[k] != 0; };
+            for (std::size_t p = 0; p < pasts.size(); p++)
+                pool.leaf[pool.pastBase + p] = stepPast(pasts[p], evalAp, pmem[i], r.ts);
+            pool.pack();
+            resid[i] = progress(pool, resid[i], r.ts);
+        };
+        auto    fail = [&]()                 //  settle FAIL with a violation line
+        {
+            value[i] = 0;
+            done[i]  = 1;
+            flag(s, i, *r.now, (*r.text)());
+            violated = true;
+        };
+
+        //  Multi-interval scopes: a running AND of one residual per
+        //  interval, refreshed at each open. `between`/`after-until`
+        //  open on Q (with R absent) and close on R -- the interval
+        //  is [Q, R), so R closes it without being progressed;
+        //  `while` opens on E and closes on !E. A closed interval is
+        //  finalised strongly; a safety breach inside fails at once.
+        if (atomReqs[i].scope == ScBetween || atomReqs[i].scope == ScAfterUntil
+            || atomReqs[i].scope == ScWhile)
+        {
+            bool    a1 = atomReqs[i].scopeA(r.sfrst, r.slast, r.curr, r.conf);
+            bool    a2 = atomReqs[i].scopeB && atomReqs[i].scopeB(r.sfrst, r.slast, r.curr, r.conf);
+            bool    enter, leave;
+            if (atomReqs[i].scope == ScWhile)   { enter = !inside[i] && a1;         leave = inside[i] && !a1; }
+            else                                { enter = !inside[i] && a1 && !a2;  leave = inside[i] && a2;  }
+
+            if (leave)          //  interval closes here (this state is not in it)
+            {
+                if (!finalize(resid[i]))    fail();
+                inside[i] = 0;
+                return violated;
+            }
+            if (enter)          //  refresh, then progress this state as the interval's first
+            {
+                inside[i] = 1;
+                resid[i]  = atomReqs[i].templ;
+                pmem[i].reset(atomReqs[i].pslots, atomReqs[i].pwins);
+            }
+            if (!inside[i])     return violated;   //  between intervals
+
+            //  Progress within the interval but do not settle: a
+            //  violation is real only once the interval is closed
+            //  (finalised strongly at its R/!E above) or the stream
+            //  ends (below). An `after-until` interval left open is
+            //  excused entirely, so an in-progress breach there must
+            //  not fail early.
+            stepAndProgress();
+            return violated;
+        }
+
+        //  `before R`: the window is [frst, R). When R first holds
+        //  the window closes at (not including) this state, so the
+        //  residual is finalised over what came before -- without
+        //  progressing this state. Until then (and forever, if R
+        //  never fires) it stays open and does not settle: a pattern
+        //  violation counts only if some R later closes the scope.
+        if (atomReqs[i].scope == ScBefore
+            && atomReqs[i].scopeA(r.sfrst, r.slast, r.curr, r.conf))
+        {
+            if (finalize(resid[i]))     { value[i] = 1; done[i] = 1; }
+            else                        fail();
+            return violated;
+        }
+        //  `after Q`: dormant until Q first holds; from then it is
+        //  a plain residual over [Q, end].
+        if (atomReqs[i].scope == ScAfter && !started[i])
+        {
+            if (!atomReqs[i].scopeA(r.sfrst, r.slast, r.curr, r.conf))  return violated;
+            started[i] = 1;
+        }
+
+        stepAndProgress();
+
+        //  A `before` residual must not settle early -- a violation
+        //  is only real once an R closes the window (handled above),
+        //  and until then more states may satisfy it. Globally and
+        //  after settle the instant they fold to a constant.
+        if (atomReqs[i].scope != ScBefore)
+        {
+            if (isT(resid[i]))          { value[i] = 1; done[i] = 1; }
+            else if (isF(resid[i]))     fail();
+        }
+        return violated;
+    }
+
+    if (atomReqs[i].fold == Totals)
+    {
+        //  Opened at the first state, the totals run to here and the
+        //  requirement over them is this prefix's verdict -- flagged as
+        //  it turns false, as the prefix path would. Opened at other
+        //  states, a window is decided once a state at or past its end
+        //  arrives; a failed one settles the requirement.
+        if (done[i])    return violated;
+        auto const& q = atomReqs[i];
+        auto&       m = s.tmem[i];
+        auto const  n = q.accs.size();
+        if (q.opens == OpFirst)
+        {
+            if (!m.any)
+            {
+                m.run.assign(n, Tot{});
+                m.last.assign(n, Tot{});
+            }
+            for (std::size_t j = 0; j < n; j++)
+            {
+                auto const& a = q.accs[j];
+                auto        w = weigh(a, r.curr, r.conf);
+                if (!a.itg)
+                {
+                    if ((!a.hasLo || r.ts >= r.t0 + a.lo) && (!a.hasHi || r.ts < r.t0 + a.hi))
+                        addTot(m.run[j], w, 1);
+                    continue;
+                }
+                if (m.any)  addTot(m.run[j], m.last[j], clipped(a, r.t0, m.lastT, r.ts));
+                m.last[j] = w;
+            }
+            m.lastT = r.ts;
+            m.any   = true;
+
+            m.sums  = m.run;            //  the last state's segment, closed as the sentinel would
+            for (std::size_t j = 0; j < n; j++)
+                if (q.accs[j].itg)
+                    addTot(m.sums[j], m.last[j], clipped(q.accs[j], r.t0, r.ts, r.ts + 1));
+            bool    holds = holdsOver(q, m, r.conf);
+            if (value[i] && !holds)
+            {
+                flag(s, i, *r.now, (*r.text)());
+                violated = true;
+            }
+            value[i] = holds;
+            return violated;
+        }
+
+        m.t.push_back(r.ts);
+        m.opens.push_back(q.opens == OpEvery || q.ante(r.curr, r.conf));
+        for (std::size_t j = 0; j < n; j++)
+            m.wt.push_back(weigh(q.accs[j], r.curr, r.conf));
+        while (!m.t.empty())
+        {
+            if (m.opens.front())
+            {
+                if (r.ts < m.t.front() + q.hi)      break;      //  still open
+                windowTotals(q, m, 0, false);
+                if (!holdsOver(q, m, r.conf))
+                {
+                    value[i] = 0;
+                    done[i]  = 1;
+                    flag(s, i, *r.now, (*r.text)());
+                    m.t.clear();
+                    m.opens.clear();
+                    m.wt.clear();
+                    return true;
+                }
+            }
+            m.t.pop_front();
+            m.opens.pop_front();
+            m.wt.erase(m.wt.begin(), m.wt.begin() + n);
+        }
+        return violated;
+    }
+
+    bool    a = atomReqs[i].fn(r.curr, r.conf);
+    if (atomReqs[i].fold == FoldAll && value[i] && !a)
+    {
+        value[i] = 0;
+        flag(s, i, *r.now, (*r.text)());
+        violated = true;
+    }
+    else if (atomReqs[i].fold == FoldAny && a)
+        value[i] = 1;
+    else if (atomReqs[i].fold == FoldFirst && !done[i])
+    {
+        value[i] = a ? 1 : 0;
+        done[i]  = 1;
+        if (!a)
+        {
+            flag(s, i, *r.now, (*r.text)());
+            violated = true;
+        }
+    }
+    return violated;
+}
+
+//  The prefix path's part of a row: append it to the session's rows, re-run
+//  those requirements over them all, and report what newly failed. False
+//  (and `failed` set) if the rows could not be read.
+bool    Stream::stepPrefix(Session& s, std::function<std::string()> const& text, std::string const& now,
+                           bool& violatedNow, FrameRow* frame)
+{
+    std::unique_ptr<referee::db::Reader>    rdb;
+    try
+    {
+        if (frames)
+        {
+            s.times.push_back(frame ? frame->time : frames->time());
+            s.rows.push_back(frame ? std::move(frame->wire) : wireRow());
+            rdb = pack(s);
+        }
+        else
+        {
+            s.csv += "\n";
+            s.csv += text();
+            rdb = ingest(s.csv);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        error(e.what());
+        failed = true;
+        return false;
+    }
+
+    std::ostringstream  capture;
+    runOneTrace(js, *rdb, capture);
+    s.lastCapture = capture.str();
+    s.verdicts    = parseVerdicts(s.lastCapture);
+
+    for (auto const& [label, pass] : s.verdicts)
+    {
+        bool    was = s.prev.count(label) ? s.prev[label] : true;
+        if (!pass && was && deferred.find(label) == deferred.end())
+        {
+            violation(s, label, now, text());
+            violatedNow = true;
+        }
+        s.prev[label] = pass;
+    }
+    return true;
+}
+
+//  The reader's current state in `Loader::load` form, its recorded props in
+//  the spec's order: a row of the prefix path's trace.
+referee::db::blob_t     Stream::wireRow() const
+{
+    auto                    got = frames->blobs();
+    referee::db::blob_t     row(frameAt.size());
+    for (std::size_t ci = 0; ci < frameAt.size(); ci++)
+        row[ci] = std::move(got[frameAt[ci]]);
+    return row;
+}
+
+//  Advance one session by one row: the incremental requirements on the
+//  row alone, the prefix path on the session's rows so far, then its
+//  verdict line. `text` renders the row for a message -- only asked for
+//  when one is printed, so a binary row is never turned back into text
+//  otherwise. Returns whether something failed at this row; `failed` is
+//  set if the row could not be read at all.
+bool    Stream::step(Session& s, std::function<std::string()> const& text, std::string const& now)
+{
+    auto&   t0       = s.t0;
+    auto&   haveT0   = s.haveT0;
+    auto&   prevTs   = s.prevTs;
+    auto&   prevNow  = s.prevNow;
+    auto&   prevLine = s.prevLine;
+    auto&   prevBody = s.prevBody;
+    auto&   curBody  = s.curBody;
+
+    bool    violatedNow = false;
+    if (!atomReqs.empty())
+    {
+        std::unique_ptr<referee::db::Reader>    rdb;
+        try
+        {
+            if (!frames)
+                rdb = ingest(header + "\n" + text());
+        }
+        catch (std::exception const& e)
+        {
+            error(e.what());
+            failed = true;
+            return false;
+        }
+        if (auto bad = loadRow(rowStates.data(), computedRows, apRow.data(), rdb.get(), now); !bad.empty())
+        {
+            error(bad);
+            failed = true;
+            return false;
+        }
+
+        void*   sfrst = rowStates.data();                   //  for scope boundary columns
+        void*   slast = rowStates.data() + 2 * stride;
+        void*   curr  = rowStates.data() + stride;          //  the single real state
+        void*   conf  = frames ? confRdb->confPtr() : rdb->confPtr();
+
+        //  Absolute `__time__` of this state, read from the state buffer
+        //  itself (its first field) so it is right regardless of CSV
+        //  column order; the first state anchors every bounded window.
+        std::int64_t    ts         = *reinterpret_cast<std::int64_t const*>(curr);
+        bool            firstState = !haveT0;
+        if (firstState) { t0 = ts; haveT0 = true; }
+        if (wall && !clockSet)
+        {
+            clockAt  = std::chrono::steady_clock::now();
+            clockTs  = ts;
+            clockSet = true;
+        }
+
+        RowCtx const    ctx{sfrst, slast, curr, conf, apRow.data(), ts, t0, firstState,
+                            prevTs, &now, &prevNow, &prevLine, &text};
+        for (std::size_t i = 0; i < atomReqs.size(); i++)
+            if (stepReq(s, i, ctx, printFlag))
+                violatedNow = true;
+
+        //  Carry this state forward as the open segment for the next row.
+        prevTs   = ts;
+        prevNow  = now;
+        if (lagText)
+            prevLine = text();
+        prevBody = curBody;
+        if (wall)
+            armBounded(s);
+    }
+
+    if (!prefixReqs.empty() && !stepPrefix(s, text, now, violatedNow))
+        return false;
+    emitLine(s, now, changes);
+    return violatedNow;
+}
+
+//  Close a session: its stream has ended, so every requirement gets its
+//  finite-trace verdict, printed under `title`. Returns whether all held.
+bool    Stream::closeSession(Session& s, std::string const& title)
+{
+    auto&   value    = s.value;
+    auto&   done     = s.done;
+    auto&   started  = s.started;
+    auto&   inside   = s.inside;
+    auto&   resid    = s.resid;
+    auto&   brBuf    = s.brBuf;
+    auto&   t0       = s.t0;
+    auto&   haveT0   = s.haveT0;
+    auto&   prevTs   = s.prevTs;
+    auto&   prevBody = s.prevBody;
+    auto&   lastCapture = s.lastCapture;
+
+    //  Close the final state as a point [prevTs, prevTs]: it covers no
+    //  segment (no successor), so it satisfies a bounded window only if
+    //  its own time falls in [t0+lo, t0+hi). F left unmet -> FAIL, G left
+    //  unbroken -> PASS, both already the standing `value`.
+    if (haveT0)
+        for (std::size_t i = 0; i < atomReqs.size(); i++)
+        {
+            if ((atomReqs[i].fold != BoundedF && atomReqs[i].fold != BoundedG) || done[i])   continue;
+            std::int64_t    winLo = t0 + atomReqs[i].lo;
+            std::int64_t    winHi = t0 + atomReqs[i].hi;
+            if (winLo <= prevTs && prevTs < winHi)
+            {
+                if (atomReqs[i].fold == BoundedF &&  prevBody[i])    { value[i] = 1; done[i] = 1; }
+                if (atomReqs[i].fold == BoundedG && !prevBody[i])    { value[i] = 0; done[i] = 1; }
+            }
+        }
+
+    //  A multi-interval scope with an interval still open at end of stream:
+    //  `between`/`while` finalise it strongly (an unmet liveness fails);
+    //  `after-until` treats it leniently (R may yet have come, so an unmet
+    //  liveness is excused -- a safety breach already failed via `done`).
+    for (std::size_t i = 0; i < atomReqs.size(); i++)
+        if (atomReqs[i].fold == Residual && !done[i] && inside[i]
+            && (atomReqs[i].scope == ScBetween || atomReqs[i].scope == ScWhile)
+            && !finalize(resid[i]))
+            value[i] = 0;
+
+    //  Bounded response `G(a => F[lo:hi] b)`, the dense-time covering fold.
+    //  Every instant `a` holds needs a `b` in its `[+lo, +hi)` window. A
+    //  `b` region `[bs, be)` (a point at the last state) witnesses exactly
+    //  the anchors whose window it falls in: `t` with `t+lo < be` and
+    //  `t+hi > bs`, i.e. the open range `(bs-hi, be-lo)`. Only *observed*
+    //  `b` counts, so an anchor whose window reaches past the last state is
+    //  covered only by a `b` seen within it. The response fails iff some
+    //  `a` anchor is covered by no `b` region.
+    //  All the open/closed boundaries fall on integer times, so working in
+    //  doubled coordinates (`t -> 2t`) turns every interval into a closed
+    //  integer one: an open end `x` becomes `2x-/+1`, a closed end `2x`.
+    //  Coverage then reduces to plain integer-interval containment.
+    for (std::size_t i = 0; i < atomReqs.size(); i++)
+    {
+        if (atomReqs[i].fold != BoundedResponse || done[i])     continue;     //  failed online already
+        auto&           buf = brBuf[i];
+        if (buf.empty())    { value[i] = 1; continue; }
+        std::int64_t    lo = atomReqs[i].lo;
+        std::int64_t    hi = atomReqs[i].hi;
+
+        //  Coverage: a `b` region `[bs, be)` witnesses anchors `(bs-hi,
+        //  be-lo)` (open); a `b` *point* at the last state witnesses
+        //  `(bp-hi, bp-lo]` -- closed at the top, since a lo-offset window
+        //  can start exactly on it. Doubled and merged (adjacent ints join).
+        std::vector<std::pair<std::int64_t, std::int64_t>>  cov;
+        for (std::size_t k = 0; k < buf.size(); k++)
+            if (buf[k].b)
+            {
+                bool            last = k + 1 >= buf.size();
+                std::int64_t    bs   = buf[k].t;
+                std::int64_t    be   = last ? buf[k].t : buf[k + 1].t;
+                cov.push_back({2 * (bs - hi) + 1, 2 * (be - lo) - (last ? 0 : 1)});
+            }
+        std::sort(cov.begin(), cov.end());
+        std::vector<std::pair<std::int64_t, std::int64_t>>  merged;
+        for (auto const& c : cov)
+            if (!merged.empty() && c.first <= merged.back().second + 1)
+                merged.back().second = std::max(merged.back().second, c.second);
+            else
+                merged.push_back(c);
+
+        //  Each `a` anchor: segment `[as, ae)` (`[2as, 2ae-1]`) or the last
+        //  state as a point (`[2ap, 2ap]`). Fail if any is not contained.
+        //  `buf` is what `brCheck` kept: the anchors before `brLo` were
+        //  already found covered, by `b` samples since dropped.
+        bool    fail = false;
+        for (std::size_t m = 0; m < buf.size() && !fail; m++)
+        {
+            if (!buf[m].a)      continue;
+            bool            last = m + 1 >= buf.size();
+            std::int64_t    aL   = std::max(2 * buf[m].t, s.brLo[i]);
+            std::int64_t    aH   = last ? 2 * buf[m].t : 2 * buf[m + 1].t - 1;
+            if (aL > aH)        continue;
+            bool            in   = false;
+            for (auto const& c : merged)    if (c.first <= aL && aH <= c.second) { in = true; break; }
+            if (!in)            fail = true;
+        }
+        value[i] = fail ? 0 : 1;
+    }
+
+    //  Totals: the windows still open close with the stream, on what
+    //  arrived of them.
+    for (std::size_t i = 0; i < atomReqs.size(); i++)
+    {
+        if (atomReqs[i].fold != Totals || atomReqs[i].opens == OpFirst || done[i])   continue;
+        auto&   m = s.tmem[i];
+        for (std::size_t k = 0; k < m.t.size() && value[i]; k++)
+            if (m.opens[k])
+            {
+                windowTotals(atomReqs[i], m, k, true);
+                value[i] = holdsOver(atomReqs[i], m, confRdb->confPtr());
+            }
+    }
+
+    //  End of stream. An incremental requirement still unsettled is closed
+    //  over the empty suffix by `finalize` (G holds, F fails, weak/strong
+    //  until and release split); a settled one keeps its verdict. An open
+    //  `before R` whose R never fired, or an `after Q` whose Q never fired, is
+    //  a vacuous PASS. A multi-interval scope carries its running AND in
+    //  `value` (its open interval already applied above). On the prefix path
+    //  the last prefix is the whole trace, so every verdict there -- the
+    //  deferred liveness ones included -- is now final.
+    if (!ndjson)
+        os << title << "\n";
+    auto    closing = parseVerdicts(lastCapture);
+    bool    passed  = true;
+    auto    report  = [&](std::string const& label, bool pass, bool unmet)
+    {
+        passed = passed && pass;
+        if (ndjson)
+            event(&s, "final", [&](json::Writer& w)
+            {
+                w.key("requirement").value(label);
+                w.key("verdict").value(pass ? "PASS" : "FAIL");
+                if (unmet)
+                    w.key("unmet").value(true);
+            });
+        else if (pass)
+            os << green << "PASS" << reset << "  " << label << "\n";
+        else
+            os << red << "FAIL" << reset << "  " << yellow << label << reset
+               << (unmet ? "  (unmet at end of stream)" : "") << "\n";
+    };
+    for (auto const& label : order)
+    {
+        if (auto f = fastAt.find(label); f != fastAt.end())
+        {
+            auto    i     = f->second;
+            Scope   scp   = atomReqs[i].scope;
+            bool    multi = scp == ScBetween || scp == ScAfterUntil || scp == ScWhile;
+            bool    pass;
+            if (atomReqs[i].fold != Residual || done[i] || multi)            pass = value[i];
+            else if (scp == ScBefore)                                        pass = true;
+            else if (scp == ScAfter && !started[i])                          pass = true;
+            else                                                             pass = finalize(resid[i]);
+            report(label, pass, false);
+        }
+        else if (auto it = closing.find(label); it != closing.end())
+            report(label, it->second, deferred.count(label) != 0);
+    }
+    //  What the prefix path reported beyond the requirements -- a computed
+    //  signal that indexed out of range -- still decides the run.
+    for (auto const& [label, pass] : closing)
+        if (std::find(order.begin(), order.end(), label) == order.end())
+            report(label, pass, false);
+    if (ndjson)
+        event(&s, "end", [&](json::Writer& w) { w.key("pass").value(passed); });
+    return passed;
+}
+
+void    Stream::retire(std::string const& key)
+{
+    auto    it = sessions.find(key);
+    bool    ok = closeSession(it->second, "-- end of session " + key + " --");
+    allPass = allPass && ok;
+    closed++;
+    closedFailing += !ok;
+    lru.erase(it->second.lru);
+    sessions.erase(it);
+}
+
+//  `--checkpoint`/`--resume`: everything the open sessions carry, and the
+//  run's tallies, written every `g_monitorCheckpointEvery` rows and read
+//  back before the first row. The file opens with a hash of the spec, the
+//  conf and the recorded schema, and names the stream it was cut from --
+//  key column, framing and CSV header -- so a checkpoint is never resumed
+//  under anything it was not taken under. A residual is written as its
+//  nodes and rebuilt through its requirement's pool, interned as before.
+std::uint64_t   Stream::specHash() const
+{
+    std::vector<std::uint8_t>   schema;
+    referee::db::encodeSchema(schema, referee::db::recordedProps(js.astModule), {});
+    auto    h = fnv1a(refSrc);
+    h = fnv1a(confContents, h);
+    return fnv1a(std::string_view(reinterpret_cast<char const*>(schema.data()), schema.size()), h);
+}
+
+void    Stream::saveCheckpoint()
+{
+    CkOut   out;
+    out.bytes = "REF-CKP1";
+    out.pod<std::uint32_t>(2);          //  2: a residual's freezes, and running totals
+    out.pod<std::uint64_t>(specHash());
+    out.str(g_monitorKey);
+    out.pod<bool>(frames != nullptr);
+    out.str(header);
+    out.pod(rowsSeen);
+    out.pod(allPass);
+    out.pod<std::uint64_t>(closed);
+    out.pod<std::uint64_t>(closedFailing);
+
+    auto    saveMap = [&](std::map<std::string, bool> const& m)
+    {
+        out.pod<std::uint64_t>(m.size());
+        for (auto const& [label, pass] : m)
+        {
+            out.str(label);
+            out.pod(pass);
+        }
+    };
+    //  Oldest first, so pushing each to the front on resume rebuilds the
+    //  recency order.
+    std::vector<Session const*>     list;
+    if (!keyed)     list.push_back(&sessions.begin()->second);
+    for (auto it = lru.rbegin(); it != lru.rend(); ++it)
+        list.push_back(&sessions.at(*it));
+    out.pod<std::uint64_t>(list.size());
+    for (auto const* s : list)
+    {
+        out.str(s->key);
+        out.vec(s->value);
+        out.vec(s->done);
+        out.vec(s->started);
+        out.vec(s->inside);
+        out.vec(s->prevBody);
+        out.vec(s->curBody);
+        out.vec(s->shown);
+        for (std::size_t i = 0; i < atomReqs.size(); i++)
+        {
+            saveResid(out, s->resid[i]);
+            savePast(out, s->pmem[i]);
+            out.vec(s->brBuf[i]);
+            auto const& m = s->tmem[i];
+            out.vec(m.run);
+            out.vec(m.last);
+            out.pod(m.lastT);
+            out.pod(m.any);
+            out.vec(std::vector<std::int64_t>(m.t.begin(), m.t.end()));
+            out.vec(std::vector<char>(m.opens.begin(), m.opens.end()));
+            out.vec(std::vector<Tot>(m.wt.begin(), m.wt.end()));
+        }
+        out.vec(s->brFrom);
+        out.vec(s->brLo);
+        out.pod(s->t0);
+        out.pod(s->haveT0);
+        out.pod(s->prevTs);
+        out.pod(s->lastT);
+        out.str(s->prevNow);
+        out.str(s->prevLine);
+        out.str(s->csv);
+        {
+            std::ostringstream  rows(std::ios::binary);
+            {
+                referee::db::FrameWriter    w(rows, referee::db::recordedProps(js.astModule));
+                for (std::size_t r = 0; r < s->times.size(); r++)
+                    w.writeState(s->times[r], s->rows[r]);
+            }
+            out.pod<std::uint64_t>(s->times.size());
+            out.str(s->times.empty() ? std::string() : rows.str());
+        }
+        saveMap(s->prev);
+        saveMap(s->verdicts);
+        out.str(s->lastCapture);
+    }
+
+    //  Written aside, synced, and renamed over the old one; then the rename
+    //  itself is synced. A crash or power loss at any point leaves either
+    //  the previous checkpoint or all of this one -- never an empty file
+    //  renamed into place ahead of its data reaching the disk.
+    auto    tmp  = g_monitorCheckpoint + ".tmp";
+    auto    fail = [&](std::string const& what, std::string const& path)
+    {
+        throw std::runtime_error("monitor: cannot " + what + " checkpoint '" + path + "': " + std::strerror(errno));
+    };
+    {
+        int     fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            fail("write", tmp);
+        for (std::size_t at = 0; at < out.bytes.size(); )
+        {
+            auto    n = ::write(fd, out.bytes.data() + at, out.bytes.size() - at);
+            if (n < 0 && errno == EINTR)    continue;
+            if (n < 0)                      { ::close(fd); fail("write", tmp); }
+            at += static_cast<std::size_t>(n);
+        }
+        if (::fsync(fd) != 0)               { ::close(fd); fail("sync", tmp); }
+        ::close(fd);
+    }
+    if (::rename(tmp.c_str(), g_monitorCheckpoint.c_str()) != 0)
+        fail("rename", g_monitorCheckpoint);
+
+    auto    dir = std::filesystem::path(g_monitorCheckpoint).parent_path();
+    if (dir.empty())    dir = ".";
+    int     dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0)
+        fail("sync the directory of", g_monitorCheckpoint);
+    if (::fsync(dfd) != 0)              { ::close(dfd); fail("sync the directory of", g_monitorCheckpoint); }
+    ::close(dfd);
+}
+
+void    Stream::loadCheckpoint(std::string const& path)
+{
+    std::ifstream   f(path, std::ios::binary);
+    if (!f)
+        throw std::runtime_error("monitor: cannot open checkpoint '" + path + "'");
+    std::string     bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    CkIn            in{bytes.data(), bytes.data() + bytes.size()};
+
+    in.need(8);
+    if (std::string_view(in.cur, 8) != "REF-CKP1")
+        throw std::runtime_error("monitor: '" + path + "' is not a checkpoint");
+    in.cur += 8;
+    if (in.pod<std::uint32_t>() != 2)
+        throw std::runtime_error("monitor: checkpoint '" + path + "' has an unsupported version");
+    if (in.pod<std::uint64_t>() != specHash())
+        throw std::runtime_error("monitor: checkpoint '" + path + "' was taken under another spec, conf or schema");
+    if (in.str() != g_monitorKey)
+        throw std::runtime_error("monitor: checkpoint '" + path + "' was taken with another --key");
+    if (in.pod<bool>() != (frames != nullptr))
+        throw std::runtime_error("monitor: checkpoint '" + path + "' was taken with" + (frames ? "out" : "") + " --binary");
+    if (in.str() != header)
+        throw std::runtime_error("monitor: checkpoint '" + path + "' was taken over another CSV header");
+    rowsSeen      = in.pod<std::uint64_t>();
+    allPass       = in.pod<bool>();
+    closed        = in.pod<std::uint64_t>();
+    closedFailing = in.pod<std::uint64_t>();
+
+    auto    loadMap = [&](std::map<std::string, bool>& m)
+    {
+        m.clear();
+        for (auto n = in.pod<std::uint64_t>(); n > 0; n--)
+        {
+            auto    label = in.str();
+            m[label] = in.pod<bool>();
+        }
+    };
+    sessions.clear();
+    lru.clear();
+    for (auto n = in.pod<std::uint64_t>(); n > 0; n--)
+    {
+        auto    key = in.str();
+        Session s   = openSession(key);
+        s.value    = in.vec<char>();
+        s.done     = in.vec<char>();
+        s.started  = in.vec<char>();
+        s.inside   = in.vec<char>();
+        s.prevBody = in.vec<char>();
+        s.curBody  = in.vec<char>();
+        s.shown    = in.vec<char>();
+        if (s.value.size() != atomReqs.size() || s.shown.size() != order.size())
+            throw std::runtime_error("monitor: checkpoint '" + path + "' is malformed");
+        for (std::size_t i = 0; i < atomReqs.size(); i++)
+        {
+            s.resid[i] = loadResid(in, *atomReqs[i].pool);
+            loadPast(in, s.pmem[i]);
+            s.brBuf[i] = in.vec<Sample>();
+            auto&   m     = s.tmem[i];
+            m.run   = in.vec<Tot>();
+            m.last  = in.vec<Tot>();
+            m.lastT = in.pod<std::int64_t>();
+            m.any   = in.pod<bool>();
+            auto    t     = in.vec<std::int64_t>();
+            auto    opens = in.vec<char>();
+            auto    wt    = in.vec<Tot>();
+            auto    n     = atomReqs[i].accs.size();
+            if ((m.any && (m.run.size() != n || m.last.size() != n))
+                || opens.size() != t.size() || wt.size() != t.size() * n)
+                throw std::runtime_error("monitor: checkpoint '" + path + "' is malformed");
+            m.t.assign(t.begin(), t.end());
+            m.opens.assign(opens.begin(), opens.end());
+            m.wt.assign(wt.begin(), wt.end());
+        }
+        s.brFrom   = in.vec<std::size_t>();
+        s.brLo     = in.vec<std::int64_t>();
+        if (s.brFrom.size() != atomReqs.size() || s.brLo.size() != atomReqs.size())
+            throw std::runtime_error("monitor: checkpoint '" + path + "' is malformed");
+        for (std::size_t i = 0; i < atomReqs.size(); i++)
+            if (s.brFrom[i] > s.brBuf[i].size())
+                throw std::runtime_error("monitor: checkpoint '" + path + "' is malformed");
+        s.t0       = in.pod<std::int64_t>();
+        s.haveT0   = in.pod<bool>();
+        s.prevTs   = in.pod<std::int64_t>();
+        s.lastT    = in.pod<std::int64_t>();
+        s.prevNow  = in.str();
+        s.prevLine = in.str();
+        s.csv      = in.str();
+        auto    count = in.pod<std::uint64_t>();
+        auto    rows  = in.str();
+        if (count > 0)
+        {
+            std::istringstream          rowsIn(rows, std::ios::binary);
+            referee::db::FrameReader    r(rowsIn, path);
+            while (r.next())
+            {
+                s.times.push_back(r.time());
+                s.rows.push_back(r.blobs());
+            }
+            if (s.times.size() != count)
+                throw std::runtime_error("monitor: checkpoint '" + path + "' is malformed");
+        }
+        loadMap(s.prev);
+        loadMap(s.verdicts);
+        s.lastCapture = in.str();
+
+        auto    it = sessions.emplace(key, std::move(s)).first;
+        if (keyed)
+        {
+            lru.push_front(key);
+            it->second.lru = lru.begin();
+        }
+    }
+    if (!keyed && sessions.size() != 1)
+        throw std::runtime_error("monitor: checkpoint '" + path + "' is malformed");
+}
+
+void    Stream::checkpoint()
+{
+    rowsSeen++;
+    if (!g_monitorCheckpoint.empty() && g_monitorCheckpointEvery > 0
+        && rowsSeen % g_monitorCheckpointEvery == 0)
+        saveCheckpoint();
+}
+
+//  The wall clock read as `__time__`: from the Unix epoch, or -- `first` --
+//  from the first row, whose `__time__` is taken to be the moment it was
+//  read. None before that first row. A row stamped earlier than the clock
+//  already reads is late: what fired before it arrived stands.
+std::optional<std::int64_t> Stream::clockNow() const
+{
+    using namespace std::chrono;
+    if (g_monitorClockEpoch == "unix")
+        return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count() / g_monitorClockUnit;
+    if (!clockSet)
+        return std::nullopt;
+    return clockTs + duration_cast<nanoseconds>(steady_clock::now() - clockAt).count() / g_monitorClockUnit;
+}
+
+std::chrono::steady_clock::time_point   Stream::wallAt(std::int64_t t) const
+{
+    auto    now = clockNow();
+    return std::chrono::steady_clock::now()
+         + std::chrono::nanoseconds((t - *now) * g_monitorClockUnit);
+}
+
+//  A fired deadline. The session's last row has held since it was read, so
+//  its open segment `[prevTs, now)` carries `prevBody` up to the clock.
+bool    Stream::fire(TimerWheel::Timer const& t, std::int64_t now)
+{
+    auto    it = sessions.find(t.key);
+    if (it == sessions.end())   return false;
+    auto&   s = it->second;
+    auto    i = t.req;
+    if (s.done[i] || s.armedAt[i] != t.at)  return false;
+    s.armedAt[i] = kUnarmed;
+
+    bool    violated = false;
+    if (atomReqs[i].fold == BoundedResponse)
+        violated = brCheck(s, i, now, [&] { return s.prevLine; }, printFlag);
+    else
+    {
+        bool            isF      = atomReqs[i].fold == BoundedF;
+        std::int64_t    winLo    = s.t0 + atomReqs[i].lo;
+        std::int64_t    winHi    = s.t0 + atomReqs[i].hi;
+        bool            decisive = isF == (s.prevBody[i] != 0);
+        if (decisive && s.prevTs < winHi && now > std::max(s.prevTs, winLo))
+        {
+            s.value[i] = isF;
+            s.done[i]  = 1;
+            if (!isF)
+                violation(s, atomReqs[i].label, s.prevNow, s.prevLine);
+            violated = !isF;
+        }
+        else if (now >= winHi)
+        {
+            s.value[i] = !isF;
+            s.done[i]  = 1;
+            if (isF)
+                violation(s, atomReqs[i].label, std::to_string(winHi), s.prevLine);
+            violated = isF;
+        }
+        else
+            armBounded(s);
+    }
+    if (s.done[i])
+        emitLine(s, std::to_string(now), true);
+    return violated;
+}
+
+//  `--latency`: each row's time from being read to its verdict line, and
+//  the run's rows per second, reported once the stream has ended.
+void    Stream::reportLatency()
+{
+    if (!g_monitorLatency)  return;
+    auto    secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    auto    rate = secs > 0 ? static_cast<std::uint64_t>(latency.count() / secs) : latency.count();
+    auto    us   = [](std::int64_t ns) { return ns / 1000; };
+    if (ndjson)
+        event(nullptr, "latency", [&](json::Writer& w)
+        {
+            w.key("rows").value(latency.count());
+            w.key("p50_us").value(us(latency.quantile(0.50)));
+            w.key("p99_us").value(us(latency.quantile(0.99)));
+            w.key("max_us").value(us(latency.max()));
+            w.key("rows_per_s").value(rate);
+        });
+    else
+        os << "-- latency: " << latency.count() << " rows, p50 " << us(latency.quantile(0.50))
+           << "us, p99 " << us(latency.quantile(0.99)) << "us, max " << us(latency.max())
+           << "us, " << rate << " rows/s --\n";
+}
+
+void    Stream::timed()
+{
+    if (g_monitorLatency)
+        latency.add(std::chrono::steady_clock::now() - readAt);
+}
+
+void    Stream::interruptInput()
+{
+    if (auto* live = dynamic_cast<referee::db::LiveBuf*>(states.rdbuf()))
+        live->interrupt();
+}
+
+//  The next row (CSV into `line`, binary into `frames`); false at end of
+//  input. On the wall clock, the wait for it is cut into the wheel's
+//  ticks, firing what falls due in each; a deadline that fires a
+//  violation under `--stop-at-first` ends the run (`halted`). With
+//  `--flush-ms`, it is cut where held output falls due as well.
+bool    Stream::fetch(std::string& line)
+{
+    if (!feed)
+        return frames ? frames->next() : static_cast<bool>(std::getline(states, line));
+    for (;;)
+    {
+        auto    now = wall ? clockNow() : std::nullopt;
+        if (now)
+        {
+            bool    violated = false;
+            wheel.advance(*now, [&](TimerWheel::Timer const& t) { violated = fire(t, *now) || violated; });
+            if (violated && stopAtFirst)    { halted = true; return false; }
+        }
+        if (held || now)
+            flush();
+        auto    until = now && !wheel.empty() ? wallAt(wheel.nextTick())
+                                              : std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        if (held)
+            until = std::min(until, flushBy());
+        bool    more  = false;
+        if (feed->wait(until, more))
+        {
+            if (more && !frames)    line = feed->line();
+            return more;
+        }
+    }
+}
+
+//  `--threads`: `serial`, pipelined. An ingest thread takes each row
+//  from a reader (a `TimedFeed`, so it can be stopped on a quiet stream),
+//  ingests it into the next slot of a ring of row windows -- a binary
+//  frame is not ingested at all, but detached from the frame reader into
+//  the slot as it is -- and runs `__prepare__`/`__ap__eval__` there; each evaluator steps a contiguous
+//  share of the incremental requirements over every slot in turn; and this
+//  thread, the reporter, takes a row once every evaluator is past it --
+//  its violations in requirement order, the prefix path, the verdict line
+//  -- and frees the slot. Each stage publishes the rows it has finished on
+//  a cursor only it writes, so a hand-off is an atomic add, and a stage
+//  that finds several rows ready takes them as one batch. A slot carries
+//  its own copy of what the session held from the row before, so an
+//  evaluator never reads a session field another stage writes.
+bool    Stream::pipelined()
+{
+    if (keyed || wall || !g_monitorCheckpoint.empty())
+        throw std::runtime_error("monitor: --threads pipelines one stream on the stream clock;"
+                                 " it does not combine with --key, --clock wall or --checkpoint");
+
+    auto&                   s      = sessions.begin()->second;
+    std::size_t const       nReq   = atomReqs.size();
+    std::size_t const       nShard = std::max<std::size_t>(1, std::min<std::size_t>(g_monitorThreads, nReq));
+    constexpr std::size_t   kRing  = 256;
+    constexpr std::size_t   kBatch = 64;
+
+    struct  Flagged
+    {
+        std::size_t     i;
+        std::string     when, row;
+    };
+    struct  Slot
+    {
+        std::string                             line, now, prevNow, prevLine, error;
+        std::unique_ptr<referee::db::Reader>    rdb;        //  CSV: the row ingested ...
+        FrameRow                                frame;      //  ... binary: the frame detached
+        std::vector<std::uint8_t>               states, ap;
+        std::vector<std::vector<std::uint8_t>>  computed;
+        std::int64_t                            ts = 0, t0 = 0, prevTs = 0;
+        bool                                    first = false, end = false;
+        std::chrono::steady_clock::time_point   readAt;
+        std::vector<std::vector<Flagged>>       flags;      //  per evaluator
+        std::vector<char>                       verdict;    //  per incremental requirement
+    };
+    std::vector<Slot>   ring(kRing);
+    for (auto& sl : ring)
+    {
+        sl.states.assign(3 * stride, 0);
+        sl.computed = computedRows;
+        sl.ap.assign(apRow.size(), 0);
+        sl.flags.resize(nShard);
+        sl.verdict.assign(nReq, '?');
+    }
+
+    //  A stage's cursor: how many rows it has finished. The top bit is the
+    //  stop signal, set on every cursor at once, so that whatever a stage
+    //  is waiting on, it wakes.
+    constexpr std::uint64_t     kStop = std::uint64_t(1) << 63;
+    struct alignas(64) Cursor { std::atomic<std::uint64_t> n{0}; };
+    Cursor                      ingested, reported;
+    std::vector<Cursor>         evaluated(nShard);
+    auto    publish = [](Cursor& c, std::uint64_t rows)
+    {
+        c.n.fetch_add(rows, std::memory_order_release);
+        c.n.notify_all();
+    };
+    auto    halt = [&]()
+    {
+        for (auto* c : {&ingested, &reported})
+        {
+            c->n.fetch_or(kStop);
+            c->n.notify_all();
+        }
+        for (auto& c : evaluated)
+        {
+            c.n.fetch_or(kStop);
+            c.n.notify_all();
+        }
+    };
+    //  Wait until `c` has finished row `r`, or is stopped: spin briefly --
+    //  a busy stream hands on faster than a sleep and wake -- then block.
+    auto    await = [&](Cursor& c, std::uint64_t r)
+    {
+        for (int spin = 0; ; spin++)
+        {
+            auto    v = c.n.load(std::memory_order_acquire);
+            if ((v & kStop) || v > r)   return v;
+            if (spin >= 128)
+                c.n.wait(v, std::memory_order_acquire);
+        }
+    };
+    std::mutex          thrownMutex;
+    std::exception_ptr  thrown;
+    auto    fail = [&](std::exception_ptr e)
+    {
+        {
+            std::lock_guard<std::mutex>     lock(thrownMutex);
+            if (!thrown)    thrown = e;
+        }
+        halt();
+    };
+
+    //  A binary row is rendered only when a message needs it, or when the
+    //  next row's may (`lagText`), as the serial step does.
+    auto    rowText = [this](Slot const& sl)
+    {
+        return frames && sl.line.empty() ? frames->text(sl.frame.time, sl.frame.ptrs) : sl.line;
+    };
+    void*   frameConf = frames ? confRdb->confPtr() : nullptr;
+
+    std::function<bool(std::string&)>   read;
+    if (frames)     read = [this](std::string&) { return frames->next(); };
+    else            read = [this](std::string& l) { return static_cast<bool>(std::getline(states, l)); };
+    TimedFeed   reader(std::move(read), [this] { interruptInput(); });
+    std::thread ingester([&]()
+    {
+        try
+        {
+            std::int64_t    t0      = s.t0;
+            bool            haveT0  = s.haveT0;
+            std::int64_t    prevTs  = s.prevTs;
+            std::string     prevNow = s.prevNow, prevLine = s.prevLine;
+            for (std::uint64_t r = 0; ; r++)
+            {
+                if (r >= kRing && (await(reported, r - kRing) & kStop))    return;
+                auto&   sl   = ring[r % kRing];
+                bool    more = false;
+                for (;;)        //  the next non-empty row, looking up for a stop while none comes
+                {
+                    if (ingested.n.load(std::memory_order_relaxed) & kStop)    return;
+                    if (!reader.wait(std::chrono::steady_clock::now() + std::chrono::milliseconds(50), more))
+                        continue;
+                    if (!more || frames || !reader.line().empty())  break;
+                }
+
+                sl.end = !more;
+                sl.error.clear();
+                if (more && frames)
+                {
+                    //  The reader is parked until the next `wait`, so its
+                    //  state is this row's until then.
+                    sl.readAt     = std::chrono::steady_clock::now();
+                    sl.frame.time = frames->time();
+                    sl.now        = std::to_string(sl.frame.time);
+                    sl.line       = lagText ? frames->text() : std::string();
+                    if (!prefixReqs.empty())
+                        sl.frame.wire = wireRow();
+                    frames->detach(sl.frame.row, sl.frame.ptrs);
+                }
+                else if (more)
+                {
+                    sl.readAt = std::chrono::steady_clock::now();
+                    sl.line   = reader.line();
+                    auto    comma = sl.line.find(',');
+                    sl.now    = comma == std::string::npos ? sl.line : sl.line.substr(0, comma);
+                }
+                if (more && nReq > 0)
+                {
+                    try
+                    {
+                        if (!frames)
+                            sl.rdb = ingest(header + "\n" + sl.line);
+                        sl.error = loadRow(sl.states.data(), sl.computed, sl.ap.data(), sl.rdb.get(), sl.now,
+                                           frames ? &sl.frame : nullptr);
+                    }
+                    catch (std::exception const& e)
+                    {
+                        sl.error = e.what();
+                    }
+                    sl.ts     = *reinterpret_cast<std::int64_t const*>(sl.states.data() + stride);
+                    sl.first  = !haveT0;
+                    if (sl.first)   { t0 = sl.ts; haveT0 = true; }
+                    sl.t0       = t0;
+                    sl.prevTs   = prevTs;
+                    sl.prevNow  = prevNow;
+                    sl.prevLine = prevLine;
+                    prevTs      = sl.ts;
+                    prevNow     = sl.now;
+                    if (lagText)
+                        prevLine = sl.line;
+                }
+                publish(ingested, 1);
+                if (sl.end || !sl.error.empty())    return;
+            }
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+    });
+
+    std::vector<std::thread>    evaluators;
+    for (std::size_t k = 0; k < nShard; k++)
+        evaluators.emplace_back([&, k]()
+        {
+            try
+            {
+                std::size_t const   lo = nReq * k / nShard;
+                std::size_t const   hi = nReq * (k + 1) / nShard;
+                for (std::uint64_t r = 0; ; )
+                {
+                    auto    ready = await(ingested, r);
+                    if (ready & kStop)      return;
+                    auto    from  = r;
+                    bool    last  = false;
+                    for (auto upTo = std::min<std::uint64_t>(ready, r + kBatch); r < upTo && !last; r++)
+                    {
+                        auto&   sl = ring[r % kRing];
+                        last = sl.end || !sl.error.empty();
+                        if (last || lo == hi)   continue;
+
+                        std::function<std::string()>    text = [&] { return rowText(sl); };
+                        RowCtx const    ctx{sl.states.data(), sl.states.data() + 2 * stride,
+                                            sl.states.data() + stride, frames ? frameConf : sl.rdb->confPtr(),
+                                            sl.ap.data(),
+                                            sl.ts, sl.t0, sl.first, sl.prevTs,
+                                            &sl.now, &sl.prevNow, &sl.prevLine, &text};
+                        auto&           flags = sl.flags[k];
+                        Flag const      keep  = [&flags](Session const&, std::size_t i,
+                                                         std::string const& when, std::string const& row)
+                        {
+                            flags.push_back({i, when, row});
+                        };
+                        flags.clear();
+                        for (std::size_t i = lo; i < hi; i++)
+                        {
+                            stepReq(s, i, ctx, keep);
+                            s.prevBody[i] = s.curBody[i];
+                            sl.verdict[i] = fastVerdict(s, i);
+                        }
+                    }
+                    publish(evaluated[k], r - from);
+                    if (last)               return;
+                }
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+        });
+
+    //  The reporter's wait. With output held (`--flush-ms`) it looks in
+    //  short sleeps rather than blocking, so what it holds is flushed on
+    //  time even while no row comes.
+    auto    awaitReport = [&](Cursor& c, std::uint64_t r)
+    {
+        while (held)
+        {
+            auto    v = c.n.load(std::memory_order_acquire);
+            if ((v & kStop) || v > r)   return v;
+            flush();
+            if (held)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return await(c, r);
+    };
+
+    bool    ended = false;
+    try
+    {
+        for (std::uint64_t r = 0; ; r++)
+        {
+            bool    stopped = false;
+            for (auto& c : evaluated)
+                stopped = (awaitReport(c, r) & kStop) || stopped;
+            if (stopped)    break;
+
+            auto&   sl = ring[r % kRing];
+            if (sl.end)     { ended = true; break; }
+            if (!sl.error.empty())
+            {
+                error(sl.error);
+                break;
+            }
+
+            bool    violatedNow = false;
+            for (auto const& flags : sl.flags)
+                for (auto const& f : flags)
+                {
+                    violation(s, atomReqs[f.i].label, f.when, f.row);
+                    violatedNow = true;
+                }
+            std::function<std::string()>    text = [&] { return rowText(sl); };
+            if (!prefixReqs.empty() && !stepPrefix(s, text, sl.now, violatedNow, frames ? &sl.frame : nullptr))
+                break;
+            emitLine(s, sl.now, changes, sl.verdict.data());
+
+            if (nReq > 0)
+            {
+                if (sl.first)   { s.t0 = sl.ts; s.haveT0 = true; }
+                s.prevTs  = sl.ts;
+                s.prevNow = sl.now;
+                if (lagText)
+                    s.prevLine = sl.line;
+            }
+            if (g_monitorLatency)
+                latency.add(std::chrono::steady_clock::now() - sl.readAt);
+            publish(reported, 1);
+            if (stopAtFirst && violatedNow)     break;
+        }
+    }
+    catch (...)
+    {
+        fail(std::current_exception());
+    }
+    halt();
+    ingester.join();
+    for (auto& t : evaluators)
+        t.join();
+    if (thrown)
+        std::rethrow_exception(thrown);
+    if (!ended)     return false;
+
+    bool    pass = closeSession(s, "-- end of stream --");
+    reportLatency();
+    return pass;
+}
+
+bool    Stream::serial()
+{
+    std::string     line;
+    if (frames)
+    {
+        auto&   s = sessions.begin()->second;   //  after a resume, the restored one
+        for (;;)
+        {
+            try
+            {
+                if (!fetch(line))       break;
+            }
+            catch (std::exception const& e)
+            {
+                error(e.what());
+                return false;
+            }
+            if (g_monitorLatency)
+                readAt = std::chrono::steady_clock::now();
+
+            bool    violatedNow = step(s, [&] { return frames->text(); }, std::to_string(frames->time()));
+            if (failed)                         return false;
+            if (stopAtFirst && violatedNow)     return false;
+            checkpoint();
+            timed();
+        }
+        if (halted)     return false;
+        bool    pass = closeSession(s, "-- end of stream --");
+        reportLatency();
+        return pass;
+    }
+
+    while (fetch(line))
+    {
+        if (line.empty())   continue;
+        if (g_monitorLatency)
+            readAt = std::chrono::steady_clock::now();
+
+        auto        comma = line.find(',');
+        std::string now   = comma == std::string::npos ? line : line.substr(0, comma);
+
+        Session*    s = nullptr;
+        if (!keyed)
+            s = &sessions.begin()->second;
+        else
+        {
+            //  Quote-aware, as the loader is: a quoted cell ahead of either
+            //  column may hold a comma.
+            auto            cells = referee::db::splitCells(line);
+            std::string     key   = keyAt  < cells.size() ? cells[keyAt]  : std::string();
+            now                   = timeAt < cells.size() ? cells[timeAt] : std::string();
+            std::int64_t    t     = 0;
+            //  The idle clock runs on this, so a bad one cannot stand in as 0:
+            //  its session would look long idle to the very next row.
+            try { t = std::stoll(now); }
+            catch (...)
+            {
+                error("unparseable __time__ '" + now + "' in: " + line);
+                return false;
+            }
+
+            //  Rows arrive in time order, so the least recently seen session
+            //  is also the longest idle: retire from the back until one is not.
+            if (g_monitorIdle > 0)
+                while (!lru.empty() && lru.back() != key && sessions.at(lru.back()).lastT + g_monitorIdle < t)
+                    retire(lru.back());
+
+            auto    it = sessions.find(key);
+            if (it == sessions.end())
+            {
+                if (g_monitorMaxKeys > 0 && sessions.size() >= g_monitorMaxKeys)
+                    retire(lru.back());
+                it = sessions.emplace(key, openSession(key)).first;
+                lru.push_front(key);
+                it->second.lru = lru.begin();
+            }
+            else
+                lru.splice(lru.begin(), lru, it->second.lru);
+            it->second.lastT = t;
+            s = &it->second;
+        }
+
+        bool    violatedNow = step(*s, [&] { return line; }, now);
+        if (failed)                         return false;
+        if (stopAtFirst && violatedNow)     return false;
+        checkpoint();
+        timed();
+    }
+    if (halted)     return false;
+
+    if (!keyed)
+    {
+        bool    pass = closeSession(sessions.begin()->second, "-- end of stream --");
+        reportLatency();
+        return pass;
+    }
+
+    //  The sessions still open end with the stream, oldest first.
+    while (!lru.empty())
+        retire(lru.back());
+    if (ndjson)
+        event(nullptr, "summary", [&](json::Writer& w)
+        {
+            w.key("sessions").value(static_cast<std::uint64_t>(closed));
+            w.key("failed").value(static_cast<std::uint64_t>(closedFailing));
+        });
+    else
+        os << "-- end of stream: " << closed << " sessions, " << closedFailing << " failed --\n";
+    reportLatency();
+    return allPass;
+}
+} // namespace
+
+Monitor::Monitor(std::istream& refStream, std::string const& refName,
+                 std::string const& confPath,
+                 std::vector<std::string> const& includePaths)
+: m_spec(std::make_unique<MonitorSpec>(refStream, refName, confPath, includePaths))
+{}
+
+Monitor::~Monitor() = default;
+
+bool    Monitor::run(std::istream& states, std::ostream& os, bool stopAtFirst)
+{
+    //  The module's arena, current again as it was while classifying: a run
+    //  must not intern AST nodes into the process-global bucket either.
+    Arena::Scope    arenaScope(m_spec->js.astOwner->arena);
+    Stream          stream(*m_spec, states, os, stopAtFirst);
+    return stream.run();
+}
+
+Monitor::Table  Monitor::table(std::string const& label) const
+{
+    for (auto const& r : m_spec->atomReqs)
+        if (r.label == label && r.pool)
+            return {r.pool->nodes.size(), r.pool->next.size()};
+    return {};
+}
+
+std::map<std::string, std::string>  Monitor::lanes() const
+{
+    std::map<std::string, std::string>  out;
+    for (auto const& label : m_spec->prefixReqs)
+        out[label] = "prefix";
+    for (auto const& r : m_spec->atomReqs)
+        out[r.label] = r.fold == Residual                           ? "residual"
+                     : r.fold == Totals                             ? "total"
+                     : r.fold == BoundedResponse                    ? "response"
+                     : r.fold == BoundedF || r.fold == BoundedG     ? "deadline"
+                     :                                                "latch";
+    return out;
+}
+
+bool    Referee::monitor(std::istream& refStream, std::string refName,
+                         std::istream& states, std::string const& confPath,
+                         std::ostream& os, bool stopAtFirst,
+                         std::vector<std::string> const& includePaths)
+{
+    Monitor     monitor(refStream, refName, confPath, includePaths);
+    return monitor.run(states, os, stopAtFirst);
+}
@@ -0,0 +1,76 @@
+/*
+ *  MIT License
+ *  
+ *  Copyright (c) 2022-2026 Michael Rolnik
+ *  
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct MonitorSpec;     // monitor.cpp
+
+/// `referee monitor`'s engine: a specification compiled once, its requirements
+/// sorted into the incremental evaluators that can carry them and the prefix
+/// path that carries the rest, then run over any number of state streams.
+/// `Referee::monitor` is one of these run once; the process-wide
+/// `Referee::monitor*` settings apply to every run.
+class Monitor
+{
+public:
+    /// Compile `refStream` and classify its requirements. `confPath` is the
+    /// conf every stream is checked under; empty for none.
+    Monitor(std::istream& refStream, std::string const& refName,
+            std::string const& confPath,
+            std::vector<std::string> const& includePaths = {});
+    ~Monitor();
+
+    Monitor(Monitor const&)             = delete;
+    Monitor&    operator=(Monitor const&) = delete;
+
+    /// Check one stream of `states`, reporting to `os` as `Referee::monitor`
+    /// does: serially, or pipelined when `Referee::monitorThreads` asks for
+    /// it. True if every requirement held.
+    bool    run(std::istream& states, std::ostream& os, bool stopAtFirst = false);
+
+    /// A residual requirement's hash-consed table as runs so far have left
+    /// it: the residuals interned and the transitions learned between them.
+    /// Zero for a label not carried as a residual.
+    struct  Table
+    {
+        std::size_t nodes = 0;
+        std::size_t steps = 0;
+    };
+    Table   table(std::string const& label) const;
+
+    /// The evaluator each requirement was sorted into, by label: `latch` (a
+    /// single-state fold), `deadline` (a top-level bounded `F`/`G`), `response`
+    /// (`G(a => F[lo:hi] b)`), `residual` (progression), `total` (running
+    /// `Sum`/`Cnt`/`Itg` totals), or `prefix` (re-run over the stream so far).
+    std::map<std::string, std::string>  lanes() const;
+
+private:
+    std::unique_ptr<MonitorSpec>    m_spec;
+};
@@ -23,6 +23,7 @@
  */
 
 #include "referee.hpp"
+#include "jit.hpp"
 #include "core/factory.hpp"
 #include "core/json.hpp"
 #include "core/colormod.hpp"
@@ -30,11 +31,23 @@
 
 #include <fmt/format.h>
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <cstring>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <set>
+#include <thread>
+#include <unordered_map>
 #include <iostream>
 
 #include "antlr4-runtime/antlr4-runtime.h"
@@ -83,6 +96,7 @@
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include <dlfcn.h>
+#include <unistd.h>
 #include <filesystem>
 #include "llvm/ExecutionEngine/Orc/Shared/ExecutorSymbolDef.h"
 #include "llvm/ExecutionEngine/Orc/Shared/ExecutorAddress.h"
@@ -91,6 +105,9 @@
 #endif
 #include "rdb/database.hpp"
 #include "rdb/ingest.hpp"
+#include "rdb/merge.hpp"
+#include "runtime/columns.hpp"
+#include "runtime/scan.hpp"
 
 namespace {
 bool isMinMaxIntrinsic(llvm::Intrinsic::ID id)
@@ -177,12 +194,14 @@ static void debugCallback(int64_t value)
     std::cerr << value << "\n";
 }
 
-// Run the standard LLVM new-PM per-module O2 pipeline on `M`. This subsumes
-// the InstCombine/Reassociate/GVN/SimplifyCFG/LoopDataPrefetch sequence the
-// legacy FunctionPassManager used to run, and additionally schedules the
-// loop-level transforms (rotate, LICM, indvar-simplify, unroll, distribute,
-// vectorize, …) with the analyses they actually require.
-static void optimizeModuleO2(llvm::Module& M)
+// Run the standard LLVM new-PM per-module pipeline at `level` on `M`. At O2
+// this subsumes the InstCombine/Reassociate/GVN/SimplifyCFG/LoopDataPrefetch
+// sequence the legacy FunctionPassManager used to run, and additionally
+// schedules the loop-level transforms (rotate, LICM, indvar-simplify, unroll,
+// distribute, vectorize, …) with the analyses they actually require. At O0
+// it is the always-inliner and nothing else: the IR goes to the instruction
+// selector as Compile::make wrote it.
+static void optimizeModule(llvm::Module& M, int level)
 {
     llvm::PassBuilder               PB;
     llvm::LoopAnalysisManager       LAM;
@@ -196,10 +215,63 @@ static void optimizeModuleO2(llvm::Module& M)
     PB.registerLoopAnalyses(LAM);
     PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
-    auto    MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
+    auto    MPM = level <= 0 ? PB.buildO0DefaultPipeline(llvm::OptimizationLevel::O0)
+                : level == 1 ? PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O1)
+                : level == 2 ? PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2)
+                :              PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
     MPM.run(M, MAM);
 }
 
+//  The instruction selector's effort to go with an IR pipeline: at O0 that is
+//  FastISel and the fast register allocator, which is most of what makes a
+//  small check start quickly -- the O2 pipeline is only half of the bill.
+static llvm::CodeGenOptLevel    codeGenLevel(int level)
+{
+    switch (level)
+    {
+    case 0:     return llvm::CodeGenOptLevel::None;
+    case 1:     return llvm::CodeGenOptLevel::Less;
+    case 2:     return llvm::CodeGenOptLevel::Default;
+    default:    return llvm::CodeGenOptLevel::Aggressive;
+    }
+}
+
+//  `--opt`: a fixed pipeline, or -1 for `auto`, which chooses per compilation
+//  from how many states the result is about to be run over.
+int     g_optLevel  = -1;
+
+//  Where `auto` stops skipping the optimiser. Compiling at O2 rather than O0
+//  costs a fixed hundred-odd milliseconds for a specification of a few dozen
+//  requirements; the O2 code then wins back about a microsecond a state. The
+//  two meet near a hundred thousand states: below that the trace is over
+//  before the optimised code has paid for itself. Measured with
+//  tools/opt_crossover.py -- rerun it when the code generator changes enough
+//  to move the balance, and keep these figures in step with the constant.
+constexpr std::size_t   kOptCrossover   = 100000;
+
+//  `--specialize-conf`: compile a module per distinct conf, with the conf
+//  baked in as constants, rather than one module that reads it per state.
+bool    g_specializeConf    = false;
+
+//  `execute --from/--to`: the window of each `.rdb` trace that is checked.
+bool            g_windowed      = false;
+std::int64_t    g_windowFrom    = 0;
+std::int64_t    g_windowTo      = 0;
+
+//  `execute --only`: the requirements checked, by label. Empty is all of them.
+std::set<std::string>   g_only;
+
+//  `execute --corpus`: the members of the open `.rdbx` files, by the trace
+//  path `Referee::corpus` gave each -- `<corpus>(<member>)`, as `ar` names
+//  the member of an archive.
+std::map<std::string, std::pair<std::shared_ptr<referee::db::Corpus>, std::size_t>>
+                        g_corpusMembers;
+
+//  `execute --attach`: the shared traces mapped here, by the trace path
+//  `Referee::attach` gave each -- `shm:<name>`.
+std::map<std::string, std::shared_ptr<referee::db::SharedTrace>>
+                        g_attached;
+
 } // anonymous namespace
 
 // ── Compiled lifetime helpers ──────────────────────────────────────────────
@@ -215,7 +287,9 @@ Referee::Compiled   Referee::compile(std::istream& is, std::string name,
                                      llvm::DataLayout const* dataLayout,
                                      std::vector<std::string> const& includePaths,
                                      Sizes const& sizes,
-                                     bool embedSchema)
+                                     bool embedSchema,
+                                     int optLevel,
+                                     std::vector<std::uint8_t> const* conf)
 {
     Compiled    out;
 
@@ -309,9 +383,9 @@ Referee::Compiled   Referee::compile(std::istream& is, std::string name,
         referee::db::encodeSchema(schema, props, confs);
     }
 
-    Compile::make(out.ctx.get(), out.mod.get(), out.ast, embedSchema ? &schema : nullptr);
+    Compile::make(out.ctx.get(), out.mod.get(), out.ast, embedSchema ? &schema : nullptr, conf);
 
-    optimizeModuleO2(*out.mod);
+    optimizeModule(*out.mod, optLevel);
 
     // Lower min/max intrinsics after optimization so that any new ones
     // introduced by the optimizer (e.g. via SCEV/IndVarSimplify) are also
@@ -1791,18 +1865,7 @@ bool            __ref_str_starts(char const* s, char const* p);
 bool            __ref_str_ends(char const* s, char const* p);
 std::int64_t    __ref_str_find(char const* s, char const* p);
 } // extern "C"
-
-// JIT setup shared by execute() / executeRdb(): create LLJIT, compile the
-// .ref pinned to the JIT's data layout, expose process symbols, register
-// the host `debug(int64)` callback, add the IR module, and collect the
-// requirement function names sorted by source position.
-struct JitWithSpecs
-{
-    std::unique_ptr<llvm::orc::LLJIT>       jit;
-    std::vector<std::string>                funcNames;
-    std::unique_ptr<Antlr2AST>              astOwner;
-    ::Module*                               astModule = nullptr;
-};
+} // namespace
 
 //  Bind every `func` the specification declared to a symbol in one of the
 //  objects on the -L path. The symbol carries a `referee_` prefix, so only
@@ -1978,7 +2041,9 @@ static void     bindExternalFunctions(llvm::orc::LLJIT&               jit,
 JitWithSpecs    buildJitFromRef(std::istream& refStream, std::string const& refName,
                                 std::vector<std::string> const& includePaths,
                                 Referee::Sizes const& sizes,
-                                std::vector<std::string> const& libraryPaths = {})
+                                std::vector<std::string> const& libraryPaths,
+                                std::size_t states,
+                                std::vector<std::uint8_t> const* conf)
 {
     JitWithSpecs    out;
 
@@ -1986,7 +2051,17 @@ JitWithSpecs    buildJitFromRef(std::istream& refStream, std::string const& refN
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetAsmParser();
 
-    auto JITOrErr = llvm::orc::LLJITBuilder().create();
+    //  One tier for both halves: an O0 module handed to an O2 instruction
+    //  selector, or the reverse, pays for the slow half and gets little.
+    auto    level   = Referee::optLevelFor(states);
+    auto    JTMB    = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!JTMB)
+        throw std::runtime_error("Failed to detect the host target");
+    JTMB->setCodeGenOptLevel(codeGenLevel(level));
+
+    auto JITOrErr = llvm::orc::LLJITBuilder()
+                        .setJITTargetMachineBuilder(std::move(*JTMB))
+                        .create();
     if (!JITOrErr)
         throw std::runtime_error("Failed to create LLJIT");
     out.jit = std::move(*JITOrErr);
@@ -2020,12 +2095,23 @@ JitWithSpecs    buildJitFromRef(std::istream& refStream, std::string const& refN
         host("__ref_str_starts", &__ref_str_starts);
         host("__ref_str_ends",   &__ref_str_ends);
         host("__ref_str_find",   &__ref_str_find);
+
+        //  Trace-length columns (runtime/columns.hpp): every unbounded
+        //  recurrence takes its buffer from here rather than the stack.
+        host("__ref_column",         &__ref_column);
+        host("__ref_column_mark",    &__ref_column_mark);
+        host("__ref_column_release", &__ref_column_release);
+
+        //  ...and are walked through the block scheduler (runtime/scan.hpp),
+        //  which is what splits one trace across `--threads` workers.
+        host("__ref_scan",           &__ref_scan);
         if (auto Err = out.jit->getMainJITDylib().define(
                 llvm::orc::absoluteSymbols(std::move(symMap))))
             throw std::runtime_error("Failed to define debug symbol");
     }
 
-    auto    built = Referee::compile(refStream, refName, &out.jit->getDataLayout(), includePaths, sizes);
+    auto    built = Referee::compile(refStream, refName, &out.jit->getDataLayout(), includePaths, sizes,
+                                 /*embedSchema*/ false, level, conf);
     out.astOwner  = std::move(built.astOwner);
     out.astModule = built.ast;
 
@@ -2052,8 +2138,10 @@ JitWithSpecs    buildJitFromRef(std::istream& refStream, std::string const& refN
         if (name.rfind("__ante__", 0) == 0) continue;
         if (name.rfind("__atom__", 0) == 0) continue;   // single-state companion, not a requirement
         if (name.rfind("__ap__", 0) == 0) continue;     // progression atomic-proposition companion
+        if (name.rfind("__acc__", 0) == 0) continue;    // running-totals companion
         if (name.rfind("__sub__", 0) == 0) continue;
         if (name.rfind("__scope", 0) == 0) continue;
+        if (name.rfind("__scan__", 0) == 0) continue;   // block kernel of a pass (runtime/scan.hpp)
         if (name == "referee_module") continue;
 
         auto        head = name.substr(0, name.find(" .. "));   // "[file:]row:col"
@@ -2093,13 +2181,24 @@ JitWithSpecs    buildJitFromRef(std::istream& refStream, std::string const& refN
     return out;
 }
 
-namespace
-{
 //  Re-intern the module's string literals through this process's `Strings`, so
 //  a literal and a trace string of equal content share one pointer and string
 //  equality stays a pointer compare. Runs before any requirement, in both the
 //  JIT setup (the module was compiled in-process, but the slots still start at
 //  their raw bytes) and the checker (a different process compiled them).
+void    internModuleStrings(referee_module_v1 const* m)
+{
+    for (std::uint64_t i = 0; i < m->stringCount; i++)
+    {
+        char const**    slot = m->strings[i];       // the literal's slot
+        *slot = Strings::instance()->getString(*slot);
+    }
+}
+
+namespace {
+
+namespace
+{
 //  Echo a block of verdict lines to `os`, colouring each line iff `os` is a
 //  terminal (colormod.hpp decides; a file, a pipe or a stringstream stays
 //  plain). The block is built plain and is also parsed elsewhere for the
@@ -2134,15 +2233,6 @@ void    emitVerdicts(std::ostream& os, std::string const& block, char const* ind
     }
 }
 
-void    internModuleStrings(referee_module_v1 const* m)
-{
-    for (std::uint64_t i = 0; i < m->stringCount; i++)
-    {
-        char const**    slot = m->strings[i];       // the literal's slot
-        *slot = Strings::instance()->getString(*slot);
-    }
-}
-
 //  The out-of-bounds fault channel, drained after each eval: an index outside
 //  its array raised the flag and answered from a zeroed buffer, and the host
 //  turns that into a failure -- same policy as the JIT path's `faulted()`.
@@ -2640,12 +2730,14 @@ bool    changedAt(Type* type, std::uint8_t const* a, std::uint8_t const* b)
 
 } // namespace
 
+} // namespace
+
 bool    runOneTrace(JitWithSpecs&            js,
                     referee::db::Reader&     rdb,
                     std::ostream&            os,
-                    std::ostream*            explain    = nullptr,
-                    std::string const&       refName    = {},
-                    std::string const&       tracePath  = {})
+                    std::ostream*            explain,
+                    std::string const&       refName,
+                    std::string const&       tracePath)
 {
     auto*   astModule   = js.astModule;
 
@@ -2687,7 +2779,12 @@ bool    runOneTrace(JitWithSpecs&            js,
     std::size_t numStates = rdb.numStates();
     std::size_t totalProps = astModule->getPropNames().size();
     std::size_t stateStride = sizeof(int64_t) + totalProps * sizeof(void*);
-    std::vector<std::uint8_t> runStates(numStates * stateStride, 0);
+
+    //  The run's own copy of the rows and every computed signal are columns,
+    //  the same as the buffers the compiled recurrences take: trace-length,
+    //  so under `--spill` they are file-backed rather than held in RAM.
+    referee::rt::ColumnScope    columns;
+    std::uint8_t*               runStates = columns.take(numStates * stateStride);
 
     // Backing storage for computed (`data x = expr`) props, which __prepare__
     // fills before any requirement runs. The stride is the prop's own width:
@@ -2704,20 +2801,20 @@ bool    runOneTrace(JitWithSpecs&            js,
     // values must survive for the whole trace, not just until the next
     // declaration that mentions it.
     std::map<std::string, std::size_t>               computedStrides;
-    std::map<std::string, std::vector<std::uint8_t>> computedBuffers;
+    std::map<std::string, std::uint8_t*>             computedBuffers;
     for (auto const& name : astModule->getPropNames())
     {
         if (astModule->isExprData(name))
         {
             auto    width           = astModule->getProp(name)->size();
             computedStrides[name]   = width;
-            computedBuffers[name].assign(numStates * width, 0);
+            computedBuffers[name]   = columns.take(numStates * width);
         }
     }
 
     for (std::size_t si = 0; si < numStates; si++)
     {
-        uint8_t* statePtr = runStates.data() + si * stateStride;
+        uint8_t* statePtr = runStates + si * stateStride;
         int64_t t = rdb.time(si);
         std::memcpy(statePtr, &t, sizeof(t));
 
@@ -2725,7 +2822,7 @@ bool    runOneTrace(JitWithSpecs&            js,
         {
             auto const& name = astModule->getPropNames()[pi];
             void* valPtr = astModule->isExprData(name)
-                         ? static_cast<void*>(computedBuffers[name].data() + si * computedStrides[name])
+                         ? static_cast<void*>(computedBuffers[name] + si * computedStrides[name])
                          : const_cast<void*>(rdb.propBlob(si, csvPropIndices[name]));
             std::memcpy(statePtr + sizeof(int64_t) + pi * sizeof(void*), &valPtr, sizeof(valPtr));
         }
@@ -2750,7 +2847,7 @@ bool    runOneTrace(JitWithSpecs&            js,
 
     using PrepFn = void(*)(void*, void*, void*);
     auto prepFn = (*prepSymOrErr).toPtr<PrepFn>();
-    prepFn(runStates.data(), runStates.data() + (numStates - 1) * stateStride, rdb.confPtr());
+    prepFn(runStates, runStates + (numStates - 1) * stateStride, rdb.confPtr());
 
     //  Every signal is materialised now, recorded and computed alike.
     if (explain != nullptr)
@@ -2770,7 +2867,7 @@ bool    runOneTrace(JitWithSpecs&            js,
         {
             return reinterpret_cast<std::uint8_t const*>(
                        *reinterpret_cast<void* const*>(
-                            runStates.data() + si * stateStride
+                            runStates + si * stateStride
                             + sizeof(std::int64_t) + pi * sizeof(void*)));
         };
 
@@ -2877,13 +2974,15 @@ bool    runOneTrace(JitWithSpecs&            js,
     }
 
     return runAllSpecs(*js.jit, js.funcNames,
-                       runStates.data(), runStates.data() + (numStates - 1) * stateStride, rdb.confPtr(),
+                       runStates, runStates + (numStates - 1) * stateStride, rdb.confPtr(),
                        os, explain,
                        stateStride, std::size_t(1),
                        numStates > 1 ? numStates - 1 : std::size_t(1),
                        &temporalReqs, js.astModule);
 }
 
+namespace {
+
 // Compile, then run against a single trace. The original single-trace entry
 // point, kept as the shape most callers want.
 bool    runAgainstRdb(std::istream&            refStream,
@@ -2895,7 +2994,7 @@ bool    runAgainstRdb(std::istream&            refStream,
     //  Any array the specification left unsized takes its extent from the
     //  trace, which is why the trace is opened before this is called.
     auto    js  = buildJitFromRef(refStream, refName, includePaths,
-                                  sizesFromSchema(rdb.props()));
+                                  sizesFromSchema(rdb.props()), {}, rdb.numStates());
     return runOneTrace(js, rdb, os);
 }
 
@@ -2941,17 +3040,37 @@ namespace {
 // Open a trace by extension: `.rdb` is already the execute-ready layout, and
 // everything else is packed into an in-memory one first. Same dispatch the CLI
 // did inline, moved here so every caller agrees on it.
+//  `only`, when not empty, is the recorded props the run reads; the rest are
+//  left null rather than parsed or fixed up.
 std::unique_ptr<referee::db::Reader>    openTrace(std::string const&  refSrc,
                                                  std::string const&  refName,
                                                  std::string const&  tracePath,
                                                  std::string const&  confPath,
-                                                 std::vector<std::string> const& includePaths)
+                                                 std::vector<std::string> const& includePaths,
+                                                 referee::db::Columns const& only = {})
 {
+    if (auto it = g_corpusMembers.find(tracePath); it != g_corpusMembers.end())
+    {
+        if (g_windowed)
+            throw std::runtime_error(fmt::format("--from/--to take a .rdb trace, not '{}'", tracePath));
+        return it->second.first->open(it->second.second, only);
+    }
+    if (auto it = g_attached.find(tracePath); it != g_attached.end())
+    {
+        if (g_windowed)
+            throw std::runtime_error(fmt::format("--from/--to take a .rdb trace, not '{}'", tracePath));
+        return it->second->open();
+    }
+
     auto    isRdb = tracePath.size() >= 4
                  && tracePath.compare(tracePath.size() - 4, 4, ".rdb") == 0;
 
+    if (isRdb && g_windowed)
+        return std::make_unique<referee::db::Reader>(tracePath, g_windowFrom, g_windowTo, only);
     if (isRdb)
-        return std::make_unique<referee::db::Reader>(tracePath);
+        return referee::db::Reader::map(tracePath, only);
+    if (g_windowed)
+        throw std::runtime_error(fmt::format("--from/--to take a .rdb trace, not '{}'", tracePath));
 
     std::ifstream   dataStream(tracePath, std::ios_base::in);
     if (!dataStream)
@@ -2965,13 +3084,50 @@ std::unique_ptr<referee::db::Reader>    openTrace(std::string const&  refSrc,
             throw std::runtime_error(fmt::format("cannot open conf '{}'", confPath));
     }
 
+    //  Spilling: ingest to a file in the spill directory and open that, rather
+    //  than building the `.rdb` in a stringstream and copying it twice more on
+    //  its way into a Reader. Three trace-sized buffers in RAM at once is what
+    //  `--spill` is there to avoid. The Reader copies the file into its own
+    //  unlinked mapping, so the ingested file goes as soon as it is open.
+    if (auto const* dir = referee::rt::spillDir())
+    {
+        static std::atomic<unsigned>    serial{0};
+        auto    path = (std::filesystem::path(dir)
+                     / fmt::format("referee-ingest-{}-{}.rdb", ::getpid(), serial++)).string();
+
+        std::unique_ptr<referee::db::Reader>    rdb;
+        try
+        {
+            {
+                std::ofstream       out(path, std::ios::binary | std::ios::trunc);
+                if (!out)
+                    throw std::runtime_error(fmt::format("cannot write spill file '{}'", path));
+
+                std::istringstream  refForIngest(refSrc);
+                referee::db::ingest(refForIngest, refName,
+                                    dataStream,   tracePath,
+                                    confPath.empty() ? nullptr : &confStream, confPath,
+                                    out,          includePaths, only);
+            }
+            rdb = std::make_unique<referee::db::Reader>(path);
+        }
+        catch (...)
+        {
+            std::filesystem::remove(path);
+            throw;
+        }
+
+        std::filesystem::remove(path);
+        return rdb;
+    }
+
     std::stringstream   rdbBuf(std::ios::in | std::ios::out | std::ios::binary);
     {
         std::istringstream  refForIngest(refSrc);
         referee::db::ingest(refForIngest, refName,
                             dataStream,   tracePath,
                             confPath.empty() ? nullptr : &confStream, confPath,
-                            rdbBuf,       includePaths);
+                            rdbBuf,       includePaths, only);
     }
 
     auto                    str = std::move(rdbBuf).str();
@@ -2979,8 +3135,66 @@ std::unique_ptr<referee::db::Reader>    openTrace(std::string const&  refSrc,
     return std::make_unique<referee::db::Reader>(std::move(bytes), tracePath);
 }
 
+//  The recorded props the checked requirements read, from a parse of the
+//  specification alone, so the traces can be opened with just those before
+//  the compile that needs them open. A specification that does not parse
+//  loads everything; the compile then reports it properly.
+referee::db::Columns    columnsRead(std::string const& refSrc,
+                                    std::string const& refName,
+                                    std::vector<std::string> const& includePaths)
+{
+    try
+    {
+        std::istringstream  refForSchema(refSrc);
+        auto                schema = Referee::parseSchema(refForSchema, refName, includePaths, {}, true);
+        Arena::Scope        arenaScope(schema.astOwner->arena);
+        return Compile::reads(schema.ast, g_only);
+    }
+    catch (std::exception const&)
+    {
+        return {};
+    }
+}
+
 } // namespace
 
+std::vector<Referee::Trace>     Referee::corpus(std::string const& corpusPath)
+{
+    auto                corpus = std::make_shared<referee::db::Corpus>(corpusPath);
+    std::vector<Trace>  traces;
+    auto const&         members = corpus->members();
+    for (std::size_t i = 0; i < members.size(); i++)
+    {
+        Trace   trace;
+        trace.path          = fmt::format("{}({})", corpusPath, members[i].name);
+        trace.expectFailure = members[i].expectFailure;
+        trace.violates      = members[i].violates;
+        g_corpusMembers[trace.path] = {corpus, i};
+        traces.push_back(std::move(trace));
+    }
+    return traces;
+}
+
+Referee::Trace  Referee::attach(std::string const& name)
+{
+    Trace   trace;
+    trace.path = "shm:" + name;
+    if (g_attached.count(trace.path))
+        return trace;
+
+    //  Each segment's strings are baked in as pointers into its own pool, and
+    //  the process adopts that pool as the one it interns into. A second pool
+    //  would have to agree with the first on every string they share, which
+    //  nothing arranges -- so refuse it up front rather than fail on whichever
+    //  common string ("on", "off") it meets first.
+    if (!g_attached.empty())
+        throw std::runtime_error(fmt::format("cannot attach '{}': '{}' is already attached, "
+                                             "and a process maps one served trace",
+                                             name, g_attached.begin()->first.substr(4)));
+    g_attached[trace.path] = std::make_shared<referee::db::SharedTrace>(name);
+    return trace;
+}
+
 std::vector<Referee::Trace>     Referee::readSuite(std::string const& manifestPath)
 {
     std::ifstream   in(manifestPath);
@@ -3209,7 +3423,8 @@ void    Referee::emitObject(std::string const&               refPath,
         auto    n = F.getName();
         if ((n.starts_with("__col__") || n.starts_with("__ante__")
           || n.starts_with("__sub__") || n.starts_with("__scope")
-          || n.starts_with("__atom__") || n.starts_with("__ap__"))
+          || n.starts_with("__atom__") || n.starts_with("__ap__")
+          || n.starts_with("__acc__"))
          && F.use_empty())
         {
             F.eraseFromParent();
@@ -3266,17 +3481,19 @@ void    Referee::emitShared(std::string const&               refPath,
 
     //  The archive supplies the std::string builtins (runtime/strfns.cpp): a
     //  spec calling std::string::len compiles to an undefined __ref_str_len,
-    //  which the JIT resolves as a host symbol and a dlopen'd .so cannot. A
-    //  static archive contributes only the objects actually referenced, so a
-    //  spec using no builtins links nothing extra -- and if the archive is
-    //  absent, such a spec still links fine.
+    //  which the JIT resolves as a host symbol and a dlopen'd .so cannot. The
+    //  same goes for the column allocator (runtime/columns.cpp) and the block
+    //  scheduler (runtime/scan.cpp) behind every unbounded temporal operator;
+    //  the scheduler starts its workers with pthreads. A static archive contributes only the
+    //  objects actually referenced, so a spec using neither links nothing
+    //  extra -- and if the archive is absent, such a spec still links fine.
     std::string rtFlags;
     try         { rtFlags = " -L" + sh(runtimeLibDir()) + " -lreferee_rt"; }
     catch (...) { }
 
     auto const* cc  = std::getenv("CC");
     std::string cmd = std::string(cc && *cc ? cc : "cc")
-                    + " -shared -fPIC " + sh(objPath) + rtFlags + " -o " + sh(outPath);
+                    + " -shared -fPIC " + sh(objPath) + rtFlags + " -pthread -o " + sh(outPath);
 
     int     rc = std::system(cmd.c_str());
     std::remove(objPath.c_str());
@@ -3351,9 +3568,16 @@ void    Referee::emitExecutable(std::string const&               refPath,
         return out + "'";
     };
 
+    //  A runtime built with zstd reads zstd-packed `.rdb` blocks, so it needs
+    //  the library too.
+#ifdef REFEREE_HAVE_ZSTD
+    std::string const   zstd = " -lzstd";
+#else
+    std::string const   zstd;
+#endif
     std::string cmd = std::string(cxx && *cxx ? cxx : "c++")
                     + " " + sh(objPath)
-                    + " -L" + sh(rtDir) + " -lreferee_rt -lfmt -lyaml-cpp"
+                    + " -L" + sh(rtDir) + " -lreferee_rt -lfmt -lyaml-cpp" + zstd + " -pthread"
                     + " -o " + sh(outPath);
 
     int     rc = std::system(cmd.c_str());
@@ -3370,6 +3594,11 @@ bool    Referee::executeChecker(std::string const&          soPath,
                                 Detail                      detail,
                                 std::string const&          confPath)
 {
+    //  A built checker has no specification left to select from or to read
+    //  the props of; build one from just the requirements wanted instead.
+    if (!g_only.empty())
+        throw std::runtime_error("--only needs the specification, not a built checker");
+
     void*   handle = dlopen(soPath.c_str(), RTLD_NOW | RTLD_LOCAL);
     if (handle == nullptr)
         throw std::runtime_error("checker: cannot load '" + soPath + "': "
@@ -3383,6 +3612,17 @@ bool    Referee::executeChecker(std::string const&          soPath,
     if (mod == nullptr || mod->version != 1)
         throw std::runtime_error("checker: unsupported module version");
 
+    //  The object carries its own copy of the column allocator and the block
+    //  scheduler, linked from libreferee_rt, and with RTLD_LOCAL it does not
+    //  see this process's. Hand the spill and thread settings across, or
+    //  `--spill` and `--threads` would silently not apply to it.
+    if (auto const* dir = referee::rt::spillDir())
+        if (auto fwd = reinterpret_cast<void (*)(char const*, std::int64_t)>(
+                            dlsym(handle, "__ref_column_spill")))
+            fwd(dir, referee::rt::kSpillThreshold);
+    if (auto fwd = reinterpret_cast<void (*)(std::int64_t)>(dlsym(handle, "__ref_threads")))
+        fwd(referee::rt::threads());
+
     //  Re-intern the checker's string literals through this process, before
     //  any requirement runs, so a literal and a trace string of equal content
     //  share a pointer again.
@@ -3420,9 +3660,27 @@ bool    Referee::executeChecker(std::string const&          soPath,
         //  the embedded schema first, exactly as the JIT path packs it against
         //  the parsed `.ref` -- but with no `.ref`.
         std::unique_ptr<referee::db::Reader>    rdbPtr;
-        if (endsWith(trace.path, ".rdb"))
+        if (auto it = g_corpusMembers.find(trace.path); it != g_corpusMembers.end())
         {
-            rdbPtr = std::make_unique<referee::db::Reader>(trace.path);
+            if (g_windowed)
+                throw std::runtime_error("checker: --from/--to take a .rdb trace, not '" + trace.path + "'");
+            rdbPtr = it->second.first->open(it->second.second);
+        }
+        else if (auto it = g_attached.find(trace.path); it != g_attached.end())
+        {
+            if (g_windowed)
+                throw std::runtime_error("checker: --from/--to take a .rdb trace, not '" + trace.path + "'");
+            rdbPtr = it->second->open();
+        }
+        else if (endsWith(trace.path, ".rdb"))
+        {
+            rdbPtr = g_windowed
+                   ? std::make_unique<referee::db::Reader>(trace.path, g_windowFrom, g_windowTo)
+                   : referee::db::Reader::map(trace.path);
+        }
+        else if (g_windowed)
+        {
+            throw std::runtime_error("checker: --from/--to take a .rdb trace, not '" + trace.path + "'");
         }
         else
         {
@@ -3970,22 +4228,73 @@ bool    Referee::executeAll(std::istream& refStream, std::string refName,
     std::string refSrc{std::istreambuf_iterator<char>(refStream),
                        std::istreambuf_iterator<char>()};
 
+    //  Only the signals the checked requirements read are loaded: a wide
+    //  trace costs what the specification looks at. A run trace draws every
+    //  signal, so `--explain` loads them all.
+    auto    columns = explainPath.empty() ? columnsRead(refSrc, refName, includePaths)
+                                          : referee::db::Columns{};
+
     //  The first trace is opened before compiling, because an array the
     //  specification declares `T[]` takes its extent from the trace. Every
     //  later trace is checked against the schema that fixed, so a corpus whose
     //  traces disagree on an extent is reported rather than silently
     //  misread.
     auto    first = openTrace(refSrc, refName, traces.front().path,
-                              confPath, includePaths);
+                              confPath, includePaths, columns);
 
     //  Compile once. This is the reason the loop is here rather than in the
     //  caller: it is the dominant cost and it does not depend on the trace.
-    JitWithSpecs    js;
+    //  `auto` weighs the compilation against every trace it serves -- the
+    //  first standing in for the rest.
+    auto    build   = [&](std::vector<std::uint8_t> const* conf)
     {
         std::istringstream  refForJit(refSrc);
-        js = buildJitFromRef(refForJit, refName, includePaths,
-                             sizesFromSchema(first->props()), libraryPaths);
-    }
+        auto    js  = buildJitFromRef(refForJit, refName, includePaths,
+                                      sizesFromSchema(first->props()), libraryPaths,
+                                      first->numStates() * traces.size(), conf);
+        if (!g_only.empty())
+        {
+            for (auto const& label : g_only)
+                if (std::find(js.funcNames.begin(), js.funcNames.end(), label) == js.funcNames.end())
+                    throw std::runtime_error(fmt::format("--only: no requirement '{}' in {}", label, refName));
+            std::erase_if(js.funcNames, [](std::string const& name) { return !g_only.contains(name); });
+        }
+        return js;
+    };
+
+    //  ...unless each module is specialised to a conf, when it does depend on
+    //  the trace, though only through the conf blob. Keyed by the blob's
+    //  bytes, so a corpus sharing one conf compiles once, exactly as without
+    //  specialising, and one that alternates between a few compiles each
+    //  once. Bounded, oldest out first, so a corpus with a conf per trace
+    //  holds a handful of JITs rather than one per trace.
+    constexpr std::size_t                   kConfCache = 16;
+    std::map<std::string, JitWithSpecs>     byConf;
+    std::deque<std::string>                 confOrder;
+    JitWithSpecs                            shared;
+    if (!g_specializeConf)
+        shared = build(nullptr);
+
+    auto    jitFor  = [&](referee::db::Reader const& rdb) -> JitWithSpecs&
+    {
+        if (!g_specializeConf)
+            return shared;
+
+        auto const* base = static_cast<std::uint8_t const*>(rdb.confPtr());
+        std::string key(reinterpret_cast<char const*>(base), rdb.confSize());
+        if (auto it = byConf.find(key); it != byConf.end())
+            return it->second;
+
+        if (byConf.size() == kConfCache)
+        {
+            byConf.erase(confOrder.front());
+            confOrder.pop_front();
+        }
+
+        std::vector<std::uint8_t>   blob(base, base + rdb.confSize());
+        confOrder.push_back(key);
+        return byConf.emplace(std::move(key), build(&blob)).first->second;
+    };
 
         auto    atLeast = [&](Detail want) {
         return static_cast<int>(detail) >= static_cast<int>(want);
@@ -4014,11 +4323,11 @@ bool    Referee::executeAll(std::istream& refStream, std::string refName,
         //  The first was opened above to fix any unsized extents.
         auto    owned = ti == 0 ? nullptr
                                 : openTrace(refSrc, refName, trace.path,
-                                            confPath, includePaths);
+                                            confPath, includePaths, columns);
         auto&   rdb   = ti == 0 ? *first : *owned;
 
         std::ostringstream  perTrace;
-        bool                allPass = runOneTrace(js, rdb, perTrace,
+        bool                allPass = runOneTrace(jitFor(rdb), rdb, perTrace,
                                                   explainFile.is_open() ? &explainFile : nullptr,
                                                   refName, trace.path);
         auto                report  = perTrace.str();
@@ -4128,1244 +4437,57 @@ bool    Referee::executeAll(std::istream& refStream, std::string refName,
     return everyTraceOk;
 }
 
-bool    Referee::executeRdb(std::istream& refStream, std::string refName,
-                            std::string const& rdbPath,
-                            std::ostream& os,
-                            std::vector<std::string> const& includePaths)
-{
-    referee::db::Reader     rdb(rdbPath);
-    return runAgainstRdb(refStream, refName, rdb, os, includePaths);
-}
-
-// ── referee monitor: online, one state at a time ────────────────────────────
-//
-//  Phase 1 (docs/monitor-implementation.md). It reuses the whole offline path
-//  per prefix: the JIT is built once, then for each new row the accumulated CSV
-//  is re-ingested and the specs run over the prefix. That is O(N^2), not the
-//  single-pass incremental evaluator the design describes, but it is correct
-//  and reuses every existing piece; the incremental evaluator is a later phase.
-//
-//  A prefix verdict is exact for safety -- an invariant broken on a prefix
-//  stays broken -- and pessimistic for liveness, where an `F`/until obligation
-//  reads unmet until it is satisfied. So a mid-stream violation is reported
-//  only for requirements with no eventually operator; the rest are finalised at
-//  end of stream, where the prefix is the whole trace and every verdict final.
-
-//  Does the requirement carry an eventually-flavoured operator (`F`, strong or
-//  weak until, release), whose prefix verdict can climb from false back to
-//  true?  Such requirements are deferred to end of stream rather than reported
-//  mid-stream, so a pessimistic prefix is never mistaken for a violation.  The
-//  walk covers the operator spine and quantifier bodies, where temporal
-//  operators actually appear.
-static bool hasEventually(Expr* e)
-{
-    if (e == nullptr)                                                   return false;
-    if (dynamic_cast<ExprF*>(e)  || dynamic_cast<ExprUs*>(e) ||
-        dynamic_cast<ExprUw*>(e) || dynamic_cast<ExprRs*>(e) ||
-        dynamic_cast<ExprRw*>(e))                                       return true;
-    if (auto* u = dynamic_cast<ExprUnary*>(e))   return hasEventually(u->arg);
-    if (auto* b = dynamic_cast<ExprBinary*>(e))  return hasEventually(b->lhs) || hasEventually(b->rhs);
-    if (auto* t = dynamic_cast<ExprTernary*>(e)) return hasEventually(t->lhs) || hasEventually(t->mhs) || hasEventually(t->rhs);
-    if (auto* c = dynamic_cast<ExprCount*>(e))   return hasEventually(c->arg) || hasEventually(c->body);
-    return false;
-}
-
-//  A state predicate: no operator that reaches another state, so it is one of
-//  the requirement's atomic propositions the code generator emitted an `__ap__`
-//  for. Mirrors the compiler's `readsOnlyCurrent`, including the `Xs`/`Ys` and
-//  freeze exclusions `is_temporal()` misses.
-static bool isStatePredicate(Expr* e)
+void    Referee::spill(std::string const& dir)
 {
-    if (e == nullptr)                                                       return true;
-    if (dynamic_cast<Temporal<ExprUnary>*>(e) || dynamic_cast<Temporal<ExprBinary>*>(e) ||
-        dynamic_cast<ExprXs*>(e) || dynamic_cast<ExprXw*>(e) ||
-        dynamic_cast<ExprYs*>(e) || dynamic_cast<ExprYw*>(e) ||
-        dynamic_cast<ExprAt*>(e))                                          return false;
-    if (auto* c = dynamic_cast<ExprCount*>(e))   return isStatePredicate(c->arg) && isStatePredicate(c->body);
-    if (auto* u = dynamic_cast<ExprUnary*>(e))   return isStatePredicate(u->arg);
-    if (auto* b = dynamic_cast<ExprBinary*>(e))  return isStatePredicate(b->lhs) && isStatePredicate(b->rhs);
-    if (auto* t = dynamic_cast<ExprTernary*>(e)) return isStatePredicate(t->lhs) && isStatePredicate(t->mhs) && isStatePredicate(t->rhs);
-    return true;
-}
-
-//  ---------------------------------------------------------------------------
-//  General residual evaluator -- LTL3 formula progression.
-//
-//  A nested future formula (`G(a => F b)`, `G(F p)`, `F(G p)`, `Fa && Fb`,
-//  `p U q`, `p R q`, ...) is not a single fold, but its verdict can still be
-//  tracked incrementally by carrying a *residual* formula and rewriting it
-//  against each state -- the formula-derivative technique. This one mechanism
-//  subsumes the response/until/release latches: each is a special case.
-//
-//  The residual is a small boolean-plus-temporal tree over the requirement's
-//  atomic propositions. `progress` evaluates every AP at the current state and
-//  unfolds one step; `finalize` closes an unsettled residual over the empty
-//  suffix at end of stream (G safety holds, F liveness fails, weak/strong until
-//  and release split). Aggressive constant folding and idempotence keep the
-//  residual bounded -- it is always a boolean combination of the formula's
-//  finitely many subformulas.
-//  Two leaf kinds beyond the plain atomic proposition (`Ap`):
-//    - `PastRef` references one of the requirement's *past* subformulas
-//      (`O`, `H`, `Ys`/`Yw`, ...). A past formula is history-determined, so it is
-//      not progressed: a little forward-DP machine (see `PNode`) evaluates it to a
-//      boolean each state, and the residual just reads that value like an atom.
-//    - `Next` (`Xs`/`Xw`) owes its body `shift` states ahead; progression counts
-//      it down and, once the target state arrives, progresses the body there. At
-//      end of stream an unresolved `Next` yields its weak/strong end value.
-struct  RNode;
-using   RPtr = std::shared_ptr<RNode const>;
-struct  RNode
-{
-    enum Kind { True, False, Ap, PastRef, Not, And, Or, Glob, Finl, Until, Release, Next }    kind;
-    int     ap    = -1;     //  Ap / PastRef: index
-    bool    weak  = false;  //  Until / Release / Next
-    int     shift = 0;      //  Next: states still to skip
-    RPtr    a, b;           //  children
-};
-
-static RPtr rTrue()                 { static RPtr t = std::make_shared<RNode>(RNode{RNode::True});  return t; }
-static RPtr rFalse()                { static RPtr f = std::make_shared<RNode>(RNode{RNode::False}); return f; }
-static bool isT(RPtr const& r)      { return r->kind == RNode::True;  }
-static bool isF(RPtr const& r)      { return r->kind == RNode::False; }
-
-//  Structural equality -- pointer identity fast-paths the shared temporal leaves
-//  (the template nodes threaded through unchanged), so idempotent folding is
-//  cheap. It is what collapses `G phi && G phi` back to `G phi`.
-static bool rEq(RPtr const& x, RPtr const& y)
-{
-    if (x == y)                     return true;
-    if (x->kind != y->kind)         return false;
-    switch (x->kind)
-    {
-        case RNode::Ap: case RNode::PastRef:        return x->ap == y->ap;
-        case RNode::Not: case RNode::Glob: case RNode::Finl:    return rEq(x->a, y->a);
-        case RNode::And: case RNode::Or:            return rEq(x->a, y->a) && rEq(x->b, y->b);
-        case RNode::Until: case RNode::Release:     return x->weak == y->weak && rEq(x->a, y->a) && rEq(x->b, y->b);
-        case RNode::Next:                           return x->weak == y->weak && x->shift == y->shift && rEq(x->a, y->a);
-        default:                                    return true;    //  True / False
-    }
-}
-
-static RPtr mkAp(int k)     { auto n = std::make_shared<RNode>(); n->kind = RNode::Ap; n->ap = k; return n; }
-static RPtr mkNot(RPtr a)
-{
-    if (isT(a))                     return rFalse();
-    if (isF(a))                     return rTrue();
-    if (a->kind == RNode::Not)      return a->a;                    //  double negation
-    auto n = std::make_shared<RNode>(); n->kind = RNode::Not; n->a = a; return n;
-}
-static RPtr mkAnd(RPtr a, RPtr b)
-{
-    if (isF(a) || isF(b))           return rFalse();
-    if (isT(a))                     return b;
-    if (isT(b))                     return a;
-    if (rEq(a, b))                  return a;
-    auto n = std::make_shared<RNode>(); n->kind = RNode::And; n->a = a; n->b = b; return n;
-}
-static RPtr mkOr(RPtr a, RPtr b)
-{
-    if (isT(a) || isT(b))           return rTrue();
-    if (isF(a))                     return b;
-    if (isF(b))                     return a;
-    if (rEq(a, b))                  return a;
-    auto n = std::make_shared<RNode>(); n->kind = RNode::Or; n->a = a; n->b = b; return n;
-}
-static RPtr mkGlob(RPtr a)              { auto n = std::make_shared<RNode>(); n->kind = RNode::Glob; n->a = a; return n; }
-static RPtr mkFinl(RPtr a)              { auto n = std::make_shared<RNode>(); n->kind = RNode::Finl; n->a = a; return n; }
-static RPtr mkUntil(RPtr a, RPtr b, bool w)   { auto n = std::make_shared<RNode>(); n->kind = RNode::Until;   n->a = a; n->b = b; n->weak = w; return n; }
-static RPtr mkRelease(RPtr a, RPtr b, bool w) { auto n = std::make_shared<RNode>(); n->kind = RNode::Release; n->a = a; n->b = b; n->weak = w; return n; }
-static RPtr mkPastRef(int k)            { auto n = std::make_shared<RNode>(); n->kind = RNode::PastRef; n->ap = k; return n; }
-static RPtr mkNext(int shift, bool w, RPtr a) { auto n = std::make_shared<RNode>(); n->kind = RNode::Next; n->shift = shift; n->weak = w; n->a = a; return n; }
-
-//  ---------------------------------------------------------------------------
-//  Past machine -- forward DP over a pure-past subformula (`O`, `H`, `Ys`/`Yw`
-//  and boolean combinations of them over state predicates). A past formula's
-//  truth at each state is fixed by the history already seen, so rather than
-//  progress it, the monitor evaluates it bottom-up once per state, threading a
-//  little memory: `O`/`H` keep their running value, `Ys`/`Yw` keep the child's
-//  previous value. The tree is immutable and shared; the mutable memory lives in
-//  a per-run slot array (`pmem`), one signed byte per stateful node (-1 = not yet
-//  started, so the first state gets the right base case).
-struct  PNode;
-using   PPtr = std::shared_ptr<PNode const>;
-struct  PNode
-{
-    enum Kind { Ap, Not, And, Or, Once, Hist, Prev, Since, Trig }    kind;
-    int     ap   = -1;      //  Ap: __ap__ index
-    bool    weak = false;   //  Prev / Since / Trig: base value before the first state
-    int     slot = -1;      //  stateful nodes: index into pmem
-    PPtr    a, b;           //  Since / Trig: a = p (lhs), b = q (rhs)
-};
-
-//  Evaluate the past subtree at the current state, updating memory. `evalAp`
-//  reads a state predicate now; `pmem` carries each stateful node's memory.
-static bool stepPast(PPtr const& p, std::function<bool(int)> const& evalAp, std::vector<signed char>& pmem)
-{
-    switch (p->kind)
-    {
-        case PNode::Ap:     return evalAp(p->ap);
-        case PNode::Not:    return !stepPast(p->a, evalAp, pmem);
-        case PNode::And:    { bool x = stepPast(p->a, evalAp, pmem); bool y = stepPast(p->b, evalAp, pmem); return x && y; }
-        case PNode::Or:     { bool x = stepPast(p->a, evalAp, pmem); bool y = stepPast(p->b, evalAp, pmem); return x || y; }
-        case PNode::Once:   //  once_i = child_i || once_{i-1}   (once_0 = child_0)
-        {
-            bool    v    = stepPast(p->a, evalAp, pmem);
-            bool    prev = pmem[p->slot] == 1;
-            bool    cur  = v || prev;
-            pmem[p->slot] = cur;
-            return cur;
-        }
-        case PNode::Hist:   //  hist_i = child_i && hist_{i-1}   (hist_0 = child_0)
-        {
-            bool    v    = stepPast(p->a, evalAp, pmem);
-            bool    prev = pmem[p->slot] != 0;      //  -1 (start) counts as true
-            bool    cur  = v && prev;
-            pmem[p->slot] = cur;
-            return cur;
-        }
-        case PNode::Prev:   //  Ys/Yw: the child's value one state back (weak/strong base at the start)
-        {
-            bool    result = pmem[p->slot] == -1 ? p->weak : pmem[p->slot] == 1;
-            bool    child  = stepPast(p->a, evalAp, pmem);
-            pmem[p->slot] = child ? 1 : 0;
-            return result;
-        }
-        case PNode::Since:  //  p Ss/Sw q:  S_i = q_i || (p_i && S_{i-1})
-        {
-            bool    pv   = stepPast(p->a, evalAp, pmem);
-            bool    qv   = stepPast(p->b, evalAp, pmem);
-            bool    prev = pmem[p->slot] == -1 ? p->weak : pmem[p->slot] == 1;
-            bool    cur  = qv || (pv && prev);
-            pmem[p->slot] = cur;
-            return cur;
-        }
-        case PNode::Trig:   //  p Ts/Tw q:  T_i = q_i && (p_i || T_{i-1})
-        {
-            bool    pv   = stepPast(p->a, evalAp, pmem);
-            bool    qv   = stepPast(p->b, evalAp, pmem);
-            bool    prev = pmem[p->slot] == -1 ? p->weak : pmem[p->slot] == 1;
-            bool    cur  = qv && (pv || prev);
-            pmem[p->slot] = cur;
-            return cur;
-        }
-    }
-    return false;
+    __ref_column_spill(dir.c_str(), referee::rt::kSpillThreshold);
 }
 
-//  Build a pure-past subtree (`O`, `H`, `Ys`/`Yw` and booleans over state
-//  predicates) into a past machine. Returns null if it meets any operator that is
-//  not history-determined (a future/next operator, a bounded past, a multi-step
-//  `Ys`), which drops the whole requirement to the prefix path. Shares the `apc`
-//  leaf counter with `buildResidual` and assigns memory slots via `pslots`.
-static PPtr buildPast(Expr* e, int& apc, int& pslots)
+void    Referee::threads(unsigned count)
 {
-    if (e == nullptr)                       return nullptr;
-    if (isStatePredicate(e))                { auto n = std::make_shared<PNode>(); n->kind = PNode::Ap; n->ap = apc++; return n; }
-
-    auto    unary = [&](PNode::Kind k, PPtr a) -> PPtr
-    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; return n; };
-    auto    binary = [&](PNode::Kind k, PPtr a, PPtr b) -> PPtr
-    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; n->b = b; return n; };
-
-    auto    stateful = [&](PNode::Kind k, PPtr a, bool w) -> PPtr
-    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; n->weak = w; n->slot = pslots++; return n; };
-    auto    statefulBin = [&](PNode::Kind k, PPtr a, PPtr b, bool w) -> PPtr
-    { auto n = std::make_shared<PNode>(); n->kind = k; n->a = a; n->b = b; n->weak = w; n->slot = pslots++; return n; };
-
-    if (auto* n = dynamic_cast<ExprNot*>(e))    { auto a = buildPast(n->arg, apc, pslots); return a ? unary(PNode::Not, a) : nullptr; }
-    if (auto* a = dynamic_cast<ExprAnd*>(e))    { auto l = buildPast(a->lhs, apc, pslots); auto r = buildPast(a->rhs, apc, pslots); return (l && r) ? binary(PNode::And, l, r) : nullptr; }
-    if (auto* o = dynamic_cast<ExprOr*>(e))     { auto l = buildPast(o->lhs, apc, pslots); auto r = buildPast(o->rhs, apc, pslots); return (l && r) ? binary(PNode::Or,  l, r) : nullptr; }
-    if (auto* i = dynamic_cast<ExprImp*>(e))    { auto l = buildPast(i->lhs, apc, pslots); auto r = buildPast(i->rhs, apc, pslots); return (l && r) ? binary(PNode::Or, unary(PNode::Not, l), r) : nullptr; }
-    if (auto* x = dynamic_cast<ExprXor*>(e))    { auto l = buildPast(x->lhs, apc, pslots); auto r = buildPast(x->rhs, apc, pslots); return (l && r) ? binary(PNode::Or, binary(PNode::And, l, unary(PNode::Not, r)), binary(PNode::And, unary(PNode::Not, l), r)) : nullptr; }
-    if (auto* q = dynamic_cast<ExprEqu*>(e))    { auto l = buildPast(q->lhs, apc, pslots); auto r = buildPast(q->rhs, apc, pslots); return (l && r) ? binary(PNode::Or, binary(PNode::And, l, r), binary(PNode::And, unary(PNode::Not, l), unary(PNode::Not, r))) : nullptr; }
-    if (auto* o = dynamic_cast<ExprO*>(e))      { if (o->time) return nullptr; auto a = buildPast(o->arg, apc, pslots); return a ? stateful(PNode::Once, a, false) : nullptr; }
-    if (auto* h = dynamic_cast<ExprH*>(e))      { if (h->time) return nullptr; auto a = buildPast(h->arg, apc, pslots); return a ? stateful(PNode::Hist, a, false) : nullptr; }
-    //  `Ys(k, phi)` = `phi` k states back = `Ys(1)` nested k deep, each a one-bit
-    //  `Prev`. The shift `lhs` is a literal `collectAPs` counts as an AP, so
-    //  consume one `apc` slot for it (before the body) to stay in step.
-    if (auto* y = dynamic_cast<ExprYs*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(y->lhs); if (!k || k->value < 1) return nullptr; apc++; auto a = buildPast(y->rhs, apc, pslots); if (!a) return nullptr; for (std::int64_t s = 0; s < k->value; s++) a = stateful(PNode::Prev, a, false); return a; }
-    if (auto* y = dynamic_cast<ExprYw*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(y->lhs); if (!k || k->value < 1) return nullptr; apc++; auto a = buildPast(y->rhs, apc, pslots); if (!a) return nullptr; for (std::int64_t s = 0; s < k->value; s++) a = stateful(PNode::Prev, a, true);  return a; }
-    //  Since `Ss`/`Sw` and trigger `Ts`/`Tw` -- the past duals of until/release.
-    //  lhs = p, rhs = q; unbounded only (a bounded window bails to the prefix path).
-    if (auto* s = dynamic_cast<ExprSs*>(e))     { if (s->time) return nullptr; auto p = buildPast(s->lhs, apc, pslots); auto q = buildPast(s->rhs, apc, pslots); return (p && q) ? statefulBin(PNode::Since, p, q, false) : nullptr; }
-    if (auto* s = dynamic_cast<ExprSw*>(e))     { if (s->time) return nullptr; auto p = buildPast(s->lhs, apc, pslots); auto q = buildPast(s->rhs, apc, pslots); return (p && q) ? statefulBin(PNode::Since, p, q, true)  : nullptr; }
-    if (auto* t = dynamic_cast<ExprTs*>(e))     { if (t->time) return nullptr; auto p = buildPast(t->lhs, apc, pslots); auto q = buildPast(t->rhs, apc, pslots); return (p && q) ? statefulBin(PNode::Trig,  p, q, false) : nullptr; }
-    if (auto* t = dynamic_cast<ExprTw*>(e))     { if (t->time) return nullptr; auto p = buildPast(t->lhs, apc, pslots); auto q = buildPast(t->rhs, apc, pslots); return (p && q) ? statefulBin(PNode::Trig,  p, q, true)  : nullptr; }
-
-    return nullptr;                             //  future/next/bounded-past/etc. inside a past formula
+    __ref_threads(count);
 }
 
-//  Build the residual template from the AST, numbering atomic propositions in
-//  the SAME pre-order the code generator's `collectAPs` uses -- so leaf k here
-//  is the compiled `__ap__k__<label>`. `isStatePredicate` is the AP boundary,
-//  exactly the generator's `readsOnlyCurrent`. A past subformula becomes a
-//  `PastRef` into `pasts` (a machine that evaluates it per state); a next
-//  operator becomes a countdown `Next`. Returns null on any operator not yet
-//  handled (bounded future, freeze, since/trigger, xor, iff, ternary, ...),
-//  routing the requirement to the prefix path. Children are sequenced left before
-//  right so AP indices match. `apc` counts leaves, `pslots` past-memory slots.
-static RPtr buildResidual(Expr* e, int& apc, int& pslots, std::vector<PPtr>& pasts)
+void    Referee::specializeConf(bool on)
 {
-    if (e == nullptr)                       return nullptr;
-    if (isStatePredicate(e))                return mkAp(apc++);
-
-    if (auto* n = dynamic_cast<ExprNot*>(e))
-    {
-        auto    x = buildResidual(n->arg, apc, pslots, pasts);
-        return x ? mkNot(x) : nullptr;
-    }
-    if (auto* a = dynamic_cast<ExprAnd*>(e))
-    {
-        auto    l = buildResidual(a->lhs, apc, pslots, pasts);
-        auto    r = buildResidual(a->rhs, apc, pslots, pasts);
-        return (l && r) ? mkAnd(l, r) : nullptr;
-    }
-    if (auto* o = dynamic_cast<ExprOr*>(e))
-    {
-        auto    l = buildResidual(o->lhs, apc, pslots, pasts);
-        auto    r = buildResidual(o->rhs, apc, pslots, pasts);
-        return (l && r) ? mkOr(l, r) : nullptr;
-    }
-    if (auto* i = dynamic_cast<ExprImp*>(e))    //  a => b  ==  !a || b
-    {
-        auto    l = buildResidual(i->lhs, apc, pslots, pasts);
-        auto    r = buildResidual(i->rhs, apc, pslots, pasts);
-        return (l && r) ? mkOr(mkNot(l), r) : nullptr;
-    }
-    if (auto* x = dynamic_cast<ExprXor*>(e))    //  a ^^ b  ==  (a & !b) | (!a & b)
-    {
-        auto    l = buildResidual(x->lhs, apc, pslots, pasts);
-        auto    r = buildResidual(x->rhs, apc, pslots, pasts);
-        return (l && r) ? mkOr(mkAnd(l, mkNot(r)), mkAnd(mkNot(l), r)) : nullptr;
-    }
-    if (auto* q = dynamic_cast<ExprEqu*>(e))    //  a <=> b  ==  (a & b) | (!a & !b)
-    {
-        auto    l = buildResidual(q->lhs, apc, pslots, pasts);
-        auto    r = buildResidual(q->rhs, apc, pslots, pasts);
-        return (l && r) ? mkOr(mkAnd(l, r), mkAnd(mkNot(l), mkNot(r))) : nullptr;
-    }
-    if (auto* g = dynamic_cast<ExprG*>(e))
-    {
-        if (g->time)    return nullptr;         //  bounded -> prefix path
-        auto    x = buildResidual(g->arg, apc, pslots, pasts);
-        return x ? mkGlob(x) : nullptr;
-    }
-    if (auto* f = dynamic_cast<ExprF*>(e))
-    {
-        if (f->time)    return nullptr;
-        auto    x = buildResidual(f->arg, apc, pslots, pasts);
-        return x ? mkFinl(x) : nullptr;
-    }
-    if (auto* u = dynamic_cast<ExprUs*>(e))     { if (u->time) return nullptr; auto l = buildResidual(u->lhs, apc, pslots, pasts); auto r = buildResidual(u->rhs, apc, pslots, pasts); return (l && r) ? mkUntil(l, r, false) : nullptr; }
-    if (auto* u = dynamic_cast<ExprUw*>(e))     { if (u->time) return nullptr; auto l = buildResidual(u->lhs, apc, pslots, pasts); auto r = buildResidual(u->rhs, apc, pslots, pasts); return (l && r) ? mkUntil(l, r, true)  : nullptr; }
-    if (auto* r = dynamic_cast<ExprRs*>(e))     { if (r->time) return nullptr; auto l = buildResidual(r->lhs, apc, pslots, pasts); auto q = buildResidual(r->rhs, apc, pslots, pasts); return (l && q) ? mkRelease(l, q, false) : nullptr; }
-    if (auto* r = dynamic_cast<ExprRw*>(e))     { if (r->time) return nullptr; auto l = buildResidual(r->lhs, apc, pslots, pasts); auto q = buildResidual(r->rhs, apc, pslots, pasts); return (l && q) ? mkRelease(l, q, true)  : nullptr; }
-
-    //  Next `Xs`/`Xw`: shift the body forward `k` states; progression counts it
-    //  down. The shift `lhs` is a literal -- and `collectAPs` counts it as a
-    //  (constant) atomic proposition, so consume one `apc` slot to stay in step.
-    if (auto* x = dynamic_cast<ExprXs*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(x->lhs); if (!k || k->value < 1) return nullptr; apc++; auto b = buildResidual(x->rhs, apc, pslots, pasts); return b ? mkNext((int)k->value, false, b) : nullptr; }
-    if (auto* x = dynamic_cast<ExprXw*>(e))     { auto* k = dynamic_cast<ExprConstInteger*>(x->lhs); if (!k || k->value < 1) return nullptr; apc++; auto b = buildResidual(x->rhs, apc, pslots, pasts); return b ? mkNext((int)k->value, true,  b) : nullptr; }
-
-    //  Past operators -- `O`/`H`/`Ys`/`Yw` and since/trigger `Ss`/`Sw`/`Ts`/`Tw`:
-    //  history-determined, built as a past machine and referenced by a `PastRef`
-    //  leaf. `buildPast` shares the `apc` counter.
-    if (dynamic_cast<ExprO*>(e) || dynamic_cast<ExprH*>(e) ||
-        dynamic_cast<ExprYs*>(e) || dynamic_cast<ExprYw*>(e) ||
-        dynamic_cast<ExprSs*>(e) || dynamic_cast<ExprSw*>(e) ||
-        dynamic_cast<ExprTs*>(e) || dynamic_cast<ExprTw*>(e))
-    {
-        auto    p = buildPast(e, apc, pslots);
-        if (!p) return nullptr;
-        int     idx = (int)pasts.size();
-        pasts.push_back(p);
-        return mkPastRef(idx);
-    }
-
-    return nullptr;                             //  unsupported operator
+    g_specializeConf = on;
 }
 
-//  Rewrite the residual against one state: evaluate every leaf (`leaf` reads an
-//  `Ap` or a `PastRef`), unfold each temporal one step, and simplify. Temporal
-//  nodes are threaded through unchanged (the `r` on the right), which the smart
-//  constructors' idempotence folds back together. A `Next` counts its shift down;
-//  when it reaches the target state the body applies there and is progressed.
-static RPtr progress(RPtr const& r, std::function<bool(RNode const&)> const& leaf)
+void    Referee::window(std::int64_t from, std::int64_t to)
 {
-    switch (r->kind)
-    {
-        case RNode::True:
-        case RNode::False:      return r;
-        case RNode::Ap:
-        case RNode::PastRef:    return leaf(*r) ? rTrue() : rFalse();
-        case RNode::Not:        return mkNot(progress(r->a, leaf));
-        case RNode::And:        return mkAnd(progress(r->a, leaf), progress(r->b, leaf));
-        case RNode::Or:         return mkOr (progress(r->a, leaf), progress(r->b, leaf));
-        case RNode::Glob:       return mkAnd(progress(r->a, leaf), r);                       //  G x = x' & G x
-        case RNode::Finl:       return mkOr (progress(r->a, leaf), r);                       //  F x = x' | F x
-        case RNode::Until:      return mkOr (progress(r->b, leaf), mkAnd(progress(r->a, leaf), r));   //  a U b = b' | (a' & aUb)
-        case RNode::Release:    return mkAnd(progress(r->b, leaf), mkOr (progress(r->a, leaf), r));   //  a R b = b' & (a' | aRb)
-        case RNode::Next:       return r->shift >= 1 ? mkNext(r->shift - 1, r->weak, r->a)   //  consume a state, one fewer to skip
-                                                     : progress(r->a, leaf);                //  target state reached: body applies now
-    }
-    return r;
+    g_windowed   = true;
+    g_windowFrom = from;
+    g_windowTo   = to;
 }
 
-//  Close an unsettled residual over the empty suffix at end of stream: G (safety)
-//  vacuously holds, F (liveness) is unmet, a still-live until/release resolves by
-//  its weak/strong flag. No AP survives here -- every one is evaluated the step
-//  it is met -- so the recursion only meets boolean and temporal nodes.
-static bool finalize(RPtr const& r)
+void    Referee::only(std::vector<std::string> const& labels)
 {
-    switch (r->kind)
-    {
-        case RNode::True:       return true;
-        case RNode::False:      return false;
-        case RNode::Not:        return !finalize(r->a);
-        case RNode::And:        return finalize(r->a) && finalize(r->b);
-        case RNode::Or:         return finalize(r->a) || finalize(r->b);
-        case RNode::Glob:       return true;
-        case RNode::Finl:       return false;
-        case RNode::Until:      return r->weak;
-        case RNode::Release:    return r->weak;
-        case RNode::Next:       return r->weak;  //  Xs owes a state that never came -> strong false / weak true
-        case RNode::Ap:
-        case RNode::PastRef:    return false;   //  unreachable: leaves are evaluated during progress
-    }
-    return false;
+    g_only = {labels.begin(), labels.end()};
 }
 
-//  A time bound as a plain integer: an absent bound takes `dflt` (a missing
-//  lower bound is 0), a constant literal its value. A non-literal bound (a conf
-//  reference, an expression) is not one the monitor's single window can carry,
-//  so it returns false and the requirement stays on the prefix path.
-static bool constTime(Expr* e, std::int64_t dflt, std::int64_t& out)
+void    Referee::optimize(int level)
 {
-    if (e == nullptr)                                       { out = dflt; return true; }
-    if (auto* c = dynamic_cast<ExprConstInteger*>(e))       { out = c->value; return true; }
-    return false;
+    if (level < -1 || level > 3)
+        throw std::runtime_error("optimisation level must be auto or 0..3, not " + std::to_string(level));
+    g_optLevel = level;
 }
 
-//  The bounded response `G(a => F[lo:hi] b)`: whenever `a` holds, `b` must follow
-//  within a `[lo, hi)` window. Unlike the top-level bounded `F`, this is nested
-//  under an unbounded `G`, so every instant `a` is true opens its own window --
-//  the dense-time interval-covering case the monitor evaluates specially. Match
-//  the exact shape (outer `G` unbounded, inner `F` bounded, `a`/`b` state
-//  predicates, literal bounds); anything else stays on the prefix path.
-static bool isBoundedResponse(Expr* e, std::int64_t& lo, std::int64_t& hi)
+int     Referee::optLevelFor(std::size_t states)
 {
-    auto* g = dynamic_cast<ExprG*>(e);
-    if (g == nullptr || g->time != nullptr)                             return false;
-    auto* imp = dynamic_cast<ExprImp*>(g->arg);
-    if (imp == nullptr)                                                 return false;
-    auto* f = dynamic_cast<ExprF*>(imp->rhs);
-    if (f == nullptr || f->time == nullptr || f->time->hi == nullptr)   return false;
-    if (!isStatePredicate(imp->lhs) || !isStatePredicate(f->arg))       return false;
-    return constTime(f->time->lo, 0, lo) && constTime(f->time->hi, 0, hi);
+    if (g_optLevel >= 0)
+        return g_optLevel;
+    return states < kOptCrossover ? 0 : 2;
 }
 
-//  Parse `name … PASS/FAIL …` verdict lines from a runOneTrace capture into a
-//  label -> passed map.  The name is left-justified in a fixed column, so it is
-//  everything before the first ` PASS`/` FAIL`, trailing padding trimmed.
-static std::map<std::string, bool>  parseVerdicts(std::string const& text)
+std::size_t     Referee::optCrossover()
 {
-    std::map<std::string, bool> out;
-    std::istringstream          in(text);
-    std::string                 line;
-    while (std::getline(in, line))
-    {
-        auto    p = line.find(" PASS");
-        auto    f = line.find(" FAIL");
-        if (p == std::string::npos && f == std::string::npos)   continue;
-
-        bool        pass = p != std::string::npos && (f == std::string::npos || p < f);
-        std::string name = line.substr(0, pass ? p : f);
-        while (!name.empty() && name.back() == ' ')             name.pop_back();
-        if (!name.empty())                                      out[name] = pass;
-    }
-    return out;
+    return kOptCrossover;
 }
 
-bool    Referee::monitor(std::istream& refStream, std::string refName,
-                         std::istream& states, std::string const& confPath,
-                         std::ostream& os, bool stopAtFirst,
-                         std::vector<std::string> const& includePaths)
+bool    Referee::executeRdb(std::istream& refStream, std::string refName,
+                            std::string const& rdbPath,
+                            std::ostream& os,
+                            std::vector<std::string> const& includePaths)
 {
-    std::string         refSrc((std::istreambuf_iterator<char>(refStream)),
-                                std::istreambuf_iterator<char>());
-    std::istringstream  refForJit(refSrc);
-    auto                js = buildJitFromRef(refForJit, refName, includePaths, Referee::Sizes{});
-
-    //  `buildJitFromRef`'s arena scope ended when it returned, so make this
-    //  module's arena current again for the rest of the monitor: classifying a
-    //  spec rewrites its pattern (`Rewrite::make`), which interns fresh AST nodes.
-    //  Without a current arena those land in the process-global (nullptr) bucket,
-    //  outlive this module, and -- once its arena is swept and the memory reused
-    //  -- collide by raw pointer with a later module, yielding a dangling node
-    //  ("bad type" on a garbage position). Bound to the module's arena, they are
-    //  keyed per module and die with it.
-    Arena::Scope        arenaScope(js.astOwner->arena);
-
-    //  Which requirements are finalised only at end of stream (see above), keyed
-    //  by the same label runOneTrace prints.  Dwyer specs all defer in phase 1.
-    std::set<std::string>       deferred;
-    std::vector<std::string>    order;      //  requirement labels, source order
-    {
-        auto&   exprs = js.astModule->getExprs();
-        for (std::size_t i = 0; i < exprs.size(); i++)
-        {
-            auto    label = js.astModule->getExprName(i);
-            if (label.empty())              label = exprs[i]->where().text();
-            if (hasEventually(exprs[i]))    deferred.insert(label);
-            order.push_back(label);
-        }
-        auto&   specs = js.astModule->getSpecs();
-        for (std::size_t i = 0; i < specs.size(); i++)
-        {
-            auto    label = js.astModule->getSpecName(i);
-            if (label.empty())  label = specs[i]->where().text();
-            deferred.insert(label);
-            order.push_back(label);
-        }
-    }
-
-    std::string     confContents;
-    if (!confPath.empty())
-    {
-        std::ifstream   cf(confPath);
-        confContents.assign(std::istreambuf_iterator<char>(cf),
-                            std::istreambuf_iterator<char>());
-    }
-
-    Color::Modifier const   green (Color::FG_GREEN);
-    Color::Modifier const   red   (Color::FG_RED);
-    Color::Modifier const   yellow(Color::FG_YELLOW);
-    Color::Modifier const   reset (Color::FG_DEFAULT);
-
-    //  ── Atom fast path ──────────────────────────────────────────────────────
-    //  When every requirement is a single-state atom -- an invariant, a bare
-    //  predicate, or an eventually/once, each with an `__atom__<name>` companion
-    //  the code generator emits -- the monitor need not re-ingest the growing
-    //  prefix. It ingests just the current row, evaluates each atom on that one
-    //  state, and folds the result into a per-requirement latch: `all` for G/H
-    //  (fails the instant an atom is false), `any` for F/O (settles once an atom
-    //  is true), `first` for a bare predicate (decided at the first state). That
-    //  is O(1) per state, not the prefix path's O(N). Computed props are
-    //  excluded -- a temporal one cannot be materialised from a single row -- so
-    //  a spec with any falls through to the exact prefix path below.
-    {
-        using AtomFn  = bool(*)(void*, void*);
-        using ScopeFn = bool(*)(void*, void*, void*, void*);    //  (frst, last, curr, conf)
-        //  Evaluators sharing the incremental fast path. A single-fold atom (an
-        //  invariant, an eventually, a bare predicate) is one latch -- fn + a
-        //  fold. A top-level bounded `F`/`G` is a latch over a `__time__` window
-        //  -- fn + a [lo, hi] deadline. Anything richer that progression handles
-        //  carries a residual formula and its atomic-proposition functions.
-        enum    Fold  { FoldAll, FoldAny, FoldFirst, BoundedF, BoundedG, BoundedResponse, Residual };
-        //  A residual's Dwyer scope. Single-interval: globally (whole trace),
-        //  before R ([frst, R), vacuous if no R), after Q ([Q, end], vacuous if no
-        //  Q). Multi-interval: between Q and R and after Q until R (each [Q, R),
-        //  plus a final open [Q, end] -- checked strongly by between, leniently by
-        //  after-until), while E (each maximal run of E). Multi-interval scopes
-        //  reset (`refresh`) the residual at each interval open.
-        enum    Scope { ScGlobally, ScBefore, ScAfter, ScBetween, ScAfterUntil, ScWhile };
-        struct  AtomReq
-        {
-            std::string         label;
-            Fold                fold;
-            AtomFn              fn  = nullptr;   //  atom folds, bounded F/G body
-            std::int64_t        lo  = 0;         //  bounded F/G: window [now+lo, now+hi]
-            std::int64_t        hi  = 0;
-            RPtr                templ;          //  Residual: the progression template
-            std::vector<AtomFn> aps;            //  Residual: __ap__0..k
-            std::vector<PPtr>   pasts;          //  Residual: past-subformula machines
-            int                 pslots = 0;     //  Residual: past-memory slots
-            Scope               scope   = ScGlobally;
-            ScopeFn             scopeA  = nullptr;   //  boundary column: before/after R/Q, between/while open
-            ScopeFn             scopeB  = nullptr;   //  boundary column: between/after-until close R
-        };
-
-        //  A `globally`-scoped Dwyer pattern applies over the whole trace, so it
-        //  is just its pattern as a residual -- no scope window. Other scopes
-        //  (before/after/between/...) still take the prefix path. A computed
-        //  temporal prop cannot be materialised from one row, so it does too.
-        bool    allAtoms = true;
-        for (auto const& name : js.astModule->getPropNames())
-            if (js.astModule->isExprData(name)) { allAtoms = false; break; }
-
-        std::vector<AtomReq>    atomReqs;
-        auto&   exprs = js.astModule->getExprs();
-        for (std::size_t i = 0; allAtoms && i < exprs.size(); i++)
-        {
-            auto    label = js.astModule->getExprName(i);
-            if (label.empty())  label = exprs[i]->where().text();
-            auto*   e = exprs[i];
-
-            auto    atomSym = js.jit->lookup("__atom__" + label);
-            if (atomSym)
-            {
-                auto    fn = (*atomSym).toPtr<AtomFn>();
-
-                //  A bounded operator folds its body over a `__time__` window the
-                //  plain all/any latch cannot express. A top-level `F[lo:hi]` or
-                //  `G[lo:hi]` over a state predicate is one window anchored at the
-                //  first state, so the monitor carries it as a deadline latch;
-                //  `__atom__` is that body predicate (`atomOf` peels the operator
-                //  bound and all). Bounded past (`H`/`O`), a non-literal bound, or
-                //  a bounded operator nested under another (many concurrent
-                //  windows) take the prefix path.
-                if (auto* t = dynamic_cast<Temporal<ExprUnary>*>(e); t != nullptr && t->time != nullptr)
-                {
-                    std::int64_t    lo, hi;
-                    bool            isF = dynamic_cast<ExprF*>(e) != nullptr;
-                    bool            isG = dynamic_cast<ExprG*>(e) != nullptr;
-                    if ((isF || isG) && t->time->hi != nullptr
-                        && constTime(t->time->lo, 0, lo) && constTime(t->time->hi, 0, hi))
-                    {
-                        atomReqs.push_back({label, isF ? BoundedF : BoundedG, fn, lo, hi});
-                        continue;
-                    }
-                    allAtoms = false;
-                    break;
-                }
-                auto    fold = (dynamic_cast<ExprG*>(e) || dynamic_cast<ExprH*>(e)) ? FoldAll
-                             : (dynamic_cast<ExprF*>(e) || dynamic_cast<ExprO*>(e)) ? FoldAny
-                             :                                                        FoldFirst;
-                atomReqs.push_back({label, fold, fn});
-                continue;
-            }
-            llvm::consumeError(atomSym.takeError());
-
-            //  The bounded response `G(a => F[lo:hi] b)`: a bounded window opened
-            //  at every instant `a` holds. Its `a`/`b` are `__ap__0`/`__ap__1`
-            //  (piece 1); the monitor evaluates the dense-time covering directly.
-            {
-                std::int64_t    rlo, rhi;
-                if (isBoundedResponse(e, rlo, rhi))
-                {
-                    auto    ap0 = js.jit->lookup("__ap__0__" + label);
-                    auto    ap1 = js.jit->lookup("__ap__1__" + label);
-                    if (ap0 && ap1)
-                    {
-                        atomReqs.push_back({label, BoundedResponse, nullptr, rlo, rhi, nullptr,
-                                            {(*ap0).toPtr<AtomFn>(), (*ap1).toPtr<AtomFn>()}});
-                        continue;
-                    }
-                    if (!ap0)   llvm::consumeError(ap0.takeError());
-                    if (!ap1)   llvm::consumeError(ap1.takeError());
-                }
-            }
-
-            //  Not a single-fold atom. If progression can represent it -- a
-            //  boolean/temporal formula over `G`/`F`/`U`/`R`, `Xs`/`Xw` next, past
-            //  operators (`O`/`H`/`Ys`/`Yw`) and state predicates, no bounded
-            //  window or freeze -- carry it as a residual. `buildResidual` numbers
-            //  the atoms exactly as the code generator's `collectAPs` did, so leaf
-            //  k binds to `__ap__k__<label>` (piece 1).
-            int                 apc    = 0;
-            int                 pslots = 0;
-            std::vector<PPtr>   pasts;
-            RPtr                tmpl = buildResidual(e, apc, pslots, pasts);
-            if (tmpl)
-            {
-                std::vector<AtomFn>     aps;
-                bool                    ok = true;
-                for (int k = 0; k < apc; k++)
-                {
-                    auto    sym = js.jit->lookup("__ap__" + std::to_string(k) + "__" + label);
-                    if (!sym)   { llvm::consumeError(sym.takeError()); ok = false; break; }
-                    aps.push_back((*sym).toPtr<AtomFn>());
-                }
-                if (ok)
-                {
-                    atomReqs.push_back({label, Residual, nullptr, 0, 0, tmpl,
-                                        std::move(aps), std::move(pasts), pslots});
-                    continue;
-                }
-            }
-            allAtoms = false;
-            break;
-        }
-
-        //  Dwyer-pattern specs. Every scope is incremental -- `globally` over
-        //  the whole trace, `before R` and `after Q` over one interval, and
-        //  `between`/`after-until`/`while` over a run of them. The pattern is
-        //  the scope body rewritten (and canonicalised, as the compiler did
-        //  when emitting its `__ap__` companions), so `buildResidual` sees the
-        //  same `Rw`/`Us`/... form and numbers the atoms alike. A scope's
-        //  boundary is one of the `__scope*__<name>` column functions the
-        //  generator emits; the monitor folds the intervals out of it. What
-        //  still drops to the prefix path: a pattern outside the residual
-        //  fragment, and a past-bearing one under any scope that restarts
-        //  (`pastOK` below).
-        auto&   specs = js.astModule->getSpecs();
-        for (std::size_t i = 0; allAtoms && i < specs.size(); i++)
-        {
-            auto    label = js.astModule->getSpecName(i);
-            if (label.empty())  label = specs[i]->where().text();
-
-            auto*   scoped = dynamic_cast<SpecScoped*>(specs[i]);
-            auto*   sc     = js.astModule->scopeFor(label);
-            if (scoped == nullptr || sc == nullptr) { allAtoms = false; break; }
-
-            Scope   scope;
-            if      (sc->kind == "globally")    scope = ScGlobally;
-            else if (sc->kind == "before")      scope = ScBefore;
-            else if (sc->kind == "after")       scope = ScAfter;
-            else if (sc->kind == "between")     scope = ScBetween;
-            else if (sc->kind == "after_until") scope = ScAfterUntil;
-            else if (sc->kind == "while")       scope = ScWhile;
-            else    { allAtoms = false; break; }
-
-            int                 apc    = 0;
-            int                 pslots = 0;
-            std::vector<PPtr>   pasts;
-            RPtr                tmpl = buildResidual(Rewrite::make(scoped->spec), apc, pslots, pasts);
-            //  Every scope but `before`/`globally` starts (or restarts) the pattern
-            //  fresh at an interval open, while the offline anchors it one state
-            //  earlier so a past operator can read across the boundary; a
-            //  past-bearing pattern there would disagree, so it takes the prefix
-            //  path. `before`/`globally` progress from the trace start, so their
-            //  past machines have the right history.
-            bool    pastOK = pslots == 0 || scope == ScBefore || scope == ScGlobally;
-            if (tmpl != nullptr && pastOK)
-            {
-                std::vector<AtomFn>     aps;
-                bool                    ok = true;
-                for (int k = 0; k < apc; k++)
-                {
-                    auto    sym = js.jit->lookup("__ap__" + std::to_string(k) + "__" + label);
-                    if (!sym)   { llvm::consumeError(sym.takeError()); ok = false; break; }
-                    aps.push_back((*sym).toPtr<AtomFn>());
-                }
-
-                auto    lookupScope = [&](std::string const& name, ScopeFn& out)
-                {
-                    auto    sym = js.jit->lookup(name);
-                    if (!sym)   { llvm::consumeError(sym.takeError()); return false; }
-                    out = (*sym).toPtr<ScopeFn>();
-                    return true;
-                };
-                ScopeFn scopeA = nullptr, scopeB = nullptr;
-                if (ok && scope != ScGlobally)              ok = lookupScope(sc->condA, scopeA);
-                if (ok && (scope == ScBetween || scope == ScAfterUntil))    ok = lookupScope(sc->condB, scopeB);
-
-                if (ok)
-                {
-                    atomReqs.push_back({label, Residual, nullptr, 0, 0, tmpl, std::move(aps),
-                                        std::move(pasts), pslots, scope, scopeA, scopeB});
-                    continue;
-                }
-            }
-            allAtoms = false;
-            break;
-        }
-
-        if (allAtoms && !atomReqs.empty())
-        {
-            if (auto modSym = js.jit->lookup("referee_module"))
-                internModuleStrings((*modSym).toPtr<referee_module_v1 const* (*)()>()());
-            else
-                llvm::consumeError(modSym.takeError());
-
-            auto    prepSym = js.jit->lookup("__prepare__");
-            if (!prepSym)   throw std::runtime_error("JIT: missing __prepare__");
-            auto    prepFn  = (*prepSym).toPtr<void(*)(void*, void*, void*)>();
-
-            std::string     header;
-            if (!std::getline(states, header))  return true;
-
-            std::vector<char>   value(atomReqs.size());     //  all/G[]: ok / any: met / first & residual: verdict once done
-            std::vector<char>   done (atomReqs.size(), 0);  //  first, residual, bounded: decided yet
-            std::vector<char>   started(atomReqs.size(), 0);//  after-scope: its Q boundary has fired
-            std::vector<char>   inside(atomReqs.size(), 0); //  multi-interval scope: currently within an interval
-            std::vector<RPtr>   resid(atomReqs.size());     //  residual: the current progression formula
-            std::vector<std::vector<signed char>>   pmem(atomReqs.size());   //  residual: past-machine memory (-1 = unstarted)
-            //  bounded response: per-state (time, a, b), for a dense-time covering
-            //  fold computed at end of stream.
-            struct  Sample { std::int64_t t; char a, b; };
-            std::vector<std::vector<Sample>>    brBuf(atomReqs.size());
-            for (std::size_t i = 0; i < atomReqs.size(); i++)
-            {
-                //  G and G[lo:hi] are safety -- true until broken. A multi-interval
-                //  scope is a running AND of its intervals -- true until one fails,
-                //  vacuously true if none opens. Everything else starts unmet.
-                bool    multi = atomReqs[i].scope == ScBetween || atomReqs[i].scope == ScAfterUntil || atomReqs[i].scope == ScWhile;
-                value[i] = (atomReqs[i].fold == FoldAll || atomReqs[i].fold == BoundedG || multi) ? 1 : 0;
-                resid[i] = atomReqs[i].templ;               //  null for atom folds
-                pmem[i].assign(atomReqs[i].pslots, -1);
-            }
-
-            //  Bounded operators are dense-time: a state's value holds over the
-            //  half-open segment [its time, the next state's time), and the window
-            //  is [t0+lo, t0+hi) -- upper-exclusive, values persisting between
-            //  states (`F[500:1000]` is met by a `b` that went true before 500 and
-            //  is still true at 500). So a segment is only closed once the next
-            //  state's time is known: the monitor lags one state, carrying the
-            //  previous state's body value, and closes the final state as a point.
-            std::int64_t        t0     = 0;      //  window anchor: __time__ of the first state
-            bool                haveT0 = false;
-            std::int64_t        prevTs = 0;
-            std::string         prevNow, prevLine;
-            std::vector<char>   prevBody(atomReqs.size(), 0);   //  bounded: body over the previous segment
-            std::vector<char>   curBody (atomReqs.size(), 0);
-
-            std::string     line;
-            while (std::getline(states, line))
-            {
-                if (line.empty())   continue;
-
-                std::string                             rowCsv = header + "\n" + line;
-                std::istringstream                      csvIn(rowCsv);
-                std::unique_ptr<std::istringstream>     confIn;
-                if (!confContents.empty())
-                    confIn = std::make_unique<std::istringstream>(confContents);
-
-                std::stringstream   rdbBuf(std::ios::in | std::ios::out | std::ios::binary);
-                try
-                {
-                    referee::db::ingestWithModule(csvIn, "stdin.csv", confIn.get(), confPath,
-                                                  js.astModule, rdbBuf);
-                }
-                catch (std::exception const& e)
-                {
-                    os << red << "error" << reset << ": " << e.what() << "\n";
-                    return false;
-                }
-
-                auto                        str = std::move(rdbBuf).str();
-                std::vector<std::uint8_t>   bytes(str.begin(), str.end());
-                referee::db::Reader         rdb(std::move(bytes), "stdin.csv");
-
-                prepFn(const_cast<void*>(rdb.ptrFirst()), const_cast<void*>(rdb.ptrLast()), rdb.confPtr());
-
-                //  the single real state sits between the two sentinels
-                auto*   base = static_cast<char*>(const_cast<void*>(rdb.ptrFirst()));
-                void*   curr = base + (rdb.numStates() - 2) * rdb.rowBytes();
-                void*   conf = rdb.confPtr();
-                void*   sfrst = const_cast<void*>(rdb.ptrFirst());   //  for scope boundary columns
-                void*   slast = const_cast<void*>(rdb.ptrLast());
-
-                auto        comma = line.find(',');
-                std::string now   = comma == std::string::npos ? line : line.substr(0, comma);
-
-                //  Absolute `__time__` of this state, read from the state buffer
-                //  itself (its first field) so it is right regardless of CSV
-                //  column order; the first state anchors every bounded window.
-                std::int64_t    ts         = *reinterpret_cast<std::int64_t const*>(curr);
-                bool            firstState = !haveT0;
-                if (firstState) { t0 = ts; haveT0 = true; }
-
-                bool    violatedNow = false;
-                for (std::size_t i = 0; i < atomReqs.size(); i++)
-                {
-                    if (atomReqs[i].fold == BoundedResponse)
-                    {
-                        //  Record (time, a, b); the dense-time covering is folded
-                        //  at end of stream, when every `a` interval and `b` gap is
-                        //  known.
-                        brBuf[i].push_back({ts, (char)atomReqs[i].aps[0](curr, conf),
-                                                (char)atomReqs[i].aps[1](curr, conf)});
-                        continue;
-                    }
-
-                    if (atomReqs[i].fold == BoundedF || atomReqs[i].fold == BoundedG)
-                    {
-                        //  Top-level `F[lo:hi]`/`G[lo:hi]` over the dense-time
-                        //  window [t0+lo, t0+hi). Close the previous state's
-                        //  segment [prevTs, ts) -- which held `prevBody[i]` -- now
-                        //  that its end `ts` is known: F is met if a `true` segment
-                        //  overlaps the window; G is broken if a `false` one does.
-                        //  A segment [a, b) overlaps iff a < winHi and b > winLo.
-                        curBody[i] = atomReqs[i].fn(curr, conf);        //  value over the NEXT segment [ts, ...)
-                        if (done[i])    continue;
-                        std::int64_t    winLo = t0 + atomReqs[i].lo;
-                        std::int64_t    winHi = t0 + atomReqs[i].hi;
-
-                        if (!firstState && prevTs < winHi && ts > winLo)    //  previous segment overlaps the window
-                        {
-                            if (atomReqs[i].fold == BoundedF && prevBody[i])     { value[i] = 1; done[i] = 1; }
-                            if (atomReqs[i].fold == BoundedG && !prevBody[i])
-                            {
-                                value[i] = 0;
-                                done[i]  = 1;
-                                os << red << "VIOLATION" << reset << "  " << yellow << atomReqs[i].label << reset
-                                   << "  @ __time__=" << prevNow << "  " << prevLine << "\n";
-                                violatedNow = true;
-                            }
-                        }
-                        //  Once we observe a state at or past the window's end, F
-                        //  can no longer be met -- the window is entirely behind us.
-                        if (atomReqs[i].fold == BoundedF && !done[i] && ts >= winHi)
-                        {
-                            value[i] = 0;
-                            done[i]  = 1;
-                            os << red << "VIOLATION" << reset << "  " << yellow << atomReqs[i].label << reset
-                               << "  @ __time__=" << now << "  " << line << "\n";
-                            violatedNow = true;
-                        }
-                        continue;
-                    }
-
-                    if (atomReqs[i].fold == Residual)
-                    {
-                        //  Evaluate each past subformula once (advancing its DP
-                        //  memory), then progress the residual against this state.
-                        //  It settles the instant the residual folds to a constant:
-                        //  TRUE is a definitive PASS, FALSE a definitive violation
-                        //  (a safety breach -- G broken, until's p failed, release's
-                        //  q failed). A liveness obligation never settles here; it
-                        //  stays `unknown` and is closed at end of stream.
-                        if (done[i])    continue;
-
-                        auto&   aps   = atomReqs[i].aps;
-                        auto&   pasts = atomReqs[i].pasts;
-                        auto    stepAndProgress = [&]()      //  advance past machines, then progress one state
-                        {
-                            auto    evalAp = [&](int k){ return aps[k](curr, conf); };
-                            std::vector<char>   pastVal(pasts.size());
-                            for (std::size_t p = 0; p < pasts.size(); p++)
-                                pastVal[p] = stepPast(pasts[p], evalAp, pmem[i]);
-                            resid[i] = progress(resid[i], [&](RNode const& n)
-                                                { return n.kind == RNode::PastRef ? (bool)pastVal[n.ap] : aps[n.ap](curr, conf); });
-                        };
-                        auto    fail = [&]()                 //  settle FAIL with a violation line
-                        {
-                            value[i] = 0;
-                            done[i]  = 1;
-                            os << red << "VIOLATION" << reset << "  " << yellow << atomReqs[i].label << reset
-                               << "  @ __time__=" << now << "  " << line << "\n";
-                            violatedNow = true;
-                        };
-
-                        //  Multi-interval scopes: a running AND of one residual per
-                        //  interval, refreshed at each open. `between`/`after-until`
-                        //  open on Q (with R absent) and close on R -- the interval
-                        //  is [Q, R), so R closes it without being progressed;
-                        //  `while` opens on E and closes on !E. A closed interval is
-                        //  finalised strongly; a safety breach inside fails at once.
-                        if (atomReqs[i].scope == ScBetween || atomReqs[i].scope == ScAfterUntil
-                            || atomReqs[i].scope == ScWhile)
-                        {
-                            bool    a1 = atomReqs[i].scopeA(sfrst, slast, curr, conf);
-                            bool    a2 = atomReqs[i].scopeB && atomReqs[i].scopeB(sfrst, slast, curr, conf);
-                            bool    enter, leave;
-                            if (atomReqs[i].scope == ScWhile)   { enter = !inside[i] && a1;         leave = inside[i] && !a1; }
-                            else                                { enter = !inside[i] && a1 && !a2;  leave = inside[i] && a2;  }
-
-                            if (leave)          //  interval closes here (this state is not in it)
-                            {
-                                if (!finalize(resid[i]))    fail();
-                                inside[i] = 0;
-                                continue;
-                            }
-                            if (enter)          //  refresh, then progress this state as the interval's first
-                            {
-                                inside[i] = 1;
-                                resid[i]  = atomReqs[i].templ;
-                                pmem[i].assign(atomReqs[i].pslots, -1);
-                            }
-                            if (!inside[i])     continue;   //  between intervals
-
-                            //  Progress within the interval but do not settle: a
-                            //  violation is real only once the interval is closed
-                            //  (finalised strongly at its R/!E above) or the stream
-                            //  ends (below). An `after-until` interval left open is
-                            //  excused entirely, so an in-progress breach there must
-                            //  not fail early.
-                            stepAndProgress();
-                            continue;
-                        }
-
-                        //  `before R`: the window is [frst, R). When R first holds
-                        //  the window closes at (not including) this state, so the
-                        //  residual is finalised over what came before -- without
-                        //  progressing this state. Until then (and forever, if R
-                        //  never fires) it stays open and does not settle: a pattern
-                        //  violation counts only if some R later closes the scope.
-                        if (atomReqs[i].scope == ScBefore
-                            && atomReqs[i].scopeA(sfrst, slast, curr, conf))
-                        {
-                            if (finalize(resid[i]))     { value[i] = 1; done[i] = 1; }
-                            else                        fail();
-                            continue;
-                        }
-                        //  `after Q`: dormant until Q first holds; from then it is
-                        //  a plain residual over [Q, end].
-                        if (atomReqs[i].scope == ScAfter && !started[i])
-                        {
-                            if (!atomReqs[i].scopeA(sfrst, slast, curr, conf))  continue;
-                            started[i] = 1;
-                        }
-
-                        stepAndProgress();
-
-                        //  A `before` residual must not settle early -- a violation
-                        //  is only real once an R closes the window (handled above),
-                        //  and until then more states may satisfy it. Globally and
-                        //  after settle the instant they fold to a constant.
-                        if (atomReqs[i].scope != ScBefore)
-                        {
-                            if (isT(resid[i]))          { value[i] = 1; done[i] = 1; }
-                            else if (isF(resid[i]))     fail();
-                        }
-                        continue;
-                    }
-
-                    bool    a = atomReqs[i].fn(curr, conf);
-                    if (atomReqs[i].fold == FoldAll && value[i] && !a)
-                    {
-                        value[i] = 0;
-                        os << red << "VIOLATION" << reset << "  " << yellow << atomReqs[i].label << reset
-                           << "  @ __time__=" << now << "  " << line << "\n";
-                        violatedNow = true;
-                    }
-                    else if (atomReqs[i].fold == FoldAny && a)
-                        value[i] = 1;
-                    else if (atomReqs[i].fold == FoldFirst && !done[i])
-                    {
-                        value[i] = a ? 1 : 0;
-                        done[i]  = 1;
-                        if (!a)
-                        {
-                            os << red << "VIOLATION" << reset << "  " << yellow << atomReqs[i].label << reset
-                               << "  @ __time__=" << now << "  " << line << "\n";
-                            violatedNow = true;
-                        }
-                    }
-                }
-
-                os << yellow << "__time__=" << now << reset;
-                for (std::size_t i = 0; i < atomReqs.size(); i++)
-                {
-                    os << "  " << atomReqs[i].label << '=';
-                    bool    v = value[i];
-                    if      (atomReqs[i].fold == FoldAll)    v ? (os << '?')                    : (os << red << "FAIL" << reset);
-                    else if (atomReqs[i].fold == FoldAny)    v ? (os << green << "PASS" << reset) : (os << '?');
-                    else                                     done[i] ? (v ? (os << green << "PASS" << reset) : (os << red << "FAIL" << reset)) : (os << '?');   //  first / residual
-                }
-                os << "\n";
-                os.flush();
-
-                //  Carry this state forward as the open segment for the next row.
-                prevTs   = ts;
-                prevNow  = now;
-                prevLine = line;
-                prevBody = curBody;
-
-                if (stopAtFirst && violatedNow)
-                    return false;
-            }
-
-            //  Close the final state as a point [prevTs, prevTs]: it covers no
-            //  segment (no successor), so it satisfies a bounded window only if
-            //  its own time falls in [t0+lo, t0+hi). F left unmet -> FAIL, G left
-            //  unbroken -> PASS, both already the standing `value`.
-            if (haveT0)
-                for (std::size_t i = 0; i < atomReqs.size(); i++)
-                {
-                    if ((atomReqs[i].fold != BoundedF && atomReqs[i].fold != BoundedG) || done[i])   continue;
-                    std::int64_t    winLo = t0 + atomReqs[i].lo;
-                    std::int64_t    winHi = t0 + atomReqs[i].hi;
-                    if (winLo <= prevTs && prevTs < winHi)
-                    {
-                        if (atomReqs[i].fold == BoundedF &&  prevBody[i])    { value[i] = 1; done[i] = 1; }
-                        if (atomReqs[i].fold == BoundedG && !prevBody[i])    { value[i] = 0; done[i] = 1; }
-                    }
-                }
-
-            //  A multi-interval scope with an interval still open at end of stream:
-            //  `between`/`while` finalise it strongly (an unmet liveness fails);
-            //  `after-until` treats it leniently (R may yet have come, so an unmet
-            //  liveness is excused -- a safety breach already failed via `done`).
-            for (std::size_t i = 0; i < atomReqs.size(); i++)
-                if (atomReqs[i].fold == Residual && !done[i] && inside[i]
-                    && (atomReqs[i].scope == ScBetween || atomReqs[i].scope == ScWhile)
-                    && !finalize(resid[i]))
-                    value[i] = 0;
-
-            //  Bounded response `G(a => F[lo:hi] b)`, the dense-time covering fold.
-            //  Every instant `a` holds needs a `b` in its `[+lo, +hi)` window. A
-            //  `b` region `[bs, be)` (a point at the last state) witnesses exactly
-            //  the anchors whose window it falls in: `t` with `t+lo < be` and
-            //  `t+hi > bs`, i.e. the open range `(bs-hi, be-lo)`. Only *observed*
-            //  `b` counts, so an anchor whose window reaches past the last state is
-            //  covered only by a `b` seen within it. The response fails iff some
-            //  `a` anchor is covered by no `b` region.
-            //  All the open/closed boundaries fall on integer times, so working in
-            //  doubled coordinates (`t -> 2t`) turns every interval into a closed
-            //  integer one: an open end `x` becomes `2x-/+1`, a closed end `2x`.
-            //  Coverage then reduces to plain integer-interval containment.
-            for (std::size_t i = 0; i < atomReqs.size(); i++)
-            {
-                if (atomReqs[i].fold != BoundedResponse)     continue;
-                auto&           buf = brBuf[i];
-                if (buf.empty())    { value[i] = 1; continue; }
-                std::int64_t    lo = atomReqs[i].lo;
-                std::int64_t    hi = atomReqs[i].hi;
-
-                //  Coverage: a `b` region `[bs, be)` witnesses anchors `(bs-hi,
-                //  be-lo)` (open); a `b` *point* at the last state witnesses
-                //  `(bp-hi, bp-lo]` -- closed at the top, since a lo-offset window
-                //  can start exactly on it. Doubled and merged (adjacent ints join).
-                std::vector<std::pair<std::int64_t, std::int64_t>>  cov;
-                for (std::size_t k = 0; k < buf.size(); k++)
-                    if (buf[k].b)
-                    {
-                        bool            last = k + 1 >= buf.size();
-                        std::int64_t    bs   = buf[k].t;
-                        std::int64_t    be   = last ? buf[k].t : buf[k + 1].t;
-                        cov.push_back({2 * (bs - hi) + 1, 2 * (be - lo) - (last ? 0 : 1)});
-                    }
-                std::sort(cov.begin(), cov.end());
-                std::vector<std::pair<std::int64_t, std::int64_t>>  merged;
-                for (auto const& c : cov)
-                    if (!merged.empty() && c.first <= merged.back().second + 1)
-                        merged.back().second = std::max(merged.back().second, c.second);
-                    else
-                        merged.push_back(c);
-
-                //  Each `a` anchor: segment `[as, ae)` (`[2as, 2ae-1]`) or the last
-                //  state as a point (`[2ap, 2ap]`). Fail if any is not contained.
-                bool    fail = false;
-                for (std::size_t m = 0; m < buf.size() && !fail; m++)
-                {
-                    if (!buf[m].a)      continue;
-                    bool            last = m + 1 >= buf.size();
-                    std::int64_t    aL   = 2 * buf[m].t;
-                    std::int64_t    aH   = last ? 2 * buf[m].t : 2 * buf[m + 1].t - 1;
-                    bool            in   = false;
-                    for (auto const& c : merged)    if (c.first <= aL && aH <= c.second) { in = true; break; }
-                    if (!in)            fail = true;
-                }
-                value[i] = fail ? 0 : 1;
-            }
-
-            os << "-- end of stream --\n";
-            bool    allPass = true;
-            for (std::size_t i = 0; i < atomReqs.size(); i++)
-            {
-                //  A residual still unsettled at end of stream is closed over the
-                //  empty suffix by `finalize` (G holds, F fails, weak/strong until
-                //  and release split); a settled one keeps its verdict. An open
-                //  `before R` whose R never fired, or an `after Q` whose Q never
-                //  fired, is a vacuous PASS. A multi-interval scope carries its
-                //  running AND in `value` (its open interval already applied above).
-                Scope   scp   = atomReqs[i].scope;
-                bool    multi = scp == ScBetween || scp == ScAfterUntil || scp == ScWhile;
-                bool    pass;
-                if (atomReqs[i].fold != Residual || done[i] || multi)            pass = value[i];
-                else if (scp == ScBefore)                                        pass = true;
-                else if (scp == ScAfter && !started[i])                          pass = true;
-                else                                                             pass = finalize(resid[i]);
-                if (pass)
-                    os << green << "PASS" << reset << "  " << atomReqs[i].label << "\n";
-                else
-                {
-                    allPass = false;
-                    os << red << "FAIL" << reset << "  " << yellow << atomReqs[i].label << reset << "\n";
-                }
-            }
-            return allPass;
-        }
-    }
-
-    std::string     header;
-    if (!std::getline(states, header))  return true;    //  empty stream
-
-    std::string                     csv = header;
-    std::map<std::string, bool>     prev;
-    std::string                     lastCapture;
-    std::string                     line;
-
-    while (std::getline(states, line))
-    {
-        if (line.empty())   continue;
-        csv += "\n";
-        csv += line;
-
-        std::istringstream                      csvIn(csv);
-        std::unique_ptr<std::istringstream>     confIn;
-        if (!confContents.empty())
-            confIn = std::make_unique<std::istringstream>(confContents);
-
-        std::stringstream   rdbBuf(std::ios::in | std::ios::out | std::ios::binary);
-        try
-        {
-            //  ingestWithModule picks the CSV vs YAML loader by the name's
-            //  extension, so the conf name must carry its real one (the path).
-            referee::db::ingestWithModule(csvIn, "stdin.csv", confIn.get(), confPath,
-                                          js.astModule, rdbBuf);
-        }
-        catch (std::exception const& e)
-        {
-            os << red << "error" << reset << ": " << e.what() << "\n";
-            return false;
-        }
-
-        auto                        str = std::move(rdbBuf).str();
-        std::vector<std::uint8_t>   bytes(str.begin(), str.end());
-        referee::db::Reader         rdb(std::move(bytes), "stdin.csv");
-
-        std::ostringstream          capture;
-        runOneTrace(js, rdb, capture);
-        lastCapture = capture.str();
-
-        auto            verdicts = parseVerdicts(lastCapture);
-        auto            comma    = line.find(',');
-        std::string     now      = comma == std::string::npos ? line : line.substr(0, comma);
-
-        bool    violatedNow = false;
-        for (auto const& [label, pass] : verdicts)
-        {
-            bool    was = prev.count(label) ? prev[label] : true;
-            if (!pass && was && deferred.find(label) == deferred.end())
-            {
-                os << red << "VIOLATION" << reset << "  "
-                   << yellow << label << reset
-                   << "  @ __time__=" << now << "  " << line << "\n";
-                violatedNow = true;
-            }
-            prev[label] = pass;
-        }
-
-        //  One verdict line per state -- the three-valued LTL3 view. A safety
-        //  requirement is `?` while it holds (it could still break) and FAIL
-        //  once broken; a liveness one is `?` until it is met and PASS once
-        //  settled true. The line is flushed so a live producer sees each state
-        //  as it arrives rather than at some buffer boundary.
-        os << yellow << "__time__=" << now << reset;
-        for (auto const& label : order)
-        {
-            auto    it = verdicts.find(label);
-            os << "  " << label << '=';
-            if (it == verdicts.end())               os << '?';
-            else if (deferred.count(label))
-                it->second ? (os << green << "PASS" << reset) : (os << '?');
-            else
-                it->second ? (os << '?') : (os << red << "FAIL" << reset);
-        }
-        os << "\n";
-        os.flush();
-
-        if (stopAtFirst && violatedNow)
-            return false;
-    }
-
-    //  End of stream: the last prefix is the whole trace, so every verdict --
-    //  the deferred liveness ones included -- is now final.
-    os << "-- end of stream --\n";
-    bool    allPass = true;
-    for (auto const& [label, pass] : parseVerdicts(lastCapture))
-    {
-        if (pass)
-            os << green << "PASS" << reset << "  " << label << "\n";
-        else
-        {
-            allPass = false;
-            os << red << "FAIL" << reset << "  " << yellow << label << reset
-               << (deferred.count(label) ? "  (unmet at end of stream)" : "") << "\n";
-        }
-    }
-    return allPass;
+    referee::db::Reader     rdb(rdbPath);
+    return runAgainstRdb(refStream, refName, rdb, os, includePaths);
 }
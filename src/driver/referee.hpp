@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <map>
@@ -64,7 +65,10 @@ public:
     };
 
     /// Parse REF source from `is`, lower it to LLVM IR, and run the standard
-    /// O2 optimisation pipeline. Returns the optimized module (and the AST
+    /// optimisation pipeline at `optLevel` (0..3; O2 unless told otherwise --
+    /// see `optimize` for what execution chooses). With `conf`, the loaded
+    /// conf blob of a trace, the module is specialised to it: every conf value
+    /// is a constant, and the module is good for that conf alone. Returns the optimized module (and the AST
     /// it was derived from) ready to be either dumped, JITed, or post-processed.
     ///
     /// `dataLayout` controls struct/aggregate layout in the produced IR:
@@ -86,7 +90,9 @@ public:
                             llvm::DataLayout const* dataLayout = nullptr,
                             std::vector<std::string> const& includePaths = {},
                             Sizes const& sizes = {},
-                            bool embedSchema = false);
+                            bool embedSchema = false,
+                            int optLevel = 2,
+                            std::vector<std::uint8_t> const* conf = nullptr);
 
     /// A single diagnostic from `diagnose`: a parse or type error, positioned.
     /// Lines and columns are 0-based (LSP convention); the range is half-open.
@@ -384,6 +390,21 @@ public:
     /// anything at all. Naming requirements after it is the useful form.
     static std::vector<Trace>   readSuite(std::string const& manifestPath);
 
+    /// The members of a `.rdbx` corpus (`rdb pack`) as traces, each with the
+    /// expectation it was packed with and the path `<corpus>(<member>)`. The
+    /// corpus stays mapped for the process, and executing one of those paths
+    /// opens the member in place rather than a file.
+    static std::vector<Trace>   corpus(std::string const& corpusPath);
+
+    /// A trace `rdb serve` put in shared memory, as the path `shm:<name>`.
+    /// The segment is mapped read-only for the process and checked in place,
+    /// with no load or fix-up of its own. Its strings become the ones this
+    /// process interns, so attach before reading a specification or trace.
+    /// Only one segment per process: each holds pointers into its own string
+    /// pool, so a second one holding any of the same strings could not be
+    /// adopted. Attaching another name throws.
+    static Trace                attach(std::string const& name);
+
     /// Compile the specification once and check every trace with it.
     ///
     /// Compilation dominates: roughly 700ms for a 233-requirement spec against
@@ -414,6 +435,60 @@ public:
                                    Detail detail = Detail::Requirements,
                                    std::string const& confPath = {});
 
+    /// Send trace-length buffers -- each recurrence's column, the run's copy
+    /// of the state rows, every computed signal, a `.rdb` slab -- to unlinked
+    /// files under `dir` instead of the heap, so a trace larger than memory is
+    /// paged through rather than held. Every pass over a column is one
+    /// straight walk, so the resident set is the pages being walked. Empty
+    /// goes back to the heap. Process-wide; call before executing.
+    static void     spill(std::string const& dir);
+
+    /// Evaluate one trace on up to `count` workers: each unbounded temporal
+    /// operator, integer accumulator and computed signal is cut into a block
+    /// per worker and stitched back together (see runtime/scan.hpp), with the
+    /// same verdicts as one thread. Traces shorter than a few hundred thousand
+    /// states stay on one. 1, the default, is sequential. Process-wide; call
+    /// before executing.
+    static void     threads(unsigned count);
+
+    /// The optimisation tier a run compiles at: 0..3 fixes both the IR
+    /// pipeline and the instruction selector's level, and -1 (`auto`, the
+    /// default) chooses per compilation -- O0 when the traces it will run over
+    /// are short enough that compiling is most of the cost, O2 otherwise. A
+    /// `monitor`'s stream has no known end, so `auto` gives it O2. Verdicts
+    /// do not depend on the tier. Process-wide; call before executing.
+    static void     optimize(int level);
+
+    /// The tier a compilation for `states` states runs at under the current
+    /// `optimize` setting: the fixed level, or for `auto` O0 below
+    /// `optCrossover()` states and O2 from there on.
+    static int          optLevelFor(std::size_t states);
+    static std::size_t  optCrossover();
+
+    /// Compile a module per distinct conf instead of one for every trace, with
+    /// the conf's values baked in as constants before optimisation, so that
+    /// thresholds fold, branches on a conf flag go, and a window whose bounds
+    /// come from the conf has constant bounds. Modules are cached by the conf
+    /// blob, so a corpus sharing one `conf.csv` still compiles once. Worth it
+    /// when the traces are long enough that the per-state code matters more
+    /// than a compilation or two. Off by default. Process-wide; call before
+    /// executing.
+    static void     specializeConf(bool on);
+
+    /// Check only the states timed in [from, to] of each `.rdb` trace, as if
+    /// they were the whole trace: `referee::db::slice` finds them by binary
+    /// search and reads nothing else. A trace of another kind, or one with no
+    /// state in the window, is an error. Process-wide; call before executing.
+    static void     window(std::int64_t from, std::int64_t to);
+
+    /// Check only the requirements with these labels -- a `@name`, or the
+    /// source position a `FAIL` line shows -- and load only the `data` props
+    /// they read (`Compile::reads`): the other columns of a trace are not
+    /// parsed, interned or fixed up. Without this the props the whole
+    /// specification reads are still all that is loaded. Process-wide; call
+    /// before executing.
+    static void     only(std::vector<std::string> const& labels);
+
     /// Compile REF source, JIT it, and evaluate every requirement against
     /// a packed `.rdb` trace whose state buffer is *already* the layout the
     /// JIT consumes — only pointer fix-up happens at load time. The
@@ -424,6 +499,56 @@ public:
                                std::ostream& os = std::cout,
                                std::vector<std::string> const& includePaths = {});
 
+    /// Split `monitor`'s stream into independent sessions by the value of
+    /// `column`: each key gets its own verdicts, residuals and past memory,
+    /// opened by its first row and closed -- finalised and reported as if its
+    /// stream had ended -- after `idle` units of `__time__` without a row
+    /// (0: never), when `maxKeys` are open and it is the least recently seen
+    /// (0: no limit), or at end of stream. An empty column turns it off.
+    /// Process-wide; call before monitoring.
+    static void     monitorKeys(std::string const& column, std::size_t maxKeys = 0,
+                                std::int64_t idle = 0);
+
+    /// Read `monitor`'s states as a binary frame stream (rdb/database.hpp,
+    /// `FrameWriter`) rather than CSV: each row arrives in `.rdb` wire form and
+    /// is evaluated where it lands. Process-wide; call before monitoring.
+    static void     monitorBinary(bool on);
+
+    /// How `monitor` reports: `states` writes every state's verdict line,
+    /// `changes` only the verdicts that moved and the violations, `ndjson` the
+    /// same events as one JSON object per line. Output is flushed per state, or
+    /// -- `flushMs` > 0 -- at most that often. Process-wide; call before
+    /// monitoring.
+    static void     monitorOutput(std::string const& format, unsigned flushMs = 0);
+
+    /// Checkpoint `monitor`: every `every` rows, write each open session's
+    /// state -- latches, residuals, past memory, the prefix path's rows -- to
+    /// `path`, atomically (a temporary renamed over it). `resume` restores such
+    /// a file before the first row; it must come from the same spec, conf,
+    /// schema and stream shape. Empty strings turn either off. Process-wide;
+    /// call before monitoring.
+    static void     monitorCheckpoint(std::string const& path, std::size_t every = 1000,
+                                      std::string const& resume = "");
+
+    /// The clock `monitor`'s deadlines run on. `stream` (the default) is the
+    /// rows' own `__time__`: a bounded `F`/`G` settles when a row past its
+    /// window arrives. `wall` reads the host clock as `__time__` -- `unit` per
+    /// unit (`1ms`, `100us`, ...), counted from the first row (`epoch` "first")
+    /// or the Unix epoch ("unix") -- and fires each pending deadline the moment
+    /// it passes, row or no row. Process-wide; call before monitoring.
+    static void     monitorClock(std::string const& clock, std::string const& unit = "1ms",
+                                 std::string const& epoch = "first");
+
+    /// Pipeline `monitor` over `threads` evaluator threads (0, the default:
+    /// one thread does everything). Rows are ingested on a thread of their own
+    /// into a ring of row windows, each evaluator steps its share of the
+    /// incremental requirements over every row, and the calling thread reports
+    /// in row and requirement order, so the output is the single-threaded
+    /// one's. For one CSV stream on the stream clock. With `latency` the run
+    /// ends with its rows' read-to-verdict latency (p50, p99, max) and its
+    /// throughput, threaded or not. Process-wide; call before monitoring.
+    static void     monitorThreads(unsigned threads, bool latency = false);
+
     /// Online monitoring: read states one CSV row at a time from `states` and
     /// evaluate every requirement as the trace grows, reporting a violation the
     /// instant an invariant breaks rather than after the run. `refStream` is
@@ -26,19 +26,39 @@
 
 #include "strings.hpp"
 #include "syntax.hpp"
+#include "runtime/columns.hpp"
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cerrno>
 #include <cstring>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <istream>
+#include <limits>
+#include <mutex>
 #include <optional>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <typeinfo>
 #include <unordered_map>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef REFEREE_HAVE_ZSTD
+#  include <zstd.h>
+#endif
+
 namespace referee::db
 {
 
@@ -47,6 +67,20 @@ namespace
 
 constexpr char      kMagic[8]    = {'R', 'E', 'F', '-', 'R', 'D', 'B', '1'};
 constexpr uint32_t  kVersion     = 1;
+constexpr uint32_t  kVersionBlocks = 2;
+//  The v1 layout with rows sharing blobs -- its own number, since a reader
+//  that predates sharing would resolve a shared blob's strings twice.
+constexpr uint32_t  kVersionShared = 3;
+//  How many of a prop's latest distinct values `Writer::finish` looks back
+//  over for one to share: enough for a value toggling between a few states.
+constexpr size_t    kRecentBlobs   = 4;
+constexpr char      kBlockMagic[8]   = {'R', 'E', 'F', '-', 'B', 'L', 'K', '1'};
+constexpr char      kPackedMagic[8]  = {'R', 'E', 'F', '-', 'B', 'L', 'K', 'P'};
+constexpr char      kTrailerMagic[8] = {'R', 'E', 'F', '-', 'E', 'N', 'D', '1'};
+constexpr char      kCorpusMagic[8]  = {'R', 'E', 'F', '-', 'R', 'D', 'B', 'X'};
+constexpr uint32_t  kCorpusVersion   = 1;
+constexpr char      kSharedMagic[8]  = {'R', 'E', 'F', '-', 'S', 'H', 'M', '1'};
+constexpr uint32_t  kSharedVersion   = 1;
 constexpr int64_t   kNullOffset  = -1;
 
 #pragma pack(push, 1)
@@ -78,6 +112,90 @@ struct OnDiskHeader
     Section     stringPool; // heterogeneous; itemNmbr = 0
     uint64_t    rowBytes;   // stride of `states`; equals 8 + 8 * schema.itemNmbr
 };
+
+/// Version 2 is an appended file (`Writer::appendState`). The header at the
+/// front places `schema` and `conf` only; the rows follow in blocks, each a
+/// `BlockHeader` and then its rows, its prop blobs and the strings it added to
+/// the pool, padded to 8. Offsets in a row and strings in a blob are into the
+/// blocks' blobs and pools taken end to end -- exactly the v1 `propBlobs` and
+/// `stringPool` -- so reading one back is concatenation. `finish` closes the
+/// file with the blocks' offsets and a `Trailer`; a file without one was cut
+/// short and is read up to its last complete block.
+struct BlockHeader
+{
+    char        magic[8];
+    uint64_t    numStates;
+    uint64_t    blobsSize;  // a multiple of 8, so the next block's blobs stay aligned
+    uint64_t    poolSize;
+};
+
+/// A block not written `Plain` (see `BlockCodec`): the `BlockHeader` counts,
+/// then how its rows are stored. `storedSize` bytes follow -- the encoded rows
+/// and the blobs, compressed as a whole for `Zstd` -- and then the pool delta,
+/// as it is.
+struct PackedHeader
+{
+    BlockHeader counts;     // magic "REF-BLKP"
+    uint32_t    codec;
+    uint32_t    reserved;
+    uint64_t    rowsSize;   // the encoded rows, before any compression
+    uint64_t    storedSize;
+};
+
+//  `times` is the sparse time index: a block's first time, so a window is
+//  found by a search over the blocks and then over the rows of one, without
+//  decoding any other. A block of no rows has the time of the row before it.
+struct Trailer
+{
+    Section     index;      // uint64 file offset per block; itemNmbr = number of blocks
+    Section     times;      // int64 first time per block; itemNmbr = number of blocks
+    uint64_t    numStates;
+    uint64_t    blobsSize;
+    uint64_t    poolSize;
+    char        magic[8];
+};
+
+/// A corpus (`.rdbx`, see `Corpus`). `members` is a `CorpusEntry` per trace,
+/// at the end of the file so `pack` streams the traces out as it reads them.
+/// Every offset is from the start of the file, a member's included.
+struct CorpusHeader
+{
+    char        magic[8];   // "REF-RDBX"
+    uint32_t    version;
+    uint32_t    flags;
+    Section     schema;     // itemNmbr = number of `data` decls
+    Section     names;      // NUL-terminated member names and `violates` lists
+    Section     stringPool; // every member's strings
+    Section     members;    // itemNmbr = number of members
+    uint64_t    rowBytes;
+};
+
+/// One member: what the `.rdb` header would place, bar the schema and the
+/// pool. Its row offsets are into its own `propBlobs`, as in a `.rdb`, and
+/// the strings in its blobs and conf into the corpus's pool.
+struct CorpusEntry
+{
+    uint64_t    name;           // offset into `names`
+    uint64_t    violates;       // offset into `names`: labels, comma-separated
+    uint32_t    expectFailure;
+    uint32_t    reserved;
+    Section     conf;
+    Section     states;
+    Section     propBlobs;
+};
+
+/// The head of a shared trace's segment (see `SharedTrace`), then the trace
+/// as a v1 `.rdb` image, fixed up for the segment mapped at `address`.
+/// `ready` is set last, so a segment whose `serve` died part way is refused.
+struct SharedHeader
+{
+    char        magic[8];   // "REF-SHM1"
+    uint32_t    version;
+    uint32_t    ready;
+    uint64_t    address;
+    uint64_t    imageOffs;
+    uint64_t    imageSize;
+};
 #pragma pack(pop)
 
 enum TypeTag : uint8_t
@@ -254,7 +372,10 @@ class BlobWalker
                      TypeEnum, TypeStruct, TypeArray>
 {
 public:
-    BlobWalker(uint8_t* base, size_t size) : m_base(base), m_size(size), m_cur(base) {}
+    //  `fixedUp`: the blob has been through the reader, so a ragged
+    //  descriptor holds a host pointer to its elements rather than an offset.
+    BlobWalker(uint8_t* base, size_t size, bool fixedUp = false)
+        : m_base(base), m_size(size), m_cur(base), m_high(base), m_fixedUp(fixedUp) {}
 
     void    walk(Type* type)
     {
@@ -264,6 +385,10 @@ public:
 
     size_t  consumed() const { return static_cast<size_t>(m_cur - m_base); }
 
+    //  How far the blob really runs: its fixed layout and any ragged elements
+    //  placed after it.
+    size_t  extent() const { return static_cast<size_t>(std::max(m_cur, m_high) - m_base); }
+
 protected:
     virtual void    visitString(uint8_t* slot) = 0;
 
@@ -294,6 +419,7 @@ protected:
         size_t  full    = s->size();
         if (written < full)
             m_cur += (full - written);
+        m_high = std::max(m_high, m_cur);
     }
     void    visit(TypeArray*   a) override
     {
@@ -312,6 +438,12 @@ protected:
 
             std::memcpy(&count, slot,     sizeof(count));
             std::memcpy(&delta, slot + 8, sizeof(delta));
+            if (m_fixedUp)
+            {
+                uint8_t*    host = nullptr;
+                std::memcpy(&host, slot + 8, sizeof(host));
+                delta = host != nullptr ? host - slot : 0;
+            }
 
             //  Elements live outside the fixed layout, so the walk detours to
             //  them and comes back. They may hold strings, which is the whole
@@ -337,6 +469,7 @@ private:
     {
         check(t->size());
         m_cur += t->size();
+        m_high = std::max(m_high, m_cur);
     }
 
     void    align(size_t a)
@@ -356,6 +489,8 @@ private:
     uint8_t*    m_base;
     size_t      m_size;
     uint8_t*    m_cur;
+    uint8_t*    m_high;
+    bool        m_fixedUp;
 };
 
 class StringInterner final : public BlobWalker
@@ -402,10 +537,18 @@ private:
 class StringResolver final : public BlobWalker
 {
 public:
-    StringResolver(uint8_t* base, size_t size, char const* pool, size_t poolSize)
+    //  `arrays` false leaves ragged descriptors relative: the blob is being
+    //  handed back in `Loader::load` form rather than to generated code.
+    //  `interned`, when given, is the pool's strings already interned, by
+    //  offset: a pool shared by many traces goes through `Strings` once.
+    StringResolver(uint8_t* base, size_t size, char const* pool, size_t poolSize,
+                   bool arrays = true,
+                   std::unordered_map<int64_t, char const*>* interned = nullptr)
         : BlobWalker(base, size)
         , m_pool(pool)
         , m_poolSize(poolSize)
+        , m_arrays(arrays)
+        , m_interned(interned)
     {
     }
 
@@ -416,6 +559,9 @@ protected:
     //  pointer.
     void    visitArray(uint8_t* slot, int64_t count, int64_t delta) override
     {
+        if (!m_arrays)
+            return;
+
         void*   host = slot + delta;
 
         std::memcpy(slot + 8, &host, sizeof(host));
@@ -432,14 +578,55 @@ protected:
         {
             if (off < 0 || static_cast<uint64_t>(off) >= m_poolSize)
                 throw std::runtime_error("rdb: string offset out of range");
-            hostPtr = Strings::instance()->getString(m_pool + off);
+            if (m_interned == nullptr)
+                hostPtr = Strings::instance()->getString(m_pool + off);
+            else
+            {
+                auto [it, added] = m_interned->try_emplace(off, nullptr);
+                if (added)
+                    it->second = Strings::instance()->getString(m_pool + off);
+                hostPtr = it->second;
+            }
         }
         std::memcpy(slot, &hostPtr, sizeof(hostPtr));
     }
 
 private:
-    char const*     m_pool;
-    size_t          m_poolSize;
+    char const*                                 m_pool;
+    size_t                                      m_poolSize;
+    bool                                        m_arrays;
+    std::unordered_map<int64_t, char const*>*   m_interned;
+};
+
+//  A fixed-up blob copied back out in `Loader::load` form: the strings are
+//  host pointers already, and each ragged descriptor's pointer goes back to
+//  the offset it was on disk. With `fixedUp` false the blob is still as on
+//  disk and the copy is just its extent, strings still pool offsets.
+class BlobCopier final : public BlobWalker
+{
+public:
+    BlobCopier(uint8_t* base, size_t size, bool fixedUp = true)
+        : BlobWalker(base, size, fixedUp), m_base(base) {}
+
+    std::vector<uint8_t>    copy(Type* type)
+    {
+        walk(type);
+        std::vector<uint8_t>    out(m_base, m_base + extent());
+        for (auto [at, delta] : m_arrays)
+            std::memcpy(out.data() + at + 8, &delta, sizeof(delta));
+        return out;
+    }
+
+protected:
+    void    visitString(uint8_t*) override {}
+    void    visitArray(uint8_t* slot, int64_t, int64_t delta) override
+    {
+        m_arrays.emplace_back(static_cast<size_t>(slot - m_base), delta);
+    }
+
+private:
+    uint8_t*                                m_base;
+    std::vector<std::pair<size_t, int64_t>> m_arrays;
 };
 
 } // namespace
@@ -489,100 +676,206 @@ void    decodeSchema(uint8_t const*&                         cur,
 }
 
 // ============================================================================
-//  Writer
+//  Packed blocks
 // ============================================================================
 
-struct Writer::Impl
+//  LEB128, signed values zigzagged first so a small negative delta is a short
+//  one too. Deltas are taken in uint64, wrapping, so no time overflows them.
+static void     putVarint(std::vector<uint8_t>& out, uint64_t v)
 {
-    std::ostream&                                       os;
-    std::vector<PropDecl>                               props;
-    std::vector<ConfDecl>                               confs;
-    size_t                                              numStates  = 0;
-    bool                                                hasNumStates = false;
-    std::vector<uint8_t>                                confBlob;
-    bool                                                hasConfBlob  = false;
-    // For each prop, the per-state blob bytes. blobs[pi][si] is the bytes for
-    // (state si, prop pi). Empty inner vector means "null pointer for this
-    // state's slot". Equivalent to `std::vector<blob_t>`, but the outer index
-    // is prop-major rather than state-major (the `blob_t` exposed by the API
-    // is one row's worth, indexed by prop).
-    std::vector<blob_t>                                 blobs;
-    std::vector<std::optional<int64_t>>                 times;
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
 
-    explicit Impl(std::ostream& s) : os(s) {}
-};
+static void     putSigned(std::vector<uint8_t>& out, uint64_t v)
+{
+    putVarint(out, (v << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(v) >> 63));
+}
 
-Writer::Writer(std::ostream& os) : m_impl(std::make_unique<Impl>(os)) {}
-Writer::~Writer() = default;
+static uint64_t getVarint(uint8_t const*& cur, uint8_t const* end)
+{
+    uint64_t    v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (cur == end)
+            throw std::runtime_error("rdb: packed block cut short");
+        uint8_t b = *cur++;
+        v |= uint64_t(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+            return v;
+    }
+    throw std::runtime_error("rdb: bad varint in a packed block");
+}
 
-void    Writer::setSchema(std::vector<PropDecl> props,
-                          std::vector<ConfDecl> confs)
+static uint64_t getSigned(uint8_t const*& cur, uint8_t const* end)
 {
-    m_impl->props = std::move(props);
-    m_impl->confs = std::move(confs);
-    m_impl->blobs.assign(m_impl->props.size(), {});
+    uint64_t    v = getVarint(cur, end);
+    return (v >> 1) ^ (0 - (v & 1));
 }
 
-void    Writer::setNumStates(std::size_t numStates)
+//  `n` on-disk rows as a packed block stores them: every time as the change in
+//  its step from the last, which for a steady sample rate is 0 -- one byte --
+//  and then prop by prop, the offsets as runs of one value, each a length and
+//  the step from the run before. A held value the writer stored once is one
+//  run however long it is held.
+static std::vector<uint8_t>     packRows(uint8_t const* rows, uint64_t n, uint64_t numProps)
 {
-    m_impl->numStates    = numStates;
-    m_impl->hasNumStates = true;
-    m_impl->times.assign(numStates, {});
-    for (auto& vec : m_impl->blobs)
-        vec.assign(numStates, {});
+    auto const  rowBytes = sizeof(int64_t) * (1 + numProps);
+    auto        slot     = [&](uint64_t si, uint64_t col)
+    {
+        uint64_t    v = 0;
+        std::memcpy(&v, rows + si * rowBytes + col * sizeof(int64_t), sizeof(v));
+        return v;
+    };
+
+    std::vector<uint8_t>    out;
+    uint64_t    prev = 0, step = 0;
+    for (uint64_t si = 0; si < n; si++)
+    {
+        uint64_t    t = slot(si, 0);
+        putSigned(out, t - prev - step);
+        step = t - prev;
+        prev = t;
+    }
+    for (uint64_t pi = 0; pi < numProps; pi++)
+    {
+        uint64_t    last = 0;
+        for (uint64_t si = 0; si < n; )
+        {
+            uint64_t    v   = slot(si, 1 + pi);
+            uint64_t    run = 1;
+            while (si + run < n && slot(si + run, 1 + pi) == v)
+                run++;
+            putVarint(out, run);
+            putSigned(out, v - last);
+            last = v;
+            si  += run;
+        }
+    }
+    return out;
 }
 
-void    Writer::setConfBlob(std::vector<std::uint8_t> blob)
+static void     unpackRows(uint8_t const* cur, uint8_t const* end,
+                           uint64_t n, uint64_t numProps, uint8_t* rows)
 {
-    m_impl->confBlob    = std::move(blob);
-    m_impl->hasConfBlob = true;
+    auto const  rowBytes = sizeof(int64_t) * (1 + numProps);
+    auto        slot     = [&](uint64_t si, uint64_t col, uint64_t v)
+    {
+        std::memcpy(rows + si * rowBytes + col * sizeof(int64_t), &v, sizeof(v));
+    };
+
+    uint64_t    prev = 0, step = 0;
+    for (uint64_t si = 0; si < n; si++)
+    {
+        step += getSigned(cur, end);
+        prev += step;
+        slot(si, 0, prev);
+    }
+    for (uint64_t pi = 0; pi < numProps; pi++)
+    {
+        uint64_t    last = 0;
+        for (uint64_t si = 0; si < n; )
+        {
+            uint64_t    run = getVarint(cur, end);
+            last += getSigned(cur, end);
+            if (run == 0 || run > n - si)
+                throw std::runtime_error("rdb: bad run in a packed block");
+            for (uint64_t k = 0; k < run; k++)
+                slot(si + k, 1 + pi, last);
+            si += run;
+        }
+    }
+    if (cur != end)
+        throw std::runtime_error("rdb: trailing bytes in packed rows");
 }
 
-void    Writer::writeState(std::size_t      stateIdx,
-                           std::int64_t     time,
-                           blob_t const&    propBlobs)
+static std::vector<uint8_t>     compressBlock(BlockCodec codec, std::vector<uint8_t> raw)
 {
-    if (!m_impl->hasNumStates)
-        throw std::runtime_error("rdb: writer.setNumStates() not called");
-    if (stateIdx >= m_impl->numStates)
-        throw std::runtime_error(fmt::format("rdb: state index {} out of range (0..{})",
-                                             stateIdx, m_impl->numStates));
-    if (propBlobs.size() != m_impl->props.size())
-        throw std::runtime_error(fmt::format("rdb: state {}: expected {} prop blobs, got {}",
-                                             stateIdx, m_impl->props.size(), propBlobs.size()));
+    if (codec != BlockCodec::Zstd)
+        return raw;
+#ifdef REFEREE_HAVE_ZSTD
+    std::vector<uint8_t>    out(ZSTD_compressBound(raw.size()));
+    auto    n = ZSTD_compress(out.data(), out.size(), raw.data(), raw.size(), 3);
+    if (ZSTD_isError(n))
+        throw std::runtime_error(fmt::format("rdb: zstd: {}", ZSTD_getErrorName(n)));
+    out.resize(n);
+    return out;
+#else
+    throw std::runtime_error("rdb: this build has no zstd");
+#endif
+}
 
-    m_impl->times[stateIdx]   = time;
-    for (size_t pi = 0; pi < propBlobs.size(); pi++)
-        m_impl->blobs[pi][stateIdx] = propBlobs[pi];
+//  `stored` -> `raw`, which the caller sized from the block header.
+static void     decompressBlock(BlockCodec codec, uint8_t const* stored, uint64_t storedSize,
+                                std::vector<uint8_t>& raw)
+{
+#ifdef REFEREE_HAVE_ZSTD
+    if (codec == BlockCodec::Zstd)
+    {
+        auto    n = ZSTD_decompress(raw.data(), raw.size(), stored, storedSize);
+        if (ZSTD_isError(n) || n != raw.size())
+            throw std::runtime_error("rdb: zstd block does not decompress to its size");
+        return;
+    }
+#endif
+    (void) stored;
+    (void) storedSize;
+    (void) raw;
+    throw std::runtime_error(fmt::format("rdb: block codec {} is not supported by this build",
+                                         static_cast<uint32_t>(codec)));
 }
 
-void    Writer::finish()
+// ============================================================================
+//  Writer
+// ============================================================================
+
+using StringDict = std::unordered_map<std::string, uint64_t>;
+
+// The conf blob is the concatenation of all conf members, each aligned
+// with `alignBuffer(buf, ctype->alignment())` before Loader::load fills
+// it. Replicate that exact walk so per-member alignment math stays
+// buffer-relative — same as Loader::load.
+static void     internConfBlob(std::vector<ConfDecl> const& confs,
+                               std::vector<uint8_t>&        confBlob,
+                               StringDict&                  dict,
+                               std::vector<uint8_t>&        stringPool)
 {
-    if (!m_impl->hasNumStates)
-        throw std::runtime_error("rdb: writer.setNumStates() not called");
-    if (!m_impl->hasConfBlob)
-        throw std::runtime_error("rdb: writer.setConfBlob() not called");
-    for (size_t si = 0; si < m_impl->numStates; si++)
-        if (!m_impl->times[si].has_value())
-            throw std::runtime_error(fmt::format("rdb: writeState() never called for index {}", si));
+    size_t cur = 0;
+    for (auto const& c : confs)
+    {
+        size_t a   = c.type->alignment();
+        size_t rem = cur % a;
+        if (rem) cur += (a - rem);
+        StringInterner sub(confBlob.data() + cur, confBlob.size() - cur,
+                           dict, stringPool);
+        sub.walk(c.type);
+        cur += sub.consumed();
+    }
+    if (cur > confBlob.size())
+        throw std::runtime_error("rdb: conf blob size disagrees with schema");
+}
 
-    auto const  numProps     = m_impl->props.size();
-    auto const  numStates    = m_impl->numStates;
+//  The `states` and `propBlobs` sections of a batch-written trace, from its
+//  blobs (`blobs[pi][si]`, interned into `dict` / `stringPool` in place) and
+//  times. True when rows share a blob, which makes the file a version 3.
+static bool     layoutRows(std::vector<PropDecl> const&  props,
+                           std::vector<blob_t>&          blobs,
+                           std::vector<int64_t> const&   times,
+                           StringDict&                   dict,
+                           std::vector<uint8_t>&         stringPool,
+                           std::vector<uint8_t>&         states,
+                           std::vector<uint8_t>&         propBlobs)
+{
+    auto const  numProps     = props.size();
+    auto const  numStates    = times.size();
     auto const  rowBytes     = sizeof(int64_t) + numProps * sizeof(int64_t);
 
-    // Encode schema.
-    std::vector<uint8_t>    schemaBytes;
-    encodeSchema(schemaBytes, m_impl->props, m_impl->confs);
-
     // Build the string pool incrementally, replacing each TypeString slot in
-    // every blob with an offset into the (yet-unfinished) pool. Pool offset 0
-    // is unused — the empty string is stored there explicitly so callers that
-    // happen to default-init a string to empty still get a real entry.
-    std::unordered_map<std::string, uint64_t>   dict;
-    std::vector<uint8_t>                        stringPool;
-    stringPool.push_back(0);                              // offset 0 = ""
-    dict.emplace("", uint64_t{0});
-
+    // every blob with an offset into the (yet-unfinished) pool.
     auto    internOne = [&](uint8_t* base, size_t size, Type* type)
     {
         if (size == 0) return;
@@ -590,51 +883,62 @@ void    Writer::finish()
         walker.walk(type);
     };
 
-    // The conf blob is the concatenation of all conf members, each aligned
-    // with `alignBuffer(buf, ctype->alignment())` before Loader::load fills
-    // it. Replicate that exact walk so per-member alignment math stays
-    // buffer-relative — same as Loader::load.
+    // A slot equal to one of the last few distinct values of its prop shares
+    // that value's blob instead of storing another copy: a signal held for a
+    // thousand rows is one blob, not a thousand. `source[pi][si]` is the state
+    // whose blob slot (si, pi) points at -- itself, unless it shares.
+    std::vector<std::vector<size_t>>    source(numProps, std::vector<size_t>(numStates));
+    bool                                shared = false;
+    for (size_t pi = 0; pi < numProps; pi++)
     {
-        size_t cur = 0;
-        for (auto const& c : m_impl->confs)
+        auto const&         col = blobs[pi];
+        std::vector<size_t> recent;
+        for (size_t si = 0; si < numStates; si++)
         {
-            size_t a   = c.type->alignment();
-            size_t rem = cur % a;
-            if (rem) cur += (a - rem);
-            StringInterner sub(m_impl->confBlob.data() + cur,
-                               m_impl->confBlob.size() - cur,
-                               dict, stringPool);
-            sub.walk(c.type);
-            cur += sub.consumed();
+            source[pi][si] = si;
+            if (col[si].empty()) continue;
+            auto    hit = std::find_if(recent.rbegin(), recent.rend(),
+                                       [&](size_t sj) { return col[sj] == col[si]; });
+            if (hit != recent.rend())
+            {
+                source[pi][si] = *hit;
+                shared         = true;
+                continue;
+            }
+            if (recent.size() == kRecentBlobs)
+                recent.erase(recent.begin());
+            recent.push_back(si);
         }
-        if (cur > m_impl->confBlob.size())
-            throw std::runtime_error("rdb: conf blob size disagrees with schema");
     }
 
     for (size_t pi = 0; pi < numProps; pi++)
     {
         for (size_t si = 0; si < numStates; si++)
         {
-            auto& blob = m_impl->blobs[pi][si];
-            if (blob.empty()) continue;
-            internOne(blob.data(), blob.size(), m_impl->props[pi].type);
+            auto& blob = blobs[pi][si];
+            if (blob.empty() || source[pi][si] != si) continue;
+            internOne(blob.data(), blob.size(), props[pi].type);
         }
     }
 
     // Build prop-blobs section and a parallel offset table.
-    std::vector<uint8_t>                        propBlobs;
     std::vector<std::vector<int64_t>>           offsets(numStates,
                                                         std::vector<int64_t>(numProps, kNullOffset));
     for (size_t si = 0; si < numStates; si++)
     {
         for (size_t pi = 0; pi < numProps; pi++)
         {
-            auto& blob = m_impl->blobs[pi][si];
+            auto& blob = blobs[pi][si];
             if (blob.empty()) continue;
+            if (source[pi][si] != si)
+            {
+                offsets[si][pi] = offsets[source[pi][si]][pi];
+                continue;
+            }
             // Align inside the prop-blobs section to the prop type's alignment
             // so that the host pointer the reader hands to JIT'd code respects
             // the alignment Loader::load assumed.
-            size_t a   = m_impl->props[pi].type->alignment();
+            size_t a   = props[pi].type->alignment();
             size_t rem = propBlobs.size() % a;
             if (rem)
                 propBlobs.insert(propBlobs.end(), a - rem, uint8_t{0});
@@ -644,11 +948,11 @@ void    Writer::finish()
     }
 
     // Build state buffer with int64 offsets (later relocated by Reader).
-    std::vector<uint8_t>    states(numStates * rowBytes, uint8_t{0});
+    states.assign(numStates * rowBytes, uint8_t{0});
     for (size_t si = 0; si < numStates; si++)
     {
         uint8_t*    row = states.data() + si * rowBytes;
-        int64_t     t   = m_impl->times[si].value();
+        int64_t     t   = times[si];
         std::memcpy(row, &t, sizeof(t));
         for (size_t pi = 0; pi < numProps; pi++)
         {
@@ -657,207 +961,1080 @@ void    Writer::finish()
                         &off, sizeof(off));
         }
     }
+    return shared;
+}
+
+struct Writer::Impl
+{
+    std::ostream&                                       os;
+    std::vector<PropDecl>                               props;
+    std::vector<ConfDecl>                               confs;
+    size_t                                              numStates  = 0;
+    bool                                                hasNumStates = false;
+    std::vector<uint8_t>                                confBlob;
+    bool                                                hasConfBlob  = false;
+    // For each prop, the per-state blob bytes. blobs[pi][si] is the bytes for
+    // (state si, prop pi). Empty inner vector means "null pointer for this
+    // state's slot". Equivalent to `std::vector<blob_t>`, but the outer index
+    // is prop-major rather than state-major (the `blob_t` exposed by the API
+    // is one row's worth, indexed by prop).
+    std::vector<blob_t>                                 blobs;
+    std::vector<std::optional<int64_t>>                 times;
+
+    //  Pool offset 0 is unused -- the empty string is stored there explicitly
+    //  so callers that happen to default-init a string to empty still get a
+    //  real entry.
+    std::unordered_map<std::string, uint64_t>           dict{{"", 0}};
+    std::vector<uint8_t>                                stringPool{0};
+
+    //  Append mode (`appendState`): rows go out in blocks as they come, each
+    //  block its rows, their blobs and the strings they added to the pool. The
+    //  writer then holds the string pool and one block, not the trace.
+    bool                                                appending  = false;
+    size_t                                              blockRows  = 1024;
+    std::vector<uint8_t>                                blkStates;
+    std::vector<uint8_t>                                blkBlobs;
+    size_t                                              blkCount   = 0;
+    uint64_t                                            blobsBase  = 0;     //  blob bytes in earlier blocks
+    uint64_t                                            poolOut    = 0;     //  pool bytes in earlier blocks
+    uint64_t                                            fileOut    = 0;     //  bytes written so far
+    uint64_t                                            appended   = 0;
+    std::vector<uint64_t>                               blockOffs;
+    std::vector<int64_t>                                blockTimes;
+    int64_t                                             lastTime   = std::numeric_limits<int64_t>::min();
+
+    //  A value held over consecutive rows of a block is stored once, as
+    //  `finish` does over the whole trace: each prop's last blob as given, and
+    //  where it went. Per block, so a packed block decodes on its own.
+    BlockCodec                                          codec      = BlockCodec::Plain;
+    blob_t                                              held;
+    std::vector<int64_t>                                heldAt;
+
+    explicit Impl(std::ostream& s) : os(s) {}
+
+    void    put(void const* p, size_t n)
+    {
+        os.write(static_cast<char const*>(p), static_cast<std::streamsize>(n));
+        fileOut += n;
+    }
+    void    padTo8()
+    {
+        static constexpr uint8_t    zeros[8] = {};
+        put(zeros, (8 - fileOut % 8) % 8);
+    }
+
+    void    internConf()
+    {
+        internConfBlob(confs, confBlob, dict, stringPool);
+    }
+
+    void    startBlocks();
+    void    flushBlock();
+    void    finishBlocks();
+};
+
+void    Writer::Impl::startBlocks()
+{
+    if (!hasConfBlob)
+        throw std::runtime_error("rdb: writer.setConfBlob() must come before appendState()");
+    appending = true;
+    held.assign(props.size(), {});
+    heldAt.assign(props.size(), kNullOffset);
+
+    std::vector<uint8_t>    schemaBytes;
+    encodeSchema(schemaBytes, props, confs);
+    internConf();
 
-    // Lay out the file. Each section is 8-byte aligned for cleanliness so a
-    // future mmap-backed reader can directly cast section pointers without
-    // worrying about misalignment.
     auto    align8 = [](uint64_t v) { return (v + 7u) & ~uint64_t{7}; };
 
     OnDiskHeader    hdr{};
     std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
-    hdr.version        = kVersion;
-    hdr.flags          = 0;
+    hdr.version  = kVersionBlocks;
+    hdr.schema   = {sizeof(OnDiskHeader), schemaBytes.size(), props.size()};
+    hdr.conf     = {align8(hdr.schema.fileOffs + hdr.schema.fileSize), confBlob.size(), confs.size()};
+    hdr.rowBytes = sizeof(int64_t) + props.size() * sizeof(int64_t);
+
+    put(&hdr, sizeof(hdr));
+    put(schemaBytes.data(), schemaBytes.size());
+    padTo8();
+    put(confBlob.data(), confBlob.size());
+    padTo8();
+
+    //  The conf's strings go out at once, in a block of no rows, so a file cut
+    //  short before its first full block still opens.
+    flushBlock();
+}
 
-    auto    place = [&](Section& sec, uint64_t& cursor, uint64_t sz, uint64_t cnt)
-    {
-        cursor       = align8(cursor);
-        sec.fileOffs = cursor;
-        sec.fileSize = sz;
-        sec.itemNmbr = cnt;
-        cursor      += sz;
-    };
+void    Writer::Impl::flushBlock()
+{
+    uint64_t    poolSize = stringPool.size() - poolOut;
+    if (blkCount == 0 && poolSize == 0)
+        return;
 
-    uint64_t cursor = sizeof(OnDiskHeader);
-    place(hdr.schema,     cursor, schemaBytes.size(),     numProps);
-    place(hdr.conf,       cursor, m_impl->confBlob.size(), m_impl->confs.size());
-    place(hdr.states,     cursor, states.size(),          numStates);
-    place(hdr.propBlobs,  cursor, propBlobs.size(),       0);
-    place(hdr.stringPool, cursor, stringPool.size(),      0);
+    alignBuffer(blkBlobs, 8);
 
-    hdr.rowBytes         = rowBytes;
+    BlockHeader bh{};
+    std::memcpy(bh.magic, kBlockMagic, sizeof(kBlockMagic));
+    bh.numStates = blkCount;
+    bh.blobsSize = blkBlobs.size();
+    bh.poolSize  = poolSize;
 
-    auto    write = [&](void const* p, size_t n)
+    blockOffs.push_back(fileOut);
+    int64_t     first = lastTime;
+    if (blkCount != 0)
     {
-        m_impl->os.write(reinterpret_cast<char const*>(p), static_cast<std::streamsize>(n));
-    };
-    auto    pad = [&](uint64_t curOff, uint64_t target)
+        std::memcpy(&first,    blkStates.data(), sizeof(first));
+        std::memcpy(&lastTime, blkStates.data() + blkStates.size() - (1 + props.size()) * sizeof(int64_t),
+                    sizeof(lastTime));
+    }
+    blockTimes.push_back(first);
+    if (codec == BlockCodec::Plain)
     {
-        while (curOff < target)
-        {
-            uint8_t z = 0;
-            write(&z, 1);
-            curOff++;
-        }
-        return curOff;
-    };
-
-    uint64_t off = 0;
-    write(&hdr, sizeof(hdr)); off += sizeof(hdr);
-    auto    emit = [&](Section const& sec, void const* data)
+        put(&bh, sizeof(bh));
+        put(blkStates.data(), blkStates.size());
+        put(blkBlobs.data(), blkBlobs.size());
+    }
+    else
     {
-        off = pad(off, sec.fileOffs);
-        write(data, sec.fileSize);
-        off += sec.fileSize;
-    };
-    emit(hdr.schema,     schemaBytes.data());
-    emit(hdr.conf,       m_impl->confBlob.data());
-    emit(hdr.states,     states.data());
-    emit(hdr.propBlobs,  propBlobs.data());
-    emit(hdr.stringPool, stringPool.data());
+        auto    raw = packRows(blkStates.data(), blkCount, props.size());
 
-    m_impl->os.flush();
-}
+        PackedHeader    ph{};
+        ph.counts   = bh;
+        std::memcpy(ph.counts.magic, kPackedMagic, sizeof(kPackedMagic));
+        ph.codec    = static_cast<uint32_t>(codec);
+        ph.rowsSize = raw.size();
+        raw.insert(raw.end(), blkBlobs.begin(), blkBlobs.end());
+        auto    stored = compressBlock(codec, std::move(raw));
+        ph.storedSize  = stored.size();
 
-// ============================================================================
-//  Reader
-// ============================================================================
+        put(&ph, sizeof(ph));
+        put(stored.data(), stored.size());
+    }
+    put(stringPool.data() + poolOut, poolSize);
+    padTo8();
+    os.flush();
+
+    blobsBase += blkBlobs.size();
+    poolOut   += poolSize;
+    blkStates.clear();
+    blkBlobs.clear();
+    blkCount   = 0;
+    held.assign(props.size(), {});
+    heldAt.assign(props.size(), kNullOffset);
+}
 
-struct Reader::Impl
+void    Writer::Impl::finishBlocks()
 {
-    std::vector<uint8_t>                    data;
-    OnDiskHeader                            hdr{};
-    std::vector<std::unique_ptr<Type>>      typeSink;
-    std::vector<PropDecl>                   props;
-    std::vector<ConfDecl>                   confs;
+    flushBlock();
+
+    Trailer tr{};
+    tr.index     = {fileOut, blockOffs.size() * sizeof(uint64_t), blockOffs.size()};
+    tr.times     = {tr.index.fileOffs + tr.index.fileSize, blockTimes.size() * sizeof(int64_t), blockTimes.size()};
+    tr.numStates = appended;
+    tr.blobsSize = blobsBase;
+    tr.poolSize  = poolOut;
+    std::memcpy(tr.magic, kTrailerMagic, sizeof(kTrailerMagic));
+
+    put(blockOffs.data(), blockOffs.size() * sizeof(uint64_t));
+    put(blockTimes.data(), blockTimes.size() * sizeof(int64_t));
+    put(&tr, sizeof(tr));
+    os.flush();
+}
 
-    // Validate the slab in `data` and run the in-place pointer fix-up.
-    // `ctx` is purely for error messages (file path or "<memory>").
-    void    fixUp(std::string const& ctx)
+Writer::Writer(std::ostream& os) : m_impl(std::make_unique<Impl>(os)) {}
+Writer::~Writer() = default;
+
+void    Writer::setSchema(std::vector<PropDecl> props,
+                          std::vector<ConfDecl> confs)
+{
+    m_impl->props = std::move(props);
+    m_impl->confs = std::move(confs);
+    m_impl->blobs.assign(m_impl->props.size(), {});
+}
+
+void    Writer::setNumStates(std::size_t numStates)
+{
+    if (m_impl->appending)
+        throw std::runtime_error("rdb: writer.setNumStates() after appendState()");
+    m_impl->numStates    = numStates;
+    m_impl->hasNumStates = true;
+    m_impl->times.assign(numStates, {});
+    for (auto& vec : m_impl->blobs)
+        vec.assign(numStates, {});
+}
+
+void    Writer::setConfBlob(std::vector<std::uint8_t> blob)
+{
+    m_impl->confBlob    = std::move(blob);
+    m_impl->hasConfBlob = true;
+}
+
+void    Writer::writeState(std::size_t      stateIdx,
+                           std::int64_t     time,
+                           blob_t const&    propBlobs)
+{
+    if (!m_impl->hasNumStates)
+        throw std::runtime_error("rdb: writer.setNumStates() not called");
+    if (stateIdx >= m_impl->numStates)
+        throw std::runtime_error(fmt::format("rdb: state index {} out of range (0..{})",
+                                             stateIdx, m_impl->numStates));
+    if (propBlobs.size() != m_impl->props.size())
+        throw std::runtime_error(fmt::format("rdb: state {}: expected {} prop blobs, got {}",
+                                             stateIdx, m_impl->props.size(), propBlobs.size()));
+
+    m_impl->times[stateIdx]   = time;
+    for (size_t pi = 0; pi < propBlobs.size(); pi++)
+        m_impl->blobs[pi][stateIdx] = propBlobs[pi];
+}
+
+void    Writer::setBlockRows(std::size_t rows)
+{
+    m_impl->blockRows = std::max<std::size_t>(rows, 1);
+}
+
+void    Writer::setBlockCodec(BlockCodec codec)
+{
+    if (m_impl->appending)
+        throw std::runtime_error("rdb: writer.setBlockCodec() after appendState()");
+#ifndef REFEREE_HAVE_ZSTD
+    if (codec == BlockCodec::Zstd)
+        throw std::runtime_error("rdb: this build has no zstd");
+#endif
+    m_impl->codec = codec;
+}
+
+void    Writer::appendState(std::int64_t time, blob_t const& propBlobs)
+{
+    auto&   impl = *m_impl;
+    if (impl.hasNumStates)
+        throw std::runtime_error("rdb: writer.appendState() after setNumStates()");
+    if (propBlobs.size() != impl.props.size())
+        throw std::runtime_error(fmt::format("rdb: state {}: expected {} prop blobs, got {}",
+                                             impl.appended, impl.props.size(), propBlobs.size()));
+    if (!impl.appending)
+        impl.startBlocks();
+
+    std::vector<int64_t>    row(1 + impl.props.size(), kNullOffset);
+    row[0] = time;
+    for (size_t pi = 0; pi < propBlobs.size(); pi++)
     {
-        if (data.size() < sizeof(OnDiskHeader))
-            throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdb file", ctx));
+        if (propBlobs[pi].empty()) continue;
+        if (impl.heldAt[pi] != kNullOffset && impl.held[pi] == propBlobs[pi])
+        {
+            row[1 + pi] = impl.heldAt[pi];
+            continue;
+        }
+
+        //  Aligned to the prop type, as `finish` places a batch-written blob;
+        //  every block's blobs start 8-aligned, so block-relative will do.
+        alignBuffer(impl.blkBlobs, impl.props[pi].type->alignment());
+        size_t  at = impl.blkBlobs.size();
+        impl.blkBlobs.insert(impl.blkBlobs.end(), propBlobs[pi].begin(), propBlobs[pi].end());
+
+        StringInterner  walker(impl.blkBlobs.data() + at, propBlobs[pi].size(),
+                               impl.dict, impl.stringPool);
+        walker.walk(impl.props[pi].type);
+        row[1 + pi]     = static_cast<int64_t>(impl.blobsBase + at);
+        impl.held[pi]   = propBlobs[pi];
+        impl.heldAt[pi] = row[1 + pi];
+    }
+    auto const* bytes = reinterpret_cast<uint8_t const*>(row.data());
+    impl.blkStates.insert(impl.blkStates.end(), bytes, bytes + row.size() * sizeof(int64_t));
+    impl.blkCount++;
+    impl.appended++;
+
+    if (impl.blkCount >= impl.blockRows)
+        impl.flushBlock();
+}
+
+void    Writer::flush()
+{
+    if (m_impl->appending)
+        m_impl->flushBlock();
+}
+
+void    Writer::finish()
+{
+    if (m_impl->appending)
+    {
+        m_impl->finishBlocks();
+        return;
+    }
+    if (!m_impl->hasNumStates)
+        throw std::runtime_error("rdb: writer.setNumStates() not called");
+    if (!m_impl->hasConfBlob)
+        throw std::runtime_error("rdb: writer.setConfBlob() not called");
+    for (size_t si = 0; si < m_impl->numStates; si++)
+        if (!m_impl->times[si].has_value())
+            throw std::runtime_error(fmt::format("rdb: writeState() never called for index {}", si));
+
+    auto const  numProps     = m_impl->props.size();
+    auto const  numStates    = m_impl->numStates;
+    auto const  rowBytes     = sizeof(int64_t) + numProps * sizeof(int64_t);
+
+    // Encode schema.
+    std::vector<uint8_t>    schemaBytes;
+    encodeSchema(schemaBytes, m_impl->props, m_impl->confs);
+
+    m_impl->internConf();
+
+    std::vector<int64_t>    times(numStates);
+    for (size_t si = 0; si < numStates; si++)
+        times[si] = m_impl->times[si].value();
+
+    auto&                   stringPool = m_impl->stringPool;
+    std::vector<uint8_t>    states;
+    std::vector<uint8_t>    propBlobs;
+    bool                    shared = layoutRows(m_impl->props, m_impl->blobs, times,
+                                                m_impl->dict, stringPool,
+                                                states, propBlobs);
+
+    // Lay out the file. Each section is 8-byte aligned for cleanliness so a
+    // future mmap-backed reader can directly cast section pointers without
+    // worrying about misalignment.
+    auto    align8 = [](uint64_t v) { return (v + 7u) & ~uint64_t{7}; };
 
-        std::memcpy(&hdr, data.data(), sizeof(OnDiskHeader));
+    OnDiskHeader    hdr{};
+    std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+    hdr.version        = shared ? kVersionShared : kVersion;
+    hdr.flags          = 0;
 
-        if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0)
-            throw std::runtime_error(fmt::format("rdb: bad magic in '{}'", ctx));
-        if (hdr.version != kVersion)
-            throw std::runtime_error(fmt::format("rdb: unsupported version {} in '{}'",
-                                                 hdr.version, ctx));
+    auto    place = [&](Section& sec, uint64_t& cursor, uint64_t sz, uint64_t cnt)
+    {
+        cursor       = align8(cursor);
+        sec.fileOffs = cursor;
+        sec.fileSize = sz;
+        sec.itemNmbr = cnt;
+        cursor      += sz;
+    };
+
+    uint64_t cursor = sizeof(OnDiskHeader);
+    place(hdr.schema,     cursor, schemaBytes.size(),     numProps);
+    place(hdr.conf,       cursor, m_impl->confBlob.size(), m_impl->confs.size());
+    place(hdr.states,     cursor, states.size(),          numStates);
+    place(hdr.propBlobs,  cursor, propBlobs.size(),       0);
+    place(hdr.stringPool, cursor, stringPool.size(),      0);
 
-        auto    needRange = [&](Section const& sec, char const* what)
+    hdr.rowBytes         = rowBytes;
+
+    auto    write = [&](void const* p, size_t n)
+    {
+        m_impl->os.write(reinterpret_cast<char const*>(p), static_cast<std::streamsize>(n));
+    };
+    auto    pad = [&](uint64_t curOff, uint64_t target)
+    {
+        while (curOff < target)
         {
-            if (sec.fileOffs + sec.fileSize > data.size())
-                throw std::runtime_error(fmt::format("rdb: {} section out of bounds", what));
-        };
-        needRange(hdr.schema,     "schema");
-        needRange(hdr.conf,       "conf");
-        needRange(hdr.states,     "states");
-        needRange(hdr.propBlobs,  "prop-blobs");
-        needRange(hdr.stringPool, "string-pool");
-
-        if (hdr.states.itemNmbr * hdr.rowBytes != hdr.states.fileSize)
-            throw std::runtime_error("rdb: states section size mismatch");
-
-        // Decode schema, then cross-check all the redundant counts/strides.
+            uint8_t z = 0;
+            write(&z, 1);
+            curOff++;
+        }
+        return curOff;
+    };
+
+    uint64_t off = 0;
+    write(&hdr, sizeof(hdr)); off += sizeof(hdr);
+    auto    emit = [&](Section const& sec, void const* data)
+    {
+        off = pad(off, sec.fileOffs);
+        write(data, sec.fileSize);
+        off += sec.fileSize;
+    };
+    emit(hdr.schema,     schemaBytes.data());
+    emit(hdr.conf,       m_impl->confBlob.data());
+    emit(hdr.states,     states.data());
+    emit(hdr.propBlobs,  propBlobs.data());
+    emit(hdr.stringPool, stringPool.data());
+
+    m_impl->os.flush();
+}
+
+// ============================================================================
+//  Reader
+// ============================================================================
+
+//  Check a `.rdb`'s header against the `size` bytes at `data` and decode its
+//  schema -- everything short of touching a row. `ctx` is for messages.
+static void openHeader(uint8_t const*                       data,
+                       std::size_t                          size,
+                       std::string const&                   ctx,
+                       OnDiskHeader&                        hdr,
+                       std::vector<PropDecl>&               props,
+                       std::vector<ConfDecl>&               confs,
+                       std::vector<std::unique_ptr<Type>>&  typeSink)
+{
+    if (size < sizeof(OnDiskHeader))
+        throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdb file", ctx));
+
+    std::memcpy(&hdr, data, sizeof(OnDiskHeader));
+
+    if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error(fmt::format("rdb: bad magic in '{}'", ctx));
+    if (hdr.version != kVersion && hdr.version != kVersionBlocks && hdr.version != kVersionShared)
+        throw std::runtime_error(fmt::format("rdb: unsupported version {} in '{}'",
+                                             hdr.version, ctx));
+
+    auto    needRange = [&](Section const& sec, char const* what)
+    {
+        if (sec.fileOffs + sec.fileSize > size)
+            throw std::runtime_error(fmt::format("rdb: {} section out of bounds", what));
+    };
+    needRange(hdr.schema,     "schema");
+    needRange(hdr.conf,       "conf");
+    needRange(hdr.states,     "states");
+    needRange(hdr.propBlobs,  "prop-blobs");
+    needRange(hdr.stringPool, "string-pool");
+
+    if (hdr.states.itemNmbr * hdr.rowBytes != hdr.states.fileSize)
+        throw std::runtime_error("rdb: states section size mismatch");
+
+    // Decode schema, then cross-check all the redundant counts/strides.
+    {
+        uint8_t const*  cur = data + hdr.schema.fileOffs;
+        uint8_t const*  end = cur + hdr.schema.fileSize;
+        decodeSchema(cur, end, props, confs, typeSink);
+        if (cur != end)
+            throw std::runtime_error("rdb: trailing bytes in schema section");
+    }
+    if (props.size() != hdr.schema.itemNmbr)
+        throw std::runtime_error("rdb: schema/schema.itemNmbr disagree");
+    if (confs.size() != hdr.conf.itemNmbr)
+        throw std::runtime_error("rdb: schema/conf.itemNmbr disagree");
+    if (hdr.rowBytes != sizeof(int64_t) + hdr.schema.itemNmbr * sizeof(int64_t))
+        throw std::runtime_error("rdb: rowBytes inconsistent with schema.itemNmbr");
+}
+
+//  An appended file's blocks, from the index `finish` wrote -- or, in a file
+//  whose writer never got that far, found walking forward from the conf, up to
+//  the first block not wholly there. `read` fetches bytes of the file and is
+//  false past its end; `complete` says which it was.
+struct BlockAt
+{
+    uint64_t        offs;
+    BlockHeader     bh;
+    BlockCodec      codec    = BlockCodec::Plain;
+    uint64_t        head     = sizeof(BlockHeader);     //  header bytes before the rows
+    uint64_t        rowsSize = 0;                       //  rows as packed, for a packed block
+    uint64_t        stored   = 0;                       //  rows and blobs as they lie in the file
+    std::optional<int64_t>  firstTime;                  //  from the index's times, when there is one
+};
+
+using ReadAt = std::function<bool(uint64_t offs, void* dst, std::size_t n)>;
+
+static std::vector<BlockAt>     findBlocks(OnDiskHeader const&  hdr,
+                                           uint64_t             fileSize,
+                                           ReadAt const&        read,
+                                           std::string const&   ctx,
+                                           bool&                complete)
+{
+    auto    align8 = [](uint64_t v) { return (v + 7u) & ~uint64_t{7}; };
+    auto    whole  = [&](BlockAt& b)
+    {
+        auto&   bh = b.bh;
+        if (b.offs > fileSize || fileSize - b.offs < sizeof(BlockHeader) || !read(b.offs, &bh, sizeof(bh)))
+            return false;
+        uint64_t    left = fileSize - b.offs - sizeof(BlockHeader);
+        if (std::memcmp(bh.magic, kBlockMagic, sizeof(kBlockMagic)) == 0)
+        {
+            if (bh.numStates > left / hdr.rowBytes || bh.blobsSize > left - bh.numStates * hdr.rowBytes)
+                return false;
+            b.codec  = BlockCodec::Plain;
+            b.head   = sizeof(BlockHeader);
+            b.stored = bh.numStates * hdr.rowBytes + bh.blobsSize;
+        }
+        else if (std::memcmp(bh.magic, kPackedMagic, sizeof(kPackedMagic)) == 0)
+        {
+            PackedHeader    ph{};
+            if (fileSize - b.offs < sizeof(PackedHeader) || !read(b.offs, &ph, sizeof(ph)))
+                return false;
+            left     = fileSize - b.offs - sizeof(PackedHeader);
+            b.codec  = static_cast<BlockCodec>(ph.codec);
+            b.head   = sizeof(PackedHeader);
+            b.rowsSize = ph.rowsSize;
+            b.stored = ph.storedSize;
+            if (b.codec != BlockCodec::Packed && b.codec != BlockCodec::Zstd)
+                throw std::runtime_error(fmt::format("rdb: unknown block codec {} in '{}'", ph.codec, ctx));
+            if (b.stored > left
+             || (b.codec == BlockCodec::Packed && b.stored != b.rowsSize + bh.blobsSize))
+                return false;
+        }
+        else
+            return false;
+        return bh.poolSize <= left - b.stored;
+    };
+
+    std::vector<BlockAt>    blocks;
+    Trailer                 tr{};
+    if (fileSize >= sizeof(Trailer) && read(fileSize - sizeof(Trailer), &tr, sizeof(tr))
+     && std::memcmp(tr.magic, kTrailerMagic, sizeof(kTrailerMagic)) == 0
+     && tr.index.fileSize == tr.index.itemNmbr * sizeof(uint64_t)
+     && tr.times.itemNmbr == tr.index.itemNmbr
+     && tr.times.fileSize == tr.times.itemNmbr * sizeof(int64_t)
+     && tr.times.fileOffs == tr.index.fileOffs + tr.index.fileSize
+     && tr.times.fileOffs + tr.times.fileSize + sizeof(Trailer) == fileSize)
+    {
+        std::vector<uint64_t>   offs(tr.index.itemNmbr);
+        std::vector<int64_t>    times(tr.times.itemNmbr);
+        if (!read(tr.index.fileOffs, offs.data(), tr.index.fileSize)
+         || !read(tr.times.fileOffs, times.data(), tr.times.fileSize))
+            throw std::runtime_error(fmt::format("rdb: short read of the block index in '{}'", ctx));
+        for (std::size_t i = 0; i < offs.size(); i++)
         {
-            uint8_t const*  cur = data.data() + hdr.schema.fileOffs;
-            uint8_t const*  end = cur + hdr.schema.fileSize;
-            decodeSchema(cur, end, props, confs, typeSink);
-            if (cur != end)
-                throw std::runtime_error("rdb: trailing bytes in schema section");
+            BlockAt b{offs[i], {}};
+            if (!whole(b))
+                throw std::runtime_error(fmt::format("rdb: block index of '{}' names a bad block", ctx));
+            b.firstTime = times[i];
+            blocks.push_back(b);
         }
-        if (props.size() != hdr.schema.itemNmbr)
-            throw std::runtime_error("rdb: schema/schema.itemNmbr disagree");
-        if (confs.size() != hdr.conf.itemNmbr)
-            throw std::runtime_error("rdb: schema/conf.itemNmbr disagree");
-        if (hdr.rowBytes != sizeof(int64_t) + hdr.schema.itemNmbr * sizeof(int64_t))
-            throw std::runtime_error("rdb: rowBytes inconsistent with schema.itemNmbr");
-
-        // Resolve all string offsets to interned host pointers, in place.
-        char const*     poolBase   = reinterpret_cast<char const*>(
-                                        data.data() + hdr.stringPool.fileOffs);
-        size_t          poolSize   = hdr.stringPool.fileSize;
-        uint8_t*        propBase   = data.data() + hdr.propBlobs.fileOffs;
-        uint64_t        propSize   = hdr.propBlobs.fileSize;
+        complete = true;
+        return blocks;
+    }
+
+    complete = false;
+    BlockAt b{align8(hdr.conf.fileOffs + hdr.conf.fileSize), {}};
+    while (whole(b))
+    {
+        blocks.push_back(b);
+        b.offs = align8(b.offs + b.head + b.stored + b.bh.poolSize);
+    }
+    return blocks;
+}
+
+//  A packed block's rows and blobs, decoded to where `states` and `blobs` say.
+static void     unpackBlock(BlockAt const& b, uint8_t const* stored, uint64_t numProps,
+                            uint8_t* states, uint8_t* blobs)
+{
+    std::vector<uint8_t>    raw;
+    uint8_t const*          in = stored;
+    if (b.codec != BlockCodec::Packed)
+    {
+        raw.resize(b.rowsSize + b.bh.blobsSize);
+        decompressBlock(b.codec, stored, b.stored, raw);
+        in = raw.data();
+    }
+    unpackRows(in, in + b.rowsSize, b.bh.numStates, numProps, states);
+    if (b.bh.blobsSize != 0)
+        std::memcpy(blobs, in + b.rowsSize, b.bh.blobsSize);
+}
 
+struct Unpack
+{
+    BlockAt const*          block;
+    std::vector<uint8_t>    stored;
+    uint8_t*                states;
+    uint8_t*                blobs;
+};
+
+//  Decode `jobs` across the cores. Every block has its own place in the slab,
+//  so the threads share nothing but the counter handing the blocks out.
+static void     unpackAll(std::vector<Unpack> const& jobs, uint64_t numProps)
+{
+    std::atomic<std::size_t>    next{0};
+    std::exception_ptr          failed;
+    std::mutex                  failedLock;
+    auto    work = [&]()
+    {
+        for (std::size_t i; (i = next++) < jobs.size(); )
         {
-            // conf blob: same per-member alignment walk as the writer.
-            uint8_t*    confBase = data.data() + hdr.conf.fileOffs;
-            size_t      confSz   = hdr.conf.fileSize;
-            size_t      cur      = 0;
-            for (auto const& c : confs)
+            try
+            {
+                auto const& j = jobs[i];
+                unpackBlock(*j.block, j.stored.data(), numProps, j.states, j.blobs);
+            }
+            catch (...)
             {
-                size_t  a   = c.type->alignment();
-                size_t  rem = cur % a;
-                if (rem) cur += (a - rem);
-                StringResolver  sub(confBase + cur, confSz - cur, poolBase, poolSize);
-                sub.walk(c.type);
-                cur += sub.consumed();
+                std::lock_guard<std::mutex> lock(failedLock);
+                if (!failed)
+                    failed = std::current_exception();
             }
         }
+    };
+
+    auto    threads = std::min<std::size_t>(jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread>    helpers;
+    for (std::size_t k = 1; k < threads; k++)
+        helpers.emplace_back(work);
+    work();
+    for (auto& t : helpers)
+        t.join();
+    if (failed)
+        std::rethrow_exception(failed);
+}
+
+//  Whether a blob of `type` holds anything the fix-up rewrites: a string, or
+//  a ragged array's descriptor.
+static bool     holdsPointers(Type* type)
+{
+    if (dynamic_cast<TypeString*>(type))
+        return true;
+    if (auto* a = dynamic_cast<TypeArray*>(type))
+        return a->count == 0 || holdsPointers(a->type);
+    if (auto* st = dynamic_cast<TypeStruct*>(type))
+        for (auto const& m : st->members)
+            if (holdsPointers(m.data))
+                return true;
+    return false;
+}
+
+//  The bytes of an opened `.rdb`: on the heap, or -- once a spill directory is
+//  set and the file is big enough to go there (runtime/columns.hpp) -- in a
+//  mapping of an unlinked file, so a trace larger than RAM is paged rather than
+//  held. A private mapping of the original would not do: the fix-up writes
+//  every row, and dirty private pages have nowhere to go but swap.
+struct Slab
+{
+    std::vector<uint8_t>    heap;
+    uint8_t*                mapped  = nullptr;
+    std::size_t             length  = 0;
 
-        // Walk every state row: rewrite each int64 prop offset to a host pointer
-        // into the prop-blobs section, and run the string resolver over the blob.
+    Slab() = default;
+    Slab(Slab const&)            = delete;
+    Slab& operator=(Slab const&) = delete;
+    ~Slab()
+    {
+        if (mapped != nullptr)
+            referee::rt::spillUnmap(mapped, length);
+    }
+
+    void        allocate(std::size_t n)
+    {
+        if (referee::rt::spilling(n))
         {
-            uint8_t*    rows     = data.data() + hdr.states.fileOffs;
-            auto const  numProps = hdr.schema.itemNmbr;
-            auto const  rowBytes = hdr.rowBytes;
-            for (uint64_t si = 0; si < hdr.states.itemNmbr; si++)
+            mapped = static_cast<uint8_t*>(referee::rt::spillMap(n));
+            length = n;
+        }
+        else
+            heap.resize(n);
+    }
+
+    uint8_t*    data()          { return mapped ? mapped : heap.data(); }
+    std::size_t size() const    { return mapped ? length : heap.size(); }
+};
+
+//  The in-place pointer fix-up of a `.rdb` laid out at `base` as `hdr` says:
+//  string offsets to interned host pointers, in the conf and in every blob,
+//  and row offsets to host pointers into the blobs. `interned`, when given,
+//  caches the pool's strings across calls sharing it. `rows` false leaves the
+//  row table as the file's offsets, for a reader that resolves them as it
+//  reads (`Reader::map`): the rows are then walked only to find the blobs
+//  that hold something to resolve, and not at all when none can.
+static void     fixUpRows(uint8_t*                                   base,
+                          OnDiskHeader const&                        hdr,
+                          std::vector<PropDecl> const&               props,
+                          std::vector<ConfDecl> const&               confs,
+                          Columns const&                             only,
+                          std::unordered_map<int64_t, char const*>*  interned,
+                          bool                                       rows = true)
+{
+    // Resolve all string offsets to interned host pointers, in place.
+    char const*     poolBase   = reinterpret_cast<char const*>(
+                                    base + hdr.stringPool.fileOffs);
+    size_t          poolSize   = hdr.stringPool.fileSize;
+    uint8_t*        propBase   = base + hdr.propBlobs.fileOffs;
+    uint64_t        propSize   = hdr.propBlobs.fileSize;
+
+    {
+        // conf blob: same per-member alignment walk as the writer.
+        uint8_t*    confBase = base + hdr.conf.fileOffs;
+        size_t      confSz   = hdr.conf.fileSize;
+        size_t      cur      = 0;
+        for (auto const& c : confs)
+        {
+            size_t  a   = c.type->alignment();
+            size_t  rem = cur % a;
+            if (rem) cur += (a - rem);
+            StringResolver  sub(confBase + cur, confSz - cur, poolBase, poolSize,
+                                true, interned);
+            sub.walk(c.type);
+            cur += sub.consumed();
+        }
+    }
+
+    // Walk every state row: rewrite each int64 prop offset to a host pointer
+    // into the prop-blobs section, and run the string resolver over the blob.
+    // Rows may share a blob (a held value, see `Writer::finish`), so each is
+    // resolved once: a blob with anything to resolve is pointer-aligned,
+    // and `resolved` has a bit per eight bytes. A blob with nothing to
+    // resolve -- no string, no ragged array -- is not walked at all. A
+    // prop left out of `only` is not looked at either: its slots go null.
+    {
+        uint8_t*    table    = base + hdr.states.fileOffs;
+        auto const  numProps = hdr.schema.itemNmbr;
+        auto const  rowBytes = hdr.rowBytes;
+        std::vector<char>   pointers(numProps);
+        std::vector<char>   loaded(numProps);
+        for (uint64_t pi = 0; pi < numProps; pi++)
+        {
+            loaded[pi]   = only.empty() || only.contains(props[pi].name);
+            pointers[pi] = loaded[pi] && holdsPointers(props[pi].type);
+        }
+        std::vector<bool>   resolved;
+        if (std::find(pointers.begin(), pointers.end(), true) != pointers.end())
+            resolved.resize(propSize / 8 + 1);
+        else if (!rows)
+            return;
+
+        for (uint64_t si = 0; si < hdr.states.itemNmbr; si++)
+        {
+            uint8_t*    row = table + si * rowBytes;
+            for (uint64_t pi = 0; pi < numProps; pi++)
             {
-                uint8_t*    row = rows + si * rowBytes;
-                for (uint64_t pi = 0; pi < numProps; pi++)
+                if (!rows && !pointers[pi])
+                    continue;
+                uint8_t*    slot = row + sizeof(int64_t) + pi * sizeof(int64_t);
+                int64_t     off  = 0;
+                std::memcpy(&off, slot, sizeof(off));
+                void*       host = nullptr;
+                if (off != kNullOffset && loaded[pi])
                 {
-                    uint8_t*    slot = row + sizeof(int64_t) + pi * sizeof(int64_t);
-                    int64_t     off  = 0;
-                    std::memcpy(&off, slot, sizeof(off));
-                    void*       host = nullptr;
-                    if (off != kNullOffset)
+                    if (off < 0 || static_cast<uint64_t>(off) >= propSize)
+                        throw std::runtime_error("rdb: prop offset out of range");
+                    host = propBase + off;
+                    Type*   t = props[pi].type;
+                    if (!pointers[pi])
+                    {
+                        if (t->size() > propSize - off)
+                            throw std::runtime_error("rdb: blob walker ran past end");
+                    }
+                    else if (!resolved[off / 8])
                     {
-                        if (off < 0 || static_cast<uint64_t>(off) >= propSize)
-                            throw std::runtime_error("rdb: prop offset out of range");
-                        host = propBase + off;
-                        // Resolve any TypeString slots within this blob.
-                        Type*   t = props[pi].type;
                         // The blob's size on disk is determined by walking the
                         // type; the walker doesn't read past its end.
                         StringResolver  sub(propBase + off, propSize - off,
-                                            poolBase, poolSize);
+                                            poolBase, poolSize, true, interned);
                         sub.walk(t);
+                        resolved[off / 8] = true;
                     }
-                    std::memcpy(slot, &host, sizeof(host));
                 }
+                if (rows)
+                    std::memcpy(slot, &host, sizeof(host));
             }
         }
     }
-};
+}
 
-Reader::Reader(std::string const& path) : m_impl(std::make_unique<Impl>())
+struct Reader::Impl
 {
-    std::ifstream in(path, std::ios::binary);
-    if (!in)
-        throw std::runtime_error(fmt::format("rdb: cannot open '{}'", path));
-    in.seekg(0, std::ios::end);
-    auto    size = in.tellg();
-    if (size < static_cast<std::streamoff>(sizeof(OnDiskHeader)))
-        throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdb file", path));
-    in.seekg(0, std::ios::beg);
-    m_impl->data.resize(static_cast<size_t>(size));
-    in.read(reinterpret_cast<char*>(m_impl->data.data()),
-            static_cast<std::streamsize>(m_impl->data.size()));
-    if (!in)
-        throw std::runtime_error(fmt::format("rdb: short read for '{}'", path));
+    Slab                                    data;
+    OnDiskHeader                            hdr{};
+    std::vector<std::unique_ptr<Type>>      typeSink;
+    std::vector<PropDecl>                   props;
+    std::vector<ConfDecl>                   confs;
+
+    //  An appended file laid out into `data` as the one contiguous v1 file
+    //  `fixUp` reads: its blocks' rows, blobs and pools end to end, packed
+    //  blocks decoded on the way in. A file cut
+    //  short has lost its closing sentinel with the rest, so one is put back
+    //  -- zeros, a tick after the last row -- and the trace still executes.
+    void    assemble(uint64_t fileSize, ReadAt const& read, std::string const& ctx)
+    {
+        //  The prefix -- header, schema, conf -- for the row size and the
+        //  types the closing sentinel is made of.
+        OnDiskHeader                        raw{};
+        std::vector<uint8_t>                prefix(sizeof(OnDiskHeader));
+        std::vector<std::unique_ptr<Type>>  sink;
+        std::vector<PropDecl>               ps;
+        std::vector<ConfDecl>               cs;
+        if (!read(0, prefix.data(), prefix.size()))
+            throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdb file", ctx));
+        std::memcpy(&raw, prefix.data(), sizeof(raw));
+        uint64_t    prefixSize = raw.conf.fileOffs + raw.conf.fileSize;
+        if (prefixSize < sizeof(OnDiskHeader) || prefixSize > fileSize)
+            throw std::runtime_error(fmt::format("rdb: conf section out of bounds in '{}'", ctx));
+        prefix.resize(prefixSize);
+        if (!read(0, prefix.data(), prefix.size()))
+            throw std::runtime_error(fmt::format("rdb: short read for '{}'", ctx));
+        openHeader(prefix.data(), prefix.size(), ctx, raw, ps, cs, sink);
+
+        bool        complete = false;
+        auto        blocks   = findBlocks(raw, fileSize, read, ctx, complete);
+        uint64_t    rows = 0, blobs = 0, pool = 0;
+        for (auto const& b : blocks)
+        {
+            rows  += b.bh.numStates;
+            blobs += b.bh.blobsSize;
+            pool  += b.bh.poolSize;
+        }
+
+        bool                    close = !complete && rows != 0;
+        std::vector<uint64_t>   zeroAt;
+        if (close)
+            for (auto const& p : ps)
+            {
+                auto    a = p.type->alignment();
+                blobs     = (blobs + a - 1) / a * a;
+                zeroAt.push_back(blobs);
+                blobs    += p.type->size();
+            }
+        auto        align8 = [](uint64_t v) { return (v + 7u) & ~uint64_t{7}; };
+
+        hdr             = raw;
+        hdr.version     = kVersion;
+        hdr.states      = {align8(prefixSize), (rows + close) * raw.rowBytes, rows + close};
+        hdr.propBlobs   = {align8(hdr.states.fileOffs + hdr.states.fileSize), blobs, 0};
+        hdr.stringPool  = {align8(hdr.propBlobs.fileOffs + blobs), pool, 0};
+
+        data.allocate(hdr.stringPool.fileOffs + pool);
+        uint8_t*    out = data.data();
+        std::memset(out, 0, data.size());
+        std::memcpy(out, &hdr, sizeof(hdr));
+        std::memcpy(out + sizeof(hdr), prefix.data() + sizeof(hdr), prefixSize - sizeof(hdr));
+
+        //  Packed blocks are read a batch at a time and decoded in parallel,
+        //  so at most a batch of them is held as stored.
+        uint8_t*    states = out + hdr.states.fileOffs;
+        uint8_t*    blob   = out + hdr.propBlobs.fileOffs;
+        uint8_t*    str    = out + hdr.stringPool.fileOffs;
+        std::size_t         batch = 4 * std::max(1u, std::thread::hardware_concurrency());
+        std::vector<Unpack> jobs;
+        for (auto const& b : blocks)
+        {
+            uint64_t    n   = b.bh.numStates * raw.rowBytes;
+            uint64_t    at  = b.offs + b.head;
+            bool        ok  = true;
+            if (b.codec == BlockCodec::Plain)
+                ok = read(at, states, n) && read(at + n, blob, b.bh.blobsSize);
+            else
+            {
+                jobs.push_back({&b, std::vector<uint8_t>(b.stored), states, blob});
+                ok = read(at, jobs.back().stored.data(), b.stored);
+            }
+            if (!ok || !read(at + b.stored, str, b.bh.poolSize))
+                throw std::runtime_error(fmt::format("rdb: short read for '{}'", ctx));
+            if (jobs.size() == batch)
+            {
+                unpackAll(jobs, ps.size());
+                jobs.clear();
+            }
+            states += n;
+            blob   += b.bh.blobsSize;
+            str    += b.bh.poolSize;
+        }
+        unpackAll(jobs, ps.size());
+
+        if (close)
+        {
+            int64_t t = 0;
+            std::memcpy(&t, states - raw.rowBytes, sizeof(t));
+            t = t < std::numeric_limits<int64_t>::max() ? t + 1 : t;
+            std::memcpy(states, &t, sizeof(t));
+            for (std::size_t pi = 0; pi < zeroAt.size(); pi++)
+            {
+                auto    off = static_cast<int64_t>(zeroAt[pi]);
+                std::memcpy(states + sizeof(int64_t) + pi * sizeof(int64_t), &off, sizeof(off));
+            }
+        }
+    }
+
+    //  The `.rdb` at `path` read into `data` as the one contiguous v1 file
+    //  `fixUp` reads -- as it lies, or assembled from its blocks.
+    void    load(std::string const& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error(fmt::format("rdb: cannot open '{}'", path));
+        in.seekg(0, std::ios::end);
+        auto    size = in.tellg();
+        if (size < static_cast<std::streamoff>(sizeof(OnDiskHeader)))
+            throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdb file", path));
+        in.seekg(0, std::ios::beg);
+
+        OnDiskHeader    probe{};
+        in.read(reinterpret_cast<char*>(&probe), sizeof(probe));
+        if (in && probe.version == kVersionBlocks)
+        {
+            assemble(static_cast<uint64_t>(size),
+                     [&in](uint64_t offs, void* dst, std::size_t n)
+                     {
+                         in.clear();
+                         in.seekg(static_cast<std::streamoff>(offs));
+                         in.read(static_cast<char*>(dst), static_cast<std::streamsize>(n));
+                         return static_cast<bool>(in);
+                     }, path);
+            return;
+        }
+
+        in.seekg(0, std::ios::beg);
+        data.allocate(static_cast<size_t>(size));
+        in.read(reinterpret_cast<char*>(data.data()),
+                static_cast<std::streamsize>(data.size()));
+        if (!in)
+            throw std::runtime_error(fmt::format("rdb: short read for '{}'", path));
+    }
+
+    // Validate the slab in `data` and run the in-place pointer fix-up.
+    // `ctx` is purely for error messages (file path or "<memory>").
+    void    fixUp(std::string const& ctx, Columns const& only)
+    {
+        openHeader(data.data(), data.size(), ctx, hdr, props, confs, typeSink);
+        fixUpRows(data.data(), hdr, props, confs, only, nullptr);
+    }
+
+    //  The bytes the header's offsets are from: the slab, or the mapping of
+    //  the corpus a member `Reader` views.
+    uint8_t*    bytes()
+    {
+        return base != nullptr ? base : data.data();
+    }
+
+    //  A corpus member: its sections lie in the corpus's mapping, and the
+    //  corpus is kept alive as long as this reader is.
+    std::shared_ptr<void const>             owner;
+    uint8_t*                                base = nullptr;
+
+    //  `Reader::map`: the rows are still the file's offsets. `propBlob`
+    //  resolves one as it is read; `ptrFirst` -- a checker taking the table
+    //  whole -- gets a copy with every one resolved, built on first use.
+    bool                                    relative = false;
+    std::vector<char>                       loaded;
+    std::once_flag                          tabled;
+    Slab                                    table;
+
+    //  State `si`'s blob of prop `pi`, whichever form the rows are in.
+    uint8_t*    blobAt(std::size_t si, std::size_t pi)
+    {
+        uint8_t*    slot = bytes() + hdr.states.fileOffs + si * hdr.rowBytes
+                         + sizeof(int64_t) + pi * sizeof(int64_t);
+        if (!relative)
+        {
+            uint8_t*    host = nullptr;
+            std::memcpy(&host, slot, sizeof(host));
+            return host;
+        }
+
+        int64_t     off  = 0;
+        std::memcpy(&off, slot, sizeof(off));
+        if (off == kNullOffset || !loaded[pi])
+            return nullptr;
+        auto const  size = hdr.propBlobs.fileSize;
+        if (off < 0 || static_cast<uint64_t>(off) >= size || props[pi].type->size() > size - off)
+            throw std::runtime_error("rdb: prop offset out of range");
+        return bytes() + hdr.propBlobs.fileOffs + off;
+    }
+
+    //  The `state_t[]` a compiled checker walks.
+    uint8_t*    rows()
+    {
+        if (!relative)
+            return bytes() + hdr.states.fileOffs;
+
+        std::call_once(tabled, [this]
+        {
+            auto const  rowBytes = hdr.rowBytes;
+            table.allocate(hdr.states.fileSize);
+            for (uint64_t si = 0; si < hdr.states.itemNmbr; si++)
+            {
+                uint8_t*    row = table.data() + si * rowBytes;
+                std::memcpy(row, bytes() + hdr.states.fileOffs + si * rowBytes, sizeof(int64_t));
+                for (uint64_t pi = 0; pi < hdr.schema.itemNmbr; pi++)
+                {
+                    void*   host = blobAt(si, pi);
+                    std::memcpy(row + sizeof(int64_t) + pi * sizeof(void*), &host, sizeof(host));
+                }
+            }
+        });
+        return table.data();
+    }
+};
 
-    m_impl->fixUp(path);
+Reader::Reader(std::string const& path, Columns const& only) : m_impl(std::make_unique<Impl>())
+{
+    m_impl->load(path);
+    m_impl->fixUp(path, only);
 }
 
-Reader::Reader(std::vector<std::uint8_t> bytes, std::string const& ctx)
+Reader::Reader(std::vector<std::uint8_t> bytes, std::string const& ctx, Columns const& only)
     : m_impl(std::make_unique<Impl>())
 {
-    m_impl->data = std::move(bytes);
-    m_impl->fixUp(ctx);
+    OnDiskHeader    probe{};
+    if (bytes.size() >= sizeof(probe))
+        std::memcpy(&probe, bytes.data(), sizeof(probe));
+    if (probe.version == kVersionBlocks)
+        m_impl->assemble(bytes.size(),
+                         [&bytes](uint64_t offs, void* dst, std::size_t n)
+                         {
+                             if (offs > bytes.size() || bytes.size() - offs < n)
+                                 return false;
+                             if (n != 0)
+                                 std::memcpy(dst, bytes.data() + offs, n);
+                             return true;
+                         }, ctx);
+    else
+        m_impl->data.heap = std::move(bytes);
+    m_impl->fixUp(ctx, only);
+}
+
+Reader::Reader(std::string const& path, std::int64_t from, std::int64_t to,
+               Columns const& only)
+    : Reader([&]
+             {
+                 std::ostringstream  os(std::ios::binary);
+                 slice(path, os, from, to, only);
+                 auto    str = std::move(os).str();
+                 return std::vector<std::uint8_t>(str.begin(), str.end());
+             }(), path, only)
+{
+}
+
+std::unique_ptr<Reader>     Reader::map(std::string const& path, Columns const& only)
+{
+    auto    impl = std::make_unique<Impl>();
+    int     fd   = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error(fmt::format("rdb: cannot open '{}'", path));
+
+    struct stat     st{};
+    OnDiskHeader    probe{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(OnDiskHeader)
+     || ::pread(fd, &probe, sizeof(probe), 0) != static_cast<ssize_t>(sizeof(probe)))
+    {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdb file", path));
+    }
+
+    //  An appended file is laid out afresh anyway; its rows are still spared
+    //  the rewrite.
+    std::size_t     size = static_cast<std::size_t>(st.st_size);
+    if (probe.version == kVersionBlocks)
+    {
+        ::close(fd);
+        impl->load(path);
+        size = impl->data.size();
+    }
+    else
+    {
+        void*   p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw std::runtime_error(fmt::format("rdb: cannot map '{}'", path));
+        impl->owner = std::shared_ptr<void const>(p, [size](void const* q)
+                                                     { ::munmap(const_cast<void*>(q), size); });
+        impl->base  = static_cast<uint8_t*>(p);
+    }
+
+    openHeader(impl->bytes(), size, path, impl->hdr, impl->props, impl->confs, impl->typeSink);
+
+    //  Only a string or a ragged array is written, and only in its own
+    //  pages, which copy on write. A file with neither stays read-only, and
+    //  its pages stay the page cache's, shared with every other reader.
+    bool    writes = false;
+    for (auto const& c : impl->confs)
+        writes |= holdsPointers(c.type);
+    for (auto const& p : impl->props)
+    {
+        impl->loaded.push_back(only.empty() || only.contains(p.name));
+        writes |= impl->loaded.back() && holdsPointers(p.type);
+    }
+    if (writes && impl->base != nullptr
+     && ::mprotect(impl->base, size, PROT_READ | PROT_WRITE) != 0)
+        throw std::runtime_error(fmt::format("rdb: cannot map '{}' for its fix-up", path));
+    fixUpRows(impl->bytes(), impl->hdr, impl->props, impl->confs, only, nullptr, /*rows*/ false);
+    impl->relative = true;
+    return std::unique_ptr<Reader>(new Reader(std::move(impl)));
 }
 
+Reader::Reader(std::unique_ptr<Impl> impl) : m_impl(std::move(impl)) {}
+
 Reader::~Reader() = default;
 
 std::vector<PropDecl> const&    Reader::props() const { return m_impl->props; }
@@ -865,19 +2042,18 @@ std::vector<ConfDecl> const&    Reader::confs() const { return m_impl->confs; }
 
 void*   Reader::ptrFirst() const
 {
-    return m_impl->data.data() + m_impl->hdr.states.fileOffs;
+    return m_impl->rows();
 }
 
 void*   Reader::ptrLast() const
 {
     if (m_impl->hdr.states.itemNmbr == 0) return nullptr;
-    return m_impl->data.data() + m_impl->hdr.states.fileOffs
-         + (m_impl->hdr.states.itemNmbr - 1) * m_impl->hdr.rowBytes;
+    return m_impl->rows() + (m_impl->hdr.states.itemNmbr - 1) * m_impl->hdr.rowBytes;
 }
 
 void*   Reader::confPtr() const
 {
-    return m_impl->data.data() + m_impl->hdr.conf.fileOffs;
+    return m_impl->bytes() + m_impl->hdr.conf.fileOffs;
 }
 
 std::size_t     Reader::numStates() const { return m_impl->hdr.states.itemNmbr; }
@@ -885,28 +2061,290 @@ std::size_t     Reader::numProps()  const { return m_impl->hdr.schema.itemNmbr;
 std::size_t     Reader::rowBytes()  const { return m_impl->hdr.rowBytes; }
 std::size_t     Reader::confSize()  const { return m_impl->hdr.conf.fileSize; }
 
-std::int64_t    Reader::time(std::size_t stateIdx) const
+std::int64_t    Reader::time(std::size_t stateIdx) const
+{
+    if (stateIdx >= m_impl->hdr.states.itemNmbr)
+        throw std::runtime_error("rdb: state index out of range");
+    auto*       row = m_impl->bytes() + m_impl->hdr.states.fileOffs
+                    + stateIdx * m_impl->hdr.rowBytes;
+    int64_t     t   = 0;
+    std::memcpy(&t, row, sizeof(t));
+    return t;
+}
+
+void const*     Reader::propBlob(std::size_t stateIdx, std::size_t propIdx) const
+{
+    if (stateIdx >= m_impl->hdr.states.itemNmbr || propIdx >= m_impl->hdr.schema.itemNmbr)
+        throw std::runtime_error("rdb: index out of range");
+    return m_impl->blobAt(stateIdx, propIdx);
+}
+
+std::vector<std::uint8_t>   Reader::blob(std::size_t stateIdx, std::size_t propIdx) const
+{
+    auto*       host = static_cast<uint8_t*>(const_cast<void*>(propBlob(stateIdx, propIdx)));
+    if (host == nullptr)
+        return {};
+
+    uint8_t*    end  = m_impl->bytes() + m_impl->hdr.propBlobs.fileOffs + m_impl->hdr.propBlobs.fileSize;
+    BlobCopier  copier(host, static_cast<size_t>(end - host));
+    return copier.copy(m_impl->props[propIdx].type);
+}
+
+// ============================================================================
+//  Scanner
+// ============================================================================
+
+struct Scanner::Impl
+{
+    uint8_t*                                mapped  = nullptr;
+    std::size_t                             length  = 0;
+    OnDiskHeader                            hdr{};
+    std::vector<std::unique_ptr<Type>>      typeSink;
+    std::vector<PropDecl>                   props;
+    std::vector<ConfDecl>                   confs;
+
+    //  Where the rows and blobs lie in the mapping: one piece for a v1 file,
+    //  one per block of an appended one. `blobBase` is the offset a row holds
+    //  for the piece's first blob byte. A packed block's `statesAt` and
+    //  `blobsAt` are into `unpacked`, once it is decoded there.
+    struct Piece
+    {
+        uint64_t                firstState;
+        uint64_t                statesAt;
+        uint64_t                blobBase;
+        uint64_t                blobsAt;
+        uint64_t                blobsSize;
+        std::optional<BlockAt>  packed;
+        std::optional<int64_t>  firstTime;      //  from an appended file's time index
+    };
+    std::vector<Piece>                      pieces;
+    mutable std::vector<uint8_t>            unpacked;
+    mutable std::size_t                     unpackedPiece = std::numeric_limits<std::size_t>::max();
+    uint64_t                                rows      = 0;
+    uint64_t                                numStates = 0;  //  and a closing sentinel, for a file cut short
+    std::vector<uint8_t>                    poolCopy;       //  an appended file's pools, end to end
+    char const*                             pool      = nullptr;
+    std::size_t                             poolSize  = 0;
+
+    ~Impl()
+    {
+        if (mapped != nullptr)
+            ::munmap(mapped, length);
+    }
+
+    //  The bytes piece `i`'s offsets are from.
+    uint8_t*    base(std::size_t i) const
+    {
+        auto const& p = pieces[i];
+        if (!p.packed)
+            return mapped;
+        if (unpackedPiece != i)
+        {
+            auto const& b = *p.packed;
+            unpacked.resize(p.blobsAt + b.bh.blobsSize);
+            unpackBlock(b, mapped + b.offs + b.head, hdr.schema.itemNmbr,
+                        unpacked.data(), unpacked.data() + p.blobsAt);
+            unpackedPiece = i;
+        }
+        return unpacked.data();
+    }
+
+    uint8_t const*  row(std::size_t si) const
+    {
+        auto    it = std::upper_bound(pieces.begin(), pieces.end(), si,
+                                      [](std::size_t s, Piece const& p) { return s < p.firstState; });
+        auto    i  = static_cast<std::size_t>(std::prev(it) - pieces.begin());
+        return base(i) + pieces[i].statesAt + (si - pieces[i].firstState) * hdr.rowBytes;
+    }
+
+    //  Row `si`'s prop slots, still the offsets the writer left there.
+    int64_t     offset(std::size_t si, std::size_t pi) const
+    {
+        if (si >= numStates || pi >= hdr.schema.itemNmbr)
+            throw std::runtime_error("rdb: index out of range");
+        if (si >= rows)
+            return kNullOffset;
+        int64_t off = 0;
+        std::memcpy(&off, row(si) + sizeof(int64_t) + pi * sizeof(int64_t), sizeof(off));
+        uint64_t    total = pieces.empty() ? 0 : pieces.back().blobBase + pieces.back().blobsSize;
+        if (off != kNullOffset && (off < 0 || static_cast<uint64_t>(off) >= total))
+            throw std::runtime_error("rdb: prop offset out of range");
+        return off;
+    }
+
+    //  The blob at offset `off`, and how many bytes its piece has from there.
+    uint8_t*    blobAt(int64_t off, std::size_t& avail) const
+    {
+        auto    it = std::upper_bound(pieces.begin(), pieces.end(), static_cast<uint64_t>(off),
+                                      [](uint64_t o, Piece const& p) { return o < p.blobBase; });
+        auto    i  = static_cast<std::size_t>(std::prev(it) - pieces.begin());
+        auto const& p = pieces[i];
+        avail = p.blobsSize - (off - p.blobBase);
+        return base(i) + p.blobsAt + (off - p.blobBase);
+    }
+};
+
+Scanner::Scanner(std::string const& path) : m_impl(std::make_unique<Impl>())
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error(fmt::format("rdb: cannot open '{}'", path));
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(OnDiskHeader)))
+    {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdb file", path));
+    }
+
+    void*   p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw std::runtime_error(fmt::format("rdb: cannot map '{}'", path));
+
+    auto&   impl = *m_impl;
+    impl.mapped = static_cast<uint8_t*>(p);
+    impl.length = static_cast<size_t>(st.st_size);
+    ::madvise(p, impl.length, MADV_SEQUENTIAL);
+
+    openHeader(impl.mapped, impl.length, path, impl.hdr, impl.props, impl.confs, impl.typeSink);
+
+    if (impl.hdr.version != kVersionBlocks)
+    {
+        auto const& h = impl.hdr;
+        impl.pieces.push_back({0, h.states.fileOffs, 0, h.propBlobs.fileOffs, h.propBlobs.fileSize, {}});
+        impl.rows     = impl.numStates = h.states.itemNmbr;
+        impl.pool     = reinterpret_cast<char const*>(impl.mapped + h.stringPool.fileOffs);
+        impl.poolSize = h.stringPool.fileSize;
+        return;
+    }
+
+    //  Appended: the blocks indexed where they lie, a packed one left to be
+    //  decoded when it is reached. Only the pools are copied, into one, for
+    //  the string offsets -- they are the distinct strings, not the trace.
+    bool    complete = false;
+    auto    blocks   = findBlocks(impl.hdr, impl.length,
+                                  [&impl](uint64_t offs, void* dst, std::size_t n)
+                                  {
+                                      if (offs > impl.length || impl.length - offs < n)
+                                          return false;
+                                      std::memcpy(dst, impl.mapped + offs, n);
+                                      return true;
+                                  }, path, complete);
+    uint64_t    blobBase = 0;
+    for (auto const& b : blocks)
+    {
+        uint64_t    at = b.offs + b.head;
+        uint64_t    n  = b.bh.numStates * impl.hdr.rowBytes;
+        if (b.codec == BlockCodec::Plain)
+            impl.pieces.push_back({impl.rows, at, blobBase, at + n, b.bh.blobsSize, {}, b.firstTime});
+        else
+            impl.pieces.push_back({impl.rows, 0, blobBase, n, b.bh.blobsSize, b, b.firstTime});
+        impl.poolCopy.insert(impl.poolCopy.end(), impl.mapped + at + b.stored,
+                             impl.mapped + at + b.stored + b.bh.poolSize);
+        impl.rows += b.bh.numStates;
+        blobBase  += b.bh.blobsSize;
+    }
+    impl.numStates = impl.rows + (!complete && impl.rows != 0);
+    impl.pool      = reinterpret_cast<char const*>(impl.poolCopy.data());
+    impl.poolSize  = impl.poolCopy.size();
+}
+
+Scanner::~Scanner() = default;
+
+std::vector<PropDecl> const&    Scanner::props()     const { return m_impl->props; }
+std::vector<ConfDecl> const&    Scanner::confs()     const { return m_impl->confs; }
+std::size_t                     Scanner::numStates() const { return m_impl->numStates; }
+
+std::vector<std::uint8_t>   Scanner::conf() const
+{
+    auto const& impl = *m_impl;
+    std::vector<uint8_t>    out(impl.mapped + impl.hdr.conf.fileOffs,
+                                impl.mapped + impl.hdr.conf.fileOffs + impl.hdr.conf.fileSize);
+
+    //  The same per-member walk as `Reader::fixUp`, on a copy.
+    size_t  cur = 0;
+    for (auto const& c : impl.confs)
+    {
+        size_t  a = c.type->alignment();
+        if (cur % a) cur += a - cur % a;
+        StringResolver  sub(out.data() + cur, out.size() - cur, impl.pool, impl.poolSize, false);
+        sub.walk(c.type);
+        cur += sub.consumed();
+    }
+    return out;
+}
+
+std::int64_t    Scanner::time(std::size_t stateIdx) const
 {
-    if (stateIdx >= m_impl->hdr.states.itemNmbr)
+    auto const& impl = *m_impl;
+    if (stateIdx >= impl.numStates)
         throw std::runtime_error("rdb: state index out of range");
-    auto*       row = m_impl->data.data() + m_impl->hdr.states.fileOffs
-                    + stateIdx * m_impl->hdr.rowBytes;
-    int64_t     t   = 0;
-    std::memcpy(&t, row, sizeof(t));
+
+    //  The closing sentinel of a file cut short, as `Reader` puts it back.
+    if (stateIdx >= impl.rows)
+    {
+        auto    t = time(stateIdx - 1);
+        return t < std::numeric_limits<int64_t>::max() ? t + 1 : t;
+    }
+    int64_t t = 0;
+    std::memcpy(&t, impl.row(stateIdx), sizeof(t));
     return t;
 }
 
-void const*     Reader::propBlob(std::size_t stateIdx, std::size_t propIdx) const
+std::size_t     Scanner::find(std::int64_t time) const
 {
-    if (stateIdx >= m_impl->hdr.states.itemNmbr || propIdx >= m_impl->hdr.schema.itemNmbr)
-        throw std::runtime_error("rdb: index out of range");
-    auto*       row  = m_impl->data.data() + m_impl->hdr.states.fileOffs
-                     + stateIdx * m_impl->hdr.rowBytes;
-    void*       host = nullptr;
-    std::memcpy(&host,
-                row + sizeof(int64_t) + propIdx * sizeof(int64_t),
-                sizeof(host));
-    return host;
+    auto const& impl = *m_impl;
+
+    //  The rows to search: all of them, unless the time index narrows it to
+    //  the last block starting before `time` -- the answer is in it, or is
+    //  the row after it. Times are not decoded anywhere else.
+    std::size_t lo = 0, hi = impl.numStates;
+    auto const& ps = impl.pieces;
+    if (!ps.empty() && ps.back().firstTime)
+    {
+        auto    it = std::partition_point(ps.begin(), ps.end(),
+                                          [time](Impl::Piece const& p) { return *p.firstTime < time; });
+        if (it == ps.begin())
+            return 0;
+        auto    i = static_cast<std::size_t>(it - ps.begin()) - 1;
+        lo = ps[i].firstState;
+        hi = i + 1 < ps.size() ? ps[i + 1].firstState : impl.numStates;
+    }
+
+    while (lo < hi)
+    {
+        auto    mid = lo + (hi - lo) / 2;
+        if (this->time(mid) < time) lo = mid + 1;
+        else                        hi = mid;
+    }
+    return lo;
+}
+
+std::vector<std::uint8_t>   Scanner::blob(std::size_t stateIdx, std::size_t propIdx) const
+{
+    int64_t     off  = m_impl->offset(stateIdx, propIdx);
+    Type*       type = m_impl->props[propIdx].type;
+
+    //  Copy the blob out, then resolve its strings in the copy: the mapping is
+    //  read-only, and stays clean so the kernel can drop it behind the scan. A
+    //  closing sentinel put back is zeros, as `Reader` makes it.
+    std::vector<uint8_t>    out;
+    if (stateIdx >= m_impl->rows)
+        out.assign(type->size(), 0);
+    else if (off == kNullOffset)
+        return {};
+    else
+    {
+        std::size_t avail = 0;
+        uint8_t*    base  = m_impl->blobAt(off, avail);
+        BlobCopier  copier(base, avail, false);
+        out = copier.copy(type);
+    }
+
+    StringResolver  resolver(out.data(), out.size(), m_impl->pool, m_impl->poolSize, false);
+    resolver.walk(type);
+    return out;
 }
 
 struct DataYamlPrinter
@@ -1131,9 +2569,11 @@ static std::pair<std::string, unsigned> flatPathOf(std::string const& prefix)
 }
 
 //  One recorded blob's contribution to the capacity table: every descriptor's
-//  count, at every nesting depth.
+//  count, at every nesting depth. `relative`: the blob is as on disk, each
+//  descriptor holding the offset of its elements rather than a pointer.
 static void flatScanCaps(Type* type, uint8_t const* data,
-                         std::string const& prefix, FlatCaps& caps)
+                         std::string const& prefix, FlatCaps& caps,
+                         bool relative = false)
 {
     if (auto* st = dynamic_cast<TypeStruct*>(type))
     {
@@ -1142,7 +2582,7 @@ static void flatScanCaps(Type* type, uint8_t const* data,
         {
             auto align = m.data->alignment();
             if (cur % align) cur += align - (cur % align);
-            flatScanCaps(m.data, data + cur, prefix + "." + m.name, caps);
+            flatScanCaps(m.data, data + cur, prefix + "." + m.name, caps, relative);
             cur += m.data->size();
         }
         return;
@@ -1156,6 +2596,12 @@ static void flatScanCaps(Type* type, uint8_t const* data,
             uint8_t const*  p = nullptr;
             std::memcpy(&n, data,     sizeof(n));
             std::memcpy(&p, data + 8, sizeof(p));
+            if (relative)
+            {
+                std::int64_t    delta = 0;
+                std::memcpy(&delta, data + 8, sizeof(delta));
+                p = data + delta;
+            }
 
             auto [path, dim] = flatPathOf(prefix);
             auto& dims = caps[path];
@@ -1165,14 +2611,14 @@ static void flatScanCaps(Type* type, uint8_t const* data,
             auto stride = a->type->size();
             for (std::int64_t i = 0; i < n; i++)
                 flatScanCaps(a->type, p + i * stride,
-                             prefix + "[" + std::to_string(i) + "]", caps);
+                             prefix + "[" + std::to_string(i) + "]", caps, relative);
             return;
         }
 
         auto stride = a->type->size();
         for (unsigned i = 0; i < a->count; i++)
             flatScanCaps(a->type, data + i * stride,
-                         prefix + "[" + std::to_string(i) + "]", caps);
+                         prefix + "[" + std::to_string(i) + "]", caps, relative);
         return;
     }
     //  leaves carry no capacity
@@ -1307,7 +2753,30 @@ bool    typesEqual(Type* a, Type* b)
     return true;        // primitives -- class identity already matched
 }
 
-void    toCsv(Reader const& rdb, std::ostream& os)
+//  Header: a null-data walk emits every column name, ragged ones padded to
+//  their capacity. The per-prop widths are kept for null-slot rows.
+static std::vector<std::string>     csvHeader(std::vector<PropDecl> const&  props,
+                                              FlatCaps const&               caps,
+                                              std::vector<std::size_t>&     width)
+{
+    std::vector<std::string>    columns{"__time__"};
+    width.assign(props.size(), 0);
+    for (std::size_t pi = 0; pi < props.size(); pi++)
+    {
+        std::vector<std::pair<std::string, std::string>>    names;
+        FlatRow::walk(names, props[pi].name, props[pi].type, nullptr, &caps);
+        width[pi] = names.size();
+        for (auto const& [name, _] : names)
+            columns.push_back(name);
+    }
+    return columns;
+}
+
+//  The header `toCsv` writes, and with it the capacity table and the columns
+//  each prop spans.
+static std::vector<std::string>     csvLayout(Reader const&             rdb,
+                                              FlatCaps&                 caps,
+                                              std::vector<std::size_t>& width)
 {
     auto const& props = rdb.props();
     std::size_t real  = rdb.numStates() >= 2 ? rdb.numStates() - 2 : 0;
@@ -1318,24 +2787,54 @@ void    toCsv(Reader const& rdb, std::ostream& os)
     //  element", so the round trip preserves each record's own count. Without
     //  this pass a ragged array emitted zero columns and its values were
     //  silently lost.
-    FlatCaps    caps;
     for (std::size_t r = 0; r < real; r++)
         for (std::size_t pi = 0; pi < props.size(); pi++)
             if (auto* blob = static_cast<uint8_t const*>(rdb.propBlob(r + 1, pi)))
                 flatScanCaps(props[pi].type, blob, props[pi].name, caps);
 
-    //  Header: a null-data walk emits every column name, ragged ones padded to
-    //  their capacity. The per-prop widths are kept for null-slot rows.
-    std::vector<std::string>    columns{"__time__"};
-    std::vector<std::size_t>    width(props.size(), 0);
-    for (std::size_t pi = 0; pi < props.size(); pi++)
-    {
-        std::vector<std::pair<std::string, std::string>>    names;
-        FlatRow::walk(names, props[pi].name, props[pi].type, nullptr, &caps);
-        width[pi] = names.size();
-        for (auto const& [name, _] : names)
-            columns.push_back(name);
-    }
+    return csvHeader(props, caps, width);
+}
+
+std::vector<std::string>    csvColumns(Reader const& rdb)
+{
+    FlatCaps                    caps;
+    std::vector<std::size_t>    width;
+    auto                        columns = csvLayout(rdb, caps, width);
+    columns.erase(columns.begin());
+    return columns;
+}
+
+std::vector<std::string>    Scanner::columns() const
+{
+    auto const& props = m_impl->props;
+    std::size_t real  = numStates() >= 2 ? numStates() - 2 : 0;
+
+    //  `csvLayout`'s capacity pass, over the blobs as they lie on disk.
+    FlatCaps    caps;
+    for (std::size_t r = 0; r < real; r++)
+        for (std::size_t pi = 0; pi < props.size(); pi++)
+        {
+            int64_t     off   = m_impl->offset(r + 1, pi);
+            std::size_t avail = 0;
+            if (off != kNullOffset)
+                flatScanCaps(props[pi].type, m_impl->blobAt(off, avail),
+                             props[pi].name, caps, true);
+        }
+
+    std::vector<std::size_t>    width;
+    auto                        columns = csvHeader(props, caps, width);
+    columns.erase(columns.begin());
+    return columns;
+}
+
+void    toCsv(Reader const& rdb, std::ostream& os)
+{
+    auto const& props = rdb.props();
+    std::size_t real  = rdb.numStates() >= 2 ? rdb.numStates() - 2 : 0;
+
+    FlatCaps                    caps;
+    std::vector<std::size_t>    width;
+    auto                        columns = csvLayout(rdb, caps, width);
 
     for (std::size_t i = 0; i < columns.size(); i++)
         os << (i ? "," : "") << columns[i];
@@ -1370,6 +2869,842 @@ void    toCsv(Reader const& rdb, std::ostream& os)
     }
 }
 
+// ============================================================================
+//  Frames
+// ============================================================================
+
+namespace
+{
+
+constexpr char      kFrameMagic[8]  = {'R', 'E', 'F', '-', 'F', 'R', 'M', '1'};
+constexpr uint32_t  kFrameVersion   = 1;
+constexpr uint8_t   kFramePool      = 'P';
+constexpr uint8_t   kFrameState     = 'S';
+
+#pragma pack(push, 1)
+struct FrameHeader
+{
+    uint32_t    length;     //  payload bytes, not counting this header
+    uint8_t     kind;       //  kFramePool / kFrameState
+};
+#pragma pack(pop)
+
+} // namespace
+
+struct FrameWriter::Impl
+{
+    std::ostream&                               os;
+    std::vector<PropDecl>                       props;
+    std::unordered_map<std::string, uint64_t>   dict;
+    std::vector<uint8_t>                        pool;       //  what the reader has been sent, and what it has not
+    std::size_t                                 sent = 1;   //  the reader starts with "" at offset 0
+    std::vector<uint8_t>                        payload;
+
+    Impl(std::ostream& s, std::vector<PropDecl> p) : os(s), props(std::move(p))
+    {
+        pool.push_back(0);
+        dict.emplace("", uint64_t{0});
+    }
+
+    void    frame(uint8_t kind, uint8_t const* data, std::size_t size)
+    {
+        if (size > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("rdb: frame too large");
+        FrameHeader h{static_cast<uint32_t>(size), kind};
+        os.write(reinterpret_cast<char const*>(&h), sizeof(h));
+        os.write(reinterpret_cast<char const*>(data), static_cast<std::streamsize>(size));
+    }
+};
+
+FrameWriter::FrameWriter(std::ostream& os, std::vector<PropDecl> props)
+    : m_impl(std::make_unique<Impl>(os, std::move(props)))
+{
+    std::vector<uint8_t>    pre(kFrameMagic, kFrameMagic + sizeof(kFrameMagic));
+    std::vector<uint8_t>    schema;
+    encodeSchema(schema, m_impl->props, {});
+    appendBytes(pre, kFrameVersion);
+    appendBytes(pre, static_cast<uint64_t>(schema.size()));
+    pre.insert(pre.end(), schema.begin(), schema.end());
+    os.write(reinterpret_cast<char const*>(pre.data()), static_cast<std::streamsize>(pre.size()));
+    os.flush();
+}
+
+FrameWriter::~FrameWriter() = default;
+
+void    FrameWriter::writeState(std::int64_t time, blob_t const& propBlobs)
+{
+    auto&       props    = m_impl->props;
+    auto&       payload  = m_impl->payload;
+    auto const  numProps = props.size();
+    if (propBlobs.size() != numProps)
+        throw std::runtime_error(fmt::format("rdb: frame: expected {} prop blobs, got {}",
+                                             numProps, propBlobs.size()));
+
+    //  The fixed part, then each blob aligned relative to the payload start --
+    //  which the reader's buffer puts at an allocation boundary -- and its
+    //  strings interned as it lands.
+    payload.assign(sizeof(int64_t) * (1 + numProps), 0);
+    std::memcpy(payload.data(), &time, sizeof(time));
+    for (std::size_t pi = 0; pi < numProps; pi++)
+    {
+        int64_t     off = kNullOffset;
+        auto const& blob = propBlobs[pi];
+        if (!blob.empty())
+        {
+            alignBuffer(payload, props[pi].type->alignment());
+            off = static_cast<int64_t>(payload.size());
+            payload.insert(payload.end(), blob.begin(), blob.end());
+            StringInterner  walker(payload.data() + off, blob.size(), m_impl->dict, m_impl->pool);
+            walker.walk(props[pi].type);
+        }
+        std::memcpy(payload.data() + sizeof(int64_t) * (1 + pi), &off, sizeof(off));
+    }
+
+    //  Whatever strings this state introduced go out ahead of it.
+    auto&   pool = m_impl->pool;
+    if (pool.size() > m_impl->sent)
+    {
+        m_impl->frame(kFramePool, pool.data() + m_impl->sent, pool.size() - m_impl->sent);
+        m_impl->sent = pool.size();
+    }
+    m_impl->frame(kFrameState, payload.data(), payload.size());
+    m_impl->os.flush();
+}
+
+struct FrameReader::Impl
+{
+    std::istream&                           is;
+    std::string                             ctx;
+    std::vector<std::unique_ptr<Type>>      typeSink;
+    std::vector<PropDecl>                   props;
+    std::vector<char>                       pool{'\0'};
+    std::vector<uint8_t>                    raw;        //  the state as it arrived
+    std::vector<uint8_t>                    row;        //  ... and fixed up
+    std::vector<int64_t>                    offs;
+    std::vector<void const*>                ptrs;
+    int64_t                                 time = 0;
+    bool                                    have = false;
+
+    Impl(std::istream& s, std::string c) : is(s), ctx(std::move(c)) {}
+
+    //  False only if the stream ended before the first byte.
+    bool    read(void* dst, std::size_t n, bool atBoundary)
+    {
+        is.read(static_cast<char*>(dst), static_cast<std::streamsize>(n));
+        auto    got = static_cast<std::size_t>(is.gcount());
+        if (got == n)                   return true;
+        if (got == 0 && atBoundary)     return false;
+        throw std::runtime_error(fmt::format("rdb: '{}': frame cut short", ctx));
+    }
+};
+
+FrameReader::FrameReader(std::istream& is, std::string const& ctx)
+    : m_impl(std::make_unique<Impl>(is, ctx))
+{
+    char        magic[8];
+    uint32_t    version = 0;
+    uint64_t    length  = 0;
+    if (!m_impl->read(magic, sizeof(magic), false)
+        || std::memcmp(magic, kFrameMagic, sizeof(kFrameMagic)) != 0)
+        throw std::runtime_error(fmt::format("rdb: bad frame-stream magic in '{}'", ctx));
+    m_impl->read(&version, sizeof(version), false);
+    if (version != kFrameVersion)
+        throw std::runtime_error(fmt::format("rdb: unsupported frame-stream version {} in '{}'",
+                                             version, ctx));
+    m_impl->read(&length, sizeof(length), false);
+
+    std::vector<uint8_t>    schema(length);
+    m_impl->read(schema.data(), schema.size(), false);
+    uint8_t const*          cur = schema.data();
+    std::vector<ConfDecl>   confs;
+    decodeSchema(cur, schema.data() + schema.size(), m_impl->props, confs, m_impl->typeSink);
+
+    m_impl->offs.assign(m_impl->props.size(), kNullOffset);
+    m_impl->ptrs.assign(m_impl->props.size(), nullptr);
+}
+
+FrameReader::~FrameReader() = default;
+
+std::vector<PropDecl> const&    FrameReader::props() const { return m_impl->props; }
+
+bool    FrameReader::next()
+{
+    auto&   m = *m_impl;
+    for (;;)
+    {
+        FrameHeader h{};
+        if (!m.read(&h, sizeof(h), true))
+            return m.have = false;
+
+        m.raw.resize(h.length);
+        m.read(m.raw.data(), m.raw.size(), false);
+
+        if (h.kind == kFramePool)
+        {
+            if (!m.raw.empty() && m.raw.back() != 0)
+                throw std::runtime_error(fmt::format("rdb: '{}': unterminated pool delta", m.ctx));
+            m.pool.insert(m.pool.end(), m.raw.begin(), m.raw.end());
+            continue;
+        }
+        if (h.kind != kFrameState)
+            throw std::runtime_error(fmt::format("rdb: '{}': unknown frame kind {}",
+                                                 m.ctx, static_cast<int>(h.kind)));
+
+        auto const  numProps = m.props.size();
+        auto const  fixed    = sizeof(int64_t) * (1 + numProps);
+        if (m.raw.size() < fixed)
+            throw std::runtime_error(fmt::format("rdb: '{}': state frame too short", m.ctx));
+
+        //  Fixed up in a copy, so `blobs()` can still hand back the wire form.
+        m.row = m.raw;
+        std::memcpy(&m.time, m.row.data(), sizeof(m.time));
+        std::memcpy(m.offs.data(), m.row.data() + sizeof(int64_t), numProps * sizeof(int64_t));
+        for (std::size_t pi = 0; pi < numProps; pi++)
+        {
+            auto    off = m.offs[pi];
+            m.ptrs[pi]  = nullptr;
+            if (off == kNullOffset)
+                continue;
+            if (off < static_cast<int64_t>(fixed) || static_cast<uint64_t>(off) >= m.row.size())
+                throw std::runtime_error("rdb: prop offset out of range");
+            StringResolver  sub(m.row.data() + off, m.row.size() - off, m.pool.data(), m.pool.size());
+            sub.walk(m.props[pi].type);
+            m.ptrs[pi] = m.row.data() + off;
+        }
+        return m.have = true;
+    }
+}
+
+std::int64_t    FrameReader::time() const { return m_impl->time; }
+
+void const*     FrameReader::propBlob(std::size_t propIdx) const
+{
+    if (propIdx >= m_impl->ptrs.size())
+        throw std::runtime_error(fmt::format("rdb: prop index {} out of range (0..{})",
+                                             propIdx, m_impl->ptrs.size()));
+    return m_impl->ptrs[propIdx];
+}
+
+blob_t  FrameReader::blobs() const
+{
+    auto&   m = *m_impl;
+    blob_t  out(m.props.size());
+    for (std::size_t pi = 0; pi < m.props.size(); pi++)
+    {
+        auto    off = m.offs[pi];
+        if (off == kNullOffset)
+            continue;
+
+        //  A blob runs to the next one (padding and all) or the payload's end.
+        auto    end = static_cast<int64_t>(m.raw.size());
+        for (auto o : m.offs)
+            if (o > off && o < end)
+                end = o;
+        out[pi].assign(m.raw.begin() + off, m.raw.begin() + end);
+        StringResolver  sub(out[pi].data(), out[pi].size(), m.pool.data(), m.pool.size(), false);
+        sub.walk(m.props[pi].type);
+    }
+    return out;
+}
+
+std::string     FrameReader::text() const
+{
+    return text(m_impl->time, m_impl->ptrs);
+}
+
+void    FrameReader::detach(std::vector<uint8_t>& row, std::vector<void const*>& ptrs)
+{
+    row.swap(m_impl->row);
+    ptrs = m_impl->ptrs;
+}
+
+std::string     FrameReader::text(std::int64_t time, std::vector<void const*> const& ptrs) const
+{
+    std::string     out = std::to_string(time);
+    for (std::size_t pi = 0; pi < m_impl->props.size() && pi < ptrs.size(); pi++)
+    {
+        std::vector<std::pair<std::string, std::string>>    leaves;
+        FlatRow::walk(leaves, m_impl->props[pi].name, m_impl->props[pi].type,
+                      static_cast<uint8_t const*>(ptrs[pi]));
+        for (auto const& [_, value] : leaves)
+            out += "," + csvQuote(value);
+    }
+    return out;
+}
+
+// ============================================================================
+//  Corpus
+// ============================================================================
+
+struct Corpus::Impl
+{
+    uint8_t*                                mapped  = nullptr;
+    std::size_t                             length  = 0;
+    CorpusHeader                            hdr{};
+    std::vector<std::unique_ptr<Type>>      typeSink;
+    std::vector<PropDecl>                   props;
+    std::vector<ConfDecl>                   confs;
+    std::vector<CorpusEntry>                entries;
+    std::vector<CorpusMember>               members;
+
+    //  Per member: 0 until opened, 1 once fixed up (with `fixedWith`), 2 if
+    //  the fix-up failed part way and the member is not to be trusted.
+    std::vector<char>                       state;
+    std::vector<Columns>                    fixedWith;
+    std::unordered_map<int64_t, char const*> interned;
+    std::mutex                              lock;
+
+    ~Impl()
+    {
+        if (mapped != nullptr)
+            ::munmap(mapped, length);
+    }
+
+    //  The `.rdb` header member `i` would have had -- what a `Reader` over the
+    //  mapping reads its sections by.
+    OnDiskHeader    header(std::size_t i) const
+    {
+        auto const&     e = entries[i];
+        OnDiskHeader    h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version    = kVersion;
+        h.schema     = hdr.schema;
+        h.conf       = e.conf;
+        h.states     = e.states;
+        h.propBlobs  = e.propBlobs;
+        h.stringPool = hdr.stringPool;
+        h.rowBytes   = hdr.rowBytes;
+        return h;
+    }
+};
+
+Corpus::Corpus(std::string const& path) : m_impl(std::make_shared<Impl>())
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error(fmt::format("rdb: cannot open '{}'", path));
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(CorpusHeader)))
+    {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("rdb: '{}' is too small to be a .rdbx file", path));
+    }
+
+    //  Private and writable: the fix-up rewrites a member's pages as it is
+    //  opened, and the members never opened stay clean page cache.
+    void*   p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw std::runtime_error(fmt::format("rdb: cannot map '{}'", path));
+
+    auto&   impl = *m_impl;
+    impl.mapped = static_cast<uint8_t*>(p);
+    impl.length = static_cast<size_t>(st.st_size);
+
+    auto&   hdr = impl.hdr;
+    std::memcpy(&hdr, impl.mapped, sizeof(hdr));
+    if (std::memcmp(hdr.magic, kCorpusMagic, sizeof(kCorpusMagic)) != 0)
+        throw std::runtime_error(fmt::format("rdb: bad magic in '{}'", path));
+    if (hdr.version != kCorpusVersion)
+        throw std::runtime_error(fmt::format("rdb: unsupported corpus version {} in '{}'",
+                                             hdr.version, path));
+
+    auto    needRange = [&](Section const& sec, char const* what)
+    {
+        if (sec.fileOffs > impl.length || sec.fileSize > impl.length - sec.fileOffs)
+            throw std::runtime_error(fmt::format("rdb: {} section out of bounds in '{}'", what, path));
+    };
+    needRange(hdr.schema,     "schema");
+    needRange(hdr.names,      "names");
+    needRange(hdr.stringPool, "string-pool");
+    needRange(hdr.members,    "members");
+    if (hdr.members.fileSize != hdr.members.itemNmbr * sizeof(CorpusEntry))
+        throw std::runtime_error(fmt::format("rdb: members section size mismatch in '{}'", path));
+
+    {
+        uint8_t const*  cur = impl.mapped + hdr.schema.fileOffs;
+        uint8_t const*  end = cur + hdr.schema.fileSize;
+        decodeSchema(cur, end, impl.props, impl.confs, impl.typeSink);
+        if (cur != end)
+            throw std::runtime_error("rdb: trailing bytes in schema section");
+    }
+    if (impl.props.size() != hdr.schema.itemNmbr)
+        throw std::runtime_error("rdb: schema/schema.itemNmbr disagree");
+    if (hdr.rowBytes != sizeof(int64_t) + hdr.schema.itemNmbr * sizeof(int64_t))
+        throw std::runtime_error("rdb: rowBytes inconsistent with schema.itemNmbr");
+
+    auto    nameAt = [&](uint64_t off)
+    {
+        auto const* base = reinterpret_cast<char const*>(impl.mapped + hdr.names.fileOffs);
+        auto const* end  = base + hdr.names.fileSize;
+        auto const* nul  = off < hdr.names.fileSize ? std::find(base + off, end, '\0') : end;
+        if (nul == end)
+            throw std::runtime_error(fmt::format("rdb: member name out of range in '{}'", path));
+        return std::string(base + off, nul);
+    };
+
+    impl.entries.resize(hdr.members.itemNmbr);
+    if (!impl.entries.empty())
+        std::memcpy(impl.entries.data(), impl.mapped + hdr.members.fileOffs, hdr.members.fileSize);
+    for (auto const& e : impl.entries)
+    {
+        needRange(e.conf,      "member conf");
+        needRange(e.states,    "member states");
+        needRange(e.propBlobs, "member prop-blobs");
+        if (e.states.itemNmbr * hdr.rowBytes != e.states.fileSize)
+            throw std::runtime_error(fmt::format("rdb: member states size mismatch in '{}'", path));
+
+        CorpusMember    m;
+        m.name          = nameAt(e.name);
+        m.expectFailure = e.expectFailure != 0;
+        std::istringstream  labels(nameAt(e.violates));
+        for (std::string label; std::getline(labels, label, ',');)
+            m.violates.push_back(label);
+        impl.members.push_back(std::move(m));
+    }
+    impl.state.assign(impl.entries.size(), 0);
+    impl.fixedWith.resize(impl.entries.size());
+}
+
+Corpus::~Corpus() = default;
+
+std::vector<PropDecl> const&        Corpus::props()   const { return m_impl->props; }
+std::vector<ConfDecl> const&        Corpus::confs()   const { return m_impl->confs; }
+std::vector<CorpusMember> const&    Corpus::members() const { return m_impl->members; }
+
+std::unique_ptr<Reader>     Corpus::open(std::size_t index, Columns const& only) const
+{
+    auto&   impl = *m_impl;
+    if (index >= impl.entries.size())
+        throw std::runtime_error(fmt::format("rdb: corpus member {} out of range (0..{})",
+                                             index, impl.entries.size()));
+    auto const& name = impl.members[index].name;
+    auto        hdr  = impl.header(index);
+    {
+        std::lock_guard<std::mutex> guard(impl.lock);
+        switch (impl.state[index])
+        {
+        case 0:
+            impl.state[index] = 2;
+            fixUpRows(impl.mapped, hdr, impl.props, impl.confs, only, &impl.interned);
+            impl.state[index]     = 1;
+            impl.fixedWith[index] = only;
+            break;
+        case 1:
+            if (impl.fixedWith[index] != only)
+                throw std::runtime_error(fmt::format(
+                    "rdb: corpus member '{}' is already open with other columns", name));
+            break;
+        default:
+            throw std::runtime_error(fmt::format("rdb: corpus member '{}' is corrupt", name));
+        }
+    }
+
+    auto    r   = std::make_unique<Reader::Impl>();
+    r->hdr      = hdr;
+    r->props    = impl.props;
+    r->confs    = impl.confs;
+    r->owner    = m_impl;
+    r->base     = impl.mapped;
+    return std::unique_ptr<Reader>(new Reader(std::move(r)));
+}
+
+void    pack(std::vector<CorpusMember> const& members, std::string const& outPath)
+{
+    if (members.empty())
+        throw std::runtime_error("rdb: a corpus needs at least one trace");
+
+    std::ofstream   os(outPath, std::ios::binary | std::ios::trunc);
+    if (!os)
+        throw std::runtime_error(fmt::format("rdb: cannot write '{}'", outPath));
+
+    //  The header goes first, as a placeholder, and is written again at the
+    //  end: the members stream out behind it, so only one is ever held.
+    CorpusHeader    hdr{};
+    uint64_t        at = 0;
+    auto    put = [&](void const* p, std::size_t n)
+    {
+        os.write(static_cast<char const*>(p), static_cast<std::streamsize>(n));
+        at += n;
+    };
+    auto    place = [&](Section& sec, std::vector<uint8_t> const& bytes, uint64_t cnt)
+    {
+        static constexpr uint8_t    zeros[8] = {};
+        put(zeros, (8 - at % 8) % 8);
+        sec = {at, bytes.size(), cnt};
+        put(bytes.data(), bytes.size());
+    };
+    put(&hdr, sizeof(hdr));
+
+    //  The first member's schema is the corpus's; its Types live in `first`.
+    std::unique_ptr<Scanner>    first;
+    std::vector<uint8_t>        schemaBytes;
+    StringDict                  dict{{"", 0}};
+    std::vector<uint8_t>        pool{0};
+    std::vector<uint8_t>        names;
+    std::vector<uint8_t>        entries;
+
+    auto    sameDecls = [](std::vector<PropDecl> const& a, std::vector<PropDecl> const& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); i++)
+            if (a[i].name != b[i].name || !typesEqual(a[i].type, b[i].type))
+                return false;
+        return true;
+    };
+    auto    addName = [&](std::string const& text)
+    {
+        uint64_t    off = names.size();
+        names.insert(names.end(), text.begin(), text.end());
+        names.push_back(0);
+        return off;
+    };
+
+    for (auto const& m : members)
+    {
+        auto    in = std::make_unique<Scanner>(m.name);
+        if (!first)
+            encodeSchema(schemaBytes, in->props(), in->confs());
+        else if (!sameDecls(in->props(), first->props()) || !sameDecls(in->confs(), first->confs()))
+            throw std::runtime_error(fmt::format(
+                "rdb: '{}' has another schema than '{}'; a corpus holds one schema",
+                m.name, members.front().name));
+        auto const& props = first ? first->props() : in->props();
+        auto const& confs = first ? first->confs() : in->confs();
+
+        auto    conf = in->conf();
+        internConfBlob(confs, conf, dict, pool);
+
+        auto const              n = in->numStates();
+        std::vector<int64_t>    times(n);
+        std::vector<blob_t>     blobs(props.size(), blob_t(n));
+        for (std::size_t si = 0; si < n; si++)
+        {
+            times[si] = in->time(si);
+            for (std::size_t pi = 0; pi < props.size(); pi++)
+                blobs[pi][si] = in->blob(si, pi);
+        }
+        std::vector<uint8_t>    states;
+        std::vector<uint8_t>    propBlobs;
+        layoutRows(props, blobs, times, dict, pool, states, propBlobs);
+
+        std::string violates;
+        for (auto const& label : m.violates)
+            violates += (violates.empty() ? "" : ",") + label;
+
+        CorpusEntry e{};
+        e.name          = addName(m.name);
+        e.violates      = addName(violates);
+        e.expectFailure = m.expectFailure ? 1 : 0;
+        place(e.conf,      conf,      confs.size());
+        place(e.states,    states,    n);
+        place(e.propBlobs, propBlobs, 0);
+        auto const* raw = reinterpret_cast<uint8_t const*>(&e);
+        entries.insert(entries.end(), raw, raw + sizeof(e));
+
+        if (!first)
+            first = std::move(in);
+    }
+
+    std::memcpy(hdr.magic, kCorpusMagic, sizeof(kCorpusMagic));
+    hdr.version  = kCorpusVersion;
+    hdr.rowBytes = sizeof(int64_t) + first->props().size() * sizeof(int64_t);
+    place(hdr.schema,     schemaBytes, first->props().size());
+    place(hdr.names,      names,       0);
+    place(hdr.stringPool, pool,        0);
+    place(hdr.members,    entries,     members.size());
+
+    os.seekp(0);
+    os.write(reinterpret_cast<char const*>(&hdr), sizeof(hdr));
+    os.flush();
+    if (!os)
+        throw std::runtime_error(fmt::format("rdb: cannot write '{}'", outPath));
+}
+
+// ============================================================================
+//  SharedTrace
+// ============================================================================
+
+//  A POSIX shared-memory name is `/` and then no other slash.
+static std::string  shmName(std::string const& name)
+{
+    auto    n = name.starts_with('/') ? name : "/" + name;
+    if (n.size() < 2 || n.find('/', 1) != std::string::npos)
+        throw std::runtime_error(fmt::format("rdb: '{}' is not a shared trace name", name));
+    return n;
+}
+
+//  Map `size` bytes of `fd` at exactly `address`, or throw. A mapping that
+//  landed anywhere else would leave every pointer in the segment dangling.
+static uint8_t*     mapAt(int fd, std::uintptr_t address, std::size_t size, int prot,
+                          std::string const& name)
+{
+    int     flags = MAP_SHARED;
+#ifdef MAP_FIXED_NOREPLACE
+    flags |= MAP_FIXED_NOREPLACE;
+#endif
+    void*   p = ::mmap(reinterpret_cast<void*>(address), size, prot, flags, fd, 0);
+    if (p == MAP_FAILED)
+        throw std::runtime_error(fmt::format("rdb: cannot map shared trace '{}' at {:#x}: "
+                                             "the address is in use here", name, address));
+    if (reinterpret_cast<std::uintptr_t>(p) != address)
+    {
+        ::munmap(p, size);
+        throw std::runtime_error(fmt::format("rdb: cannot map shared trace '{}' at {:#x}: "
+                                             "the address is in use here", name, address));
+    }
+    return static_cast<uint8_t*>(p);
+}
+
+struct SharedTrace::Impl
+{
+    uint8_t*                                mapped  = nullptr;
+    std::size_t                             length  = 0;
+    uint8_t*                                image   = nullptr;
+    OnDiskHeader                            hdr{};
+    std::vector<std::unique_ptr<Type>>      typeSink;
+    std::vector<PropDecl>                   props;
+    std::vector<ConfDecl>                   confs;
+
+    ~Impl()
+    {
+        if (mapped != nullptr)
+            ::munmap(mapped, length);
+    }
+};
+
+void    SharedTrace::serve(std::string const& path, std::string const& name,
+                           std::uintptr_t address)
+{
+    auto    shm = shmName(name);
+
+    //  Away from the heap, the libraries and the sanitizers' reservations, 4 GiB
+    //  apart by name, so traces served under different names do not collide.
+    if (address == 0)
+    {
+        uint64_t    h = 1469598103934665603ull;
+        for (unsigned char c : shm)
+            h = (h ^ c) * 1099511628211ull;
+        address = 0x200000000000ull + (h % 4096) * 0x100000000ull;
+    }
+    long    page = ::sysconf(_SC_PAGESIZE);
+    if (address % static_cast<std::uintptr_t>(page) != 0)
+        throw std::runtime_error(fmt::format("rdb: address {:#x} is not page-aligned", address));
+
+    Reader::Impl    img;
+    img.load(path);
+
+    auto const  imageOffs = (sizeof(SharedHeader) + 63) & ~std::size_t{63};
+    auto const  size      = imageOffs + img.data.size();
+
+    int     fd = ::shm_open(shm.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+        throw std::runtime_error(errno == EEXIST
+            ? fmt::format("rdb: shared trace '{}' exists already; `rdb unserve` it first", name)
+            : fmt::format("rdb: cannot create shared trace '{}'", name));
+
+    uint8_t*    base = nullptr;
+    try
+    {
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+            throw std::runtime_error(fmt::format("rdb: cannot size shared trace '{}'", name));
+        base = mapAt(fd, address, size, PROT_READ | PROT_WRITE, name);
+        ::close(fd);
+        fd = -1;
+
+        uint8_t*    image = base + imageOffs;
+        std::memcpy(image, img.data.data(), img.data.size());
+
+        OnDiskHeader                        hdr{};
+        std::vector<std::unique_ptr<Type>>  sink;
+        std::vector<PropDecl>               props;
+        std::vector<ConfDecl>               confs;
+        openHeader(image, img.data.size(), path, hdr, props, confs, sink);
+        if (hdr.stringPool.fileSize != 0 && image[hdr.stringPool.fileOffs + hdr.stringPool.fileSize - 1] != 0)
+            throw std::runtime_error(fmt::format("rdb: the string pool of '{}' is not terminated", path));
+
+        //  Every string resolves into the segment's own pool, not to this
+        //  process's interned copy: a process attaching adopts them.
+        std::unordered_map<int64_t, char const*>    inPool;
+        auto const* pool = reinterpret_cast<char const*>(image + hdr.stringPool.fileOffs);
+        for (uint64_t off = 0; off < hdr.stringPool.fileSize;)
+        {
+            inPool.emplace(static_cast<int64_t>(off), pool + off);
+            auto const* nul = std::find(pool + off, pool + hdr.stringPool.fileSize, '\0');
+            off = static_cast<uint64_t>(nul - pool) + 1;
+        }
+        auto const  strings = inPool.size();
+        fixUpRows(image, hdr, props, confs, {}, &inPool);
+        if (inPool.size() != strings)
+            throw std::runtime_error(fmt::format("rdb: a string offset in '{}' is not the start of a string", path));
+
+        SharedHeader    sh{};
+        std::memcpy(sh.magic, kSharedMagic, sizeof(kSharedMagic));
+        sh.version   = kSharedVersion;
+        sh.address   = address;
+        sh.imageOffs = imageOffs;
+        sh.imageSize = img.data.size();
+        std::memcpy(base, &sh, sizeof(sh));
+        std::atomic_thread_fence(std::memory_order_release);
+        reinterpret_cast<SharedHeader*>(base)->ready = 1;
+        ::munmap(base, size);
+    }
+    catch (...)
+    {
+        if (base != nullptr)
+            ::munmap(base, size);
+        if (fd >= 0)
+            ::close(fd);
+        ::shm_unlink(shm.c_str());
+        throw;
+    }
+}
+
+void    SharedTrace::remove(std::string const& name)
+{
+    if (::shm_unlink(shmName(name).c_str()) != 0)
+        throw std::runtime_error(fmt::format("rdb: no shared trace '{}'", name));
+}
+
+SharedTrace::SharedTrace(std::string const& name) : m_impl(std::make_shared<Impl>())
+{
+    auto    shm = shmName(name);
+    int     fd  = ::shm_open(shm.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        throw std::runtime_error(fmt::format("rdb: no shared trace '{}'", name));
+
+    struct stat     st{};
+    SharedHeader    sh{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(sh))
+     || ::pread(fd, &sh, sizeof(sh), 0) != static_cast<ssize_t>(sizeof(sh))
+     || std::memcmp(sh.magic, kSharedMagic, sizeof(kSharedMagic)) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("rdb: '{}' is not a shared trace", name));
+    }
+    if (sh.version != kSharedVersion || sh.ready != 1
+     || sh.imageOffs > static_cast<uint64_t>(st.st_size)
+     || sh.imageSize > static_cast<uint64_t>(st.st_size) - sh.imageOffs)
+    {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("rdb: shared trace '{}' is incomplete or of another version", name));
+    }
+
+    auto&   impl = *m_impl;
+    try
+    {
+        impl.mapped = mapAt(fd, sh.address, static_cast<size_t>(st.st_size), PROT_READ, name);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    impl.length = static_cast<size_t>(st.st_size);
+    impl.image  = impl.mapped + sh.imageOffs;
+    openHeader(impl.image, sh.imageSize, name, impl.hdr, impl.props, impl.confs, impl.typeSink);
+
+    //  The blobs hold the pool's addresses, so those have to be the strings
+    //  this process interns: the same content anywhere else -- a literal
+    //  interned by a parse that came first -- would compare unequal to them.
+    auto const* pool = reinterpret_cast<char const*>(impl.image + impl.hdr.stringPool.fileOffs);
+    auto const* end  = pool + impl.hdr.stringPool.fileSize;
+    if (pool != end && end[-1] != '\0')
+        throw std::runtime_error(fmt::format("rdb: the string pool of shared trace '{}' is not terminated", name));
+    std::vector<char const*>    strs;
+    for (auto const* str = pool; str < end; str = std::find(str, end, '\0') + 1)
+        strs.push_back(str);
+    if (auto const* str = Strings::instance()->adopt(strs))
+        throw std::runtime_error(fmt::format(
+                "rdb: shared trace '{}' holds \"{}\", which this process interned first; "
+                "attach before anything else", name, str));
+}
+
+SharedTrace::~SharedTrace() = default;
+
+std::unique_ptr<Reader>     SharedTrace::open() const
+{
+    auto&   impl = *m_impl;
+    auto    r    = std::make_unique<Reader::Impl>();
+    r->hdr      = impl.hdr;
+    r->props    = impl.props;
+    r->confs    = impl.confs;
+    r->owner    = m_impl;
+    r->base     = impl.image;
+    return std::unique_ptr<Reader>(new Reader(std::move(r)));
+}
+
+void    compact(std::string const& inPath, std::string const& outPath,
+                BlockCodec codec, std::size_t blockRows)
+{
+    Scanner         in(inPath);
+    std::ofstream   os(outPath, std::ios::binary);
+    if (!os)
+        throw std::runtime_error(fmt::format("rdb: cannot write '{}'", outPath));
+
+    Writer  w(os);
+    w.setSchema(in.props(), in.confs());
+    w.setConfBlob(in.conf());
+    w.setBlockRows(blockRows);
+    w.setBlockCodec(codec);
+
+    blob_t  row(in.props().size());
+    for (std::size_t si = 0; si < in.numStates(); si++)
+    {
+        for (std::size_t pi = 0; pi < row.size(); pi++)
+            row[pi] = in.blob(si, pi);
+        w.appendState(in.time(si), row);
+    }
+    w.finish();
+}
+
+void    slice(std::string const& inPath, std::ostream& os,
+              std::int64_t from, std::int64_t to,
+              Columns const& only)
+{
+    constexpr auto  kMin = std::numeric_limits<int64_t>::min();
+    constexpr auto  kMax = std::numeric_limits<int64_t>::max();
+
+    //  The real rows in the window: never a sentinel of the file's own.
+    Scanner         in(inPath);
+    std::size_t     n  = in.numStates();
+    std::size_t     lo = std::max<std::size_t>(in.find(from), 1);
+    std::size_t     hi = to < kMax ? in.find(to + 1) : n;
+    hi = std::min(hi, n > 0 ? n - 1 : 0);
+    if (from > to || lo >= hi)
+        throw std::runtime_error(fmt::format("rdb: no state of '{}' lies in [{}, {}]", inPath, from, to));
+
+    blob_t  zero(in.props().size());
+    for (std::size_t pi = 0; pi < zero.size(); pi++)
+        zero[pi].assign(in.props()[pi].type->size(), 0);
+    auto    first = in.time(lo);
+    auto    last  = in.time(hi - 1);
+
+    Writer  w(os);
+    w.setSchema(in.props(), in.confs());
+    w.setNumStates(hi - lo + 2);
+    w.setConfBlob(in.conf());
+    w.writeState(0, first > kMin ? first - 1 : kMin, zero);
+    std::vector<char>   loaded(zero.size());
+    for (std::size_t pi = 0; pi < loaded.size(); pi++)
+        loaded[pi] = only.empty() || only.contains(in.props()[pi].name);
+
+    blob_t  row(zero.size());
+    for (std::size_t si = lo; si < hi; si++)
+    {
+        for (std::size_t pi = 0; pi < row.size(); pi++)
+            if (loaded[pi])
+                row[pi] = in.blob(si, pi);
+        w.writeState(si - lo + 1, in.time(si), row);
+    }
+    w.writeState(hi - lo + 1, last < kMax ? last + 1 : kMax, zero);
+    w.finish();
+}
+
 void dump(std::string const& path, std::ostream& os)
 {
     Reader r(path);
@@ -47,12 +47,13 @@
 // After fix-up the buffer can be handed directly to a JIT-compiled spec —
 // `Referee::execute` does exactly that for `.rdb` inputs.
 //
-// NOTE on large traces: today `Reader` slurps the whole file into a single
-// `std::vector<uint8_t>`. For traces too large to fit in process memory the
-// file should be `mmap()`-ed `MAP_PRIVATE` (so the in-place pointer fix-ups
-// stay process-local instead of dirtying the on-disk image), or backed by
-// shared memory if multiple consumers share the dataset. The fix-up walk
-// itself is identical either way; only the storage backing changes.
+// NOTE on large traces: `Reader` slurps the whole file, onto the heap by
+// default. With a spill directory set (`referee execute --spill`, see
+// runtime/columns.hpp) a file past the spill threshold is read instead into
+// an unlinked file there, mapped shared -- not a `MAP_PRIVATE` mapping of the
+// original, whose fixed-up pages would be private dirty memory with nowhere
+// to go but swap. The fix-up walk itself is identical either way; only the
+// storage backing changes.
 
 #include "syntax.hpp"
 
@@ -60,6 +61,7 @@
 #include <cstdint>
 #include <iosfwd>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -88,6 +90,28 @@ using ConfDecl = PropDecl;
 /// vector means "null pointer for this slot".
 using blob_t = std::vector<std::vector<std::uint8_t>>;
 
+/// The `data` props a consumer reads, by name (`Compile::reads`). A `Reader`
+/// or an ingest given a set loads only those: every other slot is left null,
+/// its blob neither parsed nor fixed up. Empty means all of them.
+using Columns = std::set<std::string>;
+
+/// How an appended file stores its blocks (`Writer::setBlockCodec`).
+///
+///   * `Plain`  -- rows exactly as the JIT reads them;
+///   * `Packed` -- times as varint deltas of deltas, each prop's offsets as
+///     runs (a value held over consecutive rows is one blob, so one run);
+///   * `Zstd`   -- `Packed`, then each block's rows and blobs zstd-compressed.
+///     Only in a build with libzstd; elsewhere writing or reading one throws.
+///
+/// The string pool is never compressed, so a `Scanner` has it without
+/// decoding a block. Either way `Reader` lays the file out as a plain one.
+enum class BlockCodec : std::uint32_t
+{
+    Plain   = 0,
+    Packed  = 1,
+    Zstd    = 2,
+};
+
 /// Build a .rdb file from a sequence of typed prop / conf blobs.
 ///
 /// Typical use:
@@ -102,7 +126,19 @@ using blob_t = std::vector<std::vector<std::uint8_t>>;
 ///     w.finish();
 ///
 /// `propBlobs[pi]` must be the exact bytes `Loader::load` produces for
-/// `props[pi].type`; the writer copies them verbatim.
+/// `props[pi].type`; the writer copies them verbatim. A blob equal to one of
+/// the prop's last few distinct values is not copied again: the rows share it,
+/// so a held signal costs one blob however long it is held, in the file and
+/// in the `Reader` that loads it.
+///
+/// When the number of states is not known up front -- a logger writing as it
+/// runs, or a trace too big to hold -- skip `setNumStates`, call `setConfBlob`
+/// first and `appendState` each row in order. Rows then go out in blocks of
+/// `setBlockRows` (or at `flush`), and `finish` writes an index of the blocks
+/// at the end of the file instead of a table at the front. The writer holds a
+/// block and the string pool, not the trace; and a file whose writer never
+/// got to `finish` still opens, up to its last complete block. `setBlockCodec`
+/// packs (and optionally compresses) each block as it goes out.
 class Writer
 {
 public:
@@ -119,6 +155,10 @@ public:
     void    writeState(std::size_t  stateIdx,
                        std::int64_t time,
                        blob_t const& propBlobs);
+    void    setBlockRows(std::size_t rows);
+    void    setBlockCodec(BlockCodec codec);
+    void    appendState(std::int64_t time, blob_t const& propBlobs);
+    void    flush();
     void    finish();
 
 private:
@@ -131,14 +171,32 @@ private:
 class Reader
 {
 public:
-    /// Open `path`, slurp its bytes, and run pointer fix-up.
-    explicit Reader(std::string const& path);
+    /// Open `path`, slurp its bytes, and run pointer fix-up -- of the props
+    /// in `only`, when it is not empty.
+    explicit Reader(std::string const& path, Columns const& only = {});
 
     /// Take ownership of an already-materialised `.rdb` buffer (e.g. one
     /// produced by `referee::db::ingest(...)` writing to a stringstream)
     /// and run pointer fix-up. `ctx` is used only in error messages.
     explicit Reader(std::vector<std::uint8_t> bytes,
-                    std::string const& ctx = "<memory>");
+                    std::string const& ctx = "<memory>",
+                    Columns const& only = {});
+
+    /// Open `path` where it lies rather than read it: mapped privately, its
+    /// rows left as the file's offsets and resolved by `propBlob` as they
+    /// are read. Only blobs holding a string or a ragged array -- of the
+    /// props in `only`, when it is not empty -- are fixed up, in pages that
+    /// copy on write; a trace with neither is mapped read-only and never
+    /// written, so its pages are shared with every process reading it. For
+    /// a run that builds its own state table, as `Referee::execute` does;
+    /// `ptrFirst` builds one on first use.
+    static std::unique_ptr<Reader>  map(std::string const& path, Columns const& only = {});
+
+    /// Open only the states of `path` timed in [from, to], between sentinels
+    /// of their own, as `slice` cuts them. Only the window is read and fixed
+    /// up; a window with no state in it throws.
+    Reader(std::string const& path, std::int64_t from, std::int64_t to,
+           Columns const& only = {});
 
     ~Reader();
 
@@ -152,7 +210,8 @@ public:
 
     /// Direct execute interface. After construction the slab is fully
     /// fixed-up: `ptrFirst()` is `&state[0]`, `ptrLast()` is
-    /// `&state[numStates() - 1]`, `confPtr()` is the conf blob.
+    /// `&state[numStates() - 1]`, `confPtr()` is the conf blob. (Of a
+    /// mapped reader, the states are a resolved copy of the file's rows.)
     void*           ptrFirst()      const;
     void*           ptrLast()       const;
     void*           confPtr()       const;
@@ -165,6 +224,216 @@ public:
     std::int64_t        time(std::size_t stateIdx) const;
     void const*         propBlob(std::size_t stateIdx, std::size_t propIdx) const;
 
+    /// A state's prop blob copied back out in `Loader::load` form -- strings
+    /// as host pointers, ragged arrays descriptor-relative -- for a `Writer`.
+    /// Empty for a null slot.
+    std::vector<std::uint8_t>   blob(std::size_t stateIdx, std::size_t propIdx) const;
+
+private:
+    friend class Corpus;
+    friend class SharedTrace;
+
+    struct Impl;
+    explicit Reader(std::unique_ptr<Impl> impl);
+
+    std::unique_ptr<Impl>   m_impl;
+};
+
+/// One trace of a corpus, and what a run should make of it -- as a suite line
+/// says (`Referee::readSuite`). For `pack`, `name` is the `.rdb` to read.
+struct CorpusMember
+{
+    std::string                 name;
+    bool                        expectFailure = false;
+    std::vector<std::string>    violates;
+};
+
+/// Many traces of one schema in one `.rdbx` file, `rdb pack`'s output: the
+/// schema once, one string pool, a directory of members and each member's
+/// conf, rows and blobs laid out as in a `.rdb`. The file is mapped once,
+/// privately, and a member is fixed up in place the first time it is opened,
+/// with each pool string interned once for the whole corpus. Opening a member
+/// then decodes no schema, compares no types and copies nothing: the `Reader`
+/// it gives is a view into the mapping, sharing the corpus's `Type*`s.
+class Corpus
+{
+public:
+    explicit Corpus(std::string const& path);
+    ~Corpus();
+
+    Corpus(Corpus const&)            = delete;
+    Corpus& operator=(Corpus const&) = delete;
+
+    std::vector<PropDecl> const&        props()   const;
+    std::vector<ConfDecl> const&        confs()   const;
+    std::vector<CorpusMember> const&    members() const;
+
+    /// Member `index` as a `Reader`, fixed up -- of the props in `only`, when
+    /// it is not empty -- on its first open. A member is fixed up once, so
+    /// opening it again with another `only` throws. The reader keeps the
+    /// corpus mapped however long it outlives this object.
+    std::unique_ptr<Reader>             open(std::size_t index, Columns const& only = {}) const;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl>   m_impl;
+};
+
+/// Pack the `.rdb` files `members` name into a corpus at `outPath` -- `rdb
+/// pack`. Each is read through a `Scanner`, so only one is held at a time. All
+/// must have the schema of the first; a member of another is an error.
+void    pack(std::vector<CorpusMember> const& members, std::string const& outPath);
+
+/// A `.rdb` loaded and fixed up once into a POSIX shared-memory segment, for
+/// any number of processes to check at once -- `rdb serve`, `referee execute
+/// --attach`. Every process maps the segment at the one address it was built
+/// for, so the row and blob pointers its fix-up wrote hold in all of them, and
+/// its strings point into its own pool. An attaching process takes those as
+/// its interned strings (`Strings::adopt`) -- which is why it has to attach
+/// before it interns anything itself, a specification's literals included.
+class SharedTrace
+{
+public:
+    /// Create segment `name` from the `.rdb` at `path`, for mapping at
+    /// `address` -- or, for 0, at one derived from the name. The segment stays
+    /// until `remove`d, whether or not anything has it attached.
+    static void     serve(std::string const& path, std::string const& name,
+                          std::uintptr_t address = 0);
+    static void     remove(std::string const& name);
+
+    /// Map segment `name` read-only. Throws if its address is taken here, or
+    /// if one of its strings was interned in this process before it.
+    explicit SharedTrace(std::string const& name);
+    ~SharedTrace();
+
+    SharedTrace(SharedTrace const&)            = delete;
+    SharedTrace& operator=(SharedTrace const&) = delete;
+
+    /// The trace as a `Reader` over the segment, which stays mapped however
+    /// long the reader outlives this object. Nothing is copied or fixed up.
+    std::unique_ptr<Reader>     open() const;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl>   m_impl;
+};
+
+/// A `.rdb` read in place through a read-only mapping, a state at a time. No
+/// fix-up is run, so the mapped pages stay clean and a front-to-back pass over
+/// a file larger than memory costs page cache, not resident memory. This is
+/// how `rdb merge --stream` reads its `.rdb` sources. A packed block is decoded
+/// when a state in it is first asked for, into a buffer the next one reuses,
+/// so a Scanner is for one thread at a time.
+class Scanner
+{
+public:
+    explicit Scanner(std::string const& path);
+    ~Scanner();
+
+    Scanner(Scanner const&)            = delete;
+    Scanner& operator=(Scanner const&) = delete;
+
+    std::vector<PropDecl> const&    props()     const;
+    std::vector<ConfDecl> const&    confs()     const;
+    std::size_t                     numStates() const;
+    std::int64_t                    time(std::size_t stateIdx) const;
+
+    /// The first state timed at or after `time` (`numStates()` if none), by a
+    /// binary search: over the rows of a plain file, which are their own time
+    /// index, or over an appended file's block times and then one block.
+    std::size_t                     find(std::int64_t time) const;
+
+    /// The conf blob in `Loader::load` form, for a `Writer::setConfBlob`.
+    std::vector<std::uint8_t>       conf() const;
+
+    /// As `Reader::blob`: the slot in `Loader::load` form, empty for null.
+    std::vector<std::uint8_t>       blob(std::size_t stateIdx, std::size_t propIdx) const;
+
+    /// What `csvColumns` gives for the same file. Costs a pass over the blobs,
+    /// for the capacities of ragged arrays.
+    std::vector<std::string>        columns() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl>   m_impl;
+};
+
+/// A live stream of states in `.rdb` wire form, one length-framed row at a
+/// time, for `referee monitor --binary`. The stream opens with a preamble --
+/// an eight-byte magic, a version and the encoded `data` schema -- and then
+/// carries frames, each a `u32` payload length, a one-byte kind and the
+/// payload:
+///
+///   * `P` -- string-pool delta: NUL-terminated strings appended to the
+///     stream's pool, which starts as the one empty string at offset 0,
+///     exactly as a `.rdb` pool does;
+///   * `S` -- one state: `int64` time, one `int64` offset per prop into the
+///     payload (-1 for null), then the prop blobs, each aligned to its type.
+///     Strings in a blob are pool offsets, ragged arrays descriptor-relative,
+///     as on disk.
+///
+/// A string is sent once, the first time a state carries it; after that a
+/// row costs its blobs and nothing else.
+class FrameWriter
+{
+public:
+    /// Write the preamble for `props` (the recorded `data` declarations).
+    FrameWriter(std::ostream& os, std::vector<PropDecl> props);
+    ~FrameWriter();
+
+    FrameWriter(FrameWriter const&)            = delete;
+    FrameWriter& operator=(FrameWriter const&) = delete;
+
+    /// Frame one state. `propBlobs` is in `Loader::load` form, as for
+    /// `Writer::writeState`. The stream is flushed, so a reader at the other
+    /// end of a pipe sees the state as soon as it is written.
+    void    writeState(std::int64_t time, blob_t const& propBlobs);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl>   m_impl;
+};
+
+/// The receiving end of a `FrameWriter` stream. Each state frame is read into
+/// one reused buffer and fixed up there, in place, exactly as `Reader` fixes
+/// up a row: `propBlob` then points at a blob the generated code can read.
+class FrameReader
+{
+public:
+    /// Read and check the preamble. `ctx` is used only in error messages.
+    explicit FrameReader(std::istream& is, std::string const& ctx = "<stream>");
+    ~FrameReader();
+
+    FrameReader(FrameReader const&)            = delete;
+    FrameReader& operator=(FrameReader const&) = delete;
+
+    /// The stream's schema. The Type*s are owned by the FrameReader.
+    std::vector<PropDecl> const&    props() const;
+
+    /// Advance to the next state, absorbing any pool deltas before it. False
+    /// at a clean end of stream; a frame cut short is an error.
+    bool                next();
+
+    std::int64_t        time() const;
+    void const*         propBlob(std::size_t propIdx) const;
+
+    /// The current state's blobs back in `Loader::load` form -- strings as
+    /// host pointers, ragged arrays descriptor-relative -- for a `Writer`.
+    blob_t              blobs() const;
+
+    /// The current state as a CSV row, `__time__` first, for messages.
+    std::string         text() const;
+
+    /// Hand the current state over to a consumer that holds it past `next()`:
+    /// its fixed-up buffer is swapped into `row` -- no byte is copied, so the
+    /// pointers into it stay valid -- and `ptrs` gets each prop's blob in it,
+    /// as `propBlob` gives it. `row`'s old buffer is reused for the next
+    /// state. `time`, `blobs` and `text` still answer until `next()`.
+    void                detach(std::vector<uint8_t>& row, std::vector<void const*>& ptrs);
+
+    /// A detached state as a CSV row, as `text()` renders the current one.
+    std::string         text(std::int64_t time, std::vector<void const*> const& ptrs) const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl>   m_impl;
@@ -214,6 +483,22 @@ bool    typesEqual(Type* a, Type* b);
 /// using the schema embedded in the file.
 void    dump(std::string const& path, std::ostream& os);
 
+/// Rewrite the `.rdb` at `inPath` as an appended file at `outPath`, its blocks
+/// `blockRows` states long and stored as `codec` says -- `rdb compact`. The
+/// input is read through a `Scanner`, so either side may be bigger than memory.
+void    compact(std::string const& inPath, std::string const& outPath,
+                BlockCodec codec, std::size_t blockRows);
+
+/// Write the states of the `.rdb` at `inPath` timed in [from, to] to `os` as a
+/// `.rdb` of their own, bracketed by zero sentinels a tick outside them --
+/// `rdb slice`, and `referee execute --from/--to`. The window is found by
+/// `Scanner::find` and only its rows and blobs are read, so a minute of a
+/// day-long capture costs a minute of I/O. Throws if no state lies in it.
+/// Props not in a non-empty `only` are written null.
+void    slice(std::string const& inPath, std::ostream& os,
+              std::int64_t from, std::int64_t to,
+              Columns const& only = {});
+
 /// Decode an already-opened `.rdb` back to a flat CSV document on `os`:
 /// `__time__` plus one column per leaf of every `data` signal, one row per real
 /// state (the bracketing sentinels are omitted). The column layout is the one
@@ -222,4 +507,7 @@ void    dump(std::string const& path, std::ostream& os);
 /// `rdb merge`.
 void    toCsv(Reader const& rdb, std::ostream& os);
 
+/// The columns `toCsv` would write for `rdb`, `__time__` left out.
+std::vector<std::string>    csvColumns(Reader const& rdb);
+
 } // namespace referee::db
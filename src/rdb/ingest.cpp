@@ -64,10 +64,15 @@ namespace referee::db
 //  not be resolved, and two arrays in one struct would have merged their
 //  extents into one vector by position.
 Referee::Sizes  inferSizes(loader::Row const& doc)
+{
+    return inferSizes(doc.columnNames());
+}
+
+Referee::Sizes  inferSizes(std::vector<std::string> const& columns)
 {
     std::map<std::string, std::vector<unsigned>>    out;
 
-    for (auto const& col : doc.columnNames())
+    for (auto const& col : columns)
     {
         std::string path;
 
@@ -109,10 +114,17 @@ Referee::Sizes  inferSizes(loader::Row const& doc)
 }
 
 
-void    ingestWithModule(std::istream&        dataIn,  std::string const& dataName,
-                         std::istream*        confIn,  std::string const& confName,
-                         ::Module*            astModule,
-                         std::ostream&        out)
+namespace
+{
+
+//  Load every row of a CSV/YAML trace into `Loader::load` blobs, one per
+//  recorded prop of `astModule`, in `recordedProps` order. No sentinels. A prop
+//  left out of a non-empty `only` is not parsed: its blobs stay empty, null.
+void    loadRows(std::istream&               dataIn,  std::string const& dataName,
+                 ::Module*                   astModule,
+                 std::vector<std::int64_t>&  times,
+                 std::vector<blob_t>&        rows,
+                 Columns const&              only = {})
 {
     //  The trace determines a ragged array's per-record length, so the
     //  document is opened before the blobs are built. The schema is given,
@@ -121,67 +133,52 @@ void    ingestWithModule(std::istream&        dataIn,  std::string const& dataNa
 
     //  Column extents read off the header -- how far to probe for a ragged
     //  array's elements, nothing more.
-    Referee::Sizes  sizes = referee::db::inferSizes(*doc);
+    Referee::Sizes  sizes = inferSizes(*doc);
+
+    auto        props   = recordedProps(astModule);
+    std::size_t numRows = doc->rowCount();
+
+    std::vector<char>   loaded(props.size());
+    for (std::size_t pi = 0; pi < props.size(); pi++)
+        loaded[pi] = only.empty() || only.contains(props[pi].name);
+
+    times.assign(numRows, 0);
+    rows.assign(numRows, blob_t(props.size()));
+    for (std::size_t row = 0; row < numRows; row++)
+    {
+        times[row] = timeAt(*doc, row);
+        for (std::size_t pi = 0; pi < props.size(); pi++)
+            if (loaded[pi])
+                Loader::load(rows[row][pi], props[pi].name, props[pi].type,
+                    [&](std::string const& col) { return doc->cell(col, row); },
+                    sizes);
+    }
+}
 
+} // namespace
+
+std::vector<PropDecl>   recordedProps(::Module* astModule)
+{
     //  Computed props (`data x = expr`) are deliberately absent from the .rdb:
     //  nothing in the trace file backs them, and their values are a function of
     //  the spec rather than of the recording. `referee execute` materialises
     //  them from the .ref at run time (see __prepare__), so a .rdb stays valid
     //  when only a computed prop's defining expression changes.
-    std::vector<std::string> propNames;
+    std::vector<PropDecl>   out;
     for (auto const& n : astModule->getPropNames())
     {
         if (!astModule->isExprData(n))
-            propNames.push_back(n);
-    }
-
-    auto    confNames   = astModule->getConfNames();
-    std::size_t     numRows     = doc->rowCount();
-    std::size_t     numProps    = propNames.size();
-    std::size_t     numStates   = numRows + 2;          //  sentinels at 0 and N-1
-
-    auto    zeroBlob    = [&](Type* t)
-    {
-        std::vector<std::uint8_t>   b(t->size(), 0);
-        return b;
-    };
-
-    // states[state][prop]
-    std::vector<blob_t>     blobs(numStates, blob_t(numProps));
-    std::vector<std::int64_t>   times(numStates, 0);
-
-    for (std::size_t row = 0; row < numRows; row++)
-    {
-        std::size_t     si = row + 1;
-        times[si] = timeAt(*doc, row);
-        for (std::size_t pi = 0; pi < numProps; pi++)
-        {
-            auto const& name    = propNames[pi];
-            auto*       type    = astModule->getProp(name);
-            blobs[si][pi].clear();
-            Loader::load(blobs[si][pi], name, type,
-                [&](std::string const& col) { return doc->cell(col, row); },
-                sizes);
-        }
-    }
-
-    // Sentinels: zero blobs, time just outside the data window.
-    {
-        constexpr auto kMin = std::numeric_limits<std::int64_t>::min();
-        constexpr auto kMax = std::numeric_limits<std::int64_t>::max();
-        std::int64_t firstT = numRows ? times[1]       : 0;
-        std::int64_t lastT  = numRows ? times[numRows] : 0;
-        times[0]            = firstT > kMin ? firstT - 1 : kMin;
-        times[numStates - 1]= lastT  < kMax ? lastT  + 1 : kMax;
-        for (std::size_t pi = 0; pi < numProps; pi++)
-        {
-            auto* t = astModule->getProp(propNames[pi]);
-            blobs[0][pi]            = zeroBlob(t);
-            blobs[numStates - 1][pi]= zeroBlob(t);
-        }
+            out.push_back({n, astModule->getProp(n)});
     }
+    return out;
+}
 
-    // 3. Conf blob: same alignment + Loader::load rules as Referee::execute.
+std::vector<std::uint8_t>   confBlobWithModule(std::istream*      confIn,
+                                               std::string const& confName,
+                                               ::Module*          astModule)
+{
+    //  Same alignment + Loader::load rules as Referee::execute.
+    auto                        confNames = astModule->getConfNames();
     std::vector<std::uint8_t>   confBlob;
     if (!confNames.empty())
     {
@@ -212,25 +209,68 @@ void    ingestWithModule(std::istream&        dataIn,  std::string const& dataNa
         while (confBlob.size() % maxAlign) confBlob.push_back(0);
     }
     if (confBlob.empty()) confBlob.push_back(0);
+    return confBlob;
+}
+
+void    packWithModule(std::vector<std::int64_t> const&  times,
+                       std::vector<blob_t> const&        rows,
+                       std::vector<std::uint8_t>         confBlob,
+                       ::Module*                         astModule,
+                       std::ostream&                     out)
+{
+    auto            propDecls = recordedProps(astModule);
+    std::size_t     numRows   = rows.size();
+    std::size_t     numStates = numRows + 2;            //  sentinels at 0 and N-1
+
+    blob_t          zero(propDecls.size());
+    for (std::size_t pi = 0; pi < propDecls.size(); pi++)
+        zero[pi].assign(propDecls[pi].type->size(), 0);
 
-    // 4. Hand it all to the Writer.
-    std::vector<PropDecl>   propDecls;
-    propDecls.reserve(numProps);
-    for (auto const& n : propNames)
-        propDecls.push_back({n, astModule->getProp(n)});
+    //  Sentinels: zero blobs, time just outside the data window.
+    constexpr auto  kMin   = std::numeric_limits<std::int64_t>::min();
+    constexpr auto  kMax   = std::numeric_limits<std::int64_t>::max();
+    std::int64_t    firstT = numRows ? times.front() : 0;
+    std::int64_t    lastT  = numRows ? times.back()  : 0;
 
     std::vector<ConfDecl>   confDecls;
-    confDecls.reserve(confNames.size());
-    for (auto const& n : confNames)
+    for (auto const& n : astModule->getConfNames())
         confDecls.push_back({n, astModule->getConf(n)});
 
     Writer  w(out);
     w.setSchema(std::move(propDecls), std::move(confDecls));
     w.setNumStates(numStates);
     w.setConfBlob(std::move(confBlob));
-    for (std::size_t si = 0; si < numStates; si++)
-        w.writeState(si, times[si], blobs[si]);
+    w.writeState(0, firstT > kMin ? firstT - 1 : kMin, zero);
+    for (std::size_t row = 0; row < numRows; row++)
+        w.writeState(row + 1, times[row], rows[row]);
+    w.writeState(numStates - 1, lastT < kMax ? lastT + 1 : kMax, zero);
     w.finish();
 }
 
+void    ingestWithModule(std::istream&        dataIn,  std::string const& dataName,
+                         std::istream*        confIn,  std::string const& confName,
+                         ::Module*            astModule,
+                         std::ostream&        out,
+                         Columns const&       only)
+{
+    std::vector<std::int64_t>   times;
+    std::vector<blob_t>         rows;
+    loadRows(dataIn, dataName, astModule, times, rows, only);
+    packWithModule(times, rows, confBlobWithModule(confIn, confName, astModule),
+                   astModule, out);
+}
+
+void    framesWithModule(std::istream&        dataIn,  std::string const& dataName,
+                         ::Module*            astModule,
+                         std::ostream&        out)
+{
+    std::vector<std::int64_t>   times;
+    std::vector<blob_t>         rows;
+    loadRows(dataIn, dataName, astModule, times, rows);
+
+    FrameWriter     w(out, recordedProps(astModule));
+    for (std::size_t row = 0; row < rows.size(); row++)
+        w.writeState(times[row], rows[row]);
+}
+
 } // namespace referee::db
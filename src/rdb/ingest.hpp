@@ -24,10 +24,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
 #include <string>
 #include <vector>
 
+#include "database.hpp"
+#include "merge.hpp"
 #include "referee.hpp"
 #include "loaders/row.hpp"
 
@@ -48,15 +51,18 @@ namespace referee::db
 /// (`.csv` vs `.yaml`) and for error messages.
 /// `includePaths` are forwarded to the schema parse, so a spec that pulls its
 /// `data`/`conf` declarations in via `import` packs the same as an inline one.
+/// A prop left out of a non-empty `only` is not parsed; its slots go null.
 /// Array extents read off a trace's flattened column names, for a
 /// specification that leaves them out. Outermost dimension first.
 Referee::Sizes  inferSizes(loader::Row const& doc);
+Referee::Sizes  inferSizes(std::vector<std::string> const& columns);
 
 void    ingest(std::istream&        refIn,   std::string const& refName,
                std::istream&        dataIn,  std::string const& dataName,
                std::istream*        confIn,  std::string const& confName,
                std::ostream&        out,
-               std::vector<std::string> const& includePaths = {});
+               std::vector<std::string> const& includePaths = {},
+               Columns const&       only = {});
 
 /// Pack a trace against an already-built schema `Module`, without parsing a
 /// `.ref`. This is the LLVM-and-ANTLR-free half of ingest: the `ingest`
@@ -65,9 +71,62 @@ void    ingest(std::istream&        refIn,   std::string const& refName,
 /// directly to accept CSV/YAML the same way the JIT path does.
 void    ingestWithModule(std::istream&        dataIn,  std::string const& dataName,
                          std::istream*        confIn,  std::string const& confName,
+                         ::Module*            astModule,
+                         std::ostream&        out,
+                         Columns const&       only = {});
+
+/// The `data` declarations a `.rdb` records for `astModule`: every prop but
+/// the computed ones, in declaration order.
+std::vector<PropDecl>       recordedProps(::Module* astModule);
+
+/// The conf blob `ingestWithModule` packs: the single row of `confIn` loaded
+/// against the module's `conf` declarations, or zeros if `confIn` is null.
+std::vector<std::uint8_t>   confBlobWithModule(std::istream*      confIn,
+                                               std::string const& confName,
+                                               ::Module*          astModule);
+
+/// The back half of `ingestWithModule`: pack rows already in `Loader::load`
+/// form (one `blob_t` per state, `recordedProps` order) with their times,
+/// adding the sentinels.
+void    packWithModule(std::vector<std::int64_t> const&  times,
+                       std::vector<blob_t> const&        rows,
+                       std::vector<std::uint8_t>         confBlob,
+                       ::Module*                         astModule,
+                       std::ostream&                     out);
+
+/// Encode a trace as a `FrameWriter` stream rather than a `.rdb`: the input
+/// `referee monitor --binary` reads.
+void    framesWithModule(std::istream&        dataIn,  std::string const& dataName,
                          ::Module*            astModule,
                          std::ostream&        out);
 
+/// `framesWithModule` behind a `.ref` parse, as `ingest` is for a `.rdb`.
+void    frames(std::string const& refPath,
+               std::string const& dataPath,
+               std::string const& outPath,
+               std::vector<std::string> const& includePaths = {});
+
+/// `rdb merge`: fold `sources` into one `.rdb` on `out` under the schema of
+/// `refIn`, typed (`mergeToRdb`) where every signal comes whole from one
+/// source, through `mergeTraces` and a CSV where one does not.
+void    merge(std::istream&                     refIn,   std::string const& refName,
+              std::vector<MergeSource> const&   sources,
+              std::istream*                     confIn,  std::string const& confName,
+              LeadingGap                        leading,
+              Overlap                           overlap,
+              std::ostream&                     out,
+              std::vector<std::string> const&   includePaths = {});
+
+/// `rdb merge --stream`: as above, through `mergeStreaming` -- each source read
+/// once, in order, and no fallback to text.
+void    merge(std::istream&                     refIn,   std::string const& refName,
+              std::vector<StreamSource> const&  sources,
+              std::istream*                     confIn,  std::string const& confName,
+              LeadingGap                        leading,
+              Overlap                           overlap,
+              std::ostream&                     out,
+              std::vector<std::string> const&   includePaths = {});
+
 /// File-paths convenience wrapper around the stream-based variant.
 /// `confPath` may be empty for "no conf file".
 void    ingest(std::string const& refPath,
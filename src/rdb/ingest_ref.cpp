@@ -37,21 +37,43 @@
 #include <fmt/format.h>
 
 #include <fstream>
+#include <iostream>
 #include <sstream>
 #include <stdexcept>
 
 namespace referee::db
 {
 
+namespace
+{
+
+//  The trace has to be in hand before the schema is finished: a `T[]` array's
+//  extent is read off its columns. `inferSizes` needs the doc, so open it,
+//  learn the extents, then parse the schema against them.
+auto    schemaFor(std::string const& refSrc,  std::string const& refName,
+                  std::string const& dataSrc, std::string const& dataName,
+                  std::vector<std::string> const& includePaths)
+{
+    Referee::Sizes  sizes;
+    {
+        std::istringstream  probe(dataSrc);
+        auto                doc = loader::Row::open(probe, dataName);
+        sizes = inferSizes(*doc);
+    }
+
+    std::istringstream  refForSchema(refSrc);
+    return Referee::parseSchema(refForSchema, refName, includePaths, sizes);
+}
+
+} // namespace
+
 void    ingest(std::istream&        refIn,   std::string const& refName,
                std::istream&        dataIn,  std::string const& dataName,
                std::istream*        confIn,  std::string const& confName,
                std::ostream&        out,
-               std::vector<std::string> const& includePaths)
+               std::vector<std::string> const& includePaths,
+               Columns const&       only)
 {
-    //  The trace has to be in hand before the schema is finished: a `T[]`
-    //  array's extent is read off its columns. `inferSizes` needs the doc, so
-    //  open it, learn the extents, then parse the schema against them.
     std::string refSrc{std::istreambuf_iterator<char>(refIn),
                        std::istreambuf_iterator<char>()};
 
@@ -60,18 +82,89 @@ void    ingest(std::istream&        refIn,   std::string const& refName,
     std::string dataSrc{std::istreambuf_iterator<char>(dataIn),
                         std::istreambuf_iterator<char>()};
 
-    Referee::Sizes  sizes;
+    auto    schema = schemaFor(refSrc, refName, dataSrc, dataName, includePaths);
+
+    std::istringstream  dataForBlobs(dataSrc);
+    ingestWithModule(dataForBlobs, dataName, confIn, confName, schema.ast, out, only);
+}
+
+void    merge(std::istream&                     refIn,   std::string const& refName,
+              std::vector<MergeSource> const&   sources,
+              std::istream*                     confIn,  std::string const& confName,
+              LeadingGap                        leading,
+              Overlap                           overlap,
+              std::ostream&                     out,
+              std::vector<std::string> const&   includePaths)
+{
+    //  The extents the merged CSV's header would give: every source's
+    //  columns together.
+    std::vector<std::string>    columns;
+    for (auto const& source : sources)
+        columns.insert(columns.end(), source.columns.begin(), source.columns.end());
+    auto    sizes  = inferSizes(columns);
+    auto    schema = Referee::parseSchema(refIn, refName, includePaths, sizes);
+
+    //  Snapshot the conf so whichever path packs can read it.
+    std::string confSrc;
+    if (confIn)
+        confSrc.assign(std::istreambuf_iterator<char>(*confIn), std::istreambuf_iterator<char>());
+
+    std::vector<ConfDecl>   confs;
+    for (auto const& n : schema.ast->getConfNames())
+        confs.push_back({n, schema.ast->getConf(n)});
+
     {
-        std::istringstream  probe(dataSrc);
-        auto                doc = loader::Row::open(probe, dataName);
-        sizes = inferSizes(*doc);
+        std::istringstream  conf(confSrc);
+        if (mergeToRdb(sources, recordedProps(schema.ast), confs,
+                       confBlobWithModule(confIn ? &conf : nullptr, confName, schema.ast),
+                       sizes, leading, overlap, out))
+            return;
     }
 
-    std::istringstream  refForSchema(refSrc);
-    auto    schema = Referee::parseSchema(refForSchema, refName, includePaths, sizes);
+    //  A signal assembled from columns of several sources is merged through
+    //  text: every source a document, a `.rdb` decoded back to CSV first.
+    std::vector<std::unique_ptr<std::stringstream>>     texts;
+    std::vector<std::unique_ptr<loader::Row>>           owned;
+    std::vector<loader::Row*>                           docs;
+    for (std::size_t si = 0; si < sources.size(); si++)
+    {
+        if (sources[si].doc)
+        {
+            docs.push_back(sources[si].doc);
+            continue;
+        }
+        texts.push_back(std::make_unique<std::stringstream>());
+        toCsv(*sources[si].rdb, *texts.back());
+        owned.push_back(loader::Row::open(*texts.back(), "source-" + std::to_string(si) + ".csv"));
+        docs.push_back(owned.back().get());
+    }
 
-    std::istringstream  dataForBlobs(dataSrc);
-    ingestWithModule(dataForBlobs, dataName, confIn, confName, schema.ast, out);
+    std::istringstream  data(mergeTraces(docs, leading, overlap));
+    std::istringstream  conf(confSrc);
+    ingestWithModule(data, "merged.csv", confIn ? &conf : nullptr, confName, schema.ast, out);
+}
+
+void    merge(std::istream&                     refIn,   std::string const& refName,
+              std::vector<StreamSource> const&  sources,
+              std::istream*                     confIn,  std::string const& confName,
+              LeadingGap                        leading,
+              Overlap                           overlap,
+              std::ostream&                     out,
+              std::vector<std::string> const&   includePaths)
+{
+    std::vector<std::string>    columns;
+    for (auto const& source : sources)
+        columns.insert(columns.end(), source.columns().begin(), source.columns().end());
+    auto    sizes  = inferSizes(columns);
+    auto    schema = Referee::parseSchema(refIn, refName, includePaths, sizes);
+
+    std::vector<ConfDecl>   confs;
+    for (auto const& n : schema.ast->getConfNames())
+        confs.push_back({n, schema.ast->getConf(n)});
+
+    mergeStreaming(sources, recordedProps(schema.ast), confs,
+                   confBlobWithModule(confIn, confName, schema.ast),
+                   sizes, leading, overlap, out);
 }
 
 void    ingest(std::string const& refPath,
@@ -105,4 +198,39 @@ void    ingest(std::string const& refPath,
     ingest(refIn, refPath, dataIn, dataPath, confInPtr, confPath, out, includePaths);
 }
 
+void    frames(std::string const& refPath,
+               std::string const& dataPath,
+               std::string const& outPath,
+               std::vector<std::string> const& includePaths)
+{
+    std::ifstream   refIn(refPath);
+    if (!refIn)
+        throw std::runtime_error(fmt::format("rdb: cannot open '{}'", refPath));
+
+    std::ifstream   dataIn(dataPath);
+    if (!dataIn)
+        throw std::runtime_error(fmt::format("rdb: cannot open '{}'", dataPath));
+
+    std::string refSrc{std::istreambuf_iterator<char>(refIn),
+                       std::istreambuf_iterator<char>()};
+    std::string dataSrc{std::istreambuf_iterator<char>(dataIn),
+                        std::istreambuf_iterator<char>()};
+
+    auto    schema = schemaFor(refSrc, refPath, dataSrc, dataPath, includePaths);
+
+    //  `-` is standard output, so a recording can be piped straight into a
+    //  monitor.
+    std::istringstream  dataForBlobs(dataSrc);
+    if (outPath == "-")
+    {
+        framesWithModule(dataForBlobs, dataPath, schema.ast, std::cout);
+        return;
+    }
+
+    std::ofstream   out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error(fmt::format("rdb: cannot create '{}'", outPath));
+    framesWithModule(dataForBlobs, dataPath, schema.ast, out);
+}
+
 } // namespace referee::db
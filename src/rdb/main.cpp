@@ -26,6 +26,7 @@
 #include "ingest.hpp"
 #include "merge.hpp"
 #include "loaders/row.hpp"
+#include "referee.hpp"
 
 #include <CLI/App.hpp>
 #include <CLI/Config.hpp>
@@ -33,6 +34,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
@@ -77,6 +79,95 @@ int main(int argc, char* argv[])
     dumpCmd->add_option("rdb", dumpFile, "Input .rdb path")
         ->required()->check(CLI::ExistingFile);
 
+    //  compact: the same trace, its blocks packed for the archive.
+    auto*   compactCmd = app.add_subcommand(
+        "compact",
+        "Rewrite a .rdb with packed blocks: delta-coded times, held values stored once");
+    std::string     compactIn;
+    std::string     compactOut;
+    std::string     compactCodec = "packed";
+    std::size_t     compactBlock = 1024;
+    compactCmd->add_option("rdb", compactIn, "Input .rdb path")
+        ->required()->check(CLI::ExistingFile);
+    compactCmd->add_option("-o,--out", compactOut, "Output .rdb path")->required();
+    compactCmd->add_option("--codec", compactCodec,
+        "Block encoding: plain | packed | zstd (packed, then zstd-compressed)")
+        ->check(CLI::IsMember({"plain", "packed", "zstd"}));
+    compactCmd->add_option("--block", compactBlock, "States per block")
+        ->check(CLI::PositiveNumber);
+
+    //  slice: a window of a trace, as a trace of its own.
+    auto*   sliceCmd = app.add_subcommand(
+        "slice",
+        "Cut the states timed in [--from, --to] out of a .rdb into a .rdb of their own");
+    std::string     sliceIn;
+    std::string     sliceOut;
+    std::int64_t    sliceFrom = std::numeric_limits<std::int64_t>::min();
+    std::int64_t    sliceTo   = std::numeric_limits<std::int64_t>::max();
+    sliceCmd->add_option("rdb", sliceIn, "Input .rdb path")
+        ->required()->check(CLI::ExistingFile);
+    sliceCmd->add_option("-o,--out", sliceOut, "Output .rdb path")->required();
+    sliceCmd->add_option("--from", sliceFrom, "First __time__ to keep (default: the start)");
+    sliceCmd->add_option("--to",   sliceTo,   "Last __time__ to keep (default: the end)");
+
+    //  pack: a corpus of small traces, one schema and one string pool between
+    //  them, for `referee execute --corpus`.
+    auto*   packCmd = app.add_subcommand(
+        "pack",
+        "Pack .rdb traces of one schema into a .rdbx corpus for `referee execute --corpus`");
+    std::vector<std::string>    packSuccess;
+    std::vector<std::string>    packFailure;
+    std::string                 packSuite;
+    std::string                 packOut;
+    packCmd->add_option("rdb", packSuccess, "Traces expected to pass (.rdb)")
+        ->check(CLI::ExistingFile);
+    packCmd->add_option("--failure", packFailure,
+        "Traces expected to violate the specification (.rdb)")
+        ->check(CLI::ExistingFile);
+    packCmd->add_option("--suite", packSuite,
+        "Manifest of traces and what each is expected to do, as for `referee execute --suite`")
+        ->check(CLI::ExistingFile);
+    packCmd->add_option("-o,--out", packOut, "Output .rdbx path")->required();
+
+    //  serve: a trace fixed up once into shared memory, for every
+    //  `referee execute --attach` on the machine; unserve takes it down.
+    auto*   serveCmd = app.add_subcommand(
+        "serve",
+        "Load a .rdb into a named shared-memory segment for `referee execute --attach`");
+    std::string     serveIn;
+    std::string     serveName;
+    std::string     serveAddress;
+    serveCmd->add_option("rdb", serveIn, "Input .rdb path")
+        ->required()->check(CLI::ExistingFile);
+    serveCmd->add_option("name", serveName, "Segment name")->required();
+    serveCmd->add_option("--address", serveAddress,
+        "Page-aligned address every process maps the segment at (default: derived from the name)");
+    auto*   unserveCmd = app.add_subcommand(
+        "unserve",
+        "Remove a segment `rdb serve` created; processes attached to it keep their mapping");
+    std::string     unserveName;
+    unserveCmd->add_option("name", unserveName, "Segment name")->required();
+
+    //  frames: the same trace, framed for `referee monitor --binary`.
+    auto*   framesCmd = app.add_subcommand(
+        "frames",
+        "Encode a CSV/YAML trace as a binary state stream for `referee monitor --binary`");
+    std::string                 framesRef;
+    std::string                 framesData;
+    std::string                 framesOut;
+    std::vector<std::string>    framesIncludePaths;
+    framesCmd->add_option("ref", framesRef,
+        "REF source whose data declarations define the schema")
+        ->required()->check(CLI::ExistingFile);
+    framesCmd->add_option("data", framesData,
+        "Trace file (.csv / .yml / .yaml)")
+        ->required()->check(CLI::ExistingFile);
+    framesCmd->add_option("-o,--out", framesOut,
+        "Output path, `-` for standard output")->required();
+    framesCmd->add_option("-I,--include", framesIncludePaths,
+        "Directory to search for imported .ref files (repeatable)")
+        ->check(CLI::ExistingDirectory);
+
     //  merge: several sources, each sampling some of the signals at its own
     //  rate, folded into one complete-row trace and packed to .rdb.
     auto*   mergeCmd = app.add_subcommand(
@@ -89,11 +180,12 @@ int main(int argc, char* argv[])
     std::string                 mergeLeading = "trim";
     std::string                 mergeOverlap = "error";
     std::vector<std::string>    mergeIncludePaths;
+    bool                        mergeStream = false;
     mergeCmd->add_option("ref", mergeRef,
         "REF source whose data/conf declarations define the schema")
         ->required()->check(CLI::ExistingFile);
     mergeCmd->add_option("sources", mergeSources,
-        "Two or more trace files (.csv / .yml / .yaml), each sampling some signals")
+        "Two or more trace files (.csv / .yml / .yaml / .rdb), each sampling some signals")
         ->required()->expected(-1)->check(CLI::ExistingFile);
     mergeCmd->add_option("--conf", mergeConf,
         "Optional configuration file (.csv / .yml / .yaml)")
@@ -105,6 +197,9 @@ int main(int argc, char* argv[])
     mergeCmd->add_option("--overlap", mergeOverlap,
         "A column shared by two sources: error | merge")
         ->check(CLI::IsMember({"error", "merge"}));
+    mergeCmd->add_flag("--stream", mergeStream,
+        "Read each source once, in order, in bounded memory: sources must be time-sorted"
+        " and no signal split between them");
     mergeCmd->add_option("-I,--include", mergeIncludePaths,
         "Directory to search for imported .ref files (repeatable)")
         ->check(CLI::ExistingDirectory);
@@ -115,34 +210,100 @@ int main(int argc, char* argv[])
 
         if (buildCmd->parsed())
             referee::db::ingest(refFile, dataFile, confFile, outFile, includePaths);
+        else if (framesCmd->parsed())
+            referee::db::frames(framesRef, framesData, framesOut, framesIncludePaths);
         else if (dumpCmd->parsed())
             referee::db::dump(dumpFile, std::cout);
+        else if (compactCmd->parsed())
+            referee::db::compact(compactIn, compactOut,
+                                 compactCodec == "zstd"  ? referee::db::BlockCodec::Zstd
+                               : compactCodec == "plain" ? referee::db::BlockCodec::Plain
+                               :                           referee::db::BlockCodec::Packed,
+                                 compactBlock);
+        else if (sliceCmd->parsed())
+        {
+            std::ofstream   os(sliceOut, std::ios::binary);
+            if (!os)
+                throw std::runtime_error("slice: cannot write '" + sliceOut + "'");
+            referee::db::slice(sliceIn, os, sliceFrom, sliceTo);
+        }
+        else if (packCmd->parsed())
+        {
+            std::vector<referee::db::CorpusMember>  members;
+            if (!packSuite.empty())
+                for (auto const& t : Referee::readSuite(packSuite))
+                    members.push_back({t.path, t.expectFailure, t.violates});
+            for (auto const& p : packSuccess) members.push_back({p, false, {}});
+            for (auto const& p : packFailure) members.push_back({p, true, {}});
+            if (members.empty())
+                throw std::runtime_error("pack: give at least one trace");
+
+            //  A corpus holds packed traces only; the CSV is for `rdb build`.
+            for (auto const& m : members)
+                if (m.name.size() < 4 || m.name.substr(m.name.size() - 4) != ".rdb")
+                    throw std::runtime_error("pack: '" + m.name + "' is not a .rdb; `rdb build` it first");
+            referee::db::pack(members, packOut);
+        }
+        else if (serveCmd->parsed())
+        {
+            std::uintptr_t  address = 0;
+            if (!serveAddress.empty())
+            {
+                std::size_t used = 0;
+                try { address = std::stoull(serveAddress, &used, 0); } catch (std::exception const&) {}
+                if (address == 0 || used != serveAddress.size())
+                    throw std::runtime_error("serve: bad --address '" + serveAddress + "'");
+            }
+            referee::db::SharedTrace::serve(serveIn, serveName, address);
+        }
+        else if (unserveCmd->parsed())
+            referee::db::SharedTrace::remove(unserveName);
         else if (mergeCmd->parsed())
         {
             if (mergeSources.size() < 2)
                 throw std::runtime_error("merge: give at least two sources");
 
-            //  Each source becomes a `loader::Row` mergeTraces reads by name.
-            //  CSV/YAML open directly; a `.rdb` is already-packed binary, so it
-            //  is decoded back to a flat CSV in memory first and wrapped the
-            //  same way -- a `.rdb` stands in anywhere a CSV does.
+            auto    leading = mergeLeading == "zero"     ? referee::db::LeadingGap::Zero
+                            : mergeLeading == "backfill"  ? referee::db::LeadingGap::Backfill
+                            :                               referee::db::LeadingGap::Trim;
+            auto    overlap = mergeOverlap == "merge"     ? referee::db::Overlap::Merge
+                            :                               referee::db::Overlap::Error;
+
+            std::ifstream       ref(mergeRef);
+            if (!ref)
+                throw std::runtime_error("merge: cannot open '" + mergeRef + "'");
+
+            std::ifstream       conf;
+            if (!mergeConf.empty())
+            {
+                conf.open(mergeConf);
+                if (!conf)
+                    throw std::runtime_error("merge: cannot open '" + mergeConf + "'");
+            }
+
+            //  CSV/YAML sources open as documents. A `.rdb` is already packed,
+            //  so its typed blobs are merged as they are -- a `.rdb` stands in
+            //  anywhere a CSV does, without a round trip through text. Under
+            //  --stream each is instead opened by path and read as the merge
+            //  goes, so none is held whole (a YAML one aside).
             auto    isRdb = [](std::string const& p)
             {
                 return p.size() >= 4 && p.substr(p.size() - 4) == ".rdb";
             };
 
-            std::vector<std::unique_ptr<std::istream>>      streams;
-            std::vector<std::unique_ptr<loader::Row>>       owned;
-            std::vector<loader::Row*>                       docs;
+            std::vector<std::unique_ptr<std::istream>>          streams;
+            std::vector<std::unique_ptr<loader::Row>>           owned;
+            std::vector<std::unique_ptr<referee::db::Reader>>   readers;
+            std::vector<referee::db::MergeSource>               sources;
+            std::vector<referee::db::StreamSource>              streamed;
             for (auto const& path : mergeSources)
             {
-                if (isRdb(path))
+                if (mergeStream)
+                    streamed.emplace_back(path);
+                else if (isRdb(path))
                 {
-                    referee::db::Reader     rdb(path);
-                    auto    csv = std::make_unique<std::stringstream>();
-                    referee::db::toCsv(rdb, *csv);
-                    owned.push_back(loader::Row::open(*csv, path + ".csv"));
-                    streams.push_back(std::move(csv));
+                    readers.push_back(std::make_unique<referee::db::Reader>(path));
+                    sources.emplace_back(*readers.back());
                 }
                 else
                 {
@@ -151,42 +312,22 @@ int main(int argc, char* argv[])
                         throw std::runtime_error("merge: cannot open '" + path + "'");
                     owned.push_back(loader::Row::open(*in, path));
                     streams.push_back(std::move(in));
+                    sources.emplace_back(*owned.back());
                 }
-                docs.push_back(owned.back().get());
-            }
-
-            auto    leading = mergeLeading == "zero"     ? referee::db::LeadingGap::Zero
-                            : mergeLeading == "backfill"  ? referee::db::LeadingGap::Backfill
-                            :                               referee::db::LeadingGap::Trim;
-            auto    overlap = mergeOverlap == "merge"     ? referee::db::Overlap::Merge
-                            :                               referee::db::Overlap::Error;
-
-            auto    merged  = referee::db::mergeTraces(docs, leading, overlap);
-
-            //  The merged table is a CSV in memory; ingest turns it into the
-            //  .rdb, deriving the schema and column order from the .ref. It is
-            //  named `.csv` so the ingestor picks the CSV loader for it.
-            std::ifstream       ref(mergeRef);
-            if (!ref)
-                throw std::runtime_error("merge: cannot open '" + mergeRef + "'");
-
-            std::istringstream  data(merged);
-            std::ifstream       conf;
-            if (!mergeConf.empty())
-            {
-                conf.open(mergeConf);
-                if (!conf)
-                    throw std::runtime_error("merge: cannot open '" + mergeConf + "'");
             }
 
             std::ofstream       out(mergeOut, std::ios::binary);
             if (!out)
                 throw std::runtime_error("merge: cannot write '" + mergeOut + "'");
 
-            referee::db::ingest(ref,  mergeRef,
-                                data, "merged.csv",
-                                mergeConf.empty() ? nullptr : &conf, mergeConf,
-                                out,  mergeIncludePaths);
+            if (mergeStream)
+                referee::db::merge(ref, mergeRef, streamed,
+                                   mergeConf.empty() ? nullptr : &conf, mergeConf,
+                                   leading, overlap, out, mergeIncludePaths);
+            else
+                referee::db::merge(ref, mergeRef, sources,
+                                   mergeConf.empty() ? nullptr : &conf, mergeConf,
+                                   leading, overlap, out, mergeIncludePaths);
         }
     }
     catch (CLI::ParseError const& e)
@@ -24,12 +24,31 @@
 
 #include "merge.hpp"
 #include "database.hpp"
+#include "visitors/loader.hpp"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <limits>
 #include <map>
+#include <numeric>
+#include <optional>
+#include <queue>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 namespace referee::db
 {
@@ -52,6 +71,42 @@ std::int64_t    parseTime(std::string const& text, std::string const& where)
 
 } // namespace
 
+std::vector<std::string>    splitCells(std::string const& line)
+{
+    std::vector<std::string>    cells;
+    std::string                 cell;
+    bool                        quoted = false;
+
+    for (std::size_t i = 0; i < line.size(); i++)
+    {
+        char    c = line[i];
+        if (quoted)
+        {
+            if (c != '"')                                   cell += c;
+            else if (i + 1 < line.size() && line[i + 1] == '"') { cell += '"'; i++; }
+            else                                            quoted = false;
+        }
+        else if (c == '"')  quoted = true;
+        else if (c == ',')  { cells.push_back(std::move(cell)); cell.clear(); }
+        else                cell += c;
+    }
+    cells.push_back(std::move(cell));
+    return cells;
+}
+
+namespace
+{
+
+//  Whether `column` is one of `prop`'s flattened leaves: the signal itself, a
+//  member of it or an element.
+bool    leafOf(std::string const& column, std::string const& prop)
+{
+    return column.compare(0, prop.size(), prop) == 0
+        && (column.size() == prop.size() || column[prop.size()] == '.' || column[prop.size()] == '[');
+}
+
+} // namespace
+
 std::string     mergeTraces(std::vector<loader::Row*> const&   docs,
                             LeadingGap                          leading,
                             Overlap                             overlap)
@@ -169,4 +224,1010 @@ std::string     mergeTraces(std::vector<loader::Row*> const&   docs,
     return out.str();
 }
 
+//  ── Typed merge ──────────────────────────────────────────────────────────
+
+namespace
+{
+
+using Caps = std::map<std::string, std::vector<unsigned>>;
+
+//  A source as the typed merge reads it: forward, a row at a time, in time
+//  order.
+class RowCursor
+{
+public:
+    virtual ~RowCursor() = default;
+
+    //  To the next row -- the first, on the first call. False past the last.
+    virtual bool                            next() = 0;
+    virtual std::int64_t                    time() const = 0;
+
+    //  The current row's blob of `prop` in `Loader::load` form, empty for a
+    //  null slot. `at` is a `.rdb`'s own index of the signal.
+    virtual std::vector<std::uint8_t>       blob(PropDecl const& prop, std::size_t at,
+                                                 Caps const& caps) const = 0;
+
+    //  A `.rdb`'s own signals, which must have the specification's types;
+    //  null for text.
+    virtual std::vector<PropDecl> const*    typed() const { return nullptr; }
+
+    std::vector<std::string>    columns;        //  signal columns; a `.rdb`'s are those `toCsv` writes
+    bool                        timed = false;  //  it has a `__time__` column
+};
+
+//  A `MergeSource` held in memory, its rows visited in time order. The sort is
+//  stable, so of the rows at one time the last is the one held -- last write
+//  on a tie, as the text merge has it.
+class MemoryCursor final : public RowCursor
+{
+public:
+    MemoryCursor(MergeSource const& s, std::size_t si) : m_src(s)
+    {
+        columns = s.columns;
+        timed   = s.timed;
+
+        std::size_t rows = s.doc ? s.doc->rowCount()
+                         : s.rdb->numStates() >= 2 ? s.rdb->numStates() - 2 : 0;
+        m_time.resize(rows);
+        for (std::size_t r = 0; r < rows && timed; r++)
+            m_time[r] = s.doc ? parseTime(s.doc->cell("__time__", r),
+                                          "in source #" + std::to_string(si) + " row " + std::to_string(r))
+                              : s.rdb->time(r + 1);
+        m_order.resize(rows);
+        std::iota(m_order.begin(), m_order.end(), std::size_t{0});
+        std::stable_sort(m_order.begin(), m_order.end(),
+                         [this](std::size_t a, std::size_t b) { return m_time[a] < m_time[b]; });
+    }
+
+    std::vector<std::int64_t> const&    times() const { return m_time; }
+
+    bool            next() override         { return ++m_k < m_order.size(); }
+    std::int64_t    time() const override   { return m_time[m_order[m_k]]; }
+
+    std::vector<std::uint8_t>   blob(PropDecl const& prop, std::size_t at, Caps const& caps) const override
+    {
+        std::size_t r = m_order[m_k];
+        if (m_src.rdb)
+            return m_src.rdb->blob(r + 1, at);
+
+        std::vector<std::uint8_t>   buf;
+        Loader::load(buf, prop.name, prop.type,
+                     [&](std::string const& col) { return m_src.doc->cell(col, r); }, caps);
+        return buf;
+    }
+
+    std::vector<PropDecl> const*    typed() const override
+    {
+        return m_src.rdb ? &m_src.rdb->props() : nullptr;
+    }
+
+private:
+    MergeSource const&          m_src;
+    std::vector<std::int64_t>   m_time;
+    std::vector<std::size_t>    m_order;
+    std::size_t                 m_k = std::numeric_limits<std::size_t>::max();
+};
+
+//  The typed merge proper, over cursors whose rows each come in time order: a
+//  heap of the sources' current rows hands out every row in time order, the
+//  earlier source first on a tie, and each signal holds the blob of its own
+//  source's latest row. Only a row apiece and a blob per signal are held, so
+//  the cursors decide what the merge costs in memory.
+class RowMerge
+{
+public:
+    //  The text merge's own checks, on the same columns, in the same order.
+    RowMerge(std::vector<RowCursor*>        cursors,
+             std::vector<PropDecl> const&   props,
+             Caps const&                    caps,
+             LeadingGap                     leading,
+             Overlap                        overlap)
+        : m_cursors(std::move(cursors)), m_props(props), m_caps(caps), m_leading(leading)
+        , m_overlap(overlap), m_carried(m_cursors.size()), m_at(m_cursors.size())
+    {
+        std::set<std::string>   seen;
+        for (std::size_t si = 0; si < m_cursors.size(); si++)
+        {
+            for (auto const& col : m_cursors[si]->columns)
+                if (!seen.insert(col).second && overlap == Overlap::Error)
+                    throw std::runtime_error(
+                        "merge: column '" + col + "' appears in more than one source"
+                        " -- pass --overlap merge to combine them, or --overlap error"
+                        " (the default) if that is a mistake");
+            if (!m_cursors[si]->timed)
+                throw std::runtime_error(
+                    "merge: source #" + std::to_string(si) + " has no __time__ column");
+        }
+    }
+
+    //  Which sources carry each signal. It is merged whole, so it comes from
+    //  one source -- or, under Overlap::Merge, from several with the same
+    //  columns -- and a `.rdb` must hold it with the specification's type.
+    //  Returns why a signal cannot be, or nothing.
+    std::string     plan()
+    {
+        constexpr auto  npos = std::numeric_limits<std::size_t>::max();
+
+        m_carriers.assign(m_props.size(), {});
+        for (auto& at : m_at)
+            at.assign(m_props.size(), npos);
+
+        for (std::size_t pi = 0; pi < m_props.size(); pi++)
+        {
+            auto const&                 name = m_props[pi].name;
+            std::vector<std::string>    first;
+            for (std::size_t si = 0; si < m_cursors.size(); si++)
+            {
+                std::vector<std::string>    leaves;
+                for (auto const& col : m_cursors[si]->columns)
+                    if (leafOf(col, name))
+                        leaves.push_back(col);
+                if (leaves.empty())
+                    continue;
+
+                std::sort(leaves.begin(), leaves.end());
+                if (!m_carriers[pi].empty() && (m_overlap == Overlap::Error || leaves != first))
+                    return "'" + name + "' is split between sources";
+                first = std::move(leaves);
+
+                if (auto const* own = m_cursors[si]->typed())
+                {
+                    auto    it = std::find_if(own->begin(), own->end(),
+                                              [&](PropDecl const& p) { return p.name == name; });
+                    if (it == own->end() || !typesEqual(it->type, m_props[pi].type))
+                        return "source #" + std::to_string(si) + " holds '" + name
+                             + "' with another type";
+                    m_at[si][pi] = static_cast<std::size_t>(it - own->begin());
+                }
+                m_carriers[pi].push_back(si);
+                m_carried[si].push_back(pi);
+            }
+        }
+        return {};
+    }
+
+    //  Read every source's first row; the time of the first merged row to
+    //  come, which under Trim is the latest of the columns' first samples.
+    std::int64_t    start()
+    {
+        std::vector<std::int64_t>   first;
+        m_live.assign(m_cursors.size(), 0);
+        for (std::size_t si = 0; si < m_cursors.size(); si++)
+            if (m_cursors[si]->next())
+            {
+                m_heap.emplace(m_cursors[si]->time(), si);
+                first.push_back(m_cursors[si]->time());
+                m_live[si] = 1;
+            }
+        m_start = first.empty() ? 0 : *std::min_element(first.begin(), first.end());
+
+        if (m_leading == LeadingGap::Trim)
+        {
+            std::map<std::string, std::int64_t>     firstOf;
+            for (std::size_t si = 0; si < m_cursors.size(); si++)
+            {
+                if (!m_live[si])
+                    continue;
+                auto    t = m_cursors[si]->time();
+                for (auto const& col : m_cursors[si]->columns)
+                {
+                    auto [it, fresh] = firstOf.emplace(col, t);
+                    if (!fresh)
+                        it->second = std::min(it->second, t);
+                }
+            }
+            for (auto const& [_, t] : firstOf)
+                m_start = std::max(m_start, t);
+        }
+
+        //  What a signal no source has reported yet reads as: the blob an
+        //  empty cell loads to, or under Backfill its earliest sample, the
+        //  first source's on a tie.
+        m_row.assign(m_props.size(), {});
+        for (std::size_t pi = 0; pi < m_props.size(); pi++)
+        {
+            std::size_t from = m_cursors.size();
+            for (auto si : m_carriers[pi])
+                if (m_live[si] && (from == m_cursors.size() || m_cursors[si]->time() < m_cursors[from]->time()))
+                    from = si;
+            m_row[pi] = m_leading == LeadingGap::Backfill && from != m_cursors.size()
+                      ? load(from, pi) : empty(pi);
+        }
+        return m_start;
+    }
+
+    //  The next merged row, false after the last. `row` holds until the next
+    //  call.
+    bool    next(std::int64_t& t, blob_t const*& row)
+    {
+        while (!m_heap.empty())
+        {
+            t = m_heap.top().first;
+            while (!m_heap.empty() && m_heap.top().first == t)
+            {
+                auto    si = m_heap.top().second;
+                m_heap.pop();
+                for (auto pi : m_carried[si])
+                    m_row[pi] = load(si, pi);
+                if (m_cursors[si]->next())
+                {
+                    auto    u = m_cursors[si]->time();
+                    if (u < t)
+                        throw std::runtime_error(
+                            "merge: source #" + std::to_string(si) + " goes back in time (" + std::to_string(u)
+                            + " after " + std::to_string(t) + ") -- a streamed source is read once, in order;"
+                            " sort it, or merge without --stream");
+                    m_heap.emplace(u, si);
+                }
+            }
+            if (t < m_start)
+                continue;
+
+            row = &m_row;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    using Head = std::pair<std::int64_t, std::size_t>;      //  time, source
+
+    std::vector<std::uint8_t>   empty(std::size_t pi) const
+    {
+        std::vector<std::uint8_t>   buf;
+        Loader::load(buf, m_props[pi].name, m_props[pi].type,
+                     [](std::string const&) { return std::string(); }, m_caps);
+        return buf;
+    }
+
+    std::vector<std::uint8_t>   load(std::size_t si, std::size_t pi) const
+    {
+        auto    buf = m_cursors[si]->blob(m_props[pi], m_at[si][pi], m_caps);
+        return buf.empty() ? empty(pi) : buf;
+    }
+
+    std::vector<RowCursor*>                 m_cursors;
+    std::vector<PropDecl> const&            m_props;
+    Caps const&                             m_caps;
+    LeadingGap                              m_leading;
+    Overlap                                 m_overlap;
+    std::vector<std::vector<std::size_t>>   m_carriers;     //  per signal, the sources carrying it
+    std::vector<std::vector<std::size_t>>   m_carried;      //  per source, the signals it carries
+    std::vector<std::vector<std::size_t>>   m_at;           //  per source, a `.rdb`'s index of each signal
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>>    m_heap;
+    std::vector<char>                       m_live;         //  per source, whether it has a row at all
+    std::int64_t                            m_start = 0;
+    blob_t                                  m_row;
+};
+
+//  The sentinel rows every packed trace is bracketed by.
+blob_t  zeroRow(std::vector<PropDecl> const& props)
+{
+    blob_t  zero(props.size());
+    for (std::size_t pi = 0; pi < props.size(); pi++)
+        zero[pi].assign(props[pi].type->size(), 0);
+    return zero;
+}
+
+constexpr auto  kMinTime = std::numeric_limits<std::int64_t>::min();
+constexpr auto  kMaxTime = std::numeric_limits<std::int64_t>::max();
+
+} // namespace
+
+MergeSource::MergeSource(loader::Row& d) : doc(&d)
+{
+    for (auto const& col : d.columnNames())
+    {
+        if (col == "__time__")  timed = true;
+        else                    columns.push_back(col);
+    }
+}
+
+MergeSource::MergeSource(Reader const& r) : rdb(&r), columns(csvColumns(r)), timed(true)
+{
+}
+
+bool    mergeToRdb(std::vector<MergeSource> const&                      sources,
+                   std::vector<PropDecl> const&                         props,
+                   std::vector<ConfDecl> const&                         confs,
+                   std::vector<std::uint8_t>                            confBlob,
+                   std::map<std::string, std::vector<unsigned>> const&  caps,
+                   LeadingGap                                           leading,
+                   Overlap                                              overlap,
+                   std::ostream&                                        out)
+{
+    std::vector<std::unique_ptr<MemoryCursor>>  owned;
+    std::vector<RowCursor*>                     cursors;
+    for (std::size_t si = 0; si < sources.size(); si++)
+    {
+        owned.push_back(std::make_unique<MemoryCursor>(sources[si], si));
+        cursors.push_back(owned.back().get());
+    }
+
+    RowMerge    merge(cursors, props, caps, leading, overlap);
+    if (!merge.plan().empty())
+        return false;
+    auto        start = merge.start();
+
+    //  The union of the timestamps from the start on: the rows to come, which
+    //  the writer wants counted up front.
+    std::vector<std::int64_t>   times;
+    for (auto const& c : owned)
+        times.insert(times.end(), c->times().begin(), c->times().end());
+    std::sort(times.begin(), times.end());
+    times.erase(std::unique(times.begin(), times.end()), times.end());
+    times.erase(times.begin(), std::lower_bound(times.begin(), times.end(), start));
+
+    std::int64_t    firstT = times.empty() ? 0 : times.front();
+    std::int64_t    lastT  = times.empty() ? 0 : times.back();
+    auto            zero   = zeroRow(props);
+
+    Writer  w(out);
+    w.setSchema(props, confs);
+    w.setNumStates(times.size() + 2);
+    w.setConfBlob(std::move(confBlob));
+    w.writeState(0, firstT > kMinTime ? firstT - 1 : kMinTime, zero);
+
+    std::size_t     state = 1;
+    std::int64_t    t     = 0;
+    blob_t const*   row   = nullptr;
+    while (merge.next(t, row))
+        w.writeState(state++, t, *row);
+    w.writeState(state, lastT < kMaxTime ? lastT + 1 : kMaxTime, zero);
+    w.finish();
+    return true;
+}
+
+//  ── Streaming merge ──────────────────────────────────────────────────────
+
+namespace
+{
+
+//  A CSV read a record at a time. A quoted cell may run over a line break, so
+//  a record is as many lines as it takes to close its quotes; blank lines
+//  between records are skipped.
+class CsvCursor final : public RowCursor
+{
+public:
+    explicit CsvCursor(std::string const& path) : m_in(path), m_path(path)
+    {
+        if (!m_in)
+            throw std::runtime_error("merge: cannot open '" + path + "'");
+
+        std::vector<std::string>    header;
+        record(header);
+        for (std::size_t i = 0; i < header.size(); i++)
+        {
+            if (header[i] == "__time__") { timed = true; m_timeAt = i; }
+            else                         columns.push_back(header[i]);
+            m_index.emplace(header[i], i);
+        }
+    }
+
+    bool    next() override
+    {
+        if (!record(m_cells))
+            return false;
+        m_time = parseTime(cell(m_timeAt), "in '" + m_path + "' row " + std::to_string(m_row++));
+        return true;
+    }
+
+    std::int64_t    time() const override { return m_time; }
+
+    std::vector<std::uint8_t>   blob(PropDecl const& prop, std::size_t, Caps const& caps) const override
+    {
+        std::vector<std::uint8_t>   buf;
+        Loader::load(buf, prop.name, prop.type,
+                     [&](std::string const& col)
+                     {
+                         auto it = m_index.find(col);
+                         return it == m_index.end() ? std::string() : cell(it->second);
+                     }, caps);
+        return buf;
+    }
+
+private:
+    std::string cell(std::size_t i) const
+    {
+        return i < m_cells.size() ? m_cells[i] : std::string();
+    }
+
+    bool    record(std::vector<std::string>& cells)
+    {
+        std::string text;
+        std::string line;
+        while (std::getline(m_in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (text.empty() && line.empty())
+                continue;
+
+            //  Quotes pair up, an escaped one included, so an odd count means
+            //  a cell is still open.
+            text += line;
+            if (std::count(text.begin(), text.end(), '"') % 2 == 0)
+            {
+                cells = splitCells(text);
+                return true;
+            }
+            text += '\n';
+        }
+        if (!text.empty())
+            throw std::runtime_error("merge: unterminated quote at the end of '" + m_path + "'");
+        return false;
+    }
+
+    std::ifstream                                   m_in;
+    std::string                                     m_path;
+    std::unordered_map<std::string, std::size_t>    m_index;
+    std::size_t                                     m_timeAt = 0;
+    std::vector<std::string>                        m_cells;
+    std::int64_t                                    m_time   = 0;
+    std::size_t                                     m_row    = 0;
+};
+
+//  A `.rdb` read through its mapping; the real rows sit between the sentinels.
+class ScanCursor final : public RowCursor
+{
+public:
+    explicit ScanCursor(std::string const& path) : m_scan(path)
+    {
+        columns = m_scan.columns();
+        timed   = true;
+    }
+
+    bool            next() override         { return ++m_k + 1 < m_scan.numStates(); }
+    std::int64_t    time() const override   { return m_scan.time(m_k); }
+
+    std::vector<std::uint8_t>   blob(PropDecl const&, std::size_t at, Caps const&) const override
+    {
+        return m_scan.blob(m_k, at);
+    }
+
+    std::vector<PropDecl> const*    typed() const override { return &m_scan.props(); }
+
+private:
+    Scanner         m_scan;
+    std::size_t     m_k = 0;
+};
+
+} // namespace
+
+struct StreamSource::Impl
+{
+    //  A YAML source: the document, loaded whole, and its cursor's view of it.
+    std::ifstream                   in;
+    std::unique_ptr<loader::Row>    doc;
+    std::unique_ptr<MergeSource>    source;
+
+    std::unique_ptr<RowCursor>      cursor;
+};
+
+StreamSource::StreamSource(std::string const& path) : m_impl(std::make_unique<Impl>())
+{
+    auto    ext = path.substr(std::min(path.size(), path.rfind('.') + 1));
+    if (ext == "rdb")
+        m_impl->cursor = std::make_unique<ScanCursor>(path);
+    else if (ext == "csv")
+        m_impl->cursor = std::make_unique<CsvCursor>(path);
+    else
+    {
+        m_impl->in.open(path);
+        if (!m_impl->in)
+            throw std::runtime_error("merge: cannot open '" + path + "'");
+        m_impl->doc    = loader::Row::open(m_impl->in, path);
+        m_impl->source = std::make_unique<MergeSource>(*m_impl->doc);
+        m_impl->cursor = std::make_unique<MemoryCursor>(*m_impl->source, 0);
+    }
+}
+
+StreamSource::StreamSource(StreamSource&&) noexcept = default;
+StreamSource::~StreamSource() = default;
+
+std::vector<std::string> const&     StreamSource::columns() const
+{
+    return m_impl->cursor->columns;
+}
+
+void    mergeStreaming(std::vector<StreamSource> const&                     sources,
+                       std::vector<PropDecl> const&                         props,
+                       std::vector<ConfDecl> const&                         confs,
+                       std::vector<std::uint8_t>                            confBlob,
+                       std::map<std::string, std::vector<unsigned>> const&  caps,
+                       LeadingGap                                           leading,
+                       Overlap                                              overlap,
+                       std::ostream&                                        out)
+{
+    std::vector<RowCursor*>     cursors;
+    for (auto const& s : sources)
+        cursors.push_back(s.m_impl->cursor.get());
+
+    RowMerge    merge(cursors, props, caps, leading, overlap);
+    if (auto why = merge.plan(); !why.empty())
+        throw std::runtime_error("merge: --stream takes each signal whole from one source, but "
+                                 + why + " -- merge without --stream");
+    merge.start();
+
+    //  The row count is not known until the sources run out, so the rows are
+    //  appended -- the leading sentinel once the first row's time is known.
+    auto    zero = zeroRow(props);
+    Writer  w(out);
+    w.setSchema(props, confs);
+    w.setConfBlob(std::move(confBlob));
+
+    bool            any   = false;
+    std::int64_t    t     = 0;
+    std::int64_t    lastT = 0;
+    blob_t const*   row   = nullptr;
+    while (merge.next(t, row))
+    {
+        if (!any)
+            w.appendState(t > kMinTime ? t - 1 : kMinTime, zero);
+        any   = true;
+        lastT = t;
+        w.appendState(t, *row);
+    }
+    if (!any)
+        w.appendState(-1, zero);
+    w.appendState(lastT < kMaxTime ? lastT + 1 : kMaxTime, zero);
+    w.finish();
+}
+
+//  ── Live merge ───────────────────────────────────────────────────────────
+
+struct LiveMerge::Impl
+{
+    struct Source
+    {
+        bool                        header  = false;    //  its header is in (or it ended without one)
+        bool                        open    = true;
+        bool                        seen    = false;    //  it has sent a row
+        std::int64_t                latest  = 0;        //  the latest __time__ it has sent
+        std::size_t                 rows    = 0;
+        std::size_t                 timeAt  = 0;        //  the __time__ cell
+        std::vector<std::size_t>    column;             //  cell -> merged column (npos: __time__)
+    };
+
+    //  One sample waiting to be merged: its source breaks a tie, as the
+    //  stable sort does offline -- the later source wins.
+    struct Update
+    {
+        std::size_t     source;
+        std::size_t     column;
+        std::string     value;
+    };
+
+    LeadingGap                                      leading;
+    Overlap                                         overlap;
+    std::size_t                                     reorder;
+    std::int64_t                                    jitter;
+
+    std::vector<Source>                             sources;
+    std::vector<std::string>                        columns;
+    std::map<std::string, std::size_t>              columnAt;
+
+    std::map<std::int64_t, std::vector<Update>>     pending;    //  the reorder buffer
+    std::vector<std::optional<std::string>>         held;       //  each column's value so far
+    std::deque<std::string>                         out;
+    bool                                            headerOut = false;
+    bool                                            merged    = false;
+    std::int64_t                                    mergedTo  = 0;
+    std::size_t                                     late      = 0;
+
+    void    header(std::size_t si, std::string const& line)
+    {
+        auto&   src   = sources[si];
+        bool    hasTime = false;
+        for (auto const& col : splitCells(line))
+        {
+            if (col == "__time__")
+            {
+                src.timeAt = src.column.size();
+                src.column.push_back(std::string::npos);
+                hasTime    = true;
+                continue;
+            }
+
+            auto    it = columnAt.find(col);
+            if (it == columnAt.end())
+            {
+                it = columnAt.emplace(col, columns.size()).first;
+                columns.push_back(col);
+                held.emplace_back();
+            }
+            else if (overlap == Overlap::Error)
+                throw std::runtime_error(
+                    "merge: column '" + col + "' appears in more than one source"
+                    " -- pass --overlap merge to combine them, or --overlap error"
+                    " (the default) if that is a mistake");
+            src.column.push_back(it->second);
+        }
+
+        if (!hasTime)
+            throw std::runtime_error(
+                "merge: source #" + std::to_string(si) + " has no __time__ column");
+        src.header = true;
+    }
+
+    void    row(std::size_t si, std::string const& line)
+    {
+        auto&   src   = sources[si];
+        auto    cells = splitCells(line);
+        auto    t     = parseTime(src.timeAt < cells.size() ? cells[src.timeAt] : "",
+                                  "in source #" + std::to_string(si) + " row " + std::to_string(src.rows));
+        src.rows++;
+        src.latest = src.seen ? std::max(src.latest, t) : t;
+        src.seen   = true;
+
+        //  Too late to merge at its own time: everything merged from here on
+        //  is later than it, so holding it from now is what the offline merge
+        //  would have held at those rows -- unless a newer sample of the same
+        //  column is still waiting, which then overrides it in turn.
+        bool    isLate = merged && t <= mergedTo;
+        if (isLate)
+            late++;
+
+        for (std::size_t c = 0; c < src.column.size(); c++)
+        {
+            if (src.column[c] == std::string::npos)     continue;
+            auto    value = c < cells.size() ? cells[c] : std::string();
+            if (isLate)     held[src.column[c]] = std::move(value);
+            else            pending[t].push_back({si, src.column[c], std::move(value)});
+        }
+    }
+
+    //  Merge what every open source has reported past, and the oldest rows
+    //  beyond the reorder bound.
+    void    advance()
+    {
+        for (auto const& src : sources)
+            if (!src.header)    return;
+
+        if (!headerOut)
+        {
+            std::string     line = "__time__";
+            for (auto const& col : columns)
+                line += "," + col;
+            out.push_back(std::move(line));
+            headerOut = true;
+        }
+
+        std::optional<std::int64_t>     watermark = std::numeric_limits<std::int64_t>::max();
+        for (auto const& src : sources)
+        {
+            if (!src.open)      continue;
+            if (!src.seen)      { watermark.reset(); break; }
+            watermark = std::min(*watermark, src.latest - jitter);
+        }
+
+        while (!pending.empty()
+            && ((watermark && pending.begin()->first <= *watermark) || pending.size() > reorder))
+            mergeOldest();
+    }
+
+    void    mergeOldest()
+    {
+        auto    it = pending.begin();
+        auto&   ev = it->second;
+        std::stable_sort(ev.begin(), ev.end(),
+                         [](Update const& a, Update const& b) { return a.source < b.source; });
+        for (auto& u : ev)
+            held[u.column] = std::move(u.value);
+        merged   = true;
+        mergedTo = it->first;
+
+        bool    complete = std::all_of(held.begin(), held.end(),
+                                       [](auto const& v) { return v.has_value(); });
+        if (leading == LeadingGap::Zero || complete)
+        {
+            std::string     line = std::to_string(it->first);
+            for (auto const& v : held)
+                line += v ? "," + csvQuote(*v) : ",";       //  zero: REF reads the empty cell as 0
+            out.push_back(std::move(line));
+        }
+        pending.erase(it);
+    }
+};
+
+LiveMerge::LiveMerge(std::size_t   sources,
+                     LeadingGap    leading,
+                     Overlap       overlap,
+                     std::size_t   reorder,
+                     std::int64_t  jitter)
+: m_impl(std::make_unique<Impl>())
+{
+    if (leading == LeadingGap::Backfill)
+        throw std::runtime_error(
+            "merge: --leading backfill needs each signal's earliest value before the first row;"
+            " a live merge can trim or zero");
+
+    m_impl->leading = leading;
+    m_impl->overlap = overlap;
+    m_impl->reorder = reorder;
+    m_impl->jitter  = jitter;
+    m_impl->sources.resize(sources);
+}
+
+LiveMerge::~LiveMerge() = default;
+
+void    LiveMerge::push(std::size_t source, std::string const& text)
+{
+    auto    line = text;
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+    if (line.empty())
+        return;
+
+    if (!m_impl->sources[source].header)
+        m_impl->header(source, line);
+    else
+        m_impl->row(source, line);
+    m_impl->advance();
+}
+
+void    LiveMerge::close(std::size_t source)
+{
+    auto&   src  = m_impl->sources[source];
+    src.open     = false;
+    src.header   = true;
+    m_impl->advance();
+}
+
+bool    LiveMerge::pop(std::string& line)
+{
+    if (m_impl->out.empty())
+        return false;
+    line = std::move(m_impl->out.front());
+    m_impl->out.pop_front();
+    return true;
+}
+
+std::size_t     LiveMerge::late() const
+{
+    return m_impl->late;
+}
+
+//  ── Live sources ─────────────────────────────────────────────────────────
+
+namespace
+{
+
+//  A live source by path, for reading: a Unix socket is connected to, anything
+//  else opened, a FIFO blocking until its writer has opened it too. -1 with
+//  `why` set on failure; `regular` says whether it is a plain file.
+int     openSource(std::string const& path, bool& regular, std::string& why)
+{
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0)
+        return why = std::strerror(errno), -1;
+
+    regular = S_ISREG(st.st_mode);
+    if (!S_ISSOCK(st.st_mode))
+    {
+        int     fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            why = std::strerror(errno);
+        return fd;
+    }
+
+    sockaddr_un     addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        return why = "socket path too long", -1;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int     fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+        return fd;
+    why = std::strerror(errno);
+    if (fd >= 0)    ::close(fd);
+    return -1;
+}
+
+} // namespace
+
+struct SourceMerge::Impl
+{
+    struct Input
+    {
+        std::string     path;
+        int             fd      = -1;
+        bool            regular = false;
+        bool            open    = true;
+        std::string     partial;                //  bytes past the last newline
+    };
+
+    LiveMerge               merge;
+    std::vector<Input>      inputs;
+    bool                    follow;
+    std::string             line;               //  the line being handed out
+
+    Impl(std::size_t n, LeadingGap leading, Overlap overlap, std::size_t reorder,
+         std::int64_t jitter, bool follow)
+    : merge(n, leading, overlap, reorder, jitter), inputs(n), follow(follow)
+    {}
+
+    ~Impl()
+    {
+        for (auto& in : inputs)
+            if (in.fd >= 0)     ::close(in.fd);
+    }
+
+    void    open(Input& in)
+    {
+        std::string     why;
+        in.fd = openSource(in.path, in.regular, why);
+        if (in.fd < 0)
+            throw std::runtime_error("merge: cannot open source '" + in.path + "': " + why);
+    }
+
+    //  One read from source `si`, its whole lines pushed to the merge. False
+    //  if it had nothing: a followed file at its current end.
+    bool    read(std::size_t si)
+    {
+        auto&   in = inputs[si];
+        char    buf[65536];
+        ssize_t n;
+        do  n = ::read(in.fd, buf, sizeof(buf));
+        while (n < 0 && errno == EINTR);
+
+        if (n < 0)
+            throw std::runtime_error("merge: reading source '" + in.path + "': " + std::strerror(errno));
+        if (n == 0)
+        {
+            if (in.regular && follow)
+                return false;
+            if (!in.partial.empty())
+                merge.push(si, in.partial);
+            ::close(in.fd);
+            in.fd   = -1;
+            in.open = false;
+            merge.close(si);
+            return true;
+        }
+
+        in.partial.append(buf, static_cast<std::size_t>(n));
+        std::size_t     from = 0;
+        for (auto nl = in.partial.find('\n'); nl != std::string::npos; nl = in.partial.find('\n', from))
+        {
+            merge.push(si, in.partial.substr(from, nl - from));
+            from = nl + 1;
+        }
+        in.partial.erase(0, from);
+        return true;
+    }
+
+    //  Read what is there: a chunk of each file, then whatever the pipes and
+    //  sockets have, waiting for them only when the files had nothing. False
+    //  once every source has ended.
+    bool    pump()
+    {
+        bool    any = false;
+        bool    got = false;
+        for (std::size_t si = 0; si < inputs.size(); si++)
+        {
+            if (!inputs[si].open)       continue;
+            any = true;
+            if (inputs[si].regular)     got = read(si) || got;
+        }
+        if (!any)
+            return false;
+
+        std::vector<pollfd>         fds;
+        std::vector<std::size_t>    at;
+        for (std::size_t si = 0; si < inputs.size(); si++)
+            if (inputs[si].open && !inputs[si].regular)
+            {
+                fds.push_back({inputs[si].fd, POLLIN, 0});
+                at.push_back(si);
+            }
+
+        //  A followed file cannot be polled for growth -- it always reads as
+        //  ready -- so the wait is a short sleep, not a block. The pipes get
+        //  the same slices, so an interrupt is seen between them.
+        int     timeout  = got ? 0 : 50;
+        if (fds.empty() && timeout == 0)
+            return true;
+
+        int     ready;
+        do  ready = ::poll(fds.data(), fds.size(), timeout);
+        while (ready < 0 && errno == EINTR);
+        if (ready < 0)
+            throw std::runtime_error(std::string("merge: poll: ") + std::strerror(errno));
+
+        for (std::size_t k = 0; k < fds.size(); k++)
+            if (fds[k].revents & (POLLIN | POLLHUP | POLLERR))
+                read(at[k]);
+        return true;
+    }
+};
+
+LiveInput::LiveInput(int fd)
+: m_fd(fd), m_owned(false), m_buf(65536)
+{}
+
+LiveInput::LiveInput(std::string const& path)
+: m_owned(true), m_buf(65536)
+{
+    bool            regular = false;
+    std::string     why;
+    m_fd = openSource(path, regular, why);
+    if (m_fd < 0)
+        throw std::runtime_error("cannot open '" + path + "': " + why);
+}
+
+LiveInput::~LiveInput()
+{
+    if (m_owned)    ::close(m_fd);
+}
+
+LiveInput::int_type     LiveInput::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    //  Wait in slices, looking for an interrupt between them; a file is
+    //  always ready, so it is read straight through.
+    for (;;)
+    {
+        if (interrupted())
+            return traits_type::eof();
+        pollfd  fd{m_fd, POLLIN, 0};
+        int     ready = ::poll(&fd, 1, 50);
+        if (ready < 0 && errno != EINTR)
+            throw std::runtime_error(std::string("poll: ") + std::strerror(errno));
+        if (ready > 0)
+            break;
+    }
+
+    ssize_t n;
+    do  n = ::read(m_fd, m_buf.data(), m_buf.size());
+    while (n < 0 && errno == EINTR);
+    if (n < 0)
+        throw std::runtime_error(std::string("read: ") + std::strerror(errno));
+    if (n == 0)
+        return traits_type::eof();
+    setg(m_buf.data(), m_buf.data(), m_buf.data() + n);
+    return traits_type::to_int_type(*gptr());
+}
+
+SourceMerge::SourceMerge(std::vector<std::string> const& paths,
+                         LeadingGap                      leading,
+                         Overlap                         overlap,
+                         std::size_t                     reorder,
+                         std::int64_t                    jitter,
+                         bool                            follow)
+: m_impl(std::make_unique<Impl>(paths.size(), leading, overlap, reorder, jitter, follow))
+{
+    for (std::size_t si = 0; si < paths.size(); si++)
+    {
+        m_impl->inputs[si].path = paths[si];
+        m_impl->open(m_impl->inputs[si]);
+    }
+}
+
+SourceMerge::~SourceMerge() = default;
+
+std::size_t     SourceMerge::late() const
+{
+    return m_impl->merge.late();
+}
+
+SourceMerge::int_type   SourceMerge::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    std::string     line;
+    while (!m_impl->merge.pop(line))
+        if (interrupted() || !m_impl->pump())
+            return traits_type::eof();
+
+    m_impl->line = std::move(line) + "\n";
+    auto*   p    = m_impl->line.data();
+    setg(p, p, p + m_impl->line.size());
+    return traits_type::to_int_type(*gptr());
+}
+
 } // namespace referee::db
@@ -24,8 +24,16 @@
 
 #pragma once
 
+#include "database.hpp"
 #include "loaders/row.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -53,6 +61,10 @@ enum class Overlap
     Merge,      //  union the two sources' samples of the one signal
 };
 
+//  One CSV line's cells, unquoted. A live source is read a line at a time, so
+//  a quoted cell may hold commas and quotes but not a line break.
+std::vector<std::string>    splitCells(std::string const& line);
+
 //  Merge `docs` into a single CSV document -- `__time__` plus every signal
 //  column, one complete row per distinct timestamp. Returns the CSV text,
 //  which `ingest` turns into a `.rdb`; kept separate from packing so the merge
@@ -61,4 +73,191 @@ std::string     mergeTraces(std::vector<loader::Row*> const&   docs,
                             LeadingGap                          leading,
                             Overlap                             overlap);
 
+//  A source of `mergeToRdb`: a trace document, or an opened `.rdb` whose typed
+//  blobs are taken as they are.
+struct MergeSource
+{
+    explicit MergeSource(loader::Row& doc);
+    explicit MergeSource(Reader const& rdb);
+
+    loader::Row*                doc = nullptr;
+    Reader const*               rdb = nullptr;
+    std::vector<std::string>    columns;        //  signal columns; a `.rdb`'s are those `toCsv` writes
+    bool                        timed = false;  //  it has a `__time__` column
+};
+
+//  `mergeTraces` packed straight into a `.rdb` on `out`, signal by signal
+//  rather than through a merged CSV: the sources' rows are merged by time
+//  through a heap, each signal holds its latest source row, and a row's blobs
+//  are read from there -- `Loader::load` on a document's cells, a copy of a
+//  `.rdb`'s own blob -- and written by `Writer`. `props`/`confs` are the
+//  specification's, `caps` the array capacities `inferSizes` reads off every
+//  source's columns together. The result is the `.rdb` the text merge packs.
+//
+//  A signal is taken whole from one source, so where the text merge would
+//  assemble one from columns of several -- a signal split between sources, or
+//  shared under `Overlap::Merge` with different columns -- or a `.rdb` holds
+//  it with another type than `props`, this writes nothing and returns false,
+//  and the caller merges through text.
+bool            mergeToRdb(std::vector<MergeSource> const&                      sources,
+                           std::vector<PropDecl> const&                         props,
+                           std::vector<ConfDecl> const&                         confs,
+                           std::vector<std::uint8_t>                            confBlob,
+                           std::map<std::string, std::vector<unsigned>> const&  caps,
+                           LeadingGap                                           leading,
+                           Overlap                                              overlap,
+                           std::ostream&                                        out);
+
+//  A source of `mergeStreaming`, opened by path and read once, front to back:
+//  a CSV a record at a time, a `.rdb` through a `Scanner`. YAML has no
+//  record-at-a-time reader, so a YAML source is loaded whole.
+class StreamSource
+{
+public:
+    explicit StreamSource(std::string const& path);
+    StreamSource(StreamSource&&) noexcept;
+    ~StreamSource();
+
+    //  Signal columns, as `MergeSource::columns`.
+    std::vector<std::string> const&     columns() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl>   m_impl;
+
+    friend void     mergeStreaming(std::vector<StreamSource> const&,
+                                   std::vector<PropDecl> const&,
+                                   std::vector<ConfDecl> const&,
+                                   std::vector<std::uint8_t>,
+                                   std::map<std::string, std::vector<unsigned>> const&,
+                                   LeadingGap, Overlap, std::ostream&);
+};
+
+//  `mergeToRdb` for sources larger than memory (`rdb merge --stream`). Each
+//  source is read once, in order, and merged rows go out through
+//  `Writer::appendState`, so what is held is a row per source and a blob per
+//  signal. In exchange each source must already be in time order, and a signal
+//  the typed merge would hand back to the text merge is an error here.
+void            mergeStreaming(std::vector<StreamSource> const&                     sources,
+                               std::vector<PropDecl> const&                         props,
+                               std::vector<ConfDecl> const&                         confs,
+                               std::vector<std::uint8_t>                            confBlob,
+                               std::map<std::string, std::vector<unsigned>> const&  caps,
+                               LeadingGap                                           leading,
+                               Overlap                                              overlap,
+                               std::ostream&                                        out);
+
+//  `mergeTraces` for sources that are still being written. Each source's lines
+//  -- its CSV header, then its rows -- are pushed as they arrive, and a merged
+//  row comes out once every source still open has reported at or past its
+//  timestamp, so no later sample can land before it. The hold is the same:
+//  the union of the timestamps, every signal its own source's most recent value.
+//
+//  Sources reach the merge at different latencies; the rows held waiting for
+//  the slowest are the reorder buffer. Past `reorder` of them the oldest is
+//  merged anyway, the lagging sources holding their last values, and `jitter`
+//  delays every merge by that much `__time__` so a source's own rows may
+//  arrive that far out of order. A sample that comes after its timestamp was
+//  merged is late: it is held from the next merged row on, and counted.
+class LiveMerge
+{
+public:
+    /// `leading` is `Trim` or `Zero`; `Backfill` needs the whole trace.
+    LiveMerge(std::size_t   sources,
+              LeadingGap    leading,
+              Overlap       overlap,
+              std::size_t   reorder = 1000,
+              std::int64_t  jitter  = 0);
+    ~LiveMerge();
+
+    LiveMerge(LiveMerge const&)            = delete;
+    LiveMerge& operator=(LiveMerge const&) = delete;
+
+    /// One line of `source`: its header first, then its rows.
+    void            push(std::size_t source, std::string const& line);
+
+    /// `source` has ended; it no longer holds the merge back.
+    void            close(std::size_t source);
+
+    /// The next merged line -- the header once every source has sent its
+    /// own, then rows -- without its newline. False if none is ready yet.
+    bool            pop(std::string& line);
+
+    /// Samples that arrived after their timestamp was merged.
+    std::size_t     late() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl>   m_impl;
+};
+
+//  A stream over live inputs whose blocked read another thread can give up.
+//  After `interrupt()` the read under way, and every one after it, ends as at
+//  end of input -- so a reader thread blocked on a quiet FIFO can be joined.
+class LiveBuf : public std::streambuf
+{
+public:
+    /// End the read under way, and every later one, as at end of input.
+    void            interrupt()         { m_stop.store(true, std::memory_order_relaxed); }
+
+protected:
+    bool            interrupted() const { return m_stop.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool>   m_stop{false};
+};
+
+//  One live input -- stdin, a FIFO, a Unix socket (connected to), a file --
+//  read as a stream that can be interrupted. `referee monitor` reads its states through it.
+class LiveInput : public LiveBuf
+{
+public:
+    /// Read `fd`, which stays the caller's to close.
+    explicit LiveInput(int fd);
+
+    /// Open `path` and read it, connecting to it if it is a Unix socket.
+    explicit LiveInput(std::string const& path);
+    ~LiveInput() override;
+
+    LiveInput(LiveInput const&)            = delete;
+    LiveInput& operator=(LiveInput const&) = delete;
+
+protected:
+    int_type        underflow() override;
+
+private:
+    int                 m_fd;
+    bool                m_owned;
+    std::vector<char>   m_buf;
+};
+
+//  A `LiveMerge` over live paths, read as one CSV stream: a FIFO, a Unix
+//  socket (connected to) or a file. `referee monitor --source` reads it as
+//  it would stdin. A file ends at its end unless `follow`, when it is read
+//  as it grows and never ends; a FIFO or a socket ends when its writer
+//  closes it. The stream ends when every source has.
+class SourceMerge : public LiveBuf
+{
+public:
+    SourceMerge(std::vector<std::string> const& paths,
+                LeadingGap                      leading,
+                Overlap                         overlap,
+                std::size_t                     reorder = 1000,
+                std::int64_t                    jitter  = 0,
+                bool                            follow  = false);
+    ~SourceMerge() override;
+
+    SourceMerge(SourceMerge const&)            = delete;
+    SourceMerge& operator=(SourceMerge const&) = delete;
+
+    std::size_t     late() const;
+
+protected:
+    int_type        underflow() override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl>   m_impl;
+};
+
 } // namespace referee::db
@@ -37,11 +37,14 @@
 
 #include "rdb/database.hpp"
 #include "rdb/ingest.hpp"
+#include "runtime/columns.hpp"
+#include "runtime/scan.hpp"
 #include "module.hpp"
 #include "strings.hpp"
 
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <memory>
@@ -64,8 +67,10 @@ int     main(int argc, char** argv)
     }
 
     //  Traces are positional; `--conf FILE` supplies a configuration for the
-    //  CSV/YAML paths (a `.rdb` carries its own). Collected up front so the
-    //  order of flags and traces does not matter.
+    //  CSV/YAML paths (a `.rdb` carries its own), `--spill DIR` sends
+    //  trace-length buffers to files there, and `--threads N` splits each
+    //  trace across N workers. Collected up front so the order of flags and
+    //  traces does not matter.
     bool                        wantHelp = false;
     std::string                 confPath;
     std::vector<std::string>    tracePaths;
@@ -74,6 +79,10 @@ int     main(int argc, char** argv)
         std::string arg = argv[a];
         if (arg == "--help" || arg == "-h")     wantHelp = true;
         else if (arg == "--conf" && a + 1 < argc) confPath = argv[++a];
+        else if (arg == "--spill" && a + 1 < argc)
+            __ref_column_spill(argv[++a], referee::rt::kSpillThreshold);
+        else if (arg == "--threads" && a + 1 < argc)
+            __ref_threads(std::atoll(argv[++a]));
         else                                    tracePaths.push_back(arg);
     }
 
@@ -83,7 +92,7 @@ int     main(int argc, char** argv)
         //  identity: what it checks and what shape of trace it expects. Print
         //  that rather than a bare usage line, since there is no `.ref` beside
         //  it to consult.
-        std::printf("usage: %s trace.{rdb,csv,yaml} [trace ...]\n\n", argv[0]);
+        std::printf("usage: %s [--conf FILE] [--spill DIR] [--threads N] trace.{rdb,csv,yaml} [trace ...]\n\n", argv[0]);
         std::printf("An ahead-of-time referee checker: %u requirement%s over a "
                     "trace of these signals.\n",
                     mod->count, mod->count == 1 ? "" : "s");
@@ -144,7 +153,7 @@ int     main(int argc, char** argv)
     auto    openTrace = [&](std::string const& path) -> std::unique_ptr<referee::db::Reader>
     {
         if (endsWith(path, ".rdb"))
-            return std::make_unique<referee::db::Reader>(path);
+            return referee::db::Reader::map(path);
 
         std::ifstream       data(path);
         if (!data)
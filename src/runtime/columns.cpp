@@ -0,0 +1,165 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2022-2026 Michael Rolnik
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#include "columns.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+
+struct Column
+{
+    void*           base;
+    std::size_t     size;
+    bool            mapped;     //  munmap rather than free
+};
+
+//  Per thread: a compiled function releases what it took, and two threads
+//  evaluating side by side must not release each other's columns.
+thread_local Column*        t_cols  = nullptr;
+thread_local std::int64_t   t_count = 0;
+thread_local std::int64_t   t_cap   = 0;
+
+char                        g_spillDir[4096]    = {0};
+std::int64_t                g_spillThreshold    = 0;
+
+[[noreturn]] void   fail(char const* what)
+{
+    std::fprintf(stderr, "referee: cannot allocate a trace column: %s\n", what);
+    std::abort();
+}
+
+} // namespace
+
+namespace referee::rt
+{
+
+char const* spillDir()
+{
+    return g_spillDir[0] != 0 ? g_spillDir : nullptr;
+}
+
+bool    spilling(std::size_t bytes)
+{
+    return g_spillDir[0] != 0 && static_cast<std::int64_t>(bytes) >= g_spillThreshold;
+}
+
+void*   spillMap(std::size_t bytes)
+{
+    char    path[sizeof(g_spillDir) + 32];
+    std::snprintf(path, sizeof(path), "%s/referee-column-XXXXXX", g_spillDir);
+
+    int     fd = ::mkstemp(path);
+    if (fd < 0)
+        fail("cannot create a spill file");
+
+    //  Unlinked at once: the mapping keeps it alive, and nothing is left
+    //  behind when the process ends, however it ends.
+    ::unlink(path);
+
+    //  A file extended by ftruncate reads as zeros, which is what a fresh
+    //  column must hold -- without writing, and so without dirtying, a page.
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+    {
+        ::close(fd);
+        fail("cannot size a spill file");
+    }
+
+    void*   p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        fail("cannot map a spill file");
+
+    //  Every pass over a column is a straight walk, one way or the other.
+    ::madvise(p, bytes, MADV_SEQUENTIAL);
+    return p;
+}
+
+void    spillUnmap(void* base, std::size_t bytes)
+{
+    ::munmap(base, bytes);
+}
+
+} // namespace referee::rt
+
+extern "C" {
+
+void            __ref_column_spill(char const* dir, std::int64_t threshold)
+{
+    if (dir == nullptr || *dir == 0)
+    {
+        g_spillDir[0] = 0;
+        return;
+    }
+
+    std::snprintf(g_spillDir, sizeof(g_spillDir), "%s", dir);
+    g_spillThreshold = threshold < 1 ? 1 : threshold;
+}
+
+void*           __ref_column(std::int64_t bytes)
+{
+    if (t_count == t_cap)
+    {
+        auto    cap  = t_cap ? t_cap * 2 : 16;
+        auto*   grow = static_cast<Column*>(std::realloc(t_cols, cap * sizeof(Column)));
+        if (grow == nullptr)
+            fail("out of memory");
+        t_cols = grow;
+        t_cap  = cap;
+    }
+
+    //  Zero bytes is legal -- an empty trace has no states between the
+    //  sentinels -- but must still yield a distinct, freeable pointer.
+    auto    size    = static_cast<std::size_t>(bytes > 0 ? bytes : 1);
+    bool    mapped  = referee::rt::spilling(size);
+    void*   base    = mapped ? referee::rt::spillMap(size) : std::calloc(size, 1);
+    if (base == nullptr)
+        fail("out of memory");
+
+    t_cols[t_count++] = {base, size, mapped};
+    return base;
+}
+
+std::int64_t    __ref_column_mark()
+{
+    return t_count;
+}
+
+void            __ref_column_release(std::int64_t mark)
+{
+    while (t_count > mark)
+    {
+        auto&   c = t_cols[--t_count];
+        if (c.mapped) referee::rt::spillUnmap(c.base, c.size);
+        else          std::free(c.base);
+    }
+}
+
+}
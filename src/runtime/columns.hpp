@@ -0,0 +1,113 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2022-2026 Michael Rolnik
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+#pragma once
+
+/*
+ *  Trace-length columns: the per-state buffers a compiled recurrence fills
+ *  (`bool[N]` for U/R/S/T, a value per state for Sum/Itg, the decisive pass of
+ *  a bounded window) and the driver's own per-trace copies.
+ *
+ *  They used to be stack allocas. That caps a trace at whatever the stack
+ *  holds -- one operator over ten million states is ten megabytes of stack --
+ *  and leaves no way to put them anywhere but RAM. Here they come from the
+ *  host instead: the heap by default, or, once a spill directory is set, an
+ *  unlinked file in it mapped shared. A file-backed column is page cache the
+ *  kernel may write back and drop, so a pass that streams through a column a
+ *  page at a time keeps only the pages it is on resident -- the chunking is
+ *  the kernel's, the carried boundary value is the recurrence's own val[i+-1].
+ *
+ *  Compiled into both the main build and libreferee_rt, like the string
+ *  builtins, and written without the C++ library so a checker `.so` linked by
+ *  `cc -shared` does not pull it in.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+
+/*  Send columns of at least `threshold` bytes to unlinked files under `dir`.
+ *  A null or empty `dir` returns to the heap. Process-wide; set it before
+ *  evaluating, not during.  */
+void            __ref_column_spill(char const* dir, std::int64_t threshold);
+
+/*  `bytes` of zeroed memory that lives until the matching release. Never
+ *  returns null: failing to get a column is fatal to the evaluation, and the
+ *  generated code has no way to report it.  */
+void*           __ref_column(std::int64_t bytes);
+
+/*  Columns are released in stack order: a compiled function takes a mark on
+ *  entry and releases back to it before every return, the same lifetime an
+ *  alloca had.  */
+std::int64_t    __ref_column_mark();
+void            __ref_column_release(std::int64_t mark);
+
+}
+
+namespace referee::rt
+{
+
+/// Below this a column stays on the heap even with a spill directory set:
+/// mapping a file costs a few syscalls, which a short trace would notice and a
+/// long one does not.
+constexpr std::int64_t  kSpillThreshold = std::int64_t(1) << 20;
+
+/// The directory set by `__ref_column_spill`, or null when columns stay on
+/// the heap.
+char const* spillDir();
+
+/// Whether a block of `bytes` goes to the spill directory rather than the
+/// heap under the current `__ref_column_spill` setting.
+bool    spilling(std::size_t bytes);
+
+/// `bytes` of zeroed memory backed by an unlinked file in the spill
+/// directory. For storage whose lifetime is not stack-ordered -- a `.rdb`
+/// Reader's slab -- and so cannot be a column. Aborts on failure, as a column
+/// does.
+void*   spillMap(std::size_t bytes);
+void    spillUnmap(void* base, std::size_t bytes);
+
+/// Columns the driver takes for itself -- the per-trace state rows and the
+/// computed signals -- released when the scope ends, so they are spilled under
+/// exactly the same rule as the ones compiled code asks for.
+class ColumnScope
+{
+public:
+    ColumnScope() : m_mark(__ref_column_mark()) {}
+    ~ColumnScope() { __ref_column_release(m_mark); }
+
+    ColumnScope(ColumnScope const&)            = delete;
+    ColumnScope& operator=(ColumnScope const&) = delete;
+
+    std::uint8_t*   take(std::size_t bytes)
+    {
+        return static_cast<std::uint8_t*>(__ref_column(static_cast<std::int64_t>(bytes)));
+    }
+
+private:
+    std::int64_t    m_mark;
+};
+
+} // namespace referee::rt
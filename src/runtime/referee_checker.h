@@ -108,6 +108,17 @@ typedef struct referee_module_v1
     int64_t*                        oobCnt;
 } referee_module_v1;
 
+/*
+ *  The object also imports, when the specification has an unbounded temporal
+ *  operator or accumulator, the trace-column allocator its buffers come from:
+ *  `__ref_column`, `__ref_column_mark` and `__ref_column_release`
+ *  (runtime/columns.hpp). libreferee_rt defines them; a host that does not
+ *  link it must supply its own, with the same release-to-mark discipline.
+ *  Those operators, integer accumulators and computed signals are walked
+ *  through `__ref_scan` (runtime/scan.hpp), which is imported the same way;
+ *  `__ref_threads` in the object's copy sets how many workers it may use.
+ */
+
 /*  The one exported symbol. Everything else in the object is internal. */
 const referee_module_v1* referee_module(void);
 
@@ -0,0 +1,255 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2022-2026 Michael Rolnik
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+
+#include "scan.hpp"
+
+#include <cstring>
+
+#include <pthread.h>
+
+namespace
+{
+
+using referee::rt::kMaxWidth;
+
+//  Far more than any machine this runs on has cores; it only bounds the
+//  arrays below, so a scan needs no allocation of its own.
+constexpr std::int64_t  kMaxThreads = 256;
+
+std::int64_t    g_threads   = 1;
+
+struct Block
+{
+    std::int64_t    lo;
+    std::int64_t    hi;
+    std::int64_t    summary[kMaxWidth]; //  what the kernel reported, per column
+    std::int64_t    carry[kMaxWidth];   //  the true value flowing in, once known
+};
+
+struct Scan
+{
+    __ref_kernel    kernel;
+    void*           frst;
+    void*           last;
+    void*           conf;
+    void* const*    bufs;
+    std::int64_t    kind;
+    std::int64_t    width;
+    Block*          blocks;
+    std::int64_t    count;
+    std::int64_t    first;      //  the block the fold starts in: its provisional
+                                //  carry was already the true one
+    bool            patching;
+};
+
+struct Task
+{
+    Scan*           scan;
+    std::int64_t    index;
+};
+
+//  Step 3 for one column of one block: overwrite the states whose value was
+//  still waiting on the carry. For a boolean that is the run between the
+//  block's entry edge and its first decisive state, all of which take the
+//  carry itself; for a sum it is every state, each of which is short by
+//  exactly the carry.
+void    patch(Scan const& s, Block const& b, std::int64_t c)
+{
+    auto*   bytes   = static_cast<std::uint8_t*>(s.bufs[c]);
+    auto    summary = b.summary[c];
+    auto    carry   = b.carry[c];
+
+    switch (s.kind)
+    {
+    case REF_SCAN_BACKWARD:
+        std::memset(bytes + summary + 1, static_cast<int>(carry), static_cast<std::size_t>(b.hi - summary));
+        break;
+    case REF_SCAN_FORWARD:
+        std::memset(bytes + b.lo, static_cast<int>(carry), static_cast<std::size_t>(summary - b.lo));
+        break;
+    case REF_SCAN_SUM:
+        for (auto* t = static_cast<std::int64_t*>(s.bufs[c]), *i = t + b.lo, *e = t + b.hi + 1; i != e; ++i)
+            *i += carry;
+        break;
+    default:
+        break;
+    }
+}
+
+void    work(Scan& s, std::int64_t k)
+{
+    auto&   b = s.blocks[k];
+    if (!s.patching)
+        s.kernel(s.frst, s.last, s.conf, b.lo, b.hi, s.bufs, b.summary);
+    else if (k != s.first)
+        for (std::int64_t c = 0; c < s.width; c++)
+            patch(s, b, c);
+}
+
+void*   trampoline(void* arg)
+{
+    auto*   t = static_cast<Task*>(arg);
+    work(*t->scan, t->index);
+    return nullptr;
+}
+
+//  One parallel step: a worker per block but the first, which the calling
+//  thread takes itself. A worker that cannot be started is not an error --
+//  its block simply runs here, after the rest have been launched.
+void    parallel(Scan& s)
+{
+    pthread_t   tids[kMaxThreads];
+    Task        tasks[kMaxThreads];
+    bool        started[kMaxThreads];
+
+    for (std::int64_t k = 1; k < s.count; k++)
+    {
+        tasks[k]    = {&s, k};
+        started[k]  = pthread_create(&tids[k], nullptr, trampoline, &tasks[k]) == 0;
+    }
+
+    work(s, 0);
+
+    for (std::int64_t k = 1; k < s.count; k++)
+        if (!started[k])
+            work(s, k);
+
+    for (std::int64_t k = 1; k < s.count; k++)
+        if (started[k])
+            pthread_join(tids[k], nullptr);
+}
+
+//  Step 2 for one column: walk the summaries in fold order, starting from the
+//  base case the caller left in the sentinel slot.
+void    carry(Scan& s, std::int64_t c, std::int64_t numStates)
+{
+    auto*   bytes   = static_cast<std::uint8_t*>(s.bufs[c]);
+    switch (s.kind)
+    {
+    case REF_SCAN_BACKWARD:
+    {
+        std::int64_t    in = bytes[numStates - 1];
+        for (auto k = s.count - 1; k >= 0; k--)
+        {
+            auto&   b   = s.blocks[k];
+            b.carry[c]  = in;
+            in          = b.summary[c] < b.lo ? in : bytes[b.lo];
+        }
+        break;
+    }
+    case REF_SCAN_FORWARD:
+    {
+        std::int64_t    in = bytes[0];
+        for (std::int64_t k = 0; k < s.count; k++)
+        {
+            auto&   b   = s.blocks[k];
+            b.carry[c]  = in;
+            in          = b.summary[c] > b.hi ? in : bytes[b.hi];
+        }
+        break;
+    }
+    case REF_SCAN_SUM:
+    {
+        std::int64_t    in = static_cast<std::int64_t*>(s.bufs[c])[numStates - 1];
+        for (auto k = s.count - 1; k >= 0; k--)
+        {
+            auto&   b   = s.blocks[k];
+            b.carry[c]  = in;
+            in         += b.summary[c];
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+} // namespace
+
+namespace referee::rt
+{
+
+std::int64_t    threads()
+{
+    return g_threads;
+}
+
+} // namespace referee::rt
+
+extern "C" {
+
+void            __ref_threads(std::int64_t count)
+{
+    g_threads = count < 1 ? 1 : count > kMaxThreads ? kMaxThreads : count;
+}
+
+void            __ref_scan(__ref_kernel kernel, void* frst, void* last, void* conf,
+                           void* const* bufs, std::int64_t numStates,
+                           std::int64_t kind, std::int64_t width)
+{
+    auto    states  = numStates - 2;
+    if (states <= 0)
+        return;
+
+    auto    count   = states / referee::rt::kMinBlock;
+    if (count > g_threads)  count = g_threads;
+    if (count < 1)          count = 1;
+
+    //  Near-equal blocks over 1 .. numStates-2, the first `extra` one longer.
+    Block   blocks[kMaxThreads];
+    auto    share   = states / count;
+    auto    extra   = states % count;
+    for (std::int64_t k = 0, lo = 1; k < count; k++)
+    {
+        auto    len = share + (k < extra ? 1 : 0);
+        blocks[k].lo = lo;
+        blocks[k].hi = lo + len - 1;
+        lo          += len;
+    }
+
+    Scan    s{kernel, frst, last, conf, bufs, kind, width, blocks, count,
+              kind == REF_SCAN_FORWARD ? 0 : count - 1, false};
+
+    //  Step 1.
+    if (count == 1)
+    {
+        work(s, 0);
+        return;
+    }
+    parallel(s);
+
+    if (kind == REF_SCAN_MAP)
+        return;
+
+    //  Step 2.
+    for (std::int64_t c = 0; c < width; c++)
+        carry(s, c, numStates);
+
+    //  Step 3.
+    s.patching = true;
+    parallel(s);
+}
+
+}
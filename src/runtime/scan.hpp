@@ -0,0 +1,117 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2022-2026 Michael Rolnik
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ */
+
+
+#pragma once
+
+/*
+ *  Block-parallel evaluation of one trace.
+ *
+ *  Every unbounded recurrence is a left (or right) fold of a per-state step
+ *  over the trace, and for the ones the compiler lowers to columns that step
+ *  composes associatively:
+ *
+ *      U/R/S/T   val[i] = rhs hit ? rhsV : lhs hit ? lhsV : val[i+-1]
+ *                -- a step {T,F}->{T,F} that is either a constant or the
+ *                identity, and a run of them is again one or the other.
+ *      Sum/Itg   total[i] = contrib[i] + total[i+1]
+ *                -- an integer prefix sum.
+ *      prepare   one computed signal at every state -- no carry at all.
+ *
+ *  So a trace cuts into blocks, one per worker, and each runs in three steps:
+ *
+ *      1.  in parallel, every block runs the compiled step over its own
+ *          states with a provisional carry and reports its summary: for a
+ *          boolean, where its first decisive state is (everything before it,
+ *          walking in, still depends on the carry); for a sum, its total.
+ *      2.  one sequential walk over the summaries, from the block the fold
+ *          starts in, yields the true carry into every block.
+ *      3.  in parallel, every block patches the states that depended on it.
+ *
+ *  The step itself is compiled code -- a *kernel*, see compile.cpp -- so this
+ *  file only cuts, schedules and patches. A kernel may fill several columns
+ *  of the same kind in one walk (operators fused into a single pass over the
+ *  states); each has its own summary and its own carry, and only the walk is
+ *  shared. With one worker, or a trace too
+ *  short to be worth cutting, the kernel runs once over the whole trace and
+ *  steps 2 and 3 have nothing to do: the sequential evaluation is the one-block
+ *  case of the parallel one, not a separate code path.
+ *
+ *  Compiled into both the main build and libreferee_rt, like the column
+ *  allocator, and written against pthreads rather than the C++ library for the
+ *  same reason.
+ */
+
+#include <cstdint>
+
+extern "C" {
+
+/*  A compiled block step: evaluate states [lo, hi] of the trace (indices into
+ *  `frst`, so 1 .. N-2 between the sentinels) into the columns in `bufs`, and
+ *  store the block's summary for column c in `sums[c]`.  */
+typedef void    (*__ref_kernel)(void* frst, void* last, void* conf,
+                                std::int64_t lo, std::int64_t hi,
+                                void* const* bufs, std::int64_t* sums);
+
+/*  What a kernel folds, and so how its summaries combine. `bufs[0 .. width-1]`
+ *  are the columns being filled -- none for the map; the rest of `bufs` are
+ *  columns the kernel only reads.  */
+enum
+{
+    REF_SCAN_MAP        = 0,    /*  no carry; summary unused                    */
+    REF_SCAN_BACKWARD   = 1,    /*  bool, val[i] from val[i+1]; summary is the
+                                    highest decisive index, or lo-1             */
+    REF_SCAN_FORWARD    = 2,    /*  bool, val[i] from val[i-1]; summary is the
+                                    lowest decisive index, or hi+1              */
+    REF_SCAN_SUM        = 3,    /*  int64 suffix sum; summary is the block total */
+};
+
+/*  Evaluate states 1 .. numStates-2 through `kernel`, filling `width` columns
+ *  of one `kind`. Sentinel slots of each column (0 and numStates-1) must
+ *  already hold its base case.  */
+void            __ref_scan(__ref_kernel kernel, void* frst, void* last, void* conf,
+                           void* const* bufs, std::int64_t numStates,
+                           std::int64_t kind, std::int64_t width);
+
+/*  How many workers a scan may use. 0 or 1 evaluates on the calling thread
+ *  alone, which is the default. Process-wide; set it before evaluating.  */
+void            __ref_threads(std::int64_t count);
+
+}
+
+namespace referee::rt
+{
+
+/// The worker count set by `__ref_threads`.
+std::int64_t    threads();
+
+/// The most columns one kernel fills. The compiler splits a wider group of
+/// fusable operators into several passes.
+constexpr std::int64_t  kMaxWidth = 16;
+
+/// Fewer states than this per block and a scan stays on one thread: starting
+/// a worker costs tens of microseconds, which a block has to earn back.
+constexpr std::int64_t  kMinBlock = std::int64_t(1) << 16;
+
+} // namespace referee::rt
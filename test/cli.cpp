@@ -33,6 +33,7 @@
 #include <vector>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <sstream>
 #include <cstring>
 #include <cstdio>
@@ -740,6 +741,17 @@ TEST(Cli, CompileEmitsAtomicPropositions)
     EXPECT_NE(r.output.find("@__ap__0__untl("), std::string::npos) << r.output;   // x<50
     EXPECT_NE(r.output.find("@__ap__1__untl("), std::string::npos) << r.output;   // b
 
+    //  Each index map carries its length, which the monitor checks against
+    //  its own count before reading the map.
+    auto    lengthOf = [&](std::string const& label)
+    {
+        auto    b = r.output.find("@__ap__map__" + label + "__n__ = ");
+        if (b == std::string::npos)     return std::string("<missing>");
+        return r.output.substr(b, r.output.find('\n', b) - b);
+    };
+    EXPECT_NE(lengthOf("resp").find("constant i32 2"), std::string::npos) << lengthOf("resp");
+    EXPECT_NE(lengthOf("untl").find("constant i32 2"), std::string::npos) << lengthOf("untl");
+
     //  a single-fold invariant is served by __atom__, not __ap__
     EXPECT_NE(r.output.find("@__atom__inv("), std::string::npos) << r.output;
     EXPECT_EQ(r.output.find("@__ap__0__inv"), std::string::npos) << r.output;
@@ -779,6 +791,324 @@ TEST(Cli, ExecuteAcceptsYamlTrace)
     EXPECT_EQ(r.status, 0) << r.output;
 }
 
+// `--spill` changes where trace-length buffers live, never what is computed:
+// the report is the one a heap run prints, and nothing is left in the
+// directory afterwards -- every spill file is unlinked as it is created. The
+// fixtures are far below `kSpillThreshold`, so a generated `.rdb` whose state
+// rows alone run past it makes sure something is spilled at all: a file made
+// and unlinked there still moves the directory's mtime. (A CSV is ingested
+// through the directory whatever its size, so only the `.rdb` says so.)
+TEST(Cli, ExecuteSpillMatchesHeapAndLeavesNothingBehind)
+{
+    char    tmpl[] = "/tmp/referee-cli-spill-XXXXXX";
+    ASSERT_NE(::mkdtemp(tmpl), nullptr);
+    std::string dir = tmpl;
+
+    constexpr int   rows = 60000;
+    auto            ref  = tmpPath("spill", ".ref");
+    auto            csv  = tmpPath("spill", ".csv");
+    auto            rdb  = tmpPath("spill", ".rdb");
+    {
+        std::ofstream   f(csv);
+        f << "__time__,a,n\n";
+        for (int i = 0; i < rows; i++)
+            f << i * 1000 << "," << (i % 5 ? "true" : "false") << "," << i % 7 << "\n";
+    }
+    { std::ofstream f(ref); f << "data a : boolean;\ndata n : integer;\nG(n < 7);\nG(!a => F(a));\n"; }
+    ASSERT_EQ(run(quote(RDB_BIN) + " build " + quote(ref) + " " + quote(csv)
+                  + " -o " + quote(rdb)).status, 0);
+
+    auto    touched = [&]()
+    {
+        struct stat st{};
+        EXPECT_EQ(::stat(dir.c_str(), &st), 0);
+        return st.st_mtime != 1000;
+    };
+    auto    age     = [&]()
+    {
+        struct timespec times[2] = {{1000, 0}, {1000, 0}};
+        EXPECT_EQ(::utimensat(AT_FDCWD, dir.c_str(), times, 0), 0);
+    };
+
+    for (auto const* name : {"pass.ref", "fail.ref", "accumulate.ref", "generated"})
+    {
+        bool    big   = std::string(name) == "generated";
+        auto    spec  = big ? ref : data(name);
+        auto    trace = big ? rdb
+                      : std::string(name) == "accumulate.ref" ? data("accumulate.csv")
+                      :                                          data("data.csv");
+        auto    base  = quote(REFEREE_BIN) + " execute " + quote(spec) + " " + quote(trace)
+                      + (big || std::string(name) == "accumulate.ref"
+                            ? std::string() : " --conf " + quote(data("conf.csv")));
+
+        auto    heap  = run(base);
+        age();
+        auto    spill = run(base + " --spill " + quote(dir));
+        EXPECT_EQ(spill.status, heap.status) << name << "\n" << spill.output;
+        EXPECT_EQ(spill.output, heap.output) << name;
+        if (big)
+            EXPECT_TRUE(touched()) << "nothing was spilled";
+    }
+
+    auto    left = run("ls -A " + quote(dir));
+    EXPECT_EQ(left.output, "");
+    ::rmdir(dir.c_str());
+    for (auto const& f : {ref, csv, rdb})
+        std::remove(f.c_str());
+}
+
+// --threads cuts each pass into blocks and stitches them back together. The
+// trace is long enough for four blocks, and every requirement here hinges on
+// a value carried across all of them: `a` holds throughout, `b` only at the
+// last row and `f` only at the first, so a block that lost its carry would
+// decide them differently.
+TEST(Cli, ExecuteThreadsMatchesSequential)
+{
+    constexpr int   rows = 300000;
+
+    auto            ref   = tmpPath("threads", ".ref");
+    auto            csv   = tmpPath("threads", ".csv");
+    std::int64_t    total = 0;
+    {
+        std::ofstream   f(csv);
+        f << "__time__,a,b,f,n\n";
+        for (int i = 0; i < rows; i++)
+        {
+            auto    n = i % 7 - 3;
+            total    += n;
+            f << i * 1000 << ",true," << (i == rows - 1 ? "true" : "false") << ","
+              << (i == 0 ? "true" : "false") << "," << n << "\n";
+        }
+    }
+    {
+        std::ofstream   f(ref);
+        f << "data a : boolean;\ndata b : boolean;\ndata f : boolean;\ndata n : integer;\n"
+          << "data d = Us(a, b);\n"
+          << "Us(a, b);\n"
+          << "!Us(a, !a);\n"
+          << "G(d);\n"
+          << "G(__time__ == " << (rows - 1) * 1000ll << " => Ss(a, f));\n"
+          << "Sum(true, n) == " << total << ";\n"
+          << "Cnt(b) == 1;\n";
+    }
+
+    auto    base = quote(REFEREE_BIN) + " execute -v 2 " + quote(ref) + " " + quote(csv);
+    auto    one  = run(base);
+    auto    four = run(base + " --threads 4");
+    EXPECT_EQ(one.status, 0) << one.output;
+    EXPECT_EQ(four.status, 0) << four.output;
+    EXPECT_EQ(four.output, one.output);
+
+    std::remove(ref.c_str());
+    std::remove(csv.c_str());
+}
+
+// Operators at one level that walk the trace the same way share one fused
+// pass, and this checks every column of it against a naive recurrence worked
+// out here, one operator at a time. `wide` has eighteen U/R operators at level
+// one -- more than a kernel's sixteen columns, so the group is chunked -- and
+// eighteen Sums over them at level two; `mixed` puts S/T, integer Sum/Cnt and
+// a U at the same level. Each operator is summed weighted by its row number,
+// so a column that slipped, or lost its carry at a block edge, changes a
+// total. The signals flip at rates from every few rows to once in the whole
+// trace, and the trace spans three blocks, so under --threads the runs cross
+// block boundaries.
+TEST(Cli, ExecuteFusedPassesMatchReference)
+{
+    constexpr int   rows    = 200000;
+    constexpr int   signals = 6;
+
+    //  name, past, disjunctive (U/S) rather than conjunctive (R/T), weak
+    struct Op { char const* name; bool past; bool disj; bool weak; };
+    static Op const future[] = {
+        {"Us", false, true,  false}, {"Uw", false, true,  true},
+        {"Rs", false, false, false}, {"Rw", false, false, true},
+    };
+    static Op const past[] = {
+        {"Ss", true,  true,  false}, {"Sw", true,  true,  true},
+        {"Ts", true,  false, false}, {"Tw", true,  false, true},
+    };
+
+    std::vector<std::vector<bool>>  p(signals, std::vector<bool>(rows));
+    std::vector<std::int64_t>       n(rows);
+    {
+        std::uint64_t   seed = 0x2545f4914f6cdd1dull;
+        auto            next = [&] { seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                                     return seed >> 33; };
+        std::uint64_t const flip[signals] = {3, 50, 5000, 40000, 200000, 7};
+        for (int s = 0; s < signals; s++)
+        {
+            bool    v = s % 2;
+            for (int i = 0; i < rows; i++)
+            {
+                if (next() % flip[s] == 0) v = !v;
+                p[s][i] = v;
+            }
+        }
+        for (int i = 0; i < rows; i++)
+            n[i] = i % 7 - 3;
+    }
+
+    auto    reference = [&](Op const& op, int a, int b)
+    {
+        std::vector<bool>   v(rows);
+        bool                carry = op.weak;
+        for (int k = 0; k < rows; k++)
+        {
+            int     i = op.past ? k : rows - 1 - k;
+            carry     = op.disj ? p[b][i] || (p[a][i] && carry)
+                                : p[b][i] && (p[a][i] || carry);
+            v[i]      = carry;
+        }
+        return v;
+    };
+    auto    weighted = [&](std::vector<bool> const& v)
+    {
+        std::int64_t    total = 0;
+        for (int i = 0; i < rows; i++)
+            if (v[i]) total += i;
+        return total;
+    };
+
+    std::vector<std::pair<int, int>>    pairs;
+    for (int a = 0; a < signals; a++)
+        for (int b = 0; b < signals; b++)
+            if (a != b) pairs.emplace_back(a, b);
+
+    auto    term = [&](Op const& op, std::pair<int, int> ab)
+    {
+        auto [a, b] = ab;
+        return "Sum(" + std::string(op.name) + "(p" + std::to_string(a) + ", p" + std::to_string(b)
+             + "), k) == " + std::to_string(weighted(reference(op, a, b)));
+    };
+
+    std::string     wide;
+    for (int i = 0; i < 18; i++)
+        wide += (i ? " &&\n    " : "") + term(future[i % 4], pairs[i]);
+
+    std::string     mixed;
+    for (int i = 0; i < 4; i++)
+        mixed += term(past[i], pairs[18 + i]) + " &&\n    ";
+    {
+        std::int64_t    sum = 0, count = 0;
+        for (int i = 0; i < rows; i++)
+        {
+            if (p[3][i]) sum   += n[i];
+            if (p[4][i]) count += 1;
+        }
+        mixed += "Sum(p3, n) == " + std::to_string(sum) + " &&\n    Cnt(p4) == "
+               + std::to_string(count) + " &&\n    " + term(future[0], pairs[22]);
+    }
+
+    auto    ref = tmpPath("fused", ".ref");
+    auto    csv = tmpPath("fused", ".csv");
+    {
+        std::ofstream   f(csv);
+        f << "__time__,k,n";
+        for (int s = 0; s < signals; s++)
+            f << ",p" << s;
+        f << "\n";
+        for (int i = 0; i < rows; i++)
+        {
+            f << i << "," << i << "," << n[i];
+            for (int s = 0; s < signals; s++)
+                f << "," << (p[s][i] ? 1 : 0);
+            f << "\n";
+        }
+    }
+    {
+        std::ofstream   f(ref);
+        f << "data k : integer;\ndata n : integer;\n";
+        for (int s = 0; s < signals; s++)
+            f << "data p" << s << " : boolean;\n";
+        f << "@wide\n    " << wide << ";\n"
+          << "@mixed\n    " << mixed << ";\n";
+    }
+
+    auto    base = quote(REFEREE_BIN) + " execute -v 2 " + quote(ref) + " " + quote(csv);
+    auto    one  = run(base);
+    EXPECT_EQ(one.status, 0) << one.output;
+    for (auto const* threads : {" --threads 3", " --threads 8"})
+    {
+        auto    r = run(base + threads);
+        EXPECT_EQ(r.status, 0) << threads << "\n" << r.output;
+        EXPECT_EQ(r.output, one.output) << threads;
+    }
+
+    std::remove(ref.c_str());
+    std::remove(csv.c_str());
+}
+
+// An index fault in every block: `k` runs past the array at a different index
+// each time, and whichever block faulted last used to be the one reported.
+// The earliest faulting state wins instead -- the third row, index 6 -- with
+// any number of threads.
+TEST(Cli, ExecuteThreadsReportsTheEarliestIndexFault)
+{
+    constexpr int   rows = 300000;
+
+    auto    ref = tmpPath("oobthreads", ".ref");
+    auto    csv = tmpPath("oobthreads", ".csv");
+    {
+        std::ofstream   f(csv);
+        f << "__time__,v[0],v[1],v[2],v[3],k\n";
+        for (int i = 0; i < rows; i++)
+            f << i << ",1,2,3,4," << i * 3 % 7 << "\n";
+    }
+    {
+        std::ofstream   f(ref);
+        f << "data v : integer[4];\ndata k : integer;\ndata d = v[k];\nG(d > 0);\n";
+    }
+
+    auto    base = quote(REFEREE_BIN) + " execute " + quote(ref) + " " + quote(csv);
+    for (auto const* threads : {"", " --threads 4", " --threads 8"})
+    {
+        auto    r = run(base + threads);
+        EXPECT_NE(r.status, 0) << threads;
+        EXPECT_NE(r.output.find("index 6 is outside an array of 4"), std::string::npos)
+            << threads << "\n" << r.output;
+    }
+
+    std::remove(ref.c_str());
+    std::remove(csv.c_str());
+}
+
+// The tier changes how long the code takes to build and to run, never what it
+// computes: pass.ref exercises every lowering path, and each tier must print
+// the report `auto` does -- which, for a trace this short, is the O0 one.
+TEST(Cli, ExecuteOptTiersAgree)
+{
+    auto    base = quote(REFEREE_BIN) + " execute -v 2 " + quote(data("pass.ref")) + " "
+                 + quote(data("data.csv")) + " --conf " + quote(data("conf.csv"));
+    auto    ref  = run(base);
+    EXPECT_EQ(ref.status, 0) << ref.output;
+
+    for (auto level : {"0", "1", "2", "3"})
+    {
+        auto    r = run(base + " --opt " + level);
+        EXPECT_EQ(r.status, 0) << "--opt " << level << "\n" << r.output;
+        EXPECT_EQ(r.output, ref.output) << "--opt " << level;
+    }
+
+    auto    bad = run(base + " --opt 4");
+    EXPECT_NE(bad.status, 0) << bad.output;
+}
+
+// A module specialised to its conf computes what the general one does. Two
+// traces sharing conf.csv are also the cache's hit: the second must reuse the
+// first's module and still report the same.
+TEST(Cli, ExecuteSpecializeConfMatchesGeneral)
+{
+    auto    base = quote(REFEREE_BIN) + " execute -v 2 " + quote(data("pass.ref")) + " "
+                 + quote(data("data.csv")) + " " + quote(data("data.csv"))
+                 + " --conf " + quote(data("conf.csv"));
+    auto    general     = run(base);
+    auto    specialised = run(base + " --specialize-conf");
+    EXPECT_EQ(general.status, 0) << general.output;
+    EXPECT_EQ(specialised.status, 0) << specialised.output;
+    EXPECT_EQ(specialised.output, general.output);
+}
+
 // A malformed .ref must fail the run, not print a complaint and emit IR anyway.
 TEST(Cli, ExecuteReportsBadSyntax)
 {
@@ -868,6 +1198,226 @@ TEST(Cli, RdbBuildDumpAndExecuteRoundTrip)
     std::remove(out.c_str());
 }
 
+// compact -> dump -> execute: packed blocks read back as the states they were.
+TEST(Cli, RdbCompactKeepsStatesAndExecutes)
+{
+    auto    out    = tmpPath("plain") + ".rdb";
+    auto    packed = tmpPath("packed") + ".rdb";
+
+    ASSERT_EQ(run(quote(RDB_BIN) + " build "
+                  + quote(data("pass.ref")) + " " + quote(data("data.csv"))
+                  + " --conf " + quote(data("conf.csv"))
+                  + " -o " + quote(out)).status, 0);
+    auto    c = run(quote(RDB_BIN) + " compact " + quote(out) + " --block 2 -o " + quote(packed));
+    ASSERT_EQ(c.status, 0) << c.output;
+
+    //  Everything past the path line, which names the file.
+    auto    body = [](std::string const& dump) { return dump.substr(dump.find("numStates:")); };
+    auto    d0   = run(quote(RDB_BIN) + " dump " + quote(out));
+    auto    d1   = run(quote(RDB_BIN) + " dump " + quote(packed));
+    ASSERT_EQ(d1.status, 0) << d1.output;
+    EXPECT_EQ(body(d0.output), body(d1.output));
+
+    auto    exec = run(quote(REFEREE_BIN) + " execute "
+                     + quote(data("pass.ref")) + " " + quote(packed));
+    EXPECT_EQ(exec.status, 0) << exec.output;
+
+    std::remove(out.c_str());
+    std::remove(packed.c_str());
+}
+
+// A window of a trace is checked as a trace of its own: the violation at
+// t=300 is outside [0, 200], so that window passes, and `rdb slice` cuts the
+// same window to a file.
+TEST(Cli, RdbSliceAndExecuteWindow)
+{
+    auto    dir = tmpPath("slice", "");
+    auto    ref = dir + ".ref";
+    auto    csv = dir + ".csv";
+    auto    out = dir + ".rdb";
+    auto    cut = dir + ".cut.rdb";
+
+    { std::ofstream f(ref); f << "data x : integer;\nG(x < 100);\n"; }
+    { std::ofstream f(csv); f << "__time__,x\n0,1\n100,2\n200,3\n300,500\n400,4\n"; }
+    ASSERT_EQ(run(quote(RDB_BIN) + " build " + quote(ref) + " " + quote(csv)
+                  + " -o " + quote(out)).status, 0);
+
+    auto    exec = [&](std::string const& args)
+    {
+        return run(quote(REFEREE_BIN) + " execute " + quote(ref) + " " + args);
+    };
+    EXPECT_NE(exec(quote(out)).status, 0);
+    auto    w = exec(quote(out) + " --from 0 --to 200");
+    EXPECT_EQ(w.status, 0) << w.output;
+    EXPECT_NE(exec(quote(out) + " --from 250").status, 0);
+    EXPECT_NE(exec(quote(csv) + " --from 0 --to 200").status, 0);
+
+    auto    s = run(quote(RDB_BIN) + " slice " + quote(out) + " --from 50 --to 200 -o " + quote(cut));
+    ASSERT_EQ(s.status, 0) << s.output;
+    auto    dump = run(quote(RDB_BIN) + " dump " + quote(cut));
+    ASSERT_EQ(dump.status, 0) << dump.output;
+    EXPECT_NE(dump.output.find("numStates: 4"), std::string::npos) << dump.output;
+    EXPECT_EQ(exec(quote(cut)).status, 0);
+
+    EXPECT_NE(run(quote(RDB_BIN) + " slice " + quote(out) + " --from 310 --to 390 -o " + quote(cut)).status, 0);
+
+    for (auto const& p : {ref, csv, out, cut})
+        std::remove(p.c_str());
+}
+
+// `--only` checks the requirements named and loads only the signals they read.
+TEST(Cli, ExecuteOnlyNamedRequirements)
+{
+    auto    dir = tmpPath("only", "");
+    auto    ref = dir + ".ref";
+    auto    csv = dir + ".csv";
+    auto    out = dir + ".rdb";
+
+    { std::ofstream f(ref); f << "data x : integer;\ndata y : integer;\n"
+                                 "@x_small\nG(x < 100);\n@y_small\nG(y < 100);\n"; }
+    { std::ofstream f(csv); f << "__time__,x,y\n0,1,1\n100,2,500\n200,3,2\n"; }
+    ASSERT_EQ(run(quote(RDB_BIN) + " build " + quote(ref) + " " + quote(csv)
+                  + " -o " + quote(out)).status, 0);
+
+    auto    exec = [&](std::string const& args)
+    {
+        return run(quote(REFEREE_BIN) + " execute " + quote(ref) + " " + args);
+    };
+    EXPECT_NE(exec(quote(out)).status, 0);
+    auto    x = exec(quote(out) + " --only x_small");
+    EXPECT_EQ(x.status, 0) << x.output;
+    EXPECT_EQ(x.output.find("y_small"), std::string::npos) << x.output;
+    EXPECT_NE(exec(quote(out) + " --only y_small").status, 0);
+    EXPECT_EQ(exec(quote(csv) + " --only x_small").status, 0);
+    EXPECT_NE(exec(quote(out) + " --only no_such").status, 0);
+
+    //  The projection is real: a column only `b_small` reads holds a cell that
+    //  cannot load (a byte past 255), and the run fails on it -- unless that
+    //  column is never loaded because `--only` leaves its reader out.
+    auto    bref = dir + ".byte.ref";
+    auto    bcsv = dir + ".byte.csv";
+    { std::ofstream f(bref); f << "data x : integer;\ndata b : byte;\n"
+                                  "@x_small\nG(x < 100);\n@b_small\nG(b < 100);\n"; }
+    { std::ofstream f(bcsv); f << "__time__,x,b\n0,1,1\n100,2,300\n200,3,2\n"; }
+    auto    all = run(quote(REFEREE_BIN) + " execute " + quote(bref) + " " + quote(bcsv));
+    EXPECT_NE(all.status, 0) << all.output;
+    EXPECT_NE(all.output.find("out of range"), std::string::npos) << all.output;
+    auto    projected = run(quote(REFEREE_BIN) + " execute " + quote(bref) + " " + quote(bcsv) + " --only x_small");
+    EXPECT_EQ(projected.status, 0) << projected.output;
+
+    for (auto const& p : {ref, csv, out, bref, bcsv})
+        std::remove(p.c_str());
+}
+
+// `rdb pack` puts traces of one schema into a `.rdbx`, each with what it is
+// expected to do, and `execute --corpus` checks them all from it.
+TEST(Cli, RdbPackAndExecuteCorpus)
+{
+    auto    dir  = tmpPath("corpus", "");
+    auto    ref  = dir + ".ref";
+    auto    csvA = dir + ".a.csv";
+    auto    csvB = dir + ".b.csv";
+    auto    rdbA = dir + ".a.rdb";
+    auto    rdbB = dir + ".b.rdb";
+    auto    out  = dir + ".rdbx";
+
+    { std::ofstream f(ref);  f << "data x : integer;\ndata s : string;\nG(x < 100);\n"; }
+    { std::ofstream f(csvA); f << "__time__,x,s\n0,1,on\n100,2,off\n"; }
+    { std::ofstream f(csvB); f << "__time__,x,s\n0,1,on\n100,500,on\n"; }
+    for (auto [csv, rdb] : {std::pair{csvA, rdbA}, std::pair{csvB, rdbB}})
+        ASSERT_EQ(run(quote(RDB_BIN) + " build " + quote(ref) + " " + quote(csv)
+                      + " -o " + quote(rdb)).status, 0);
+
+    auto    pack = [&](std::string const& args)
+    {
+        return run(quote(RDB_BIN) + " pack " + args + " -o " + quote(out));
+    };
+    auto    exec = [&]()
+    {
+        return run(quote(REFEREE_BIN) + " execute " + quote(ref) + " --corpus " + quote(out));
+    };
+
+    auto    p = pack(quote(rdbA) + " --failure " + quote(rdbB));
+    ASSERT_EQ(p.status, 0) << p.output;
+    auto    e = exec();
+    EXPECT_EQ(e.status, 0) << e.output;
+    EXPECT_NE(e.output.find(out + "(" + rdbB + ")"), std::string::npos) << e.output;
+
+    ASSERT_EQ(pack(quote(rdbA) + " " + quote(rdbB)).status, 0);
+    EXPECT_NE(exec().status, 0);
+
+    EXPECT_NE(pack(quote(csvA)).status, 0);
+
+    for (auto const& f : {ref, csvA, csvB, rdbA, rdbB, out})
+        std::remove(f.c_str());
+}
+
+//  One trace served from shared memory and checked by several processes, each
+//  mapping the same fixed-up image. The string column is compared against a
+//  literal, so the trace's strings have to be the ones the spec interns.
+TEST(Cli, RdbServeAndExecuteAttach)
+{
+    auto    dir  = tmpPath("serve", "");
+    auto    ref  = dir + ".ref";
+    auto    bad  = dir + ".bad.ref";
+    auto    csv  = dir + ".csv";
+    auto    rdb  = dir + ".rdb";
+    auto    name = "referee-cli-" + dir.substr(dir.rfind('-') + 1);
+
+    { std::ofstream f(ref); f << "data x : integer;\ndata s : string;\nG(x < 100 && s != \"stuck\");\n"; }
+    { std::ofstream f(bad); f << "data x : integer;\ndata s : string;\nG(s == \"on\");\n"; }
+    { std::ofstream f(csv); f << "__time__,x,s\n0,1,on\n100,2,off\n200,3,on\n"; }
+    ASSERT_EQ(run(quote(RDB_BIN) + " build " + quote(ref) + " " + quote(csv)
+                  + " -o " + quote(rdb)).status, 0);
+
+    auto    serve = [&]()
+    {
+        return run(quote(RDB_BIN) + " serve " + quote(rdb) + " " + name + " --address 0x3f0000000000");
+    };
+    auto    exec  = [&](std::string const& spec)
+    {
+        return run(quote(REFEREE_BIN) + " execute " + quote(spec) + " --attach " + name);
+    };
+
+    auto    s = serve();
+    ASSERT_EQ(s.status, 0) << s.output;
+    EXPECT_NE(serve().status, 0);
+    for (int i = 0; i < 2; i++)
+    {
+        auto    e = exec(ref);
+        EXPECT_EQ(e.status, 0) << e.output;
+    }
+    EXPECT_NE(exec(bad).status, 0);
+
+    //  Beside a suite the attached trace is still checked: `bad` fails on it
+    //  and on nothing the suite names.
+    auto    suite = dir + ".suite";
+    auto    good  = dir + ".on.csv";
+    { std::ofstream f(good);  f << "__time__,x,s\n0,1,on\n100,2,on\n"; }
+    { std::ofstream f(suite); f << good << " passes\n"; }
+    auto    both = run(quote(REFEREE_BIN) + " execute " + quote(bad) + " --attach " + name
+                     + " --suite " + quote(suite) + " -v 1");
+    EXPECT_NE(both.status, 0) << both.output;
+    EXPECT_NE(both.output.find("shm:" + name), std::string::npos) << both.output;
+
+    //  A second segment holds the same strings ("on", "off") in a pool of its
+    //  own; it is refused by name, not by whichever string collides first.
+    auto    name2 = name + "-b";
+    auto    s2    = run(quote(RDB_BIN) + " serve " + quote(rdb) + " " + name2 + " --address 0x3f8000000000");
+    ASSERT_EQ(s2.status, 0) << s2.output;
+    auto    two = run(quote(REFEREE_BIN) + " execute " + quote(ref) + " --attach " + name + " --attach " + name2);
+    EXPECT_NE(two.status, 0) << two.output;
+    EXPECT_NE(two.output.find("already attached"), std::string::npos) << two.output;
+    EXPECT_EQ(run(quote(RDB_BIN) + " unserve " + name2).status, 0);
+
+    EXPECT_EQ(run(quote(RDB_BIN) + " unserve " + name).status, 0);
+    EXPECT_NE(exec(ref).status, 0);
+    EXPECT_NE(run(quote(RDB_BIN) + " unserve " + name).status, 0);
+
+    for (auto const& f : {ref, bad, csv, rdb, suite, good})
+        std::remove(f.c_str());
+}
+
 TEST(Cli, RdbBuildRejectsMissingInputs)
 {
     auto    out = tmpPath("missing");
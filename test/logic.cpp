@@ -69,6 +69,8 @@
 #include "strings.hpp"
 #include "visitors/compile.hpp"
 #include "runtime/referee_checker.h"
+#include "runtime/columns.hpp"
+#include "runtime/scan.hpp"
 
 
 //  LCOV_EXCL_START 
@@ -166,6 +168,21 @@ public:
             llvm::orc::ExecutorAddr::fromPtr(&debug),
             llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable,
         };
+
+        //  Trace columns and block walks, as the driver's JIT registers them:
+        //  a test binary does not export its own symbols to the search
+        //  generator above.
+        auto    host = [&](char const* name, auto* fn)
+        {
+            symMap[Mangle(name)] = {
+                llvm::orc::ExecutorAddr::fromPtr(fn),
+                llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable,
+            };
+        };
+        host("__ref_column",         &__ref_column);
+        host("__ref_column_mark",    &__ref_column_mark);
+        host("__ref_column_release", &__ref_column_release);
+        host("__ref_scan",           &__ref_scan);
         if (auto Err = J->getMainJITDylib().define(
                 llvm::orc::absoluteSymbols(std::move(symMap))))
             return std::move(Err);
@@ -273,10 +290,14 @@ protected:
                     continue;
                 if(name.rfind("__ap__", 0) == 0)
                     continue;
+                if(name.rfind("__acc__", 0) == 0)
+                    continue;
                 if(name.rfind("__sub__", 0) == 0)
                     continue;
                 if(name.rfind("__scope", 0) == 0)
                     continue;
+                if(name.rfind("__scan__", 0) == 0)     // block kernel, internal
+                    continue;
                 if(name == "referee_module")
                     continue;
 
@@ -26,20 +26,37 @@
 
 #include "rdb/database.hpp"
 #include "rdb/ingest.hpp"
+#include "rdb/merge.hpp"
 #include "referee.hpp"
+#include "monitor.hpp"
 #include "strings.hpp"
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#if __has_include("llvm/ExecutionEngine/Orc/AbsoluteSymbols.h")
+#  include "llvm/ExecutionEngine/Orc/AbsoluteSymbols.h"
+#endif
+#include "runtime/columns.hpp"
+#include "runtime/scan.hpp"
 #include "antlr2ast.hpp"
 #include "syntax.hpp"
 #include "visitors/loader.hpp"
 #include "visitors/csvHeaders.hpp"
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 namespace
 {
@@ -55,6 +72,30 @@ std::string     tmpFile(std::string const& tag)
     return std::string(buf.data());
 }
 
+//  The host functions compiled code calls for its trace-length columns and
+//  its block walks -- what the driver's JIT registers, and the least a bare
+//  one needs to run `__prepare__`.
+void    defineRuntime(llvm::orc::LLJIT& jit)
+{
+    llvm::orc::MangleAndInterner    mangle(jit.getExecutionSession(), jit.getDataLayout());
+    llvm::orc::SymbolMap            symbols;
+
+    auto    host = [&](char const* name, auto* fn)
+    {
+        symbols[mangle(name)] = {
+            llvm::orc::ExecutorAddr::fromPtr(fn),
+            llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable,
+        };
+    };
+    host("__ref_column",         &__ref_column);
+    host("__ref_column_mark",    &__ref_column_mark);
+    host("__ref_column_release", &__ref_column_release);
+    host("__ref_scan",           &__ref_scan);
+
+    if (auto err = jit.getMainJITDylib().define(llvm::orc::absoluteSymbols(std::move(symbols))))
+        llvm::consumeError(std::move(err));
+}
+
 std::vector<std::uint8_t>   readWholeFile(std::string const& path)
 {
     std::ifstream   in(path, std::ios::binary);
@@ -194,6 +235,30 @@ TEST(Rdb, ExecuteRdbFail)
     std::remove(rdbPath.c_str());
 }
 
+// `--opt auto` compiles at O0 for a run shorter than the crossover, where the
+// compile would cost more than the optimised code saves, and at O2 from there
+// on. A fixed level is taken as given, whatever the length. (That the tiers'
+// verdicts agree is Cli.ExecuteOptTiersAgree.)
+TEST(Rdb, ExecuteAutoTierFollowsCrossover)
+{
+    auto    crossover = Referee::optCrossover();
+    ASSERT_GT(crossover, 1u);
+
+    Referee::optimize(-1);
+    EXPECT_EQ(Referee::optLevelFor(1), 0);
+    EXPECT_EQ(Referee::optLevelFor(crossover - 1), 0);
+    EXPECT_EQ(Referee::optLevelFor(crossover), 2);
+    EXPECT_EQ(Referee::optLevelFor(crossover * 10), 2);
+
+    for (int level : {0, 1, 2, 3})
+    {
+        Referee::optimize(level);
+        EXPECT_EQ(Referee::optLevelFor(1), level);
+        EXPECT_EQ(Referee::optLevelFor(crossover * 10), level);
+    }
+    Referee::optimize(-1);
+}
+
 // The monitor streams states one CSV row at a time and reports a safety
 // (invariant) violation the instant it happens, while deferring a liveness
 // obligation to end of stream -- so an `F` that has not been met yet is never
@@ -1179,6 +1244,987 @@ TEST(Rdb, MonitorBoundedResponseAgreesAtEveryPrefix)
     }
 }
 
+// Bounded windows nested inside a requirement, and computed props, now run on
+// the incremental evaluators: a past window keeps only the samples still inside
+// it, a future one waits for its first decisive state, and a row-local computed
+// prop is prepared per row. A prop that reads other states, or an accumulator,
+// sends only its own requirement to the prefix re-run, so the last specs mix the
+// two lanes in one monitor. Irregular timestamps put samples exactly on window
+// edges. All must agree with the offline checker at EVERY prefix.
+TEST(Rdb, MonitorIncrementalAgreesAtEveryPrefix)
+{
+    constexpr int   N = 24;
+
+    std::string                 header = "__time__,a,b,c";
+    std::vector<std::string>    rows;
+    int                         t = 0;
+    for (int k = 0; k < N; k++)
+    {
+        bool    a = (k % 3) == 2;
+        bool    b = (k % 5) == 1 || (k % 5) == 2;
+        bool    c = (k % 7) != 4;
+        rows.push_back(std::to_string(t)
+                     + "," + (a ? "true" : "false")
+                     + "," + (b ? "true" : "false")
+                     + "," + (c ? "true" : "false"));
+        t += (k % 4) == 3 ? 500 : 1000;
+    }
+
+    //  Each spec with the lane every requirement must take: agreement alone
+    //  would also hold if one silently fell back to the prefix re-run.
+    struct  Case
+    {
+        std::string                         spec;
+        std::map<std::string, std::string>  lanes;
+    };
+    std::string const   decl = "data a:boolean;\ndata b:boolean;\ndata c:boolean;\n";
+    Case const          cases[] = {
+        {decl + "@r G(a => O[0:2500](b));\n",       {{"r", "residual"}}},      // b within the last 2.5 s
+        {decl + "@r G(a => O[1000:3000](b));\n",    {{"r", "residual"}}},      // offset past window
+        {decl + "@r G(a => H[1000:3000](c));\n",    {{"r", "residual"}}},      // c throughout an offset window
+        {decl + "@r G(a => Ss[0:4000](c, b));\n",   {{"r", "residual"}}},      // c since a recent b
+        {decl + "@r G(a => F[0:2500](b));\n",       {{"r", "response"}}},      // b within 2.5 s ahead
+        {decl + "@r G(a => F[500:2000](b));\n",     {{"r", "response"}}},      // window opens mid-persistence
+        {decl + "@r G(a => G[0:1500](c));\n",       {{"r", "residual"}}},      // c for the next 1.5 s
+        {decl + "@r G(a => Us[0:3000](c, b));\n",   {{"r", "residual"}}},      // c until b, within 3 s
+        {decl + "@r G(a => Rw[0:2000](b, c));\n",   {{"r", "residual"}}},      // c released by b
+        {decl + "data d = a && c;\n@r G(d => F[0:3000](b));\n",                   // row-local computed prop
+                                                    {{"r", "response"}}},
+        {decl + "data e = O(b);\n@p G(a => e);\n@q G(a => O[0:3000](b));\n",       // temporal prop beside a window
+                                                    {{"p", "prefix"}, {"q", "residual"}}},
+        {decl + "@p Cnt(a) <= 5;\n@q G(a => O[0:2500](b));\n",                    // accumulator beside a window
+                                                    {{"p", "total"}, {"q", "residual"}}},
+        {decl + "@s Sum(b, 3) <= 20;\n",            {{"s", "total"}}},          // running sum, one verdict
+        {decl + "@i Itg(c, 1) >= 15000;\n",         {{"i", "total"}}},          // time c holds
+        {decl + "@z Sum[1000:5000](c, 1) >= 4;\n",  {{"z", "total"}}},          // offset window at the start
+        {decl + "@w G(a => Cnt[0:3000](b) >= 1);\n",                              // per-mark window
+                                                    {{"w", "total"}}},
+        {decl + "@g G(Itg[0:2500](c, 1) >= 1000);\n",                             // every state's window
+                                                    {{"g", "total"}}},
+        {decl + "@f G(a => t@(F[0:3000](b && t.elapsed >= 500)));\n",             // frozen time in a bound
+                                                    {{"f", "residual"}}},
+        {decl + "@d G(a => t@(F(b && t.elapsed <= 2000)));\n",                    // retires on the deadline
+                                                    {{"d", "residual"}}},
+        {decl + "@e G(t@(t.elapsed == 0));\n",      {{"e", "residual"}}},       // freeze read at once
+        {decl + "@x G(b => t@(Xw(c || t.c)));\n",   {{"x", "residual"}}},       // frozen signal one state on
+    };
+
+    for (auto const& [spec, lanes] : cases)
+    {
+        auto    refPath = tmpFile("inc") + ".ref";
+        { std::ofstream f(refPath); f << spec; }
+        {
+            std::ifstream   ref(refPath);
+            Monitor         monitor(ref, refPath, "");
+            EXPECT_EQ(monitor.lanes(), lanes) << spec;
+        }
+
+        for (int k = 1; k <= N; k++)
+        {
+            std::string     csv = header;
+            for (int j = 0; j < k; j++)  csv += "\n" + rows[j];
+
+            auto            csvPath = tmpFile("inc-csv") + ".csv";
+            { std::ofstream f(csvPath); f << csv << "\n"; }
+
+            auto                rdbPath = tmpFile("inc-rdb");
+            referee::db::ingest(refPath, csvPath, /*conf=*/"", rdbPath);
+            std::ifstream       refA(refPath);
+            std::ostringstream  offOut;
+            bool                offline = Referee::executeRdb(refA, refPath, rdbPath, offOut);
+
+            std::istringstream  states(csv);
+            std::ifstream       refB(refPath);
+            std::ostringstream  monOut;
+            bool                online = Referee::monitor(refB, refPath, states, "", monOut);
+
+            std::remove(rdbPath.c_str());
+            std::remove(csvPath.c_str());
+
+            ASSERT_EQ(offline, online)
+                << "incremental disagree at prefix " << k << " of " << N
+                << "\nspec:\n" << spec
+                << "\noffline:\n" << offOut.str() << "\nmonitor:\n" << monOut.str();
+        }
+        std::remove(refPath.c_str());
+    }
+}
+
+// `--key`: one stream interleaving several sessions is monitored as if each
+// session had its own `referee monitor`. Each session's closing block must be
+// exactly what an unkeyed run over that session's rows alone prints, and the
+// run passes only if every session does. Past `--max-keys` the least recently
+// seen session is closed, and a key seen again starts afresh; past `--idle`
+// an abandoned session is closed as soon as the stream's clock passes it.
+TEST(Rdb, MonitorKeyedSessionsAgreeWithOneMonitorEach)
+{
+    std::string const   spec =
+        "data a:boolean;\ndata b:boolean;\n"
+        "@inv G(a || b);\n@ev F(b);\n@win G(a => O[0:2500](b));\n";
+    auto    refPath = tmpFile("keyed") + ".ref";
+    { std::ofstream f(refPath); f << spec; }
+
+    std::string const           header = "__time__,sid,a,b";
+    std::vector<std::string>    keys   = {"s1", "s2", "s3"};
+    std::map<std::string, std::string>  perKey;
+    std::string                 stream = header;
+    for (int k = 0; k < 30; k++)
+    {
+        auto const& key = keys[(k * 7) % 3];
+        bool        a   = (k % 4) != 1 || key == "s2";      //  s2 never breaks the invariant
+        bool        b   = (k % 5) == 0 || key == "s3";      //  s3 always has b
+        auto        row = std::to_string(k * 1000) + "," + key
+                        + "," + (a ? "true" : "false") + "," + (b ? "true" : "false");
+        stream      += "\n" + row;
+        perKey[key] += "\n" + row;
+    }
+
+    auto    closing = [](std::string const& out, std::string const& title)
+    {
+        auto    b = out.find(title);
+        if (b == std::string::npos)     return std::string("<missing " + title + ">");
+        b += title.size();
+        auto    e = out.find("--", b);
+        return out.substr(b, e == std::string::npos ? std::string::npos : e - b);
+    };
+
+    Referee::monitorKeys("sid");
+    std::istringstream  states(stream);
+    std::ifstream       refK(refPath);
+    std::ostringstream  keyedOut;
+    bool                keyed = Referee::monitor(refK, refPath, states, "", keyedOut);
+    Referee::monitorKeys("");
+
+    bool    all = true;
+    for (auto const& key : keys)
+    {
+        std::istringstream  one(header + perKey[key]);
+        std::ifstream       refU(refPath);
+        std::ostringstream  oneOut;
+        all = Referee::monitor(refU, refPath, one, "", oneOut) && all;
+        EXPECT_EQ(closing(oneOut.str(), "-- end of stream --"),
+                  closing(keyedOut.str(), "-- end of session " + key + " --"))
+            << "session " << key << "\nkeyed:\n" << keyedOut.str() << "\nalone:\n" << oneOut.str();
+    }
+    EXPECT_EQ(all, keyed);
+    EXPECT_NE(keyedOut.str().find("key=s2  __time__="), std::string::npos);
+    EXPECT_NE(keyedOut.str().find("-- end of stream: 3 sessions"), std::string::npos) << keyedOut.str();
+
+    //  One open session at a time: s1, s2, s1 is three sessions.
+    Referee::monitorKeys("sid", 1);
+    std::istringstream  lruStates(header + "\n0,s1,true,true\n1000,s2,true,true\n2000,s1,true,true\n");
+    std::ifstream       refL(refPath);
+    std::ostringstream  lruOut;
+    Referee::monitor(refL, refPath, lruStates, "", lruOut);
+    Referee::monitorKeys("");
+    EXPECT_NE(lruOut.str().find("-- end of stream: 3 sessions"), std::string::npos) << lruOut.str();
+
+    //  s1 goes quiet at 0; with --idle 1500 the row at 2000 closes it first.
+    Referee::monitorKeys("sid", 0, 1500);
+    std::istringstream  idleStates(header + "\n0,s1,true,true\n1000,s2,true,true\n2000,s2,true,true\n");
+    std::ifstream       refI(refPath);
+    std::ostringstream  idleOut;
+    Referee::monitor(refI, refPath, idleStates, "", idleOut);
+    Referee::monitorKeys("");
+    auto    endS1 = idleOut.str().find("-- end of session s1 --");
+    auto    row2k = idleOut.str().find("key=s2  __time__=2000");
+    EXPECT_NE(endS1, std::string::npos) << idleOut.str();
+    EXPECT_LT(endS1, row2k) << idleOut.str();
+
+    //  A `__time__` that does not parse is an error, not time 0.
+    Referee::monitorKeys("sid", 0, 1500);
+    std::istringstream  badStates(header + "\n0,s1,true,true\nsoon,s2,true,true\n");
+    std::ifstream       refB(refPath);
+    std::ostringstream  badOut;
+    EXPECT_FALSE(Referee::monitor(refB, refPath, badStates, "", badOut));
+    Referee::monitorKeys("");
+    EXPECT_NE(badOut.str().find("unparseable __time__ 'soon'"), std::string::npos) << badOut.str();
+
+    //  A quoted cell holding a comma, ahead of both the key and `__time__`,
+    //  shifts neither: each row still reaches its own session at its own time.
+    auto    quotedRef = tmpFile("keyed-quoted") + ".ref";
+    { std::ofstream f(quotedRef); f << "data note:string;\ndata a:boolean;\n@inv G(a);\n"; }
+    Referee::monitorKeys("sid");
+    std::istringstream  quoted("note,__time__,sid,a\n"
+                               "\"x, y\",0,s1,true\n\"p, q\",500,s2,false\n\"x, y\",1000,s1,true\n");
+    std::ifstream       refQ(quotedRef);
+    std::ostringstream  quotedOut;
+    EXPECT_FALSE(Referee::monitor(refQ, quotedRef, quoted, "", quotedOut));
+    Referee::monitorKeys("");
+    EXPECT_EQ(quotedOut.str().find("unparseable"), std::string::npos) << quotedOut.str();
+    EXPECT_NE(quotedOut.str().find("key=s2  __time__=500"), std::string::npos) << quotedOut.str();
+    EXPECT_NE(quotedOut.str().find("-- end of stream: 2 sessions"), std::string::npos) << quotedOut.str();
+    EXPECT_NE(closing(quotedOut.str(), "-- end of session s1 --").find("PASS"), std::string::npos) << quotedOut.str();
+    EXPECT_NE(closing(quotedOut.str(), "-- end of session s2 --").find("FAIL"), std::string::npos) << quotedOut.str();
+    std::remove(quotedRef.c_str());
+
+    std::remove(refPath.c_str());
+}
+
+// `monitor --binary` reads the same states framed (`rdb frames`): every lane --
+// a latch, a residual, a bounded window and the prefix re-run of an
+// accumulator -- must print exactly what the CSV monitor prints, violation
+// lines included, since a frame renders back to the row it came from.
+TEST(Rdb, MonitorBinaryFramesAgreeWithCsv)
+{
+    std::string const   spec =
+        "data a:boolean;\ndata b:boolean;\ndata tag:string;\n"
+        "@inv G(a || b);\n@ev F(b);\n@win G(a => O[0:2500](b));\n"
+        "@cnt Cnt(a) <= 5;\n@str G(tag != \"bad\");\n";
+    auto    refPath = tmpFile("frames") + ".ref";
+    auto    csvPath = tmpFile("frames-csv") + ".csv";
+    auto    frmPath = tmpFile("frames-bin");
+    { std::ofstream f(refPath); f << spec; }
+
+    std::string     csv = "__time__,a,b,tag";
+    for (int k = 0; k < 12; k++)
+        csv += "\n" + std::to_string(k * 1000) + "," + ((k % 4) != 1 ? "true" : "false")
+             + "," + ((k % 5) == 0 ? "true" : "false") + "," + (k == 7 ? "bad" : "ok");
+    { std::ofstream f(csvPath); f << csv << "\n"; }
+
+    referee::db::frames(refPath, csvPath, frmPath);
+
+    std::ifstream       refC(refPath);
+    std::istringstream  csvIn(csv);
+    std::ostringstream  csvOut;
+    bool                csvPass = Referee::monitor(refC, refPath, csvIn, "", csvOut);
+
+    Referee::monitorBinary(true);
+    std::ifstream       refB(refPath);
+    std::ifstream       frmIn(frmPath, std::ios::binary);
+    std::ostringstream  binOut;
+    bool                binPass = Referee::monitor(refB, refPath, frmIn, "", binOut);
+    Referee::monitorBinary(false);
+
+    EXPECT_EQ(csvPass, binPass);
+    EXPECT_EQ(csvOut.str(), binOut.str());
+    EXPECT_NE(binOut.str().find("VIOLATION"), std::string::npos) << binOut.str();
+
+    std::remove(refPath.c_str());
+    std::remove(csvPath.c_str());
+    std::remove(frmPath.c_str());
+}
+
+// `--format changes` prints a state only when a verdict moves, `ndjson` the same
+// events as JSON lines. Neither may lose a violation or change an end-of-stream
+// verdict, and a quiet stretch must print nothing at all.
+TEST(Rdb, MonitorChangeOnlyAndNdjsonOutput)
+{
+    std::string const   spec =
+        "data a:boolean;\ndata b:boolean;\n"
+        "@inv G(a || b);\n@ev F(b);\n@cnt Cnt(a) <= 5;\n";
+    auto    refPath = tmpFile("format") + ".ref";
+    { std::ofstream f(refPath); f << spec; }
+
+    std::string     csv = "__time__,a,b";
+    for (int k = 0; k < 40; k++)
+        csv += "\n" + std::to_string(k * 1000) + "," + (k != 30 ? "true" : "false")
+             + "," + (k == 20 ? "true" : "false");
+
+    auto    run = [&](std::string const& format, bool& pass)
+    {
+        Referee::monitorOutput(format);
+        std::ifstream       ref(refPath);
+        std::istringstream  in(csv);
+        std::ostringstream  out;
+        pass = Referee::monitor(ref, refPath, in, "", out);
+        Referee::monitorOutput("states");
+        return out.str();
+    };
+    auto    lines = [](std::string const& text, std::string const& with)
+    {
+        std::vector<std::string>    out;
+        std::istringstream          in(text);
+        for (std::string l; std::getline(in, l); )
+            if (l.find(with) != std::string::npos)  out.push_back(l);
+        return out;
+    };
+
+    bool    statesPass = false, changesPass = false, ndjsonPass = false;
+    auto    states  = run("states",  statesPass);
+    auto    changes = run("changes", changesPass);
+    auto    ndjson  = run("ndjson",  ndjsonPass);
+
+    EXPECT_EQ(statesPass, changesPass);
+    EXPECT_EQ(statesPass, ndjsonPass);
+    EXPECT_EQ(lines(states, "VIOLATION"), lines(changes, "VIOLATION"));
+    EXPECT_EQ(states.substr(states.find("-- end of stream --")),
+              changes.substr(changes.find("-- end of stream --")));
+
+    //  A changes line for exactly the states whose full line differs from the
+    //  one before it -- here only where `ev` is met and where `inv` breaks.
+    std::size_t     moved = 0;
+    std::string     last  = "  inv=?  ev=?  cnt=?";
+    for (auto const& l : lines(states, "__time__="))
+    {
+        if (l.rfind("VIOLATION", 0) == 0)   continue;
+        auto    cols = l.substr(l.find("  "));
+        moved += cols != last;
+        last   = cols;
+    }
+    EXPECT_GE(moved, 2u);
+    EXPECT_LT(moved, 40u);
+    EXPECT_EQ(lines(changes, "__time__=").size(), moved + lines(changes, "VIOLATION").size()) << changes;
+
+    for (auto const& l : lines(ndjson, ""))
+        EXPECT_EQ(l.rfind("{\"event\":\"", 0), 0u) << l;
+    EXPECT_EQ(lines(ndjson, "\"event\":\"violation\"").size(), lines(states, "VIOLATION").size());
+    EXPECT_EQ(lines(ndjson, "\"event\":\"final\"").size(), 3u);
+    EXPECT_NE(ndjson.find(std::string("\"event\":\"end\",\"pass\":") + (statesPass ? "true" : "false")),
+              std::string::npos) << ndjson;
+
+    std::remove(refPath.c_str());
+}
+
+TEST(Rdb, MonitorResumesFromCheckpoint)
+{
+    std::string const   spec =
+        "data a:boolean;\ndata b:boolean;\n"
+        "@inv G(a || b);\n@ev F(b);\n@resp G(b => X a);\n"
+        "@win G[0:25000](a);\n@cnt Cnt(a) <= 30;\n";
+    auto    refPath  = tmpFile("resume") + ".ref";
+    auto    ckptPath = tmpFile("resume") + ".ckpt";
+    { std::ofstream f(refPath); f << spec; }
+
+    std::string const   header = "__time__,a,b";
+    std::vector<std::string>    rows;
+    for (int k = 0; k < 40; k++)
+        rows.push_back(std::to_string(k * 1000) + "," + (k != 30 ? "true" : "false")
+                       + "," + (k % 7 == 3 ? "true" : "false"));
+    auto    stream = [&](std::size_t from, std::size_t to)
+    {
+        std::string     csv = header;
+        for (auto k = from; k < to; k++)    csv += "\n" + rows[k];
+        return csv;
+    };
+    auto    run = [&](std::string const& csv, bool& pass)
+    {
+        std::ifstream       ref(refPath);
+        std::istringstream  in(csv);
+        std::ostringstream  out;
+        pass = Referee::monitor(ref, refPath, in, "", out);
+        return out.str();
+    };
+    auto    tail = [](std::string const& text) { return text.substr(text.find("-- end of stream --")); };
+
+    bool    wholePass = false, firstPass = false, restPass = false;
+    auto    whole = run(stream(0, rows.size()), wholePass);
+
+    //  Killed after 25 rows: the last checkpoint is the one at 20, so the
+    //  producer resends from row 20 on.
+    Referee::monitorCheckpoint(ckptPath, 10);
+    run(stream(0, 25), firstPass);
+    Referee::monitorCheckpoint("", 0, ckptPath);
+    auto    rest = run(stream(20, rows.size()), restPass);
+    Referee::monitorCheckpoint("", 0);
+
+    EXPECT_NE(rest.find("-- resumed after 20 rows"), std::string::npos) << rest;
+    EXPECT_EQ(wholePass, restPass);
+    EXPECT_EQ(tail(whole), tail(rest));
+
+    //  A checkpoint is refused under another spec.
+    { std::ofstream f(refPath); f << spec << "@more G(a);\n"; }
+    Referee::monitorCheckpoint("", 0, ckptPath);
+    EXPECT_THROW(run(stream(20, rows.size()), restPass), std::runtime_error);
+    Referee::monitorCheckpoint("", 0);
+
+    std::remove(refPath.c_str());
+    std::remove(ckptPath.c_str());
+}
+
+// A bounded response keeps only the samples its open windows still need: a
+// checkpoint taken after 6000 rows is no bigger than one after 1000, and
+// resuming from it -- the trimmed buffer and where its scan had got to --
+// ends exactly as the uninterrupted run does.
+TEST(Rdb, MonitorBoundedResponseKeepsOnlyOpenWindows)
+{
+    auto    refPath  = tmpFile("brtrim") + ".ref";
+    auto    ckptPath = tmpFile("brtrim") + ".ckpt";
+    { std::ofstream f(refPath); f << "data a:boolean;\ndata b:boolean;\n@r G(a => F[0:1500](b));\n"; }
+
+    std::string const           header = "__time__,a,b";
+    std::vector<std::string>    rows;
+    for (int k = 0; k < 6000; k++)
+        rows.push_back(std::to_string(k * 100) + "," + (k % 7 < 4 ? "true" : "false")
+                       + "," + (k % 5 == 3 ? "true" : "false"));
+    auto    stream = [&](std::size_t from, std::size_t to)
+    {
+        std::string     csv = header;
+        for (auto k = from; k < to; k++)    csv += "\n" + rows[k];
+        return csv;
+    };
+    auto    run = [&](std::string const& csv, bool& pass)
+    {
+        std::ifstream       ref(refPath);
+        std::istringstream  in(csv);
+        std::ostringstream  out;
+        pass = Referee::monitor(ref, refPath, in, "", out);
+        return out.str();
+    };
+    auto    tail = [](std::string const& text) { return text.substr(text.find("-- end of stream --")); };
+
+    bool    pass = false, wholePass = false, restPass = false;
+    Referee::monitorCheckpoint(ckptPath, 1000);
+    run(stream(0, 1000), pass);
+    auto    small = std::filesystem::file_size(ckptPath);
+    auto    whole = run(stream(0, rows.size()), wholePass);
+    auto    big   = std::filesystem::file_size(ckptPath);
+    Referee::monitorCheckpoint("", 0);
+    EXPECT_TRUE(wholePass) << whole;
+    EXPECT_LT(big, small + 256) << "the samples of windows long closed were kept";
+
+    //  Killed after 1050 rows: resumed from the checkpoint at 1000.
+    Referee::monitorCheckpoint(ckptPath, 1000);
+    run(stream(0, 1050), pass);
+    Referee::monitorCheckpoint("", 0, ckptPath);
+    auto    rest = run(stream(1000, rows.size()), restPass);
+    Referee::monitorCheckpoint("", 0);
+    EXPECT_EQ(wholePass, restPass);
+    EXPECT_EQ(tail(whole), tail(rest));
+
+    std::remove(refPath.c_str());
+    std::remove(ckptPath.c_str());
+}
+
+// `--clock wall`: on a stream that goes quiet, a bounded `F` and a bounded
+// response fire at their deadlines on the host clock, not when the next row
+// finally arrives. The producer is a gated in-process stream: it sends one
+// row, goes quiet for well past both windows, then sends the next.
+TEST(Rdb, MonitorWallClockFiresDeadlinesOnQuietStream)
+{
+    struct  GatedBuf : std::streambuf
+    {
+        std::mutex              mutex;
+        std::condition_variable cv;
+        std::string             data;
+        std::size_t             at     = 0;
+        bool                    closed = false;
+        char                    ch     = 0;
+
+        void    send(std::string const& s, bool last = false)
+        {
+            std::lock_guard<std::mutex>     lock(mutex);
+            data  += s;
+            closed = last;
+            cv.notify_all();
+        }
+        int_type    underflow() override
+        {
+            std::unique_lock<std::mutex>    lock(mutex);
+            cv.wait(lock, [&] { return at < data.size() || closed; });
+            if (at >= data.size())  return traits_type::eof();
+            ch = data[at++];
+            setg(&ch, &ch, &ch + 1);
+            return traits_type::to_int_type(ch);
+        }
+    };
+
+    std::string const   spec =
+        "data req:boolean;\ndata ack:boolean;\n"
+        "@ack F[0:200](ack);\n@resp G(req => F[0:300](ack));\n";
+    auto    refPath = tmpFile("wall") + ".ref";
+    { std::ofstream f(refPath); f << spec; }
+
+    auto    run = [&](std::string const& clock)
+    {
+        Referee::monitorClock(clock, "1ms");
+        GatedBuf        buf;
+        std::istream    in(&buf);
+        std::thread     producer([&]
+        {
+            buf.send("__time__,req,ack\n0,true,false\n");
+            std::this_thread::sleep_for(std::chrono::milliseconds(700));
+            buf.send("1000,false,true\n", true);
+        });
+        std::ifstream       ref(refPath);
+        std::ostringstream  out;
+        bool                pass = Referee::monitor(ref, refPath, in, "", out);
+        producer.join();
+        Referee::monitorClock("stream");
+        EXPECT_FALSE(pass);
+        return out.str();
+    };
+
+    auto    wall   = run("wall");
+    auto    stream = run("stream");
+    auto    row    = wall.find("__time__=1000");
+    ASSERT_NE(row, std::string::npos) << wall;
+    EXPECT_LT(wall.find("VIOLATION  ack  @ __time__=200"), row) << wall;
+    EXPECT_LT(wall.find("VIOLATION  resp  @ __time__=300"), row) << wall;
+    EXPECT_NE(stream.find("VIOLATION  ack  @ __time__=1000"), std::string::npos) << stream;
+    EXPECT_EQ(wall.substr(wall.find("-- end of stream --")),
+              stream.substr(stream.find("-- end of stream --")));
+
+    std::remove(refPath.c_str());
+}
+
+// `--flush-ms` holds output to flush it in batches, but never past its
+// deadline and never a violation: on a stream that goes quiet, a violation
+// is seen at once and the held state line by the deadline, both long before
+// the stream ends. Flushes are what `visible` records.
+TEST(Rdb, MonitorFlushMsBoundsHeldOutput)
+{
+    struct  GatedBuf : std::streambuf
+    {
+        std::mutex              mutex;
+        std::condition_variable cv;
+        std::string             data;
+        std::size_t             at     = 0;
+        bool                    closed = false;
+        char                    ch     = 0;
+
+        void    send(std::string const& s, bool last = false)
+        {
+            std::lock_guard<std::mutex>     lock(mutex);
+            data  += s;
+            closed = last;
+            cv.notify_all();
+        }
+        int_type    underflow() override
+        {
+            std::unique_lock<std::mutex>    lock(mutex);
+            cv.wait(lock, [&] { return at < data.size() || closed; });
+            if (at >= data.size())  return traits_type::eof();
+            ch = data[at++];
+            setg(&ch, &ch, &ch + 1);
+            return traits_type::to_int_type(ch);
+        }
+    };
+    struct  SyncedBuf : std::stringbuf
+    {
+        std::mutex      mutex;
+        std::string     visible;
+
+        int     sync() override
+        {
+            std::lock_guard<std::mutex>     lock(mutex);
+            visible = str();
+            return 0;
+        }
+        bool    shows(std::string const& what, std::chrono::milliseconds within)
+        {
+            auto    until = std::chrono::steady_clock::now() + within;
+            do
+            {
+                {
+                    std::lock_guard<std::mutex>     lock(mutex);
+                    if (visible.find(what) != std::string::npos)    return true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            while (std::chrono::steady_clock::now() < until);
+            return false;
+        }
+    };
+
+    auto    refPath = tmpFile("flushms") + ".ref";
+    { std::ofstream f(refPath); f << "data a:boolean;\n@inv G(a);\n"; }
+
+    Referee::monitorOutput("states", 2000);
+    GatedBuf        inBuf;
+    SyncedBuf       outBuf;
+    std::istream    in(&inBuf);
+    std::ostream    out(&outBuf);
+    std::thread     producer([&]
+    {
+        inBuf.send("__time__,a\n0,true\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        inBuf.send("1000,false\n");
+        EXPECT_TRUE(outBuf.shows("VIOLATION  inv  @ __time__=1000", std::chrono::milliseconds(1000)));
+        EXPECT_TRUE(outBuf.shows("__time__=1000  inv=", std::chrono::milliseconds(5000)));
+        inBuf.send("2000,true\n", true);
+    });
+    std::ifstream   ref(refPath);
+    bool            pass = Referee::monitor(ref, refPath, in, "", out);
+    producer.join();
+    Referee::monitorOutput("states");
+
+    EXPECT_FALSE(pass);
+    EXPECT_NE(outBuf.str().find("-- end of stream --"), std::string::npos) << outBuf.str();
+
+    std::remove(refPath.c_str());
+}
+
+// `--clock wall --stop-at-first` on a pipe whose writer stays open but says
+// nothing more: the deadline fires, and the monitor returns with its reader
+// thread joined -- the blocked read interrupted, not left behind reading a
+// stream the caller is about to destroy.
+TEST(Rdb, MonitorWallClockStopsOnAQuietPipe)
+{
+    auto    refPath = tmpFile("quiet") + ".ref";
+    { std::ofstream f(refPath); f << "data ack:boolean;\n@ack F[0:100](ack);\n"; }
+
+    int     fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    std::string const   rows = "__time__,ack\n0,false\n";
+    ASSERT_EQ(::write(fds[1], rows.data(), rows.size()), static_cast<ssize_t>(rows.size()));
+
+    Referee::monitorClock("wall", "1ms");
+    bool    pass = true;
+    {
+        referee::db::LiveInput  live(fds[0]);
+        std::istream            in(&live);
+        std::ifstream           ref(refPath);
+        std::ostringstream      out;
+        pass = Referee::monitor(ref, refPath, in, "", out, true);
+        EXPECT_NE(out.str().find("VIOLATION  ack  @ __time__=100"), std::string::npos) << out.str();
+
+        //  Interrupted, the input reads as ended from then on.
+        std::string     line;
+        EXPECT_FALSE(std::getline(in, line));
+    }
+    Referee::monitorClock("stream");
+    EXPECT_FALSE(pass);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+    std::remove(refPath.c_str());
+}
+
+// `--input` on a Unix socket: the monitor connects to the producer listening
+// there and reads what it writes until it closes, exactly as it would the same
+// rows on stdin.
+TEST(Rdb, MonitorInputConnectsToAUnixSocket)
+{
+    auto    refPath  = tmpFile("sock") + ".ref";
+    auto    sockPath = tmpFile("sock") + ".sock";
+    { std::ofstream f(refPath); f << "data a:boolean;\ndata b:boolean;\n@inv G(a || b);\n@ev F(b);\n"; }
+
+    std::string     csv = "__time__,a,b";
+    for (int k = 0; k < 40; k++)
+        csv += "\n" + std::to_string(k * 1000) + "," + ((k % 7) != 3 ? "true" : "false")
+             + "," + ((k % 5) == 0 ? "true" : "false");
+    csv += "\n";
+
+    std::istringstream  plainIn(csv);
+    std::ifstream       refA(refPath);
+    std::ostringstream  plainOut;
+    bool                plainPass = Referee::monitor(refA, refPath, plainIn, "", plainOut);
+
+    std::remove(sockPath.c_str());
+    int             listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_un     addr{};
+    addr.sun_family = AF_UNIX;
+    ASSERT_LT(sockPath.size(), sizeof(addr.sun_path));
+    std::memcpy(addr.sun_path, sockPath.c_str(), sockPath.size() + 1);
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(::listen(listener, 1), 0);
+
+    std::thread     producer([&]
+    {
+        int     fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0)     return;
+        for (std::size_t at = 0; at < csv.size(); )
+        {
+            auto    n = ::write(fd, csv.data() + at, std::min<std::size_t>(97, csv.size() - at));
+            if (n <= 0)     break;
+            at += static_cast<std::size_t>(n);
+        }
+        ::close(fd);
+    });
+
+    bool                sockPass = true;
+    std::ostringstream  sockOut;
+    {
+        referee::db::LiveInput  live(sockPath);
+        std::istream            in(&live);
+        std::ifstream           refB(refPath);
+        sockPass = Referee::monitor(refB, refPath, in, "", sockOut);
+    }
+    producer.join();
+    ::close(listener);
+
+    EXPECT_EQ(sockPass, plainPass);
+    EXPECT_EQ(sockOut.str(), plainOut.str());
+    EXPECT_NE(sockOut.str().find("VIOLATION"), std::string::npos) << sockOut.str();
+
+    std::remove(refPath.c_str());
+    std::remove(sockPath.c_str());
+}
+
+// Requirements sharing predicates read them from the module's one table of
+// atomic propositions (`__ap__eval__`), each through its own index map. Each
+// requirement's closing verdict in the combined monitor must be exactly what a
+// monitor of that requirement alone reports -- a map pointing one slot off
+// would not survive the mix of shared, reordered and private atoms here.
+TEST(Rdb, MonitorSharedAtomsAgreeWithEachAlone)
+{
+    std::string const   decl = "data door:boolean;\ndata alarm:boolean;\ndata armed:boolean;\n";
+    std::vector<std::string> const  reqs = {
+        "@r1 G(door => F(alarm));\n",
+        "@r2 G(alarm => Ys(1, door));\n",
+        "@r3 G(armed && door => Xs(alarm));\n",
+        "@r4 Us(!alarm, door);\n",
+        "@r5 G(door => F[0:2000](alarm));\n",
+        "@r6 G(armed => (door || !alarm));\n",
+    };
+
+    std::string     csv = "__time__,door,alarm,armed";
+    for (int k = 0; k < 30; k++)
+        csv += "\n" + std::to_string(k * 500) + "," + ((k % 4) == 1 ? "true" : "false")
+             + "," + ((k % 5) == 2 || (k % 4) == 2 ? "true" : "false")
+             + "," + ((k % 7) < 5 ? "true" : "false");
+
+    auto    closing = [&](std::string const& spec)
+    {
+        auto    refPath = tmpFile("shared-ap") + ".ref";
+        { std::ofstream f(refPath); f << spec; }
+        std::ifstream       ref(refPath);
+        std::istringstream  in(csv);
+        std::ostringstream  out;
+        Referee::monitor(ref, refPath, in, "", out);
+        std::remove(refPath.c_str());
+        auto    text = out.str();
+        return text.substr(text.find("-- end of stream --"));
+    };
+
+    std::string     all = decl;
+    for (auto const& r : reqs)  all += r;
+    auto            combined = closing(all);
+    for (auto const& r : reqs)
+    {
+        auto    alone = closing(decl + r);
+        auto    line  = alone.substr(alone.find('\n') + 1);
+        line = line.substr(0, line.find('\n') + 1);
+        EXPECT_NE(combined.find(line), std::string::npos) << r << "alone:\n" << alone << "combined:\n" << combined;
+    }
+}
+
+// `monitor --source`: live sources merged online must hand the monitor the
+// states `rdb merge` builds from the same sources recorded -- here a file and
+// a FIFO written a row at a time. A source lagging past the reorder bound is
+// passed over, and its late sample held from the next merged state on.
+TEST(Rdb, MonitorMergesLiveSourcesAsRdbMergeWould)
+{
+    using referee::db::LeadingGap;
+    using referee::db::Overlap;
+
+    std::string const   spec =
+        "data door:boolean;\ndata alarm:boolean;\ndata level:integer;\n"
+        "@inv G(door => level < 5);\n@resp G(door => F[0:3000](alarm));\n";
+    auto    refPath  = tmpFile("live") + ".ref";
+    auto    aPath    = tmpFile("live-a") + ".csv";
+    auto    fifoPath = tmpFile("live-b");
+    { std::ofstream f(refPath); f << spec; }
+
+    std::string     a = "__time__,door,level\n";
+    std::string     b = "__time__,alarm\n";
+    for (int k = 0; k < 10; k++)
+        a += std::to_string(k * 1000) + "," + (k % 3 == 1 ? "true" : "false") + "," + std::to_string(k % 6) + "\n";
+    for (int k = 0; k < 7; k++)
+        b += std::to_string(k * 1500 + 500) + "," + (k % 2 ? "true" : "false") + "\n";
+    { std::ofstream f(aPath); f << a; }
+
+    std::istringstream  aIn(a), bIn(b);
+    auto                aDoc = loader::Row::open(aIn, "a.csv");
+    auto                bDoc = loader::Row::open(bIn, "b.csv");
+    std::istringstream  offIn(referee::db::mergeTraces({aDoc.get(), bDoc.get()},
+                                                       LeadingGap::Trim, Overlap::Error));
+    std::ifstream       refOff(refPath);
+    std::ostringstream  offOut;
+    bool                offPass = Referee::monitor(refOff, refPath, offIn, "", offOut);
+
+    std::remove(fifoPath.c_str());
+    ASSERT_EQ(::mkfifo(fifoPath.c_str(), 0600), 0);
+    std::thread         writer([&]
+    {
+        std::ofstream       f(fifoPath);
+        std::istringstream  lines(b);
+        for (std::string l; std::getline(lines, l); )
+        {
+            f << l << "\n" << std::flush;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+    referee::db::SourceMerge    merged({aPath, fifoPath}, LeadingGap::Trim, Overlap::Error);
+    std::istream                liveIn(&merged);
+    std::ifstream               refLive(refPath);
+    std::ostringstream          liveOut;
+    bool                        livePass = Referee::monitor(refLive, refPath, liveIn, "", liveOut);
+    writer.join();
+
+    EXPECT_EQ(offPass, livePass);
+    EXPECT_EQ(offOut.str(), liveOut.str());
+    EXPECT_NE(liveOut.str().find("VIOLATION"), std::string::npos) << liveOut.str();
+    EXPECT_EQ(merged.late(), 0u);
+
+    //  Source 1 says nothing while source 0 runs ahead: past two held rows
+    //  the oldest is merged without it, and its sample for 5, arriving after
+    //  10 was merged, holds from 20 on.
+    referee::db::LiveMerge  m(2, LeadingGap::Zero, Overlap::Error, 2);
+    for (auto const& l : {"__time__,x", "0,1", "10,2", "20,3", "30,4"})
+        m.push(0, l);
+    for (auto const& l : {"__time__,y", "5,7", "25,8"})
+        m.push(1, l);
+    m.close(0);
+    m.close(1);
+
+    std::string     rows;
+    for (std::string l; m.pop(l); )
+        rows += l + "\n";
+    EXPECT_EQ(rows, "__time__,x,y\n0,1,\n10,2,\n20,3,7\n25,3,8\n30,4,8\n");
+    EXPECT_EQ(m.late(), 1u);
+
+    std::remove(refPath.c_str());
+    std::remove(aPath.c_str());
+    std::remove(fifoPath.c_str());
+}
+
+// `monitor --threads`: ingest, evaluation and reporting pipelined across
+// threads must print what the one-thread loop prints, byte for byte -- the
+// same violations in the same order, the same verdict lines -- whether the
+// stream runs to its end or stops at the first violation, and whether it
+// arrives as CSV or as `--binary` frames.
+TEST(Rdb, MonitorThreadsAgreeWithSerial)
+{
+    std::string const   spec =
+        "data a:boolean;\ndata b:boolean;\ndata c:boolean;\n"
+        "@inv G(a || b);\n@ev F(c);\n@resp G(a => F[0:3000](b));\n"
+        "@win G[0:40000](a || c);\n@nxt G(b => X(a || c));\n@cnt Cnt(a && !b) <= 50;\n";
+    auto    refPath = tmpFile("threads") + ".ref";
+    { std::ofstream f(refPath); f << spec; }
+
+    std::string     csv = "__time__,a,b,c";
+    for (int k = 0; k < 200; k++)
+        csv += "\n" + std::to_string(k * 1000) + "," + ((k % 9) != 4 ? "true" : "false")
+             + "," + ((k % 5) == 0 || (k % 7) == 3 ? "true" : "false")
+             + "," + ((k % 11) == 6 ? "true" : "false");
+
+    //  One compiled spec for every run, so the two paths are checked against
+    //  the very same requirements and pools.
+    std::ifstream       ref(refPath);
+    Monitor             monitor(ref, refPath, "");
+    auto    run = [&](unsigned threads, bool stopAtFirst, bool& pass)
+    {
+        Referee::monitorThreads(threads);
+        std::istringstream  in(csv);
+        std::ostringstream  out;
+        pass = monitor.run(in, out, stopAtFirst);
+        Referee::monitorThreads(0);
+        return out.str();
+    };
+
+    for (bool stopAtFirst : {false, true})
+    {
+        bool    serialPass = false;
+        auto    serial     = run(0, stopAtFirst, serialPass);
+        EXPECT_NE(serial.find("VIOLATION"), std::string::npos);
+        for (unsigned threads : {1u, 3u, 8u})
+        {
+            bool    pass = true;
+            EXPECT_EQ(run(threads, stopAtFirst, pass), serial) << threads << " threads";
+            EXPECT_EQ(pass, serialPass);
+        }
+    }
+
+    Referee::monitorThreads(3, true);
+    std::istringstream  in(csv);
+    std::ostringstream  out;
+    monitor.run(in, out);
+    Referee::monitorThreads(0);
+    EXPECT_NE(out.str().find("-- latency: 200 rows, p50 "), std::string::npos) << out.str();
+
+    //  The same states framed: the pipeline takes each frame off the reader
+    //  without an ingest, and must still print what the CSV serial run does.
+    auto    csvPath = tmpFile("threads-csv") + ".csv";
+    auto    frmPath = tmpFile("threads-bin");
+    { std::ofstream f(csvPath); f << csv << "\n"; }
+    referee::db::frames(refPath, csvPath, frmPath);
+
+    bool    csvPass = false;
+    auto    csvOut  = run(0, false, csvPass);
+    Referee::monitorBinary(true);
+    for (unsigned threads : {0u, 3u, 8u})
+    {
+        Referee::monitorThreads(threads);
+        std::ifstream       in(frmPath, std::ios::binary);
+        std::ostringstream  binOut;
+        EXPECT_EQ(monitor.run(in, binOut), csvPass) << threads << " threads";
+        Referee::monitorThreads(0);
+        EXPECT_EQ(binOut.str(), csvOut) << threads << " threads";
+    }
+    Referee::monitorBinary(false);
+
+    std::remove(refPath.c_str());
+    std::remove(csvPath.c_str());
+    std::remove(frmPath.c_str());
+}
+
+// A residual requirement's hash-consed table is bounded by the states the
+// stream visits, not by its length: over a periodic stream it fills within the
+// first periods and then stays put, however many more periods follow, while
+// the verdicts still agree with the offline checker. `win` holds a bounded `F`,
+// whose anchored windows are rebuilt each step rather than cached; they must
+// not grow the table either. `resp`, the bare bounded response, has a lane of
+// its own and no table at all.
+TEST(Rdb, MonitorResidualTableStopsGrowing)
+{
+    std::string const   spec =
+        "data a:boolean;\ndata b:boolean;\ndata c:boolean;\n"
+        "@rec G(F(a) => F(b));\n@nest G(a => Us(b, c));\n"
+        "@win G(a => (F[0:2500](b) || c));\n@resp G(a => F[0:2500](b));\n";
+    auto    refPath = tmpFile("table") + ".ref";
+    { std::ofstream f(refPath); f << spec; }
+
+    auto    periods = [](int n)
+    {
+        std::string     csv = "__time__,a,b,c";
+        for (int k = 0; k < 12 * n; k++)
+            csv += "\n" + std::to_string(k * 1000) + "," + ((k % 3) == 0 ? "true" : "false")
+                 + "," + ((k % 4) == 1 ? "true" : "false")
+                 + "," + ((k % 6) == 2 ? "true" : "false");
+        return csv;
+    };
+
+    std::ifstream       ref(refPath);
+    Monitor             monitor(ref, refPath, "");
+    auto    run = [&](int n)
+    {
+        auto    csv     = periods(n);
+        auto    csvPath = tmpFile("table-csv") + ".csv";
+        { std::ofstream f(csvPath); f << csv << "\n"; }
+        auto                rdbPath = tmpFile("table-rdb");
+        referee::db::ingest(refPath, csvPath, /*conf=*/"", rdbPath);
+        std::ifstream       refA(refPath);
+        std::ostringstream  offOut;
+        bool                offline = Referee::executeRdb(refA, refPath, rdbPath, offOut);
+        std::remove(rdbPath.c_str());
+        std::remove(csvPath.c_str());
+
+        std::istringstream  in(csv);
+        std::ostringstream  out;
+        EXPECT_EQ(monitor.run(in, out), offline)
+            << n << " periods\noffline:\n" << offOut.str() << "\nmonitor:\n" << out.str();
+    };
+
+    run(4);
+    auto    rec  = monitor.table("rec");
+    auto    nest = monitor.table("nest");
+    EXPECT_GT(rec.nodes, 0u);
+    EXPECT_GT(rec.steps, 0u);
+    EXPECT_GT(nest.nodes, 0u);
+    auto    win  = monitor.table("win");
+    EXPECT_GT(win.nodes, 0u);
+    EXPECT_EQ(monitor.lanes().at("win"),  "residual");
+    EXPECT_EQ(monitor.lanes().at("resp"), "response");
+    EXPECT_EQ(monitor.table("resp").nodes, 0u);
+
+    for (int n : {8, 16})
+    {
+        run(n);
+        EXPECT_EQ(monitor.table("rec").nodes,  rec.nodes)  << n << " periods";
+        EXPECT_EQ(monitor.table("rec").steps,  rec.steps)  << n << " periods";
+        EXPECT_EQ(monitor.table("nest").nodes, nest.nodes) << n << " periods";
+        EXPECT_EQ(monitor.table("nest").steps, nest.steps) << n << " periods";
+        EXPECT_EQ(monitor.table("win").nodes,  win.nodes)  << n << " periods";
+        EXPECT_EQ(monitor.table("win").steps,  win.steps)  << n << " periods";
+    }
+    EXPECT_EQ(monitor.table("no-such").nodes, 0u);
+
+    std::remove(refPath.c_str());
+}
+
 // The atom fast path (all requirements single-state atoms: invariants and an
 // eventually) must agree with the offline checker. This exercises the O(1)
 // per-state route -- ingest one row, call `__atom__`, fold a latch -- rather
@@ -1270,6 +2316,144 @@ TEST(Rdb, CsvAndYamlAgree)
     std::remove(rdbYml.c_str());
 }
 
+// `rdb merge` packs typed: a signal's blob comes straight from the source row
+// it holds -- a `.rdb`'s own blob, or its cells loaded -- with no merged CSV in
+// between. The `.rdb` must be the one the text merge packs, byte for byte, in
+// every leading-gap mode; a signal split between sources still merges, through
+// text.
+TEST(Rdb, TypedMergeMatchesTextMerge)
+{
+    using referee::db::LeadingGap;
+    using referee::db::Overlap;
+
+    std::string const   spec =
+        "type K : enum { A, B, C };\n"
+        "data k : K;\ndata s : string;\ndata p : struct { x : integer; y : number; };\n"
+        "data n : number;\ndata arr : integer[3];\ndata e : boolean;\n"
+        "conf lim : integer;\n"
+        "G(n < lim);\n";
+    std::string const   srcSpec = "data n : number;\ndata arr : integer[3];\nG(n >= 0);\n";
+    std::string const   a = "__time__,k,s,p.x,p.y\n10,B,\"x,y\",1,0.5\n40,C,plain,2,0.25\n25,A,\"q\"\"\",3,1e-3\n";
+    std::string const   b = "__time__,n,arr[0],arr[1],arr[2]\n0,1.5,1,2,3\n25,2.75,4,5,6\n25,3.125,7,8,9\n60,0.1,0,0,0\n";
+    std::string const   c = "__time__,e,junk\n5,true,1\n40,false,2\n";
+    std::string const   conf = "lim\n10\n";
+
+    //  The middle source as a `.rdb`.
+    std::ostringstream  packed;
+    {
+        std::istringstream  ref(srcSpec), data(b);
+        referee::db::ingest(ref, "src.ref", data, "b.csv", nullptr, "", packed);
+    }
+    auto                bytes = packed.str();
+    referee::db::Reader rdb(std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+
+    auto    merged = [&](std::string const& first, std::string const& last, LeadingGap leading)
+    {
+        std::istringstream                  aIn(first), cIn(last);
+        auto                                aDoc = loader::Row::open(aIn, "a.csv");
+        auto                                cDoc = loader::Row::open(cIn, "c.csv");
+        std::vector<referee::db::MergeSource>   sources;
+        sources.emplace_back(*aDoc);
+        sources.emplace_back(rdb);
+        sources.emplace_back(*cDoc);
+
+        std::istringstream  ref(spec), confIn(conf);
+        std::ostringstream  out;
+        referee::db::merge(ref, "merge.ref", sources, &confIn, "conf.csv", leading, Overlap::Error, out);
+        return out.str();
+    };
+    auto    text   = [&](std::string const& first, std::string const& last, LeadingGap leading)
+    {
+        std::istringstream  aIn(first), cIn(last);
+        std::stringstream   bCsv;
+        referee::db::toCsv(rdb, bCsv);
+        auto                aDoc = loader::Row::open(aIn, "a.csv");
+        auto                bDoc = loader::Row::open(bCsv, "b.csv");
+        auto                cDoc = loader::Row::open(cIn, "c.csv");
+
+        std::istringstream  ref(spec), confIn(conf);
+        std::istringstream  data(referee::db::mergeTraces({aDoc.get(), bDoc.get(), cDoc.get()},
+                                                          leading, Overlap::Error));
+        std::ostringstream  out;
+        referee::db::ingest(ref, "merge.ref", data, "merged.csv", &confIn, "conf.csv", out);
+        return out.str();
+    };
+
+    for (auto leading : {LeadingGap::Trim, LeadingGap::Zero, LeadingGap::Backfill})
+        EXPECT_EQ(merged(a, c, leading), text(a, c, leading)) << int(leading);
+
+    //  `p.y` moves to the last source: `p` is assembled from two, by column.
+    std::string const   aSplit = "__time__,k,s,p.x\n10,B,one,1\n40,C,two,2\n";
+    std::string const   cSplit = "__time__,e,p.y\n5,true,0.5\n40,false,1.5\n";
+    EXPECT_EQ(merged(aSplit, cSplit, LeadingGap::Zero), text(aSplit, cSplit, LeadingGap::Zero));
+}
+
+//  `--stream` reads the same sorted sources from disk -- a CSV a record at a
+//  time, a `.rdb` through its mapping -- and must decode to the same trace. The
+//  bytes differ: appended rows intern their strings in row order.
+TEST(Rdb, StreamingMergeMatchesTypedMerge)
+{
+    using referee::db::LeadingGap;
+    using referee::db::Overlap;
+
+    std::string const   spec =
+        "data s : string;\ndata p : struct { x : integer; y : number; };\n"
+        "data n : number;\ndata arr : integer[3];\nG(n >= 0);\n";
+    std::string const   srcSpec = "data n : number;\ndata arr : integer[3];\nG(n >= 0);\n";
+    std::string const   a = "__time__,s,p.x,p.y\n10,\"x,y\",1,0.5\n25,\"q\"\"\",3,1e-3\n40,plain,2,0.25\n";
+    std::string const   b = "__time__,n,arr[0],arr[1],arr[2]\n0,1.5,1,2,3\n25,2.75,4,5,6\n25,3.125,7,8,9\n60,0.1,0,0,0\n";
+
+    auto    aPath = tmpFile("stream-a") + ".csv";
+    auto    bPath = tmpFile("stream-b") + ".rdb";
+    std::ofstream(aPath) << a;
+    {
+        std::istringstream  ref(srcSpec), data(b);
+        std::ofstream       out(bPath, std::ios::binary);
+        referee::db::ingest(ref, "src.ref", data, "b.csv", nullptr, "", out);
+    }
+
+    auto    decoded = [](std::string const& bytes)
+    {
+        referee::db::Reader rdb(std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+        std::ostringstream  os;
+        referee::db::toCsv(rdb, os);
+        return os.str() + std::to_string(rdb.time(0)) + "," + std::to_string(rdb.time(rdb.numStates() - 1));
+    };
+    auto    streamed = [&](std::string const& first, LeadingGap leading)
+    {
+        std::vector<referee::db::StreamSource>  sources;
+        sources.emplace_back(first);
+        sources.emplace_back(bPath);
+        std::istringstream  ref(spec);
+        std::ostringstream  out;
+        referee::db::merge(ref, "merge.ref", sources, nullptr, "", leading, Overlap::Error, out);
+        return out.str();
+    };
+
+    referee::db::Reader rdb(bPath);
+    for (auto leading : {LeadingGap::Trim, LeadingGap::Zero, LeadingGap::Backfill})
+    {
+        std::istringstream                      aIn(a);
+        auto                                    aDoc = loader::Row::open(aIn, "a.csv");
+        std::vector<referee::db::MergeSource>   sources;
+        sources.emplace_back(*aDoc);
+        sources.emplace_back(rdb);
+        std::istringstream  ref(spec);
+        std::ostringstream  out;
+        referee::db::merge(ref, "merge.ref", sources, nullptr, "", leading, Overlap::Error, out);
+        EXPECT_EQ(decoded(streamed(aPath, leading)), decoded(out.str())) << int(leading);
+    }
+
+    //  A source out of time order cannot be streamed.
+    std::ofstream(aPath) << "__time__,s,p.x,p.y\n10,x,1,0.5\n5,y,2,0.25\n";
+    EXPECT_THROW(streamed(aPath, LeadingGap::Zero), std::runtime_error);
+
+    std::remove(aPath.c_str());
+    std::remove(bPath.c_str());
+    std::remove(aPath.substr(0, aPath.size() - 4).c_str());
+    std::remove(bPath.substr(0, bPath.size() - 4).c_str());
+}
+
 // Phase 5 — dump should produce the schema, conf, and per-state rows.
 TEST(Rdb, DumpHasSchemaAndStates)
 {
@@ -1363,6 +2547,226 @@ TEST(Rdb, SingleStateHasThreeRows)
     std::remove(path.c_str());
 }
 
+// An appended file reads back as the batch-written one, and a file cut short
+// of its footer still opens up to its last complete block.
+TEST(Rdb, AppendedWriterReadsBackWhenCut)
+{
+    TypeInteger tInt;
+    std::vector<referee::db::PropDecl> props = {{"x", &tInt}};
+
+    auto makeIntBlob = [](std::int64_t v) {
+        std::vector<std::uint8_t>   b(8);
+        std::memcpy(b.data(), &v, sizeof(v));
+        return b;
+    };
+
+    std::vector<std::int64_t>   times = {9, 10, 20, 30, 40, 50, 51};
+    auto path = tmpFile("appended");
+    std::streamoff  cut = 0;
+    {
+        std::ofstream os(path, std::ios::binary);
+        referee::db::Writer w(os);
+        w.setSchema(props, {});
+        w.setConfBlob({});
+        w.setBlockRows(2);
+        for (size_t i = 0; i < times.size(); i++)
+        {
+            w.appendState(times[i], {makeIntBlob(std::int64_t(i) * 7)});
+            if (i == 3)
+                cut = os.tellp();   // two full blocks are out
+        }
+        w.finish();
+    }
+
+    {
+        referee::db::Reader r(path);
+        ASSERT_EQ(r.numStates(), times.size());
+        for (size_t i = 0; i < times.size(); i++)
+        {
+            EXPECT_EQ(r.time(i), times[i]);
+            std::int64_t    v;
+            std::memcpy(&v, r.propBlob(i, 0), sizeof(v));
+            EXPECT_EQ(v, std::int64_t(i) * 7);
+        }
+    }
+
+    //  Partway into the third block: the first four rows survive, and a
+    //  closing sentinel stands in for the one the writer never wrote.
+    std::filesystem::resize_file(path, cut + 20);
+    {
+        referee::db::Reader r(path);
+        ASSERT_EQ(r.numStates(), 5u);
+        EXPECT_EQ(r.time(3), 30);
+        EXPECT_EQ(r.time(4), 31);
+        std::int64_t    v;
+        std::memcpy(&v, r.propBlob(3, 0), sizeof(v));
+        EXPECT_EQ(v, 21);
+    }
+
+    std::remove(path.c_str());
+}
+
+// A value repeated within the last few distinct ones of its prop is stored
+// once and shared, and its strings still resolve for every row holding it.
+TEST(Rdb, WriterSharesRepeatedValues)
+{
+    TypeString  tStr;
+    TypeInteger tInt;
+    std::vector<referee::db::PropDecl> props = {{"mode", &tStr}, {"n", &tInt}};
+
+    auto makeStrBlob = [](char const* v) {
+        std::vector<std::uint8_t>   b(8);
+        char const* p = Strings::instance()->getString(v);
+        std::memcpy(b.data(), &p, sizeof(p));
+        return b;
+    };
+    auto makeIntBlob = [](std::int64_t v) {
+        std::vector<std::uint8_t>   b(8);
+        std::memcpy(b.data(), &v, sizeof(v));
+        return b;
+    };
+
+    std::vector<char const*>    modes = {"", "idle", "idle", "run", "idle", ""};
+    auto path = tmpFile("shared");
+    {
+        std::ofstream os(path, std::ios::binary);
+        referee::db::Writer w(os);
+        w.setSchema(props, {});
+        w.setNumStates(modes.size());
+        w.setConfBlob({});
+        for (size_t i = 0; i < modes.size(); i++)
+            w.writeState(i, std::int64_t(i), {makeStrBlob(modes[i]), makeIntBlob(std::int64_t(i))});
+        w.finish();
+    }
+
+    referee::db::Reader r(path);
+    for (size_t i = 0; i < modes.size(); i++)
+    {
+        char const* sv = nullptr;
+        std::memcpy(&sv, r.propBlob(i, 0), sizeof(sv));
+        EXPECT_STREQ(sv, modes[i]);
+        std::int64_t    iv;
+        std::memcpy(&iv, r.propBlob(i, 1), sizeof(iv));
+        EXPECT_EQ(iv, std::int64_t(i));
+    }
+    EXPECT_EQ(r.propBlob(1, 0), r.propBlob(2, 0));
+    EXPECT_EQ(r.propBlob(1, 0), r.propBlob(4, 0));
+    EXPECT_EQ(r.propBlob(0, 0), r.propBlob(5, 0));
+    EXPECT_NE(r.propBlob(3, 0), r.propBlob(4, 0));
+    EXPECT_NE(r.propBlob(1, 1), r.propBlob(2, 1));
+
+    std::remove(path.c_str());
+}
+
+// A mapped reader leaves the rows as the file's offsets and resolves them as
+// they are read; it has to hand out exactly what the copying reader does, and
+// `ptrFirst` has to be the table the copying reader fixed up in place.
+TEST(Rdb, MappedReaderAgreesWithCopy)
+{
+    TypeString  tStr;
+    TypeInteger tInt;
+    std::vector<referee::db::PropDecl> props = {{"mode", &tStr}, {"n", &tInt}};
+
+    auto makeStrBlob = [](char const* v) {
+        std::vector<std::uint8_t>   b(8);
+        char const* p = Strings::instance()->getString(v);
+        std::memcpy(b.data(), &p, sizeof(p));
+        return b;
+    };
+    auto makeIntBlob = [](std::int64_t v) {
+        std::vector<std::uint8_t>   b(8);
+        std::memcpy(b.data(), &v, sizeof(v));
+        return b;
+    };
+
+    std::vector<char const*>    modes = {"", "idle", "idle", "run", "idle", ""};
+    auto path = tmpFile("mapped");
+    {
+        std::ofstream os(path, std::ios::binary);
+        referee::db::Writer w(os);
+        w.setSchema(props, {});
+        w.setNumStates(modes.size());
+        w.setConfBlob({});
+        for (size_t i = 0; i < modes.size(); i++)
+            w.writeState(i, std::int64_t(i), {makeStrBlob(modes[i]), makeIntBlob(std::int64_t(i) / 2)});
+        w.finish();
+    }
+
+    referee::db::Reader r(path);
+    auto    m = referee::db::Reader::map(path);
+    ASSERT_EQ(m->numStates(), r.numStates());
+    auto*   table = static_cast<std::uint8_t const*>(m->ptrFirst());
+    auto*   fixed = static_cast<std::uint8_t const*>(r.ptrFirst());
+    for (size_t i = 0; i < modes.size(); i++)
+    {
+        EXPECT_EQ(m->time(i), r.time(i));
+        for (size_t p = 0; p < props.size(); p++)
+        {
+            EXPECT_EQ(m->blob(i, p), r.blob(i, p));
+
+            void const* row = nullptr;
+            std::memcpy(&row, table + i * m->rowBytes() + 8 + 8 * p, sizeof(row));
+            EXPECT_EQ(row, m->propBlob(i, p));
+        }
+        char const* sv = nullptr;
+        std::memcpy(&sv, m->propBlob(i, 0), sizeof(sv));
+        EXPECT_EQ(sv, Strings::instance()->getString(modes[i]));
+        EXPECT_EQ(std::memcmp(table + i * m->rowBytes(), fixed + i * r.rowBytes(), 8), 0);
+    }
+    EXPECT_EQ(m->propBlob(1, 0), m->propBlob(4, 0));
+    EXPECT_EQ(static_cast<std::uint8_t const*>(m->ptrLast()),
+              table + (m->numStates() - 1) * m->rowBytes());
+
+    //  A prop left out is not resolved, and reads as null.
+    auto    n = referee::db::Reader::map(path, {"n"});
+    EXPECT_EQ(n->propBlob(1, 0), nullptr);
+    EXPECT_EQ(n->blob(3, 1), r.blob(3, 1));
+
+    std::remove(path.c_str());
+}
+
+// A packed block stores a held value once: the rows holding it share a blob,
+// and its strings are resolved once, not once per row.
+TEST(Rdb, PackedBlocksShareHeldValues)
+{
+    TypeString  tStr;
+    std::vector<referee::db::PropDecl> props = {{"mode", &tStr}};
+
+    auto makeStrBlob = [](char const* v) {
+        std::vector<std::uint8_t>   b(8);
+        char const* p = Strings::instance()->getString(v);
+        std::memcpy(b.data(), &p, sizeof(p));
+        return b;
+    };
+
+    std::vector<char const*>    modes = {"", "idle", "idle", "run", "run", "run", ""};
+    auto path = tmpFile("packed");
+    {
+        std::ofstream os(path, std::ios::binary);
+        referee::db::Writer w(os);
+        w.setSchema(props, {});
+        w.setConfBlob({});
+        w.setBlockCodec(referee::db::BlockCodec::Packed);
+        for (size_t i = 0; i < modes.size(); i++)
+            w.appendState(std::int64_t(i) * 100, {makeStrBlob(modes[i])});
+        w.finish();
+    }
+
+    referee::db::Reader r(path);
+    ASSERT_EQ(r.numStates(), modes.size());
+    for (size_t i = 0; i < modes.size(); i++)
+    {
+        EXPECT_EQ(r.time(i), std::int64_t(i) * 100);
+        char const* sv = nullptr;
+        std::memcpy(&sv, r.propBlob(i, 0), sizeof(sv));
+        EXPECT_STREQ(sv, modes[i]);
+    }
+    EXPECT_EQ(r.propBlob(3, 0), r.propBlob(5, 0));
+    EXPECT_NE(r.propBlob(2, 0), r.propBlob(3, 0));
+
+    std::remove(path.c_str());
+}
+
 // Phase 9 — Loader throws for dynamic (count=0) array fields.
 // An array with no written extent loads as `{count, offset}` with the elements
 // placed after the fixed layout. The offset is relative to the descriptor, so
@@ -2668,6 +4072,7 @@ TEST(Rdb, ExprDataBlobValues)
     auto JITOrErr = llvm::orc::LLJITBuilder().create();
     ASSERT_TRUE(!!JITOrErr);
     auto jit = std::move(*JITOrErr);
+    defineRuntime(*jit);
 
     auto built = Referee::compile(refStream, refPath, &jit->getDataLayout());
     auto* astModule = built.ast;
@@ -2861,6 +4266,7 @@ TEST(Rdb, ExprTemporalBlobValues)
     auto JITOrErr = llvm::orc::LLJITBuilder().create();
     ASSERT_TRUE(!!JITOrErr);
     auto jit = std::move(*JITOrErr);
+    defineRuntime(*jit);
 
     auto built = Referee::compile(refStream, refPath, &jit->getDataLayout());
     auto* astModule = built.ast;
@@ -40,4 +40,19 @@ TEST(Strings, simple)
     EXPECT_NE(a, b);
     EXPECT_NE(a, aa);
     EXPECT_EQ(c, B);
-}
\ No newline at end of file
+}
+TEST(Strings, adopt)
+{
+    auto        strings = Strings::instance();
+    static char const   fresh[] = "adopt-fresh";
+    static char const   other[] = "adopt-other";
+    static char const   taken[] = "adopt-taken";
+    auto        t       = strings->getString(std::string("adopt-taken"));
+
+    //  All or none: a clash leaves `fresh` unadopted too.
+    EXPECT_EQ(strings->adopt({fresh, taken}), taken);
+    EXPECT_NE(strings->getString(std::string("adopt-fresh")), fresh);
+    EXPECT_EQ(strings->adopt({other}), nullptr);
+    EXPECT_EQ(strings->getString(std::string("adopt-other")), other);
+    EXPECT_EQ(strings->getString(std::string("adopt-taken")), t);
+}
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""
+Find where `referee execute --opt auto` should switch from O0 to O2.
+
+    python3 tools/opt_crossover.py ./build/referee
+    python3 tools/opt_crossover.py ./build/referee --spec my.ref --csv-columns a,b
+
+Times `execute --opt 0` and `execute --opt 2` over traces of growing length
+and reports the first length at which O2 -- slower to compile, faster to run
+-- is the quicker of the two end to end. That length is `kOptCrossover` in
+src/driver/referee.cpp.
+
+The default specification is a few dozen requirements over four signals, the
+shape of a typical unit-test spec. A real one can be passed instead; its
+`data` signals must all be boolean, since the generated trace is random bits.
+The trace has a column per `data` declaration it finds; --csv-columns names
+them instead, for a spec whose signals that scan misses or where only some of
+them should be generated.
+The crossover scales with how much work a state costs, so a spec far heavier
+than the default moves it down and a trivial one moves it up.
+"""
+import argparse, os, random, re, subprocess, sys, tempfile, time
+
+#  A mix of what the code generator emits: state formulas, the unbounded
+#  backward and forward recurrences, bounded windows and an accumulator.
+SPEC = """
+data a : boolean;
+data b : boolean;
+data c : boolean;
+data d : boolean;
+""" + "".join(f"""
+G(a && b => F(c || d)) || {i} > 0;
+Us(a || c, b) || Ss(d, c) || {i} > 0;
+G[0:{1000 * (i + 1)}](a => b) || {i} > 0;
+Cnt(a && !d) >= {i};
+""" for i in range(8))
+
+LENGTHS = [10, 100, 1000, 10000, 30000, 100000, 300000, 1000000]
+
+
+def trace(path, columns, rows, rng):
+    with open(path, "w") as f:
+        f.write("__time__," + ",".join(columns) + "\n")
+        for i in range(rows):
+            f.write(f"{i * 1000}," + ",".join(rng.choice(("true", "false")) for _ in columns) + "\n")
+
+
+def best(referee, ref, csv, level, repeat):
+    #  Best of a few, so a page-cache miss on the first run does not decide it.
+    times = []
+    for _ in range(repeat):
+        start = time.perf_counter()
+        subprocess.run([referee, "execute", "-v", "0", "--opt", str(level), ref, csv],
+                       stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        times.append(time.perf_counter() - start)
+    return min(times)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("referee", help="the referee binary")
+    ap.add_argument("--spec", help="a .ref to time instead of the built-in one")
+    ap.add_argument("--csv-columns", metavar="A,B,...",
+                    help="the boolean columns to generate, instead of the spec's data signals")
+    ap.add_argument("--repeat", type=int, default=3)
+    args = ap.parse_args()
+
+    src = open(args.spec).read() if args.spec else SPEC
+    if args.csv_columns:
+        columns = [c.strip() for c in args.csv_columns.split(",") if c.strip()]
+    else:
+        columns = re.findall(r"^\s*data\s+(\w+)\s*:", src, re.M)
+    if not columns:
+        ap.error("no columns to generate: pass --csv-columns")
+    rng = random.Random(0)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        ref = os.path.join(tmp, "spec.ref")
+        csv = os.path.join(tmp, "trace.csv")
+        with open(ref, "w") as f:
+            f.write(src)
+
+        print(f"{'states':>10} {'O0 s':>9} {'O2 s':>9}")
+        crossover = None
+        for n in LENGTHS:
+            trace(csv, columns, n, rng)
+            o0 = best(args.referee, ref, csv, 0, args.repeat)
+            o2 = best(args.referee, ref, csv, 2, args.repeat)
+            print(f"{n:>10} {o0:>9.3f} {o2:>9.3f}")
+            if crossover is None and o2 < o0:
+                crossover = n
+
+    if crossover is None:
+        print(f"O0 was never slower: the crossover is above {LENGTHS[-1]} states")
+    else:
+        print(f"O2 first wins at {crossover} states")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())